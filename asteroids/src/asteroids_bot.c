@@ -0,0 +1,46 @@
+#include "asteroids_bot.h"
+#include <math.h>
+
+#define BOT_DODGE_DISTANCE (2.0f*SHIP_SIZE)     // Gap to an asteroid's edge that makes the ship run
+#define BOT_AIM_DEGREES 6.0f
+
+unsigned int GetAsteroidsBotButtons(const AsteroidsGame *game)
+{
+    const Ship *ship = &game->ship;
+    const Vector2 *nearest = NULL;
+    float nearestGap = 0.0f;
+
+    EcsIter it = IterateQuery(&game->world, game->asteroids);
+    while (NextQueryChunk(&it)) {
+        const Vector2 *pos = GetQueryColumn(&it, ASTEROIDS_POSITION);
+        const AsteroidShape *shape = GetQueryColumn(&it, ASTEROIDS_SHAPE);
+        for (int i = 0; i < it.count; i++) {
+            float dx = pos[i].x - ship->pos.x, dy = pos[i].y - ship->pos.y;
+            float gap = sqrtf(dx*dx + dy*dy) - shape[i].size;
+            if (nearest == NULL || gap < nearestGap) {
+                nearest = &pos[i];
+                nearestGap = gap;
+            }
+        }
+    }
+    if (nearest == NULL) return 0;
+
+    // Ship angle 0 points right, in degrees clockwise on screen
+    float bearing = atan2f(nearest->y - ship->pos.y, nearest->x - ship->pos.x)*RAD2DEG;
+    bool dodging = nearestGap < BOT_DODGE_DISTANCE;
+    if (dodging) bearing += 180.0f;
+
+    float angle = fmodf(bearing - ship->angle + 540.0f, 360.0f) - 180.0f;
+    while (angle < -180.0f) angle += 360.0f;
+
+    unsigned int buttons = 0;
+    if (angle > SHIP_TURN_SPEED/2) buttons |= ASTEROIDS_INPUT_RIGHT;
+    else if (angle < -SHIP_TURN_SPEED/2) buttons |= ASTEROIDS_INPUT_LEFT;
+
+    if (dodging && fabsf(angle) < 45.0f) buttons |= ASTEROIDS_INPUT_THRUST;
+
+    // A shot needs the button released in between
+    if (!dodging && fabsf(angle) < BOT_AIM_DEGREES && game->canShoot) buttons |= ASTEROIDS_INPUT_FIRE;
+
+    return buttons;
+}
@@ -0,0 +1,11 @@
+#ifndef ASTEROIDS_BOT_H
+#define ASTEROIDS_BOT_H
+
+// Autoplayer policy for soak and performance runs (see bot.h): turns to the nearest asteroid and shoots it, and
+// turns away and thrusts when one gets too close
+
+#include "asteroids_sim.h"
+
+unsigned int GetAsteroidsBotButtons(const AsteroidsGame *game);     // Buttons a player would hold this tick
+
+#endif // ASTEROIDS_BOT_H
@@ -0,0 +1,64 @@
+#include "asteroids_draw.h"
+#include "gameloop.h"
+#include <math.h>
+
+void RecordAsteroids(DrawList *list, const AsteroidsGame *game, const AsteroidsGame *previous, float alpha)
+{
+    const Ship *ship = &game->ship;
+    Vector2 shipPos = InterpolatePosition(previous->ship.pos, ship->pos, alpha, SHIP_SIZE*2);
+    float shipAngle = InterpolateAngle(previous->ship.angle, ship->angle, alpha);
+
+    RecordClear(list, BLACK);
+
+    RecordTextFormat(list, 20, 20, 32, WHITE, "Score: %d", game->score);
+    RecordTextFormat(list, SCREEN_WIDTH - 160, 20, 32, WHITE, "Lives: %d", game->lives);
+
+    // Draw ship
+    Vector2 nose = {
+        shipPos.x + cosf(DEG2RAD * shipAngle) * SHIP_SIZE,
+        shipPos.y + sinf(DEG2RAD * shipAngle) * SHIP_SIZE
+    };
+    Vector2 left = {
+        shipPos.x + cosf(DEG2RAD * (shipAngle + 140)) * SHIP_SIZE * 0.6f,
+        shipPos.y + sinf(DEG2RAD * (shipAngle + 140)) * SHIP_SIZE * 0.6f
+    };
+    Vector2 right = {
+        shipPos.x + cosf(DEG2RAD * (shipAngle - 140)) * SHIP_SIZE * 0.6f,
+        shipPos.y + sinf(DEG2RAD * (shipAngle - 140)) * SHIP_SIZE * 0.6f
+    };
+    RecordTriangle(list, nose, right, left, WHITE);
+
+    // Draw bullets, from where the same entity was the tick before if it was there
+    EcsIter it = IterateQuery(&game->world, game->bullets);
+    while (NextQueryChunk(&it)) {
+        const Vector2 *current = GetQueryColumn(&it, ASTEROIDS_POSITION);
+        for (int i = 0; i < it.count; i++) {
+            const Vector2 *last = GetComponent(&previous->world, it.entities[i], ASTEROIDS_POSITION);
+            Vector2 pos = (last != NULL)? InterpolatePosition(*last, current[i], alpha, BULLET_SPEED*2) : current[i];
+            RecordCircle(list, pos, 2, YELLOW);
+        }
+    }
+
+    // Draw asteroids
+    it = IterateQuery(&game->world, game->asteroids);
+    while (NextQueryChunk(&it)) {
+        const Vector2 *current = GetQueryColumn(&it, ASTEROIDS_POSITION);
+        const AsteroidShape *shape = GetQueryColumn(&it, ASTEROIDS_SHAPE);
+        for (int i = 0; i < it.count; i++) {
+            const AsteroidShape *asteroid = &shape[i];
+            const Vector2 *last = GetComponent(&previous->world, it.entities[i], ASTEROIDS_POSITION);
+            Vector2 pos = (last != NULL)? InterpolatePosition(*last, current[i], alpha, ASTEROID_MAX_SPEED*2) : current[i];
+            Vector2 points[16];
+            float angleStep = 360.0f / asteroid->sides;
+            for (int v = 0; v < asteroid->sides; v++) {
+                float ang = DEG2RAD * (asteroid->angle + v * angleStep);
+                float rad = asteroid->size * asteroid->radii[v];
+                points[v].x = pos.x + cosf(ang) * rad;
+                points[v].y = pos.y + sinf(ang) * rad;
+            }
+            for (int v = 0; v < asteroid->sides; v++) {
+                RecordLine(list, points[v], points[(v+1)%asteroid->sides], GRAY);
+            }
+        }
+    }
+}
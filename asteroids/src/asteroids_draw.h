@@ -0,0 +1,13 @@
+#ifndef ASTEROIDS_DRAW_H
+#define ASTEROIDS_DRAW_H
+
+// Asteroids' picture, recorded in a draw list: replayed to raylib by the game, rasterized on the CPU by
+// asteroids_headless --frames and the benchmarks
+
+#include "asteroids_sim.h"
+#include "drawlist.h"
+
+// Moving objects are drawn alpha of the way from previous to game (see gameloop.h), pass game twice for a tick as is
+void RecordAsteroids(DrawList *list, const AsteroidsGame *game, const AsteroidsGame *previous, float alpha);
+
+#endif // ASTEROIDS_DRAW_H
@@ -0,0 +1,288 @@
+#include "asteroids_sim.h"
+#include "replay.h"
+#include "profiler.h"
+#include "counters.h"
+#include <math.h>
+
+static void StartRound(AsteroidsGame *game);
+static void FireBullet(AsteroidsGame *game);
+static void SpawnAsteroid(AsteroidsGame *game, Vector2 pos, float size);
+static void PushEvent(AsteroidsGame *game, AsteroidsEventType type, Vector2 position);
+static void WrapPosition(Vector2 *pos);
+
+void InitAsteroids(AsteroidsGame *game, unsigned int seed)
+{
+    EcsWorld *world = &game->world;
+    if (world->queryCount == 0) {
+        InitEcsWorld(world);
+        RegisterComponent(world, ASTEROIDS_POSITION, sizeof(Vector2));
+        RegisterComponent(world, ASTEROIDS_VELOCITY, sizeof(Vector2));
+        RegisterComponent(world, ASTEROIDS_LIFETIME, sizeof(int));
+        RegisterComponent(world, ASTEROIDS_SHAPE, sizeof(AsteroidShape));
+        game->bullets = AddQuery(world, ECS_BIT(ASTEROIDS_LIFETIME), 0);
+        game->asteroids = AddQuery(world, ECS_BIT(ASTEROIDS_SHAPE), 0);
+        game->moving = AddQuery(world, ECS_BIT(ASTEROIDS_POSITION) | ECS_BIT(ASTEROIDS_VELOCITY), 0);
+    }
+
+    SeedRng(&game->roundRng, seed, ASTEROIDS_RNG_ROUND);
+    SeedRng(&game->spawnRng, seed, ASTEROIDS_RNG_SPAWN);
+    game->score = 0;
+    game->lives = STARTING_LIVES;
+    game->canShoot = true;
+    game->eventCount = 0;
+    StartRound(game);
+}
+
+// Respawn ship and asteroids, but keep score and lives
+void StartRound(AsteroidsGame *game)
+{
+    Ship *ship = &game->ship;
+    ship->pos = (Vector2){SCREEN_WIDTH/2, SCREEN_HEIGHT/2};
+    ship->vel = (Vector2){0, 0};
+    ship->angle = 0;
+    ship->radius = SHIP_SIZE/2;
+
+    ClearEcsWorld(&game->world);
+
+    // Spawn initial asteroids
+    for (int i = 0; i < 5; i++) {
+        Vector2 pos = {RandomRange(&game->roundRng, 0, SCREEN_WIDTH), RandomRange(&game->roundRng, 0, SCREEN_HEIGHT)};
+        SpawnAsteroid(game, pos, ASTEROID_MAX_SIZE);
+    }
+}
+
+void StepAsteroids(AsteroidsGame *game, AsteroidsInput input)
+{
+    Ship *ship = &game->ship;
+    EcsWorld *world = &game->world;
+
+    game->eventCount = 0;
+
+    // Ship controls
+    if (input.buttons & ASTEROIDS_INPUT_LEFT) ship->angle -= SHIP_TURN_SPEED;
+    if (input.buttons & ASTEROIDS_INPUT_RIGHT) ship->angle += SHIP_TURN_SPEED;
+    if (input.buttons & ASTEROIDS_INPUT_THRUST) {
+        ship->vel.x += cosf(DEG2RAD * ship->angle) * SHIP_ACCELERATION;
+        ship->vel.y += sinf(DEG2RAD * ship->angle) * SHIP_ACCELERATION;
+    }
+    ship->vel.x *= SHIP_FRICTION;
+    ship->vel.y *= SHIP_FRICTION;
+    ship->pos.x += ship->vel.x;
+    ship->pos.y += ship->vel.y;
+    WrapPosition(&ship->pos);
+
+    // Fire bullets, one per press
+    if (input.buttons & ASTEROIDS_INPUT_FIRE) {
+        if (game->canShoot) {
+            FireBullet(game);
+            game->canShoot = false;
+        }
+    } else {
+        game->canShoot = true;
+    }
+
+    COUNT("bullets", CountQueryEntities(world, game->bullets));
+    COUNT("asteroids", CountQueryEntities(world, game->asteroids));
+
+    // Move bullets and asteroids
+    EcsIter it = IterateQuery(world, game->moving);
+    while (NextQueryChunk(&it)) {
+        Vector2 *pos = GetQueryColumn(&it, ASTEROIDS_POSITION);
+        const Vector2 *vel = GetQueryColumn(&it, ASTEROIDS_VELOCITY);
+        for (int i = 0; i < it.count; i++) {
+            pos[i].x += vel[i].x;
+            pos[i].y += vel[i].y;
+            WrapPosition(&pos[i]);
+        }
+    }
+
+    // Bullets fly for a while
+    it = IterateQuery(world, game->bullets);
+    while (NextQueryChunk(&it)) {
+        int *lifetime = GetQueryColumn(&it, ASTEROIDS_LIFETIME);
+        for (int i = 0; i < it.count; i++) {
+            if (++lifetime[i] > BULLET_LIFETIME) DestroyEntityLater(world, it.entities[i]);
+        }
+    }
+    FlushEcsWorld(world);
+
+    PROFILE_ZONE("collision") CollideAsteroids(game);
+}
+
+// Bullets and ship against the asteroids, the last part of a step
+void CollideAsteroids(AsteroidsGame *game)
+{
+    Ship *ship = &game->ship;
+    EcsWorld *world = &game->world;
+    int pairs = 0;
+
+    // Bullet-asteroid collision. Hit asteroids are dead at once, their rows go at the flush
+    EcsIter bullets = IterateQuery(world, game->bullets);
+    while (NextQueryChunk(&bullets)) {
+        const Vector2 *bulletPos = GetQueryColumn(&bullets, ASTEROIDS_POSITION);
+        for (int i = 0; i < bullets.count; i++) {
+            bool hit = false;
+            EcsIter asteroids = IterateQuery(world, game->asteroids);
+            while (!hit && NextQueryChunk(&asteroids)) {
+                const Vector2 *pos = GetQueryColumn(&asteroids, ASTEROIDS_POSITION);
+                const AsteroidShape *shape = GetQueryColumn(&asteroids, ASTEROIDS_SHAPE);
+                for (int j = 0; j < asteroids.count && !hit; j++) {
+                    if (!IsEntityAlive(world, asteroids.entities[j])) continue;
+                    pairs++;
+                    float dx = bulletPos[i].x - pos[j].x;
+                    float dy = bulletPos[i].y - pos[j].y;
+                    float dist = sqrtf(dx*dx + dy*dy);
+                    if (dist < shape[j].size) {
+                        hit = true;
+                        Vector2 at = pos[j];
+                        float size = shape[j].size;
+                        DestroyEntityLater(world, bullets.entities[i]);
+                        DestroyEntityLater(world, asteroids.entities[j]);
+                        // Score based on asteroid size
+                        if (size > ASTEROID_MIN_SIZE) {
+                            game->score += 20;
+                            for (int s = 0; s < 2; s++) {
+                                SpawnAsteroid(game, at, size/2);
+                            }
+                        } else {
+                            game->score += 50;
+                        }
+                        PushEvent(game, ASTEROIDS_EVENT_EXPLOSION, at);
+                    }
+                }
+            }
+        }
+    }
+
+    // Ship-asteroid collision
+    bool lost = false;
+    EcsIter it = IterateQuery(world, game->asteroids);
+    while (!lost && NextQueryChunk(&it)) {
+        const Vector2 *pos = GetQueryColumn(&it, ASTEROIDS_POSITION);
+        const AsteroidShape *shape = GetQueryColumn(&it, ASTEROIDS_SHAPE);
+        for (int i = 0; i < it.count && !lost; i++) {
+            if (!IsEntityAlive(world, it.entities[i])) continue;
+            pairs++;
+            float dx = ship->pos.x - pos[i].x;
+            float dy = ship->pos.y - pos[i].y;
+            float dist = sqrtf(dx*dx + dy*dy);
+            lost = (dist < shape[i].size + ship->radius);
+        }
+    }
+    FlushEcsWorld(world);
+
+    if (lost) {
+        // Lose a life on collision
+        game->lives--;
+        PushEvent(game, ASTEROIDS_EVENT_SHIP_LOST, ship->pos);
+        if (game->lives <= 0) {
+            // Game over: reset everything
+            PushEvent(game, ASTEROIDS_EVENT_GAME_OVER, ship->pos);
+            game->score = 0;
+            game->lives = STARTING_LIVES;
+        }
+        StartRound(game);
+    }
+
+    COUNT("collision pairs", pairs);
+}
+
+void FireBullet(AsteroidsGame *game)
+{
+    Ship *ship = &game->ship;
+    EcsWorld *world = &game->world;
+    if (CountQueryEntities(world, game->bullets) >= MAX_BULLETS) return;
+
+    EcsEntity bullet = CreateEntity(world, ASTEROIDS_BULLET);
+    *(Vector2 *)GetComponent(world, bullet, ASTEROIDS_POSITION) = ship->pos;
+    *(Vector2 *)GetComponent(world, bullet, ASTEROIDS_VELOCITY) = (Vector2){
+        cosf(DEG2RAD * ship->angle) * BULLET_SPEED,
+        sinf(DEG2RAD * ship->angle) * BULLET_SPEED
+    };
+    PushEvent(game, ASTEROIDS_EVENT_SHOT, ship->pos);
+}
+
+void SpawnAsteroid(AsteroidsGame *game, Vector2 pos, float size)
+{
+    EcsWorld *world = &game->world;
+    if (CountQueryEntities(world, game->asteroids) >= MAX_ASTEROIDS) return;
+
+    EcsEntity asteroid = CreateEntity(world, ASTEROIDS_ASTEROID);
+    Vector2 *vel = GetComponent(world, asteroid, ASTEROIDS_VELOCITY);
+    AsteroidShape *shape = GetComponent(world, asteroid, ASTEROIDS_SHAPE);
+    *(Vector2 *)GetComponent(world, asteroid, ASTEROIDS_POSITION) = pos;
+
+    Rng *rng = &game->spawnRng;
+    float angle = DEG2RAD * RandomRange(rng, 0, 359);
+    float speed = ASTEROID_MIN_SPEED + RandomFloat(rng) * (ASTEROID_MAX_SPEED - ASTEROID_MIN_SPEED);
+    vel->x = cosf(angle) * speed;
+    vel->y = sinf(angle) * speed;
+    shape->angle = RandomRange(rng, 0, 359);
+    shape->size = size;
+    shape->sides = RandomRange(rng, 8, 11);
+    for (int v = 0; v < shape->sides; v++) shape->radii[v] = 0.75f + 0.25f*RandomFloat(rng);
+}
+
+unsigned long long HashAsteroids(const AsteroidsGame *game)
+{
+    const EcsWorld *world = &game->world;
+    unsigned long long hash = REPLAY_HASH_SEED;
+    hash = HashInt(hash, game->score);
+    hash = HashInt(hash, game->lives);
+    hash = HashInt(hash, game->canShoot);
+    hash = HashBytes(hash, &game->roundRng, sizeof(Rng));
+    hash = HashBytes(hash, &game->spawnRng, sizeof(Rng));
+    hash = HashBytes(hash, &game->ship, sizeof(Ship));      // Floats only, no padding
+
+    hash = HashInt(hash, CountQueryEntities(world, game->bullets));
+    EcsIter it = IterateQuery(world, game->bullets);
+    while (NextQueryChunk(&it)) {
+        const Vector2 *pos = GetQueryColumn(&it, ASTEROIDS_POSITION);
+        const int *lifetime = GetQueryColumn(&it, ASTEROIDS_LIFETIME);
+        for (int i = 0; i < it.count; i++) {
+            hash = HashFloat(hash, pos[i].x);
+            hash = HashFloat(hash, pos[i].y);
+            hash = HashInt(hash, lifetime[i]);
+        }
+    }
+    hash = HashInt(hash, CountQueryEntities(world, game->asteroids));
+    it = IterateQuery(world, game->asteroids);
+    while (NextQueryChunk(&it)) {
+        const Vector2 *pos = GetQueryColumn(&it, ASTEROIDS_POSITION);
+        const AsteroidShape *shape = GetQueryColumn(&it, ASTEROIDS_SHAPE);
+        for (int i = 0; i < it.count; i++) {
+            hash = HashFloat(hash, pos[i].x);
+            hash = HashFloat(hash, pos[i].y);
+            hash = HashFloat(hash, shape[i].size);
+        }
+    }
+
+    return hash;
+}
+
+void CopyAsteroids(AsteroidsGame *dst, const AsteroidsGame *src)
+{
+    EcsWorld world = dst->world;        // Its chunks are reused
+    *dst = *src;
+    dst->world = world;
+    CopyEcsWorld(&dst->world, &src->world);
+}
+
+void UnloadAsteroids(AsteroidsGame *game)
+{
+    UnloadEcsWorld(&game->world);
+}
+
+void PushEvent(AsteroidsGame *game, AsteroidsEventType type, Vector2 position)
+{
+    if (game->eventCount < ASTEROIDS_MAX_EVENTS) game->events[game->eventCount++] = (AsteroidsEvent){ type, position };
+}
+
+// Screen wrap
+void WrapPosition(Vector2 *pos)
+{
+    if (pos->x < 0) pos->x += SCREEN_WIDTH;
+    if (pos->x > SCREEN_WIDTH) pos->x -= SCREEN_WIDTH;
+    if (pos->y < 0) pos->y += SCREEN_HEIGHT;
+    if (pos->y > SCREEN_HEIGHT) pos->y -= SCREEN_HEIGHT;
+}
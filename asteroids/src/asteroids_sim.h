@@ -0,0 +1,110 @@
+#ifndef ASTEROIDS_SIM_H
+#define ASTEROIDS_SIM_H
+
+// Asteroids simulation: game state and the per-tick step, with no window, input or audio calls.
+// Only the raylib.h types are used, so it also builds into the headless target. Bullets and asteroids are entities
+// of an ECS world (see ecs.h), the game holds a heap: copy it with CopyAsteroids(), free it with UnloadAsteroids()
+
+#include "raylib.h"
+#include "rng.h"
+#include "ecs.h"
+
+#define SCREEN_WIDTH 720
+#define SCREEN_HEIGHT 900
+#define STARTING_LIVES 3
+#define SHIP_SIZE 30
+#define SHIP_TURN_SPEED 5.0f
+#define SHIP_ACCELERATION 0.2f
+#define SHIP_FRICTION 0.99f
+#define BULLET_SPEED 8.0f
+#define BULLET_LIFETIME 60
+#define MAX_BULLETS 10
+#define MAX_ASTEROIDS 16
+#define ASTEROID_MIN_SIZE 20
+#define ASTEROID_MAX_SIZE 60
+#define ASTEROID_MIN_SPEED 1.0f
+#define ASTEROID_MAX_SPEED 3.0f
+#define ASTEROID_MAX_SIDES 12
+#define ASTEROIDS_MAX_EVENTS 32
+
+// Random streams of a game, see rng.h
+enum {
+    ASTEROIDS_RNG_ROUND = 0,
+    ASTEROIDS_RNG_SPAWN
+};
+
+// Buttons held this tick
+enum {
+    ASTEROIDS_INPUT_LEFT = 1,
+    ASTEROIDS_INPUT_RIGHT = 2,
+    ASTEROIDS_INPUT_THRUST = 4,
+    ASTEROIDS_INPUT_FIRE = 8,
+    ASTEROIDS_INPUT_ALL = 15
+};
+
+typedef struct {
+    unsigned int buttons;
+} AsteroidsInput;
+
+// What happened during the last step, for sounds and effects
+typedef enum {
+    ASTEROIDS_EVENT_SHOT = 0,
+    ASTEROIDS_EVENT_EXPLOSION,
+    ASTEROIDS_EVENT_SHIP_LOST,
+    ASTEROIDS_EVENT_GAME_OVER
+} AsteroidsEventType;
+
+typedef struct {
+    AsteroidsEventType type;
+    Vector2 position;
+} AsteroidsEvent;
+
+// Components of the bullets and asteroids
+enum {
+    ASTEROIDS_POSITION = 0,             // Vector2
+    ASTEROIDS_VELOCITY,                 // Vector2, per tick
+    ASTEROIDS_LIFETIME,                 // int, ticks a bullet has flown
+    ASTEROIDS_SHAPE                     // AsteroidShape
+};
+
+#define ASTEROIDS_BULLET (ECS_BIT(ASTEROIDS_POSITION) | ECS_BIT(ASTEROIDS_VELOCITY) | ECS_BIT(ASTEROIDS_LIFETIME))
+#define ASTEROIDS_ASTEROID (ECS_BIT(ASTEROIDS_POSITION) | ECS_BIT(ASTEROIDS_VELOCITY) | ECS_BIT(ASTEROIDS_SHAPE))
+
+typedef struct {
+    float angle;
+    float size;
+    int sides;
+    float radii[ASTEROID_MAX_SIDES];    // Distance of each vertex, as a fraction of size
+} AsteroidShape;
+
+typedef struct {
+    Vector2 pos;
+    Vector2 vel;
+    float angle;
+    float radius;
+} Ship;
+
+typedef struct {
+    int score;
+    int lives;
+    Ship ship;
+    EcsWorld world;                 // Bullets and asteroids
+    int bullets;                    // Queries of the world
+    int asteroids;
+    int moving;                     // Both
+    bool canShoot;
+    Rng roundRng;                   // Start positions of each round
+    Rng spawnRng;                   // Motion and outline of every new asteroid
+
+    AsteroidsEvent events[ASTEROIDS_MAX_EVENTS];
+    int eventCount;
+} AsteroidsGame;
+
+void InitAsteroids(AsteroidsGame *game, unsigned int seed);       // New game, creates the world on first use
+void StepAsteroids(AsteroidsGame *game, AsteroidsInput input);    // One tick, events are replaced
+unsigned long long HashAsteroids(const AsteroidsGame *game);      // For replays, see replay.h
+void CollideAsteroids(AsteroidsGame *game);                       // Collision part of the step, on its own for the bench
+void CopyAsteroids(AsteroidsGame *dst, const AsteroidsGame *src); // dst zeroed or a game, its world's memory is reused
+void UnloadAsteroids(AsteroidsGame *game);
+
+#endif // ASTEROIDS_SIM_H
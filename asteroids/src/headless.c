@@ -0,0 +1,51 @@
+// Asteroids simulation without window or audio, on random, bot or replayed input: asteroids_headless [--ticks N] [--seed N] [--replay FILE]
+// (all options in headless.h). --frames DIR draws pictures of the game with the software rasterizer
+#define HEADLESS_IMPLEMENTATION
+#define REPLAY_IMPLEMENTATION
+#define COUNTERS_IMPLEMENTATION
+#define ECS_IMPLEMENTATION
+#define SOAK_IMPLEMENTATION
+#define DRAWLIST_IMPLEMENTATION
+#define SOFTRASTER_IMPLEMENTATION
+#include "headless.h"
+#include "asteroids_sim.h"
+#include "asteroids_bot.h"
+#include "asteroids_draw.h"
+#include "softraster.h"
+
+int main(int argc, char *argv[])
+{
+    HeadlessRun run;
+    static AsteroidsGame game;
+    DrawList list = { 0 };
+    RasterFrame frame = { 0 };
+
+    if (!StartHeadlessRun(&run, argc, argv, "asteroids", 0)) return 1;
+    InitAsteroids(&game, run.options.seed);
+    if (run.options.framesDir != NULL) {
+        InitJobSystem(0);
+        frame = LoadRasterFrame(SCREEN_WIDTH, SCREEN_HEIGHT);
+    }
+
+    while (run.tick < run.options.ticks) {
+        AsteroidsInput input = { run.botting? NextHeadlessBotButtons(&run, GetAsteroidsBotButtons(&game), ASTEROIDS_INPUT_ALL) : NextHeadlessButtons(&run, ASTEROIDS_INPUT_ALL) };
+        StepAsteroids(&game, input);
+        if (!EndHeadlessTick(&run, game.eventCount, run.hashing? HashAsteroids(&game) : 0)) break;
+
+        if (IsHeadlessFrameDue(&run)) {
+            ResetDrawList(&list);
+            RecordAsteroids(&list, &game, &game, 0.0f);
+            RasterizeDrawList(&frame, &list);
+            SaveRasterFrame(&frame, GetHeadlessFramePath(&run));
+        }
+    }
+
+    if (run.options.framesDir != NULL) {
+        UnloadRasterFrame(&frame);
+        UnloadDrawList(&list);
+        CloseJobSystem();
+    }
+
+    UnloadAsteroids(&game);
+    return FinishHeadlessRun(&run);
+}
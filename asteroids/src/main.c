@@ -1,310 +1,209 @@
 #include "raylib.h"
+#include "asteroids_sim.h"
+#include "asteroids_draw.h"
+#include "asteroids_bot.h"
+#include "bot.h"
+
+#define REPLAY_IMPLEMENTATION
+#include "replay.h"
+#define ECS_IMPLEMENTATION
+#include "ecs.h"
+#define PROFILER_GRAPH_IMPLEMENTATION
+#include "profiler.h"
+#define COUNTERS_IMPLEMENTATION
+#define COUNTERS_OVERLAY_IMPLEMENTATION
+#include "counters.h"
+#define GAMELOOP_IMPLEMENTATION
+#include "gameloop.h"
+#define DRAWLIST_IMPLEMENTATION
+#define DRAWLIST_REPLAY_IMPLEMENTATION
+#include "drawlist.h"
+#define SOAK_IMPLEMENTATION
+#include "soak.h"
+#define PAK_LOADERS_IMPLEMENTATION
+#include "pak.h"
+#define ATLAS_IMPLEMENTATION
+#include "atlas.h"
+#define MIXER_IMPLEMENTATION
+#include "mixer.h"
+#define MUSIC_IMPLEMENTATION
+#include "music.h"
+#define ASSETS_IMPLEMENTATION
+#include "assets.h"
+#define STARTUP_IMPLEMENTATION
+#include "startup.h"
 #include <math.h>
 #include <stdlib.h>
-
-#define SCREEN_WIDTH 720
-#define SCREEN_HEIGHT 900
-#define STARTING_LIVES 3
-#define SHIP_SIZE 30
-#define SHIP_TURN_SPEED 5.0f
-#define SHIP_ACCELERATION 0.2f
-#define SHIP_FRICTION 0.99f
-#define BULLET_SPEED 8.0f
-#define BULLET_LIFETIME 60
-#define MAX_BULLETS 10
-#define MAX_ASTEROIDS 16
-#define ASTEROID_MIN_SIZE 20
-#define ASTEROID_MAX_SIZE 60
-#define ASTEROID_MIN_SPEED 1.0f
-#define ASTEROID_MAX_SPEED 3.0f
-
-static int score = 0;
-static int lives = STARTING_LIVES;
+#include <string.h>
 
 Music music = { 0 };
-Sound sfxLaser = { 0 };
-Sound sfxAsteroidExplode = { 0 };
-
-typedef struct {
-    Vector2 pos;
-    Vector2 vel;
-    float angle;
-    bool active;
-} Bullet;
-
-typedef struct {
-    Vector2 pos;
-    Vector2 vel;
-    float angle;
-    float size;
-    int sides;
-    bool active;
-} Asteroid;
-
-typedef struct {
-    Vector2 pos;
-    Vector2 vel;
-    float angle;
-    float radius;
-} Ship;
-
-static Ship ship;
-static Bullet bullets[MAX_BULLETS];
-static int bulletTimer[MAX_BULLETS];
-static Asteroid asteroids[MAX_ASTEROIDS];
+MixerSound sfxLaser = { 0 };
+MixerSound sfxAsteroidExplode = { 0 };
+
+static AsteroidsGame game = { 0 };
+static AsteroidsGame previous = { 0 };     // State of the tick before, drawing interpolates from it
+static GameLoop loop = { 0 };
+static FramePipeline pipeline = { 0 };
+static AsteroidsInput input = { 0 };       // Read on the main thread, for the ticks of the frame being recorded
+static int frameTicks = 0;
+static float frameAlpha = 0.0f;
+static Replay replay = { 0 };      // This session, saved as asteroids.replay on exit for asteroids_headless --replay
+static int botSkill = -1;          // --bot SKILL, negative when the keyboard plays
+static Bot bot = { 0 };
+static Pak pak = { 0 };            // resources.pak, mapped until the music stream is unloaded
+static AssetCache assets = { 0 };  // Owns every asset loaded (see assets.h)
+static Startup startup = { 0 };
 
 static void InitGame(void);
-static void UpdateGame(void);
-static void DrawGame(void);
+static void ReadInput(void);
+static void RunFrame(void *user, DrawList *list);
+static void UpdateGame(DrawList *list);
+static void DrawGame(DrawList *list, float alpha);
+static void DrawFrame(void);
 static void UnloadGame(void);
-static void FireBullet(void);
-static void SpawnAsteroid(Vector2 pos, float size);
 
-int main(void)
+int main(int argc, char *argv[])
 {
-    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "asteroids");
-
-    InitAudioDevice();    
-    music = LoadMusicStream("resources/background_music.ogg"); 
-    sfxLaser = LoadSound("resources/laser.wav");
-    sfxAsteroidExplode = LoadSound("resources/sfx_asteroid_explode.ogg");
-
-    SetMusicVolume(music, 1.0f);
-    PlayMusicStream(music);
+    // --profile FILE writes a Chrome trace of the session on exit, F3 shows the frame-time graph
+    // --counters FILE streams the workload counters of every frame (see counters.h), F4 shows them
+    // --bot SKILL plays by itself, 0 to 100 (see bot.h)
+    // --soak SECONDS ends the session after that long, --soak-log FILE logs its frame times and memory (see soak.h)
+    const char *profileFile = NULL, *countersFile = NULL, *soakLogFile = NULL;
+    double soakSeconds = 0.0;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--profile") == 0) profileFile = argv[++i];
+        else if (strcmp(argv[i], "--counters") == 0) countersFile = argv[++i];
+        else if (strcmp(argv[i], "--bot") == 0) botSkill = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--soak") == 0) soakSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--soak-log") == 0) soakLogFile = argv[++i];
+    }
+    InitProfiler(profileFile);
+    if (countersFile != NULL) OpenCounterStream(countersFile);
+
+    // Assets decode and the audio device starts while the window opens (see startup.h)
+    pak = LoadPak(TextFormat("%sresources.pak", GetApplicationDirectory()), "resources/");
+    InitAssetCache(&assets, &pak);
+    InitStartup(&startup, &assets);
+    AddStartupMusic(&startup, "background_music.ogg", &music, 1.0f);
+    AddStartupMixerSound(&startup, "laser.wav", &sfxLaser);
+    AddStartupMixerSound(&startup, "sfx_asteroid_explode.ogg", &sfxAsteroidExplode);
+    AddStartupMixer(&startup);
+    InitMusicPlayer();             // The music decodes on its own thread (see music.h)
+    BeginStartup(&startup, true);
 
+    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "asteroids");
+    MarkStartup(&startup, "window");
     InitGame();
-    SetTargetFPS(60);
+    MarkStartup(&startup, "game");
+    WaitStartup(&startup);
+    SetTargetFPS(GetMonitorRefreshRate(GetCurrentMonitor()));   // Draw at the display rate, the game ticks at GAMELOOP_TICK_RATE
 
-    while (!WindowShouldClose())
+    SoakRun soak;
+    StartSoakRun(&soak, soakSeconds, soakLogFile);
+
+    while (!WindowShouldClose() && UpdateSoakRun(&soak, GetTime()))
     {
-        UpdateGame();
-        DrawGame();
-        UpdateMusicStream(music);
+        ProfileFrame();
+        UpdateStartup(&startup);   // Uploads the assets decoded since the last frame
+        UpdateProfilerGraph();     // Once per frame, a frame can run no tick or several
+        UpdateCounterOverlay();
+        ReadInput();
+        frameTicks = AdvanceGameLoop(&loop, GetTime());
+        frameAlpha = GetGameLoopAlpha(&loop);
+
+        StartPipelineFrame(&pipeline);      // The next frame updates and records on the worker...
+        DrawFrame();                        // ...while this one is drawn
+        UpdateMusicPlayer();
+        FinishPipelineFrame(&pipeline);
+        CounterFrame();
     }
 
     UnloadGame();
     CloseWindow();
+    CloseProfiler();
+    CloseCounterStream();
+    FinishSoakRun(&soak, "asteroids");
     return 0;
 }
 
 void InitGame(void)
 {
-    ship.pos = (Vector2){SCREEN_WIDTH/2, SCREEN_HEIGHT/2};
-    ship.vel = (Vector2){0, 0};
-    ship.angle = 0;
-    ship.radius = SHIP_SIZE/2;
-
-    for (int i = 0; i < MAX_BULLETS; i++) bullets[i].active = false;
-    for (int i = 0; i < MAX_ASTEROIDS; i++) asteroids[i].active = false;
-
-    // Spawn initial asteroids
-    for (int i = 0; i < 5; i++) {
-        Vector2 pos = {GetRandomValue(0, SCREEN_WIDTH), GetRandomValue(0, SCREEN_HEIGHT)};
-        SpawnAsteroid(pos, ASTEROID_MAX_SIZE);
-    }
-
-    static bool firstInit = true;
-    if (firstInit) {
-        score = 0;
-        lives = STARTING_LIVES;
-        firstInit = false;
-    }
+    unsigned int seed = (unsigned int)GetRandomValue(0, 0x7fffffff);
+    InitAsteroids(&game, seed);
+    InitReplay(&replay, "asteroids", seed, 0);
+    if (botSkill >= 0) InitBot(&bot, botSkill, seed);
+    InitGameLoop(&loop, GAMELOOP_TICK_RATE, GAMELOOP_MAX_CATCH_UP);
+    InitFramePipeline(&pipeline, RunFrame, NULL);
 }
 
-void UpdateGame(void)
+void ReadInput(void)
 {
-    // Ship controls
-    if (IsKeyDown(KEY_LEFT)) ship.angle -= SHIP_TURN_SPEED;
-    if (IsKeyDown(KEY_RIGHT)) ship.angle += SHIP_TURN_SPEED;
-    if (IsKeyDown(KEY_UP)) {
-        ship.vel.x += cosf(DEG2RAD * ship.angle) * SHIP_ACCELERATION;
-        ship.vel.y += sinf(DEG2RAD * ship.angle) * SHIP_ACCELERATION;
-    }
-    ship.vel.x *= SHIP_FRICTION;
-    ship.vel.y *= SHIP_FRICTION;
-    ship.pos.x += ship.vel.x;
-    ship.pos.y += ship.vel.y;
-
-    // Screen wrap
-    if (ship.pos.x < 0) ship.pos.x += SCREEN_WIDTH;
-    if (ship.pos.x > SCREEN_WIDTH) ship.pos.x -= SCREEN_WIDTH;
-    if (ship.pos.y < 0) ship.pos.y += SCREEN_HEIGHT;
-    if (ship.pos.y > SCREEN_HEIGHT) ship.pos.y -= SCREEN_HEIGHT;
-
-    // Fire bullets
-    static bool canShoot = true;
-    if (IsKeyDown(KEY_SPACE)) {
-        if (canShoot) {
-            FireBullet();
-            canShoot = false;
-        }
-    } else {
-        canShoot = true;
-    }
-
-    // Update bullets
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        if (bullets[i].active) {
-            bullets[i].pos.x += bullets[i].vel.x;
-            bullets[i].pos.y += bullets[i].vel.y;
-            bulletTimer[i]++;
-            // Screen wrap
-            if (bullets[i].pos.x < 0) bullets[i].pos.x += SCREEN_WIDTH;
-            if (bullets[i].pos.x > SCREEN_WIDTH) bullets[i].pos.x -= SCREEN_WIDTH;
-            if (bullets[i].pos.y < 0) bullets[i].pos.y += SCREEN_HEIGHT;
-            if (bullets[i].pos.y > SCREEN_HEIGHT) bullets[i].pos.y -= SCREEN_HEIGHT;
-            if (bulletTimer[i] > BULLET_LIFETIME) bullets[i].active = false;
-        }
-    }
-
-    // Update asteroids
-    for (int i = 0; i < MAX_ASTEROIDS; i++) {
-        if (asteroids[i].active) {
-            asteroids[i].pos.x += asteroids[i].vel.x;
-            asteroids[i].pos.y += asteroids[i].vel.y;
-            // Screen wrap
-            if (asteroids[i].pos.x < 0) asteroids[i].pos.x += SCREEN_WIDTH;
-            if (asteroids[i].pos.x > SCREEN_WIDTH) asteroids[i].pos.x -= SCREEN_WIDTH;
-            if (asteroids[i].pos.y < 0) asteroids[i].pos.y += SCREEN_HEIGHT;
-            if (asteroids[i].pos.y > SCREEN_HEIGHT) asteroids[i].pos.y -= SCREEN_HEIGHT;
-        }
-    }
-
-    // Bullet-asteroid collision
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        if (!bullets[i].active) continue;
-        for (int j = 0; j < MAX_ASTEROIDS; j++) {
-            if (!asteroids[j].active) continue;
-            float dx = bullets[i].pos.x - asteroids[j].pos.x;
-            float dy = bullets[i].pos.y - asteroids[j].pos.y;
-            float dist = sqrtf(dx*dx + dy*dy);
-            if (dist < asteroids[j].size) {
-                bullets[i].active = false;
-                asteroids[j].active = false;
-                // Score based on asteroid size
-                if (asteroids[j].size > ASTEROID_MIN_SIZE) {
-                    score += 20;
-                    for (int s = 0; s < 2; s++) {
-                        SpawnAsteroid(asteroids[j].pos, asteroids[j].size/2);
-                    }
-                } else {
-                    score += 50;
-                }
-                PlaySound(sfxAsteroidExplode);
-                break;
-            }
-        }
-    }
-
-    // Ship-asteroid collision
-    for (int i = 0; i < MAX_ASTEROIDS; i++) {
-        if (!asteroids[i].active) continue;
-        float dx = ship.pos.x - asteroids[i].pos.x;
-        float dy = ship.pos.y - asteroids[i].pos.y;
-        float dist = sqrtf(dx*dx + dy*dy);
-        if (dist < asteroids[i].size + ship.radius) {
-            // Lose a life on collision
-            lives--;
-            if (lives > 0) {
-                // Respawn ship and asteroids, but keep score and lives
-                InitGame();
-            } else {
-                // Game over: reset everything
-                score = 0;
-                lives = STARTING_LIVES;
-                InitGame();
-            }
-            break;
-        }
-    }
+    ProfileBegin("input");
+    input = (AsteroidsInput){ 0 };
+    if (IsKeyDown(KEY_LEFT)) input.buttons |= ASTEROIDS_INPUT_LEFT;
+    if (IsKeyDown(KEY_RIGHT)) input.buttons |= ASTEROIDS_INPUT_RIGHT;
+    if (IsKeyDown(KEY_UP)) input.buttons |= ASTEROIDS_INPUT_THRUST;
+    if (IsKeyDown(KEY_SPACE)) input.buttons |= ASTEROIDS_INPUT_FIRE;
+    ProfileEnd();
 }
 
-void DrawGame(void)
+// Worker side of the pipeline
+void RunFrame(void *user, DrawList *list)
 {
-    BeginDrawing();
-    ClearBackground(BLACK);
+    (void)user;
+    for (int i = 0; i < frameTicks; i++) UpdateGame(list);
+    DrawGame(list, frameAlpha);
+}
 
-    DrawText(TextFormat("Score: %d", score), 20, 20, 32, WHITE);
-    DrawText(TextFormat("Lives: %d", lives), SCREEN_WIDTH - 160, 20, 32, WHITE);
+void UpdateGame(DrawList *list)
+{
+    AsteroidsInput tickInput = input;
+    if (botSkill >= 0) tickInput.buttons = NextBotButtons(&bot, GetAsteroidsBotButtons(&game), ASTEROIDS_INPUT_ALL);  // Every tick, from the state it starts from
 
-    // Draw ship
-    Vector2 nose = {
-        ship.pos.x + cosf(DEG2RAD * ship.angle) * SHIP_SIZE,
-        ship.pos.y + sinf(DEG2RAD * ship.angle) * SHIP_SIZE
-    };
-    Vector2 left = {
-        ship.pos.x + cosf(DEG2RAD * (ship.angle + 140)) * SHIP_SIZE * 0.6f,
-        ship.pos.y + sinf(DEG2RAD * (ship.angle + 140)) * SHIP_SIZE * 0.6f
-    };
-    Vector2 right = {
-        ship.pos.x + cosf(DEG2RAD * (ship.angle - 140)) * SHIP_SIZE * 0.6f,
-        ship.pos.y + sinf(DEG2RAD * (ship.angle - 140)) * SHIP_SIZE * 0.6f
-    };
-    DrawTriangle(nose, right, left, WHITE);
+    CopyAsteroids(&previous, &game);
+    PROFILE_ZONE("update") StepAsteroids(&game, tickInput);
+    RecordReplayTick(&replay, tickInput.buttons, HashAsteroids(&game));
 
-    // Draw bullets
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        if (bullets[i].active) {
-            DrawCircleV(bullets[i].pos, 2, YELLOW);
-        }
+    for (int i = 0; i < game.eventCount; i++) {
+        // Rapid fire overlaps, explosions win the voices over shots (see mixer.h)
+        if (game.events[i].type == ASTEROIDS_EVENT_SHOT) RecordMixerSound(list, &sfxLaser, 0.6f, 0);
+        else if (game.events[i].type == ASTEROIDS_EVENT_EXPLOSION) RecordMixerSound(list, &sfxAsteroidExplode, 1.0f, 1);
     }
-
-    // Draw asteroids
-    for (int i = 0; i < MAX_ASTEROIDS; i++) {
-        if (asteroids[i].active) {
-            Vector2 points[16];
-            float angleStep = 360.0f / asteroids[i].sides;
-            for (int v = 0; v < asteroids[i].sides; v++) {
-                float ang = DEG2RAD * (asteroids[i].angle + v * angleStep);
-                float rad = asteroids[i].size * (0.75f + 0.25f * (float)GetRandomValue(0, 100)/100.0f);
-                points[v].x = asteroids[i].pos.x + cosf(ang) * rad;
-                points[v].y = asteroids[i].pos.y + sinf(ang) * rad;
-            }
-            for (int v = 0; v < asteroids[i].sides; v++) {
-                DrawLineV(points[v], points[(v+1)%asteroids[i].sides], GRAY);
-            }
-        }
-    }
-
-    EndDrawing();
 }
 
-void UnloadGame(void)
+void DrawGame(DrawList *list, float alpha)
 {
-    UnloadMusicStream(music);
-    UnloadSound(sfxLaser);
-    UnloadSound(sfxAsteroidExplode);
+    ProfileBegin("record");
+    RecordAsteroids(list, &game, &previous, alpha);
+    COUNT("draw calls", list->draws);
+    ProfileEnd();
 }
 
-void FireBullet(void)
+// Main thread side: the frame recorded before, then the overlays
+void DrawFrame(void)
 {
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        if (!bullets[i].active) {
-            bullets[i].active = true;
-            bullets[i].pos = ship.pos;
-            bullets[i].vel.x = cosf(DEG2RAD * ship.angle) * BULLET_SPEED;
-            bullets[i].vel.y = sinf(DEG2RAD * ship.angle) * BULLET_SPEED;
-            bulletTimer[i] = 0;
-            PlaySound(sfxLaser);
-            break;
-        }
-    }
+    ProfileBegin("draw");
+    BeginDrawing();
+    ReplayDrawList(GetPipelineFrame(&pipeline));
+    ProfileEnd();
+    DrawProfilerGraph(10, 100);
+    DrawCounterOverlay(SCREEN_WIDTH - 258, 100);
+    EndDrawing();
 }
 
-void SpawnAsteroid(Vector2 pos, float size)
+void UnloadGame(void)
 {
-    for (int i = 0; i < MAX_ASTEROIDS; i++) {
-        if (!asteroids[i].active) {
-            asteroids[i].active = true;
-            asteroids[i].pos = pos;
-            float angle = DEG2RAD * GetRandomValue(0, 359);
-            float speed = ASTEROID_MIN_SPEED + (float)GetRandomValue(0, 100)/100.0f * (ASTEROID_MAX_SPEED - ASTEROID_MIN_SPEED);
-            asteroids[i].vel.x = cosf(angle) * speed;
-            asteroids[i].vel.y = sinf(angle) * speed;
-            asteroids[i].angle = GetRandomValue(0, 359);
-            asteroids[i].size = size;
-            asteroids[i].sides = 8 + GetRandomValue(0, 3); // 8-11 sides
-            break;
-        }
-    }
-}
\ No newline at end of file
+    CloseFramePipeline(&pipeline);
+    CloseStartup(&startup);
+    CloseMixer();
+    CloseMusicPlayer();
+
+    LogAssetCache(&assets);
+    UnloadAssetCache(&assets);
+    UnloadPak(&pak);
+
+    SaveReplay(&replay, "asteroids.replay");
+    UnloadReplay(&replay);
+    UnloadAsteroids(&game);
+    UnloadAsteroids(&previous);
+}
@@ -0,0 +1,44 @@
+// Heap allocation counter for the bench report. On Linux the linker redirects malloc, calloc and
+// realloc calls from our own code here (-Wl,--wrap, see CMakeLists.txt), elsewhere nothing is counted
+#include "bench.h"
+#include <stddef.h>
+
+#if defined(BENCH_COUNT_ALLOCATIONS)
+
+static long long allocationCount = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    __atomic_add_fetch(&allocationCount, 1, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    __atomic_add_fetch(&allocationCount, 1, __ATOMIC_RELAXED);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    __atomic_add_fetch(&allocationCount, 1, __ATOMIC_RELAXED);
+    return __real_realloc(ptr, size);
+}
+
+long long GetAllocationCount(void)
+{
+    return __atomic_load_n(&allocationCount, __ATOMIC_RELAXED);
+}
+
+#else
+
+long long GetAllocationCount(void)
+{
+    return -1;
+}
+
+#endif
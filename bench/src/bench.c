@@ -0,0 +1,264 @@
+// Tick throughput of every game's step and of their hot kernels, see bench.h for the scenarios
+//
+//   bench [--filter TEXT] [--seconds S]      run the scenarios whose name contains TEXT, S seconds each
+//   [--json FILE]                            write the results as JSON, "-" for stdout
+//   [--baseline FILE] [--threshold PCT]      compare with the JSON of an earlier run, exit code 2 on a regression
+//   [--list]                                 scenario names only
+//
+// Ticks are timed in batches of at least BENCH_MIN_BATCH_SECONDS, so cheap kernels aren't lost in the
+// clock overhead: ns/tick is the mean over all batches, p50/p99 the percentiles of the per-batch means
+#define HEADLESS_IMPLEMENTATION
+#define REPLAY_IMPLEMENTATION
+#define COUNTERS_IMPLEMENTATION
+#define VECENV_IMPLEMENTATION
+#define SOAK_IMPLEMENTATION
+#define ECS_IMPLEMENTATION
+#include "headless.h"
+#include "vecenv.h"
+#include "ecs.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_DEFAULT_SECONDS 0.25
+#define BENCH_DEFAULT_THRESHOLD 10.0    // Percent slower than the baseline p50 that counts as a regression
+#define BENCH_MIN_BATCH_SECONDS 50e-6
+#define BENCH_MIN_SAMPLES 32
+#define BENCH_MAX_SAMPLES 8192
+#define BENCH_MAX_RESULTS 64
+
+typedef struct {
+    const char *filter;
+    double seconds;
+    const char *jsonFile;
+    const char *baselineFile;
+    double threshold;
+    bool list;
+} BenchOptions;
+
+typedef struct {
+    char name[64];
+    int entities;
+    long long ticks;
+    double nsPerTick;
+    double p50;
+    double p99;
+    double allocationsPerTick;      // Mean over the timed ticks, -1 if not counted
+} BenchResult;
+
+static const BenchScenario *scenarioSets[] = {
+    asteroidsScenarios, breakoutScenarios, ecsScenarios, galaxianScenarios, invadersScenarios,
+    pacmanScenarios, sandboxScenarios, tankScenarios
+};
+
+volatile int benchSink = 0;
+static RandomButtons buttons = { 0 };
+
+static BenchOptions ParseBenchOptions(int argc, char *argv[]);
+static BenchResult RunScenario(const BenchScenario *scenario, double seconds);
+static int CompareDoubles(const void *a, const void *b);
+static void WriteResults(FILE *file, const BenchResult *results, int count);
+static int LoadResults(const char *fileName, BenchResult *results, int maxCount);
+static int CompareWithBaseline(const BenchResult *results, int count, const char *fileName, double threshold);
+
+int main(int argc, char *argv[])
+{
+    BenchOptions options = ParseBenchOptions(argc, argv);
+    static BenchResult results[BENCH_MAX_RESULTS];
+    int resultCount = 0;
+
+    if (!options.list) printf("%-28s %8s %12s %12s %12s %12s\n", "scenario", "entities", "ns/tick", "p50", "p99", "allocs/tick");
+
+    for (int s = 0; s < (int)(sizeof(scenarioSets)/sizeof(scenarioSets[0])); s++) {
+        for (const BenchScenario *scenario = scenarioSets[s]; scenario->name != NULL; scenario++) {
+            if (options.filter != NULL && strstr(scenario->name, options.filter) == NULL) continue;
+            if (options.list) {
+                printf("%s %d\n", scenario->name, scenario->entities);
+                continue;
+            }
+            if (resultCount == BENCH_MAX_RESULTS) break;
+
+            BenchResult *result = &results[resultCount++];
+            *result = RunScenario(scenario, options.seconds);
+            printf("%-28s %8d %12.1f %12.1f %12.1f %12.4g\n", result->name, result->entities, result->nsPerTick, result->p50, result->p99, result->allocationsPerTick);
+            fflush(stdout);
+        }
+    }
+    if (options.list) return 0;
+
+    if (options.jsonFile != NULL) {
+        bool toStdout = (strcmp(options.jsonFile, "-") == 0);
+        FILE *file = toStdout? stdout : fopen(options.jsonFile, "w");
+        if (file == NULL) {
+            fprintf(stderr, "BENCH: [%s] Failed to create results file\n", options.jsonFile);
+            return 1;
+        }
+        WriteResults(file, results, resultCount);
+        if (!toStdout) fclose(file);
+    }
+
+    if (options.baselineFile != NULL) return CompareWithBaseline(results, resultCount, options.baselineFile, options.threshold);
+
+    return 0;
+}
+
+unsigned int NextBenchButtons(unsigned int buttonMask)
+{
+    return NextRandomButtons(&buttons, buttonMask);
+}
+
+void ResetBenchButtons(void)
+{
+    buttons = (RandomButtons){ .seed = BENCH_SEED };
+}
+
+BenchOptions ParseBenchOptions(int argc, char *argv[])
+{
+    BenchOptions options = { NULL, BENCH_DEFAULT_SECONDS, NULL, NULL, BENCH_DEFAULT_THRESHOLD, false };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) options.filter = argv[++i];
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) options.seconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) options.jsonFile = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) options.baselineFile = argv[++i];
+        else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) options.threshold = atof(argv[++i]);
+        else if (strcmp(argv[i], "--list") == 0) options.list = true;
+        else {
+            printf("usage: %s [--filter TEXT] [--seconds S] [--json FILE] [--baseline FILE] [--threshold PCT] [--list]\n", argv[0]);
+            exit(1);
+        }
+    }
+
+    return options;
+}
+
+BenchResult RunScenario(const BenchScenario *scenario, double seconds)
+{
+    static double samples[BENCH_MAX_SAMPLES];
+    BenchResult result = { 0 };
+    snprintf(result.name, sizeof(result.name), "%s", scenario->name);
+    result.entities = scenario->entities;
+
+    scenario->Setup(scenario->entities);
+
+    // Batch size: double until a batch is long enough to time, this also warms up caches and branch predictors
+    long long batch = 1;
+    for (;;) {
+        double start = GetHeadlessTime();
+        for (long long i = 0; i < batch; i++) scenario->Tick();
+        if (GetHeadlessTime() - start >= BENCH_MIN_BATCH_SECONDS || batch >= (1 << 20)) break;
+        batch *= 2;
+    }
+
+    int sampleCount = 0;
+    double total = 0.0;
+    long long allocationsBefore = GetAllocationCount();
+    while (sampleCount < BENCH_MAX_SAMPLES && (total < seconds || sampleCount < BENCH_MIN_SAMPLES)) {
+        double start = GetHeadlessTime();
+        for (long long i = 0; i < batch; i++) scenario->Tick();
+        double elapsed = GetHeadlessTime() - start;
+
+        samples[sampleCount++] = elapsed*1e9/batch;
+        total += elapsed;
+    }
+    long long allocationsAfter = GetAllocationCount();
+
+    if (scenario->Teardown != NULL) scenario->Teardown();
+
+    qsort(samples, sampleCount, sizeof(double), CompareDoubles);
+    result.ticks = batch*sampleCount;
+    result.nsPerTick = total*1e9/result.ticks;
+    result.p50 = samples[sampleCount/2];
+    result.p99 = samples[(sampleCount*99)/100];
+    result.allocationsPerTick = (allocationsBefore >= 0)? (double)(allocationsAfter - allocationsBefore)/result.ticks : -1.0;
+
+    return result;
+}
+
+int CompareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// One scenario per line, LoadResults() relies on it
+void WriteResults(FILE *file, const BenchResult *results, int count)
+{
+    fprintf(file, "{\n  \"version\": 2,\n  \"scenarios\": [\n");
+    for (int i = 0; i < count; i++) {
+        const BenchResult *r = &results[i];
+        fprintf(file, "    { \"name\": \"%s\", \"entities\": %d, \"ticks\": %lld, \"nsPerTick\": %.2f, \"p50\": %.2f, \"p99\": %.2f, ",
+            r->name, r->entities, r->ticks, r->nsPerTick, r->p50, r->p99);
+        if (r->allocationsPerTick >= 0.0) fprintf(file, "\"allocationsPerTick\": %.6g }", r->allocationsPerTick);
+        else fprintf(file, "\"allocationsPerTick\": null }");
+        fprintf(file, "%s\n", (i + 1 < count)? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+// Reads back what WriteResults() wrote, not general JSON
+int LoadResults(const char *fileName, BenchResult *results, int maxCount)
+{
+    FILE *file = fopen(fileName, "r");
+    if (file == NULL) return -1;
+
+    char line[512];
+    int count = 0;
+    while (count < maxCount && fgets(line, sizeof(line), file) != NULL) {
+        BenchResult *r = &results[count];
+        const char *p50 = strstr(line, "\"p50\":");
+        const char *p99 = strstr(line, "\"p99\":");
+        const char *allocations = strstr(line, "\"allocationsPerTick\":");
+        if (sscanf(line, " { \"name\": \"%63[^\"]\", \"entities\": %d, \"ticks\": %lld, \"nsPerTick\": %lf",
+            r->name, &r->entities, &r->ticks, &r->nsPerTick) != 4 || p50 == NULL || p99 == NULL) continue;
+
+        r->p50 = atof(p50 + 6);
+        r->p99 = atof(p99 + 6);
+        // Version 1 files had total counts, those runs had different lengths and aren't compared
+        if (allocations == NULL || sscanf(allocations + 21, " %lf", &r->allocationsPerTick) != 1) r->allocationsPerTick = -1.0;
+        count++;
+    }
+
+    fclose(file);
+    return count;
+}
+
+// p50 more than threshold percent slower, or more than threshold percent more allocations per tick, than the same
+// scenario in the baseline
+int CompareWithBaseline(const BenchResult *results, int count, const char *fileName, double threshold)
+{
+    static BenchResult baseline[BENCH_MAX_RESULTS];
+    int baselineCount = LoadResults(fileName, baseline, BENCH_MAX_RESULTS);
+    if (baselineCount < 0) {
+        fprintf(stderr, "BENCH: [%s] Failed to open baseline\n", fileName);
+        return 1;
+    }
+
+    int regressions = 0;
+    printf("\ncompared with %s (threshold %.1f%%)\n", fileName, threshold);
+    for (int i = 0; i < count; i++) {
+        const BenchResult *r = &results[i];
+        const BenchResult *base = NULL;
+        for (int j = 0; j < baselineCount && base == NULL; j++) {
+            if (strcmp(baseline[j].name, r->name) == 0 && baseline[j].entities == r->entities) base = &baseline[j];
+        }
+        if (base == NULL) {
+            printf("%-28s %8d   not in baseline\n", r->name, r->entities);
+            continue;
+        }
+
+        double change = (base->p50 > 0.0)? (r->p50/base->p50 - 1.0)*100.0 : 0.0;
+        bool slower = (change > threshold);
+        bool allocates = (r->allocationsPerTick >= 0.0 && base->allocationsPerTick >= 0.0 &&
+            r->allocationsPerTick > base->allocationsPerTick*(1.0 + threshold/100.0));
+        if (slower || allocates) regressions++;
+
+        printf("%-28s %8d %+11.1f%%%s", r->name, r->entities, change, slower? "   REGRESSION" : "");
+        if (allocates) printf("   ALLOCATIONS %.4g/tick, were %.4g", r->allocationsPerTick, base->allocationsPerTick);
+        printf("\n");
+    }
+
+    printf("%d regression%s\n", regressions, (regressions == 1)? "" : "s");
+    return (regressions > 0)? 2 : 0;
+}
@@ -0,0 +1,36 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Benchmark scenarios: a set-up game (or part of one) ticked over and over while bench.c times it.
+// Each game's scenarios live in their own bench_<game>.c, the sim headers can't share a translation unit
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define BENCH_SEED 1                // Scripted input and game seed, the same on every run
+
+typedef struct {
+    const char *name;               // "<game>/<what>"
+    int entities;                   // What the scenario scales with (tanks, asteroids, queries...), 0 if fixed
+    void (*Setup)(int entities);
+    void (*Tick)(void);
+    void (*Teardown)(void);         // Optional
+} BenchScenario;
+
+extern const BenchScenario asteroidsScenarios[];
+extern const BenchScenario breakoutScenarios[];
+extern const BenchScenario ecsScenarios[];
+extern const BenchScenario galaxianScenarios[];
+extern const BenchScenario invadersScenarios[];
+extern const BenchScenario pacmanScenarios[];
+extern const BenchScenario sandboxScenarios[];
+extern const BenchScenario tankScenarios[];
+
+extern volatile int benchSink;      // Kernel results go here, so the compiler can't drop the calls
+
+unsigned int NextBenchButtons(unsigned int buttonMask);     // Scripted input, restarted by each Setup()
+void ResetBenchButtons(void);
+
+long long GetAllocationCount(void); // Heap allocations made so far, -1 if this build can't count them
+
+#endif // BENCH_H
@@ -0,0 +1,87 @@
+// Asteroids scenarios: the whole step on scripted input, the bullet/ship against asteroids collisions and a frame through the software rasterizer
+#include "bench.h"
+#include "asteroids_sim.h"
+#include "asteroids_draw.h"
+#include "softraster.h"
+
+static AsteroidsGame game;
+static DrawList list;
+static RasterFrame frame;
+
+static void SetupStep(int entities)
+{
+    (void)entities;
+    InitAsteroids(&game, BENCH_SEED);
+    ResetBenchButtons();
+}
+
+static void TickStep(void)
+{
+    AsteroidsInput input = { NextBenchButtons(ASTEROIDS_INPUT_ALL) };
+    StepAsteroids(&game, input);
+}
+
+// Every bullet in flight and the given number of asteroids, none touching so the scan never stops early. The game
+// caps its asteroids at MAX_ASTEROIDS, the bench creates them past it
+static void SetupCollisions(int entities)
+{
+    InitAsteroids(&game, BENCH_SEED);
+    ClearEcsWorld(&game.world);
+    game.ship.pos = (Vector2){ SCREEN_WIDTH/2, SCREEN_HEIGHT - 100 };
+
+    for (int i = 0; i < entities; i++) {
+        EcsEntity asteroid = CreateEntity(&game.world, ASTEROIDS_ASTEROID);
+        AsteroidShape *shape = GetComponent(&game.world, asteroid, ASTEROIDS_SHAPE);
+        *(Vector2 *)GetComponent(&game.world, asteroid, ASTEROIDS_POSITION) = (Vector2){ 60.0f + (i%8)*80.0f, 100.0f + (i/8%4)*150.0f };
+        shape->size = ASTEROID_MIN_SIZE;
+        shape->sides = 8;
+    }
+    for (int i = 0; i < MAX_BULLETS; i++) {
+        EcsEntity bullet = CreateEntity(&game.world, ASTEROIDS_BULLET);
+        *(Vector2 *)GetComponent(&game.world, bullet, ASTEROIDS_POSITION) = (Vector2){ 40.0f + i*60.0f, SCREEN_HEIGHT/2 };
+    }
+}
+
+static void TickCollisions(void)
+{
+    CollideAsteroids(&game);
+    benchSink += game.score;
+}
+
+// A frame a few seconds into a scripted game, rasterized on the calling thread alone
+static void SetupRaster(int entities)
+{
+    (void)entities;
+    InitAsteroids(&game, BENCH_SEED);
+    ResetBenchButtons();
+    for (int i = 0; i < 300; i++) {
+        AsteroidsInput input = { NextBenchButtons(ASTEROIDS_INPUT_ALL) };
+        StepAsteroids(&game, input);
+    }
+
+    ResetDrawList(&list);
+    RecordAsteroids(&list, &game, &game, 0.0f);
+    frame = LoadRasterFrame(SCREEN_WIDTH, SCREEN_HEIGHT);
+}
+
+static void TickRaster(void)
+{
+    RasterizeDrawList(&frame, &list);
+    benchSink += (int)frame.pixels[0];
+}
+
+static void TeardownRaster(void)
+{
+    UnloadRasterFrame(&frame);
+    UnloadDrawList(&list);
+}
+
+const BenchScenario asteroidsScenarios[] = {
+    { "asteroids/step", 0, SetupStep, TickStep, NULL },
+    { "asteroids/collisions", 4, SetupCollisions, TickCollisions, NULL },
+    { "asteroids/collisions", 8, SetupCollisions, TickCollisions, NULL },
+    { "asteroids/collisions", MAX_ASTEROIDS, SetupCollisions, TickCollisions, NULL },
+    { "asteroids/collisions", 1024, SetupCollisions, TickCollisions, NULL },
+    { "asteroids/raster", 0, SetupRaster, TickRaster, TeardownRaster },
+    { NULL }
+};
@@ -0,0 +1,99 @@
+// Breakout scenarios: the whole step on scripted input, the ball against the bricks, a frame through the software
+// rasterizer and a step of the vectorized env
+#include "bench.h"
+#include "breakout_sim.h"
+#include "breakout_env.h"
+#include "breakout_draw.h"
+#include "softraster.h"
+
+static BreakoutGame game;
+static DrawList list;
+static RasterFrame frame;
+
+static void SetupStep(int entities)
+{
+    (void)entities;
+    InitBreakout(&game);
+    ResetBenchButtons();
+}
+
+static void TickStep(void)
+{
+    BreakoutInput input = { NextBenchButtons(BREAKOUT_INPUT_ALL) };
+    StepBreakout(&game, input);
+}
+
+// The given number of bricks left, the ball below them all
+static void SetupBricks(int entities)
+{
+    InitBreakout(&game);
+    for (int i = entities; i < BRICK_ROWS*BRICK_COLS; i++) game.bricks[i/BRICK_COLS][i%BRICK_COLS].active = false;
+    game.ballPosition = (Vector2){ SCREEN_WIDTH/2, SCREEN_HEIGHT/2 };
+    game.ballActive = true;
+}
+
+static void TickBricks(void)
+{
+    HitBricks(&game);
+    benchSink += game.score;
+}
+
+// A frame a few seconds into a scripted game, rasterized on the calling thread alone
+static void SetupRaster(int entities)
+{
+    (void)entities;
+    InitBreakout(&game);
+    ResetBenchButtons();
+    for (int i = 0; i < 300; i++) {
+        BreakoutInput input = { NextBenchButtons(BREAKOUT_INPUT_ALL) };
+        StepBreakout(&game, input);
+    }
+
+    ResetDrawList(&list);
+    RecordBreakout(&list, &game, &game, 0.0f);
+    frame = LoadRasterFrame(SCREEN_WIDTH, SCREEN_HEIGHT);
+}
+
+static void TickRaster(void)
+{
+    RasterizeDrawList(&frame, &list);
+    benchSink += (int)frame.pixels[0];
+}
+
+static void TeardownRaster(void)
+{
+    UnloadRasterFrame(&frame);
+    UnloadDrawList(&list);
+}
+
+// A step of the given number of env instances, each on its own scripted input, on the calling thread alone
+static BreakoutEnv env;
+
+static void SetupEnv(int entities)
+{
+    env = LoadBreakoutEnv(entities, BENCH_SEED);
+    ResetBenchButtons();
+}
+
+static void TickEnv(void)
+{
+    for (int i = 0; i < env.base.count; i++) env.base.actions[i] = NextBenchButtons(BREAKOUT_INPUT_ALL);
+    StepBreakoutEnv(&env);
+    benchSink += (int)env.base.episodes;
+}
+
+static void TeardownEnv(void)
+{
+    UnloadBreakoutEnv(&env);
+}
+
+const BenchScenario breakoutScenarios[] = {
+    { "breakout/step", 0, SetupStep, TickStep, NULL },
+    { "breakout/bricks", 15, SetupBricks, TickBricks, NULL },
+    { "breakout/bricks", 30, SetupBricks, TickBricks, NULL },
+    { "breakout/bricks", BRICK_ROWS*BRICK_COLS, SetupBricks, TickBricks, NULL },
+    { "breakout/raster", 0, SetupRaster, TickRaster, TeardownRaster },
+    { "breakout/env", 64, SetupEnv, TickEnv, TeardownEnv },
+    { "breakout/env", 1024, SetupEnv, TickEnv, TeardownEnv },
+    { NULL }
+};
@@ -0,0 +1,156 @@
+// ECS scenarios: a movement system over a world of entities spread on a few archetypes, the same update over an
+// array of game-style structs for comparison, and entities changing archetype, dying and respawning every tick
+#include "bench.h"
+#include "raylib.h"
+#include "ecs.h"
+#include <stdlib.h>
+
+enum {
+    BENCH_POSITION = 0,                 // Vector2
+    BENCH_VELOCITY,                     // Vector2
+    BENCH_LIFETIME,                     // int
+    BENCH_SHAPE,                        // BenchShape
+    BENCH_TAG
+};
+
+// What an entity carries besides its position, the structs' payload
+typedef struct {
+    float angle;
+    float size;
+    int sides;
+    float radii[12];
+} BenchShape;
+
+typedef struct {
+    Vector2 position;
+    Vector2 velocity;
+    int lifetime;
+    BenchShape shape;
+    bool alive;
+} BenchStruct;
+
+static const EcsMask benchArchetypes[] = {
+    ECS_BIT(BENCH_POSITION) | ECS_BIT(BENCH_VELOCITY),
+    ECS_BIT(BENCH_POSITION) | ECS_BIT(BENCH_VELOCITY) | ECS_BIT(BENCH_LIFETIME),
+    ECS_BIT(BENCH_POSITION) | ECS_BIT(BENCH_VELOCITY) | ECS_BIT(BENCH_SHAPE),
+    ECS_BIT(BENCH_POSITION) | ECS_BIT(BENCH_VELOCITY) | ECS_BIT(BENCH_SHAPE) | ECS_BIT(BENCH_TAG)
+};
+#define BENCH_ARCHETYPES (int)(sizeof(benchArchetypes)/sizeof(benchArchetypes[0]))
+
+static EcsWorld world;
+static int moving;
+static EcsEntity *entities;             // Of the churn, to pick from
+static int entityCount;
+static BenchStruct *structs;
+static unsigned int state;
+
+static unsigned int NextBenchRandom(void)
+{
+    state = state*1664525u + 1013904223u;
+    return state >> 8;
+}
+
+static void SetupWorld(int count)
+{
+    InitEcsWorld(&world);
+    RegisterComponent(&world, BENCH_POSITION, sizeof(Vector2));
+    RegisterComponent(&world, BENCH_VELOCITY, sizeof(Vector2));
+    RegisterComponent(&world, BENCH_LIFETIME, sizeof(int));
+    RegisterComponent(&world, BENCH_SHAPE, sizeof(BenchShape));
+    RegisterComponent(&world, BENCH_TAG, 0);
+    moving = AddQuery(&world, ECS_BIT(BENCH_POSITION) | ECS_BIT(BENCH_VELOCITY), 0);
+
+    state = BENCH_SEED;
+    entities = (EcsEntity *)malloc((size_t)count*sizeof(EcsEntity));
+    entityCount = count;
+    for (int i = 0; i < count; i++) {
+        entities[i] = CreateEntity(&world, benchArchetypes[i%BENCH_ARCHETYPES]);
+        *(Vector2 *)GetComponent(&world, entities[i], BENCH_POSITION) = (Vector2){ (float)(i%800), (float)(i/800%450) };
+        *(Vector2 *)GetComponent(&world, entities[i], BENCH_VELOCITY) = (Vector2){ 1.0f + (i%7), 1.0f + (i%5) };
+    }
+}
+
+static void TeardownWorld(void)
+{
+    UnloadEcsWorld(&world);
+    free(entities);
+    entities = NULL;
+}
+
+static void TickMove(void)
+{
+    EcsIter it = IterateQuery(&world, moving);
+    while (NextQueryChunk(&it)) {
+        Vector2 *position = GetQueryColumn(&it, BENCH_POSITION);
+        const Vector2 *velocity = GetQueryColumn(&it, BENCH_VELOCITY);
+        for (int i = 0; i < it.count; i++) {
+            position[i].x += velocity[i].x;
+            position[i].y += velocity[i].y;
+            if (position[i].x > 800.0f) position[i].x -= 800.0f;
+            if (position[i].y > 450.0f) position[i].y -= 450.0f;
+        }
+    }
+    benchSink += CountQueryEntities(&world, moving);
+}
+
+static void SetupStructs(int count)
+{
+    structs = (BenchStruct *)calloc(count, sizeof(BenchStruct));
+    entityCount = count;
+    for (int i = 0; i < count; i++) {
+        structs[i].position = (Vector2){ (float)(i%800), (float)(i/800%450) };
+        structs[i].velocity = (Vector2){ 1.0f + (i%7), 1.0f + (i%5) };
+        structs[i].alive = true;
+    }
+}
+
+static void TickStructs(void)
+{
+    int alive = 0;
+    for (int i = 0; i < entityCount; i++) {
+        BenchStruct *s = &structs[i];
+        if (!s->alive) continue;
+        s->position.x += s->velocity.x;
+        s->position.y += s->velocity.y;
+        if (s->position.x > 800.0f) s->position.x -= 800.0f;
+        if (s->position.y > 450.0f) s->position.y -= 450.0f;
+        alive++;
+    }
+    benchSink += alive;
+}
+
+static void TeardownStructs(void)
+{
+    free(structs);
+    structs = NULL;
+}
+
+// A sixteenth of the entities a tick: lifetimes added and removed, some killed and respawned elsewhere
+static void TickChurn(void)
+{
+    for (int n = entityCount/16; n > 0; n--) {
+        int i = NextBenchRandom()%entityCount;
+        EcsEntity entity = entities[i];
+        switch (NextBenchRandom()%3) {
+            case 0: AddComponent(&world, entity, BENCH_LIFETIME); break;
+            case 1: RemoveComponent(&world, entity, BENCH_LIFETIME); break;
+            case 2: {
+                DestroyEntity(&world, entity);
+                entities[i] = CreateEntity(&world, benchArchetypes[NextBenchRandom()%BENCH_ARCHETYPES]);
+            } break;
+        }
+    }
+    TickMove();
+}
+
+const BenchScenario ecsScenarios[] = {
+    { "ecs/move", 1000, SetupWorld, TickMove, TeardownWorld },
+    { "ecs/move", 10000, SetupWorld, TickMove, TeardownWorld },
+    { "ecs/move", 100000, SetupWorld, TickMove, TeardownWorld },
+    { "ecs/move-structs", 1000, SetupStructs, TickStructs, TeardownStructs },
+    { "ecs/move-structs", 10000, SetupStructs, TickStructs, TeardownStructs },
+    { "ecs/move-structs", 100000, SetupStructs, TickStructs, TeardownStructs },
+    { "ecs/churn", 10000, SetupWorld, TickChurn, TeardownWorld },
+    { "ecs/churn", 100000, SetupWorld, TickChurn, TeardownWorld },
+    { NULL }
+};
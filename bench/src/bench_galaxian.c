@@ -0,0 +1,56 @@
+// Galaxian scenarios: the whole step on scripted input, and a frame through the software rasterizer
+#include "bench.h"
+#include "galaxian_sim.h"
+#include "galaxian_draw.h"
+#include "softraster.h"
+
+static GalaxianGame game;
+static DrawList list;
+static RasterFrame frame;
+
+static void SetupStep(int entities)
+{
+    (void)entities;
+    InitGalaxian(&game);
+    ResetBenchButtons();
+}
+
+static void TickStep(void)
+{
+    GalaxianInput input = { NextBenchButtons(GALAXIAN_INPUT_ALL) };
+    StepGalaxian(&game, input);
+}
+
+// A frame a few seconds into a scripted game, rasterized on the calling thread alone
+static void SetupRaster(int entities)
+{
+    (void)entities;
+    InitGalaxian(&game);
+    ResetBenchButtons();
+    for (int i = 0; i < 300; i++) {
+        GalaxianInput input = { NextBenchButtons(GALAXIAN_INPUT_ALL) };
+        StepGalaxian(&game, input);
+    }
+
+    ResetDrawList(&list);
+    RecordGalaxian(&list, &game, &game, 0.0f);
+    frame = LoadRasterFrame(SCREEN_WIDTH, SCREEN_HEIGHT);
+}
+
+static void TickRaster(void)
+{
+    RasterizeDrawList(&frame, &list);
+    benchSink += (int)frame.pixels[0];
+}
+
+static void TeardownRaster(void)
+{
+    UnloadRasterFrame(&frame);
+    UnloadDrawList(&list);
+}
+
+const BenchScenario galaxianScenarios[] = {
+    { "galaxian/step", 0, SetupStep, TickStep, NULL },
+    { "galaxian/raster", 0, SetupRaster, TickRaster, TeardownRaster },
+    { NULL }
+};
@@ -0,0 +1,38 @@
+// Space invaders scenarios: the whole step on scripted input, and the formation march
+#include "bench.h"
+#include "invaders_sim.h"
+
+static InvadersGame game;
+
+static void SetupStep(int entities)
+{
+    (void)entities;
+    InitInvaders(&game);
+    ResetBenchButtons();
+}
+
+static void TickStep(void)
+{
+    InvadersInput input = { NextBenchButtons(INVADERS_INPUT_ALL & ~INVADERS_INPUT_PAUSE) };     // Paused ticks measure nothing
+    StepInvaders(&game, input);
+}
+
+static void SetupFormation(int entities)
+{
+    InitInvaders(&game);
+    game.activeEnemies = entities;
+}
+
+static void TickFormation(void)
+{
+    MoveInvaders(&game);
+    benchSink += game.direction;
+}
+
+const BenchScenario invadersScenarios[] = {
+    { "space-invaders/step", 0, SetupStep, TickStep, NULL },
+    { "space-invaders/formation", 10, SetupFormation, TickFormation, NULL },
+    { "space-invaders/formation", 25, SetupFormation, TickFormation, NULL },
+    { "space-invaders/formation", NUM_MAX_ENEMIES, SetupFormation, TickFormation, NULL },
+    { NULL }
+};
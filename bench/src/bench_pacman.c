@@ -0,0 +1,86 @@
+// Pacman scenarios: the whole step on scripted input, the ghosts' BFS chase path and a step of the vectorized env
+#include "bench.h"
+#include "pacman_sim.h"
+#include "pacman_env.h"
+
+#define MAX_PATH_QUERIES 16
+
+static PacmanGame game;
+static int queryCount = 0;
+static int queryStart[MAX_PATH_QUERIES][2];
+
+static void SetupStep(int entities)
+{
+    (void)entities;
+    InitPacman(&game, BENCH_SEED);
+    ResetBenchButtons();
+}
+
+static void TickStep(void)
+{
+    PacmanInput input = { NextBenchButtons(PACMAN_INPUT_ALL) };
+    StepPacman(&game, input);
+}
+
+// The given number of searches per tick, from open tiles spread over the maze to Pacman's start tile
+static void SetupPaths(int entities)
+{
+    InitPacman(&game, BENCH_SEED);
+
+    int openTiles = 0;
+    for (int row = 0; row < MAZE_ROWS; row++)
+        for (int col = 0; col < MAZE_COLS; col++) if (game.maze[row][col] != 1) openTiles++;
+
+    queryCount = 0;
+    int tile = 0;
+    for (int row = 0; row < MAZE_ROWS && queryCount < entities; row++) {
+        for (int col = 0; col < MAZE_COLS && queryCount < entities; col++) {
+            if (game.maze[row][col] == 1) continue;
+            if (tile++%(openTiles/entities) == 0) {
+                queryStart[queryCount][0] = col;
+                queryStart[queryCount][1] = row;
+                queryCount++;
+            }
+        }
+    }
+}
+
+static void TickPaths(void)
+{
+    int goalX = (int)(game.pacman.position.x/TILE_SIZE), goalY = (int)(game.pacman.position.y/TILE_SIZE);
+    for (int i = 0; i < queryCount; i++) {
+        Vector2 direction = { 0, 0 };
+        if (FindGhostStep(&game, queryStart[i][0], queryStart[i][1], goalX, goalY, &direction)) benchSink += (int)direction.x;
+    }
+}
+
+// A step of the given number of env instances, each on its own scripted input, on the calling thread alone
+static PacmanEnv env;
+
+static void SetupEnv(int entities)
+{
+    env = LoadPacmanEnv(entities, BENCH_SEED);
+    ResetBenchButtons();
+}
+
+static void TickEnv(void)
+{
+    for (int i = 0; i < env.base.count; i++) env.base.actions[i] = NextBenchButtons(PACMAN_INPUT_ALL);
+    StepPacmanEnv(&env);
+    benchSink += (int)env.base.episodes;
+}
+
+static void TeardownEnv(void)
+{
+    UnloadPacmanEnv(&env);
+}
+
+const BenchScenario pacmanScenarios[] = {
+    { "pacman/step", 0, SetupStep, TickStep, NULL },
+    { "pacman/paths", 1, SetupPaths, TickPaths, NULL },
+    { "pacman/paths", GHOST_COUNT, SetupPaths, TickPaths, NULL },
+    { "pacman/paths", MAX_PATH_QUERIES, SetupPaths, TickPaths, NULL },
+    { "pacman/env", 64, SetupEnv, TickEnv, TeardownEnv },
+    { "pacman/env", 1024, SetupEnv, TickEnv, TeardownEnv },
+    { NULL }
+};
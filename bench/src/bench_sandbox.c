@@ -0,0 +1,38 @@
+// Sandbox scenario: the whole step on scripted input, timer wheel and logging included.
+// The log goes nowhere, only the cost of queueing the records is measured
+#include "bench.h"
+#include "sandbox_sim.h"
+#include "logger.h"
+
+#if defined(_WIN32)
+    #define NULL_DEVICE "NUL"
+#else
+    #define NULL_DEVICE "/dev/null"
+#endif
+
+static SandboxGame game;
+
+static void SetupStep(int entities)
+{
+    (void)entities;
+    InitLogger(NULL_DEVICE);
+    InitSandbox(&game);
+    ResetBenchButtons();
+}
+
+static void TickStep(void)
+{
+    SandboxInput input = { NextBenchButtons(SANDBOX_INPUT_ALL) };
+    StepSandbox(&game, input);
+}
+
+static void TeardownStep(void)
+{
+    UnloadSandbox(&game);
+    CloseLogger();
+}
+
+const BenchScenario sandboxScenarios[] = {
+    { "sandbox/step", 0, SetupStep, TickStep, TeardownStep },
+    { NULL }
+};
@@ -0,0 +1,57 @@
+// Tank scenarios: the whole step (bots and bullets on the job system) and the tile obstacle queries,
+// from a duel up to a full battle royale
+#include "bench.h"
+#include "tank_sim.h"
+#include "jobs.h"
+#include <math.h>
+
+static TankGame game;
+
+static void SetupStep(int entities)
+{
+    InitJobSystem(0);
+    InitTankGame(&game, entities);
+    ResetBenchButtons();
+}
+
+static void TickStep(void)
+{
+    unsigned int buttons = NextBenchButtons(TANK_INPUT_ALL | (TANK_INPUT_ALL << 8));
+    TankInput input = { { (unsigned char)(buttons & 0xff), (unsigned char)(buttons >> 8) } };
+    StepTankGame(&game, input);
+}
+
+static void TeardownStep(void)
+{
+    CloseJobSystem();
+}
+
+static void SetupObstacles(int entities)
+{
+    InitTankGame(&game, entities);
+}
+
+// What a moving bot asks every tick: can it stand one step ahead, and how far is the wall in front
+static void TickObstacles(void)
+{
+    for (int i = 0; i < game.tankCount; i++) {
+        const Tank *tank = &game.tanks[i];
+        Vector2 forward = { sinf(tank->rotation*DEG2RAD), -cosf(tank->rotation*DEG2RAD) };
+        Vector2 next = { tank->position.x + forward.x*TANK_SPEED, tank->position.y + forward.y*TANK_SPEED };
+        Vector2 ahead = { tank->position.x + forward.x*LOOKAHEAD_DISTANCE, tank->position.y + forward.y*LOOKAHEAD_DISTANCE };
+        float distance = LOOKAHEAD_DISTANCE;
+
+        benchSink += CheckTankObstacleCollision(&game, next);
+        benchSink += RaycastTiles(&game, tank->position, ahead, &distance);
+    }
+}
+
+const BenchScenario tankScenarios[] = {
+    { "tank/step", PLAYER_TANKS, SetupStep, TickStep, TeardownStep },
+    { "tank/step", ROYALE_TANKS, SetupStep, TickStep, TeardownStep },
+    { "tank/step", MAX_TANKS, SetupStep, TickStep, TeardownStep },
+    { "tank/obstacles", PLAYER_TANKS, SetupObstacles, TickObstacles, NULL },
+    { "tank/obstacles", ROYALE_TANKS, SetupObstacles, TickObstacles, NULL },
+    { "tank/obstacles", MAX_TANKS, SetupObstacles, TickObstacles, NULL },
+    { NULL }
+};
@@ -0,0 +1,10 @@
+// Implementations of the shared utilities the simulations are built on, like the games' src/platform.c.
+// Kept apart from the bench sources because <windows.h> clashes with raylib.h
+#define THREAD_IMPLEMENTATION
+#define JOBS_IMPLEMENTATION
+#define LOGGER_IMPLEMENTATION
+#define PROFILER_IMPLEMENTATION
+#include "thread.h"
+#include "jobs.h"
+#include "logger.h"
+#include "profiler.h"
@@ -0,0 +1,5 @@
+// Draw list and software rasterizer implementations for the raster scenarios. In their own file since the
+// scenario files each include a sim header, and bench.c has the headless ones
+#define DRAWLIST_IMPLEMENTATION
+#define SOFTRASTER_IMPLEMENTATION
+#include "softraster.h"
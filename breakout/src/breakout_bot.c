@@ -0,0 +1,34 @@
+#include "breakout_bot.h"
+#include <math.h>
+
+unsigned int GetBreakoutBotButtons(const BreakoutGame *game)
+{
+    unsigned int buttons = 0;
+
+    // Launch and restart act on the press, let go for a tick after each
+    if (game->gameOver || game->gameWon) {
+        if (!(game->previousButtons & BREAKOUT_INPUT_RESTART)) buttons |= BREAKOUT_INPUT_RESTART;
+        return buttons;
+    }
+    if (!game->ballActive && !(game->previousButtons & BREAKOUT_INPUT_LAUNCH)) buttons |= BREAKOUT_INPUT_LAUNCH;
+
+    // Track the ball, where it will be when it comes down to the paddle if it is falling
+    float target = game->ballPosition.x;
+    if (game->ballActive && game->ballSpeed.y > 0.0f) {
+        float ticks = (game->paddle.y - BALL_RADIUS - game->ballPosition.y)/game->ballSpeed.y;
+        target += game->ballSpeed.x*ticks;
+
+        // Fold the prediction back into the screen, the ball bounces off the side walls
+        float span = SCREEN_WIDTH - 2.0f*BALL_RADIUS;
+        float x = fmodf(target - BALL_RADIUS, 2.0f*span);
+        if (x < 0.0f) x += 2.0f*span;
+        if (x > span) x = 2.0f*span - x;
+        target = x + BALL_RADIUS;
+    }
+
+    float center = game->paddle.x + game->paddle.width/2;
+    if (target < center - PADDLE_SPEED) buttons |= BREAKOUT_INPUT_LEFT;
+    else if (target > center + PADDLE_SPEED) buttons |= BREAKOUT_INPUT_RIGHT;
+
+    return buttons;
+}
@@ -0,0 +1,11 @@
+#ifndef BREAKOUT_BOT_H
+#define BREAKOUT_BOT_H
+
+// Autoplayer policy for soak and performance runs (see bot.h): keeps the paddle under the ball, launches it and
+// restarts finished games
+
+#include "breakout_sim.h"
+
+unsigned int GetBreakoutBotButtons(const BreakoutGame *game);   // Buttons a player would hold this tick
+
+#endif // BREAKOUT_BOT_H
@@ -0,0 +1,39 @@
+#include "breakout_draw.h"
+#include "gameloop.h"
+
+void RecordBreakout(DrawList *list, const BreakoutGame *game, const BreakoutGame *previous, float alpha)
+{
+    Rectangle paddle = InterpolateRectangle(previous->paddle, game->paddle, alpha, PADDLE_SPEED*2);
+    Vector2 ballPosition = InterpolatePosition(previous->ballPosition, game->ballPosition, alpha, BALL_SPEED*2);
+
+    RecordClear(list, BLACK);
+
+    // Draw bricks
+    for (int r = 0; r < BRICK_ROWS; r++) {
+        for (int c = 0; c < BRICK_COLS; c++) {
+            if (game->bricks[r][c].active) {
+                Color color = (Color){ 200, 200 - r * 30, 100 + r * 20, 255 };
+                RecordRectangle(list, game->bricks[r][c].rect, color);
+            }
+        }
+    }
+
+    // Draw paddle
+    RecordRectangle(list, paddle, WHITE);
+
+    // Draw ball
+    RecordCircle(list, ballPosition, BALL_RADIUS, YELLOW);
+
+    // Draw UI
+    RecordTextFormat(list, 20, SCREEN_HEIGHT - 40, 24, LIGHTGRAY, "LIVES: %d", game->lives);
+    RecordTextFormat(list, SCREEN_WIDTH - 180, SCREEN_HEIGHT - 40, 24, LIGHTGRAY, "SCORE: %d", game->score);
+
+    if (!game->ballActive && !game->gameOver && !game->gameWon)
+        RecordText(list, "PRESS SPACE TO LAUNCH", SCREEN_WIDTH/2 - 160, SCREEN_HEIGHT/2, 28, GRAY);
+
+    if (game->gameOver)
+        RecordText(list, "GAME OVER! PRESS ENTER TO RESTART", SCREEN_WIDTH/2 - 260, SCREEN_HEIGHT/2, 32, RED);
+
+    if (game->gameWon)
+        RecordText(list, "YOU WIN! PRESS ENTER TO RESTART", SCREEN_WIDTH/2 - 220, SCREEN_HEIGHT/2, 32, GREEN);
+}
@@ -0,0 +1,13 @@
+#ifndef BREAKOUT_DRAW_H
+#define BREAKOUT_DRAW_H
+
+// Breakout's picture, recorded in a draw list: replayed to raylib by the game, rasterized on the CPU by
+// breakout_headless --frames and the benchmarks
+
+#include "breakout_sim.h"
+#include "drawlist.h"
+
+// Moving objects are drawn alpha of the way from previous to game (see gameloop.h), pass game twice for a tick as is
+void RecordBreakout(DrawList *list, const BreakoutGame *game, const BreakoutGame *previous, float alpha);
+
+#endif // BREAKOUT_DRAW_H
@@ -0,0 +1,100 @@
+#include "breakout_env.h"
+#include <stdlib.h>
+
+static void StartEpisode(BreakoutEnv *env, int instance);
+static void WriteObservation(BreakoutEnv *env, int instance);
+static void StepInstances(void *data, int first, int last);
+static void ResetInstances(void *data, int first, int last);
+
+BreakoutEnv LoadBreakoutEnv(int count, unsigned long long seed)
+{
+    BreakoutEnv env = { 0 };
+    env.base = LoadVecEnv(count, seed, BREAKOUT_ENV_MAX_EPISODE_TICKS);
+    env.games = (BreakoutGame *)calloc(count, sizeof(BreakoutGame));
+    env.observations = (float *)calloc((size_t)count*BREAKOUT_ENV_OBSERVATION_SIZE, sizeof(float));
+
+    ResetBreakoutEnv(&env);
+    return env;
+}
+
+void UnloadBreakoutEnv(BreakoutEnv *env)
+{
+    UnloadVecEnv(&env->base);
+    free(env->games);
+    free(env->observations);
+    *env = (BreakoutEnv){ 0 };
+}
+
+void ResetBreakoutEnv(BreakoutEnv *env)
+{
+    RunParallelFor(ResetInstances, env, env->base.count, VECENV_BATCH_SIZE);
+}
+
+void StepBreakoutEnv(BreakoutEnv *env)
+{
+    RunVecEnv(&env->base, StepInstances, env);
+}
+
+// New game, then the random start
+void StartEpisode(BreakoutEnv *env, int instance)
+{
+    BreakoutGame *game = &env->games[instance];
+    Rng *rng = &env->base.rngs[instance];
+
+    InitBreakout(game);
+    for (int ticks = RandomRange(rng, 0, BREAKOUT_ENV_RANDOM_START_TICKS); ticks > 0; ticks--) {
+        BreakoutInput input = { (unsigned int)RandomRange(rng, 0, BREAKOUT_INPUT_LEFT | BREAKOUT_INPUT_RIGHT) };
+        StepBreakout(game, input);
+    }
+}
+
+void WriteObservation(BreakoutEnv *env, int instance)
+{
+    const BreakoutGame *game = &env->games[instance];
+    float *observation = &env->observations[(size_t)instance*BREAKOUT_ENV_OBSERVATION_SIZE];
+
+    observation[BREAKOUT_ENV_PADDLE_X] = (game->paddle.x + game->paddle.width/2)/SCREEN_WIDTH;
+    observation[BREAKOUT_ENV_BALL_X] = game->ballPosition.x/SCREEN_WIDTH;
+    observation[BREAKOUT_ENV_BALL_Y] = game->ballPosition.y/SCREEN_HEIGHT;
+    observation[BREAKOUT_ENV_BALL_SPEED_X] = game->ballSpeed.x/BALL_SPEED;
+    observation[BREAKOUT_ENV_BALL_SPEED_Y] = game->ballSpeed.y/BALL_SPEED;
+    observation[BREAKOUT_ENV_BALL_ACTIVE] = game->ballActive? 1.0f : 0.0f;
+    observation[BREAKOUT_ENV_LIVES] = (float)game->lives;
+
+    float *bricks = &observation[BREAKOUT_ENV_BRICKS];
+    for (int r = 0; r < BRICK_ROWS; r++) {
+        for (int c = 0; c < BRICK_COLS; c++) bricks[r*BRICK_COLS + c] = game->bricks[r][c].active? 1.0f : 0.0f;
+    }
+}
+
+void StepInstances(void *data, int first, int last)
+{
+    BreakoutEnv *env = (BreakoutEnv *)data;
+
+    for (int i = first; i < last; i++) {
+        BreakoutGame *game = &env->games[i];
+        int score = game->score;
+
+        BreakoutInput input = { env->base.actions[i] & ~BREAKOUT_INPUT_RESTART };
+        StepBreakout(game, input);
+
+        bool terminal = game->gameOver || game->gameWon;
+        if (EndVecEnvStep(&env->base, i, (float)(game->score - score), terminal)) StartEpisode(env, i);
+        WriteObservation(env, i);
+    }
+}
+
+void ResetInstances(void *data, int first, int last)
+{
+    BreakoutEnv *env = (BreakoutEnv *)data;
+
+    for (int i = first; i < last; i++) {
+        StartEpisode(env, i);
+        env->base.rewards[i] = 0.0f;
+        env->base.dones[i] = 0;
+        env->base.truncated[i] = 0;
+        env->base.episodeReturns[i] = 0.0f;
+        env->base.episodeTicks[i] = 0;
+        WriteObservation(env, i);
+    }
+}
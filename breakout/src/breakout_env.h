@@ -0,0 +1,40 @@
+#ifndef BREAKOUT_ENV_H
+#define BREAKOUT_ENV_H
+
+// Breakout as a vectorized environment (see vecenv.h): N games stepped in lockstep, observations in one
+// contiguous array the caller reads in place. Actions are BREAKOUT_INPUT_* buttons, restart aside: an episode
+// ends when the game is lost or won, and the env starts the next one itself. The reward is the score gained.
+// Each episode starts with up to BREAKOUT_ENV_RANDOM_START_TICKS ticks of random paddle moves, drawn from the
+// instance's own random stream, so instances don't all play the same opening
+
+#include "breakout_sim.h"
+#include "vecenv.h"
+
+#define BREAKOUT_ENV_MAX_EPISODE_TICKS 18000    // Five minutes at 60 ticks per second
+#define BREAKOUT_ENV_RANDOM_START_TICKS 30
+
+// Observation of an instance, floats
+enum {
+    BREAKOUT_ENV_PADDLE_X = 0,                  // Paddle center, 0 to 1 across the screen
+    BREAKOUT_ENV_BALL_X,                        // Ball center, 0 to 1 across and down the screen
+    BREAKOUT_ENV_BALL_Y,
+    BREAKOUT_ENV_BALL_SPEED_X,                  // -1 to 1
+    BREAKOUT_ENV_BALL_SPEED_Y,
+    BREAKOUT_ENV_BALL_ACTIVE,                   // 0 while the ball waits on the paddle for a launch
+    BREAKOUT_ENV_LIVES,
+    BREAKOUT_ENV_BRICKS,                        // BRICK_ROWS*BRICK_COLS, row by row, 1 for a brick still up
+    BREAKOUT_ENV_OBSERVATION_SIZE = BREAKOUT_ENV_BRICKS + BRICK_ROWS*BRICK_COLS
+};
+
+typedef struct {
+    VecEnv base;                                // Actions in, rewards and dones out
+    BreakoutGame *games;                        // [count]
+    float *observations;                        // [count][BREAKOUT_ENV_OBSERVATION_SIZE]
+} BreakoutEnv;
+
+BreakoutEnv LoadBreakoutEnv(int count, unsigned long long seed);     // Every instance starts an episode
+void UnloadBreakoutEnv(BreakoutEnv *env);
+void ResetBreakoutEnv(BreakoutEnv *env);        // New episode for every instance, without a done flag
+void StepBreakoutEnv(BreakoutEnv *env);         // One tick of every instance on its action
+
+#endif // BREAKOUT_ENV_H
@@ -0,0 +1,174 @@
+#include "breakout_sim.h"
+#include "replay.h"
+#include "profiler.h"
+#include "counters.h"
+#include "collision.h"
+#include <math.h>
+
+static void PushEvent(BreakoutGame *game, BreakoutEventType type, Vector2 position);
+
+void InitBreakout(BreakoutGame *game)
+{
+    // Paddle
+    game->paddle.width = PADDLE_WIDTH;
+    game->paddle.height = PADDLE_HEIGHT;
+    game->paddle.x = (SCREEN_WIDTH - PADDLE_WIDTH) / 2;
+    game->paddle.y = SCREEN_HEIGHT - 60;
+
+    // Ball
+    game->ballPosition = (Vector2){ game->paddle.x + PADDLE_WIDTH / 2, game->paddle.y - BALL_RADIUS - 2 };
+    game->ballSpeed = (Vector2){ BALL_SPEED, -BALL_SPEED };
+    game->ballActive = false;
+
+    // Bricks
+    for (int r = 0; r < BRICK_ROWS; r++) {
+        for (int c = 0; c < BRICK_COLS; c++) {
+            game->bricks[r][c].rect.x = BRICK_OFFSET_LEFT + c * (BRICK_WIDTH + BRICK_PADDING);
+            game->bricks[r][c].rect.y = BRICK_OFFSET_TOP + r * (BRICK_HEIGHT + BRICK_PADDING);
+            game->bricks[r][c].rect.width = BRICK_WIDTH;
+            game->bricks[r][c].rect.height = BRICK_HEIGHT;
+            game->bricks[r][c].active = true;
+        }
+    }
+
+    game->lives = 3;
+    game->score = 0;
+    game->gameOver = false;
+    game->gameWon = false;
+    game->previousButtons = 0;
+    game->eventCount = 0;
+}
+
+void StepBreakout(BreakoutGame *game, BreakoutInput input)
+{
+    Rectangle *paddle = &game->paddle;
+    Vector2 *ballPosition = &game->ballPosition;
+    Vector2 *ballSpeed = &game->ballSpeed;
+    unsigned int pressed = input.buttons & ~game->previousButtons;
+
+    game->previousButtons = input.buttons;
+    game->eventCount = 0;
+
+    if (game->gameOver || game->gameWon) {
+        if (pressed & BREAKOUT_INPUT_RESTART) {
+            InitBreakout(game);
+            game->previousButtons = input.buttons;
+        }
+        return;
+    }
+
+    // Paddle movement
+    if (input.buttons & BREAKOUT_INPUT_LEFT) paddle->x -= PADDLE_SPEED;
+    if (input.buttons & BREAKOUT_INPUT_RIGHT) paddle->x += PADDLE_SPEED;
+    if (paddle->x < 0) paddle->x = 0;
+    if (paddle->x > SCREEN_WIDTH - paddle->width) paddle->x = SCREEN_WIDTH - paddle->width;
+
+    // Launch ball
+    if (!game->ballActive) {
+        ballPosition->x = paddle->x + paddle->width / 2;
+        ballPosition->y = paddle->y - BALL_RADIUS - 2;
+        if (pressed & BREAKOUT_INPUT_LAUNCH) game->ballActive = true;
+    }
+
+    // Ball movement
+    if (game->ballActive) {
+        ballPosition->x += ballSpeed->x;
+        ballPosition->y += ballSpeed->y;
+
+        // Wall collision
+        if (ballPosition->x < BALL_RADIUS) {
+            ballPosition->x = BALL_RADIUS;
+            ballSpeed->x *= -1;
+        }
+        if (ballPosition->x > SCREEN_WIDTH - BALL_RADIUS) {
+            ballPosition->x = SCREEN_WIDTH - BALL_RADIUS;
+            ballSpeed->x *= -1;
+        }
+        if (ballPosition->y < BALL_RADIUS) {
+            ballPosition->y = BALL_RADIUS;
+            ballSpeed->y *= -1;
+        }
+
+        // Paddle collision
+        if (OverlapCircleRec(*ballPosition, BALL_RADIUS, *paddle)) {
+            ballPosition->y = paddle->y - BALL_RADIUS - 1;
+            ballSpeed->y *= -1;
+
+            float hitPos = (ballPosition->x - (paddle->x + paddle->width / 2)) / (paddle->width / 2);
+            ballSpeed->x = BALL_SPEED * hitPos;
+            PushEvent(game, BREAKOUT_EVENT_PADDLE_HIT, *ballPosition);
+        }
+
+        PROFILE_ZONE("collision") HitBricks(game);
+
+        // Ball lost
+        if (ballPosition->y > SCREEN_HEIGHT) {
+            game->lives--;
+            game->ballActive = false;
+            PushEvent(game, BREAKOUT_EVENT_BALL_LOST, *ballPosition);
+            if (game->lives <= 0) {
+                game->gameOver = true;
+                PushEvent(game, BREAKOUT_EVENT_GAME_OVER, *ballPosition);
+            }
+        }
+    }
+
+    // Win check
+    int bricksLeft = 0;
+    for (int r = 0; r < BRICK_ROWS; r++)
+        for (int c = 0; c < BRICK_COLS; c++)
+            if (game->bricks[r][c].active) bricksLeft++;
+    if (bricksLeft == 0) {
+        game->gameWon = true;
+        PushEvent(game, BREAKOUT_EVENT_GAME_WON, *ballPosition);
+    }
+}
+
+// Ball against the bricks: knocks out the ones it touches and bounces off them
+void HitBricks(BreakoutGame *game)
+{
+    int bricks = 0;
+
+    for (int r = 0; r < BRICK_ROWS; r++) {
+        for (int c = 0; c < BRICK_COLS; c++) {
+            if (!game->bricks[r][c].active) continue;
+            bricks++;
+            if (OverlapCircleRec(game->ballPosition, BALL_RADIUS, game->bricks[r][c].rect)) {
+                game->bricks[r][c].active = false;
+                game->score += 10;
+                // Simple collision response
+                float bx = game->ballPosition.x;
+                Rectangle brick = game->bricks[r][c].rect;
+                if (bx < brick.x || bx > brick.x + brick.width) game->ballSpeed.x *= -1;
+                else game->ballSpeed.y *= -1;
+                PushEvent(game, BREAKOUT_EVENT_BRICK_HIT, game->ballPosition);
+            }
+        }
+    }
+
+    COUNT("brick tests", bricks);
+}
+
+void PushEvent(BreakoutGame *game, BreakoutEventType type, Vector2 position)
+{
+    if (game->eventCount < BREAKOUT_MAX_EVENTS) game->events[game->eventCount++] = (BreakoutEvent){ type, position };
+}
+
+unsigned long long HashBreakout(const BreakoutGame *game)
+{
+    unsigned long long hash = REPLAY_HASH_SEED;
+    hash = HashBytes(hash, &game->paddle, sizeof(Rectangle));
+    hash = HashBytes(hash, &game->ballPosition, sizeof(Vector2));
+    hash = HashBytes(hash, &game->ballSpeed, sizeof(Vector2));
+    hash = HashInt(hash, game->ballActive);
+    hash = HashInt(hash, game->lives);
+    hash = HashInt(hash, game->score);
+    hash = HashInt(hash, game->gameOver);
+    hash = HashInt(hash, game->gameWon);
+    hash = HashInt(hash, (int)game->previousButtons);
+
+    for (int row = 0; row < BRICK_ROWS; row++)
+        for (int col = 0; col < BRICK_COLS; col++) hash = HashInt(hash, game->bricks[row][col].active);
+
+    return hash;
+}
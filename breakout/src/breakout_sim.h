@@ -0,0 +1,81 @@
+#ifndef BREAKOUT_SIM_H
+#define BREAKOUT_SIM_H
+
+// Breakout simulation: game state and the per-tick step, with no window, input or audio calls.
+// Only the raylib.h types are used, so it also builds into the headless target
+
+#include "raylib.h"
+
+#define SCREEN_WIDTH 720
+#define SCREEN_HEIGHT 900
+
+#define PADDLE_WIDTH 120
+#define PADDLE_HEIGHT 20
+#define PADDLE_SPEED 8
+
+#define BALL_RADIUS 10
+#define BALL_SPEED 6
+
+#define BRICK_ROWS 6
+#define BRICK_COLS 10
+#define BRICK_WIDTH 60
+#define BRICK_HEIGHT 30
+#define BRICK_PADDING 8
+#define BRICK_OFFSET_TOP 60
+#define BRICK_OFFSET_LEFT 30
+
+#define BREAKOUT_MAX_EVENTS 16
+
+// Buttons held this tick, launch and restart act on the press
+enum {
+    BREAKOUT_INPUT_LEFT = 1,
+    BREAKOUT_INPUT_RIGHT = 2,
+    BREAKOUT_INPUT_LAUNCH = 4,
+    BREAKOUT_INPUT_RESTART = 8,
+    BREAKOUT_INPUT_ALL = 15
+};
+
+typedef struct {
+    unsigned int buttons;
+} BreakoutInput;
+
+typedef enum {
+    BREAKOUT_EVENT_PADDLE_HIT = 0,
+    BREAKOUT_EVENT_BRICK_HIT,
+    BREAKOUT_EVENT_BALL_LOST,
+    BREAKOUT_EVENT_GAME_OVER,
+    BREAKOUT_EVENT_GAME_WON
+} BreakoutEventType;
+
+typedef struct {
+    BreakoutEventType type;
+    Vector2 position;
+} BreakoutEvent;
+
+typedef struct {
+    Rectangle rect;
+    bool active;
+} Brick;
+
+typedef struct {
+    Rectangle paddle;
+    Vector2 ballPosition;
+    Vector2 ballSpeed;
+    bool ballActive;
+    Brick bricks[BRICK_ROWS][BRICK_COLS];
+    int lives;
+    int score;
+    bool gameOver;
+    bool gameWon;
+    unsigned int previousButtons;
+
+    BreakoutEvent events[BREAKOUT_MAX_EVENTS];
+    int eventCount;
+} BreakoutGame;
+
+void InitBreakout(BreakoutGame *game);                            // New game
+void StepBreakout(BreakoutGame *game, BreakoutInput input);       // One tick, events are replaced
+unsigned long long HashBreakout(const BreakoutGame *game);        // For replays, see replay.h
+void HitBricks(BreakoutGame *game);                               // Brick part of the step, on its own for the bench
+
+#endif // BREAKOUT_SIM_H
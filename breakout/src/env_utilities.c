@@ -0,0 +1,8 @@
+// Implementations of the shared utilities for the breakout_env library, which has neither main.c nor
+// headless.c to carry them
+#define REPLAY_IMPLEMENTATION
+#define COUNTERS_IMPLEMENTATION
+#define VECENV_IMPLEMENTATION
+#include "replay.h"
+#include "counters.h"
+#include "vecenv.h"
@@ -0,0 +1,49 @@
+// Breakout simulation without window or audio, on random, bot or replayed input: breakout_headless [--ticks N] [--seed N] [--replay FILE]
+// (all options in headless.h). --frames DIR draws pictures of the game with the software rasterizer
+#define HEADLESS_IMPLEMENTATION
+#define REPLAY_IMPLEMENTATION
+#define COUNTERS_IMPLEMENTATION
+#define SOAK_IMPLEMENTATION
+#define DRAWLIST_IMPLEMENTATION
+#define SOFTRASTER_IMPLEMENTATION
+#include "headless.h"
+#include "breakout_sim.h"
+#include "breakout_bot.h"
+#include "breakout_draw.h"
+#include "softraster.h"
+
+int main(int argc, char *argv[])
+{
+    HeadlessRun run;
+    static BreakoutGame game;
+    DrawList list = { 0 };
+    RasterFrame frame = { 0 };
+
+    if (!StartHeadlessRun(&run, argc, argv, "breakout", 0)) return 1;
+    InitBreakout(&game);
+    if (run.options.framesDir != NULL) {
+        InitJobSystem(0);
+        frame = LoadRasterFrame(SCREEN_WIDTH, SCREEN_HEIGHT);
+    }
+
+    while (run.tick < run.options.ticks) {
+        BreakoutInput input = { run.botting? NextHeadlessBotButtons(&run, GetBreakoutBotButtons(&game), BREAKOUT_INPUT_ALL) : NextHeadlessButtons(&run, BREAKOUT_INPUT_ALL) };
+        StepBreakout(&game, input);
+        if (!EndHeadlessTick(&run, game.eventCount, run.hashing? HashBreakout(&game) : 0)) break;
+
+        if (IsHeadlessFrameDue(&run)) {
+            ResetDrawList(&list);
+            RecordBreakout(&list, &game, &game, 0.0f);
+            RasterizeDrawList(&frame, &list);
+            SaveRasterFrame(&frame, GetHeadlessFramePath(&run));
+        }
+    }
+
+    if (run.options.framesDir != NULL) {
+        UnloadRasterFrame(&frame);
+        UnloadDrawList(&list);
+        CloseJobSystem();
+    }
+
+    return FinishHeadlessRun(&run);
+}
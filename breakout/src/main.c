@@ -1,209 +1,158 @@
 #include "raylib.h"
+#include "breakout_sim.h"
+#include "breakout_draw.h"
+#include "breakout_bot.h"
+#include "bot.h"
+
+#define REPLAY_IMPLEMENTATION
+#include "replay.h"
+#define PROFILER_GRAPH_IMPLEMENTATION
+#include "profiler.h"
+#define COUNTERS_IMPLEMENTATION
+#define COUNTERS_OVERLAY_IMPLEMENTATION
+#include "counters.h"
+#define GAMELOOP_IMPLEMENTATION
+#include "gameloop.h"
+#define MIXER_IMPLEMENTATION
+#include "mixer.h"
+#define DRAWLIST_IMPLEMENTATION
+#define DRAWLIST_REPLAY_IMPLEMENTATION
+#include "drawlist.h"
+#define SOAK_IMPLEMENTATION
+#include "soak.h"
 #include <math.h>
-
-#define SCREEN_WIDTH 720
-#define SCREEN_HEIGHT 900
-
-#define PADDLE_WIDTH 120
-#define PADDLE_HEIGHT 20
-#define PADDLE_SPEED 8
-
-#define BALL_RADIUS 10
-#define BALL_SPEED 6
-
-#define BRICK_ROWS 6
-#define BRICK_COLS 10
-#define BRICK_WIDTH 60
-#define BRICK_HEIGHT 30
-#define BRICK_PADDING 8
-#define BRICK_OFFSET_TOP 60
-#define BRICK_OFFSET_LEFT 30
-
-typedef struct {
-    Rectangle rect;
-    bool active;
-} Brick;
-
-static Rectangle paddle;
-static Vector2 ballPosition;
-static Vector2 ballSpeed;
-static bool ballActive = false;
-static Brick bricks[BRICK_ROWS][BRICK_COLS];
-static int lives = 3;
-static int score = 0;
-static bool gameOver = false;
-static bool gameWon = false;
+#include <stdlib.h>
+#include <string.h>
+
+static BreakoutGame game = { 0 };
+static BreakoutGame previous = { 0 };  // State of the tick before, drawing interpolates from it
+static GameLoop loop = { 0 };
+static FramePipeline pipeline = { 0 };
+static BreakoutInput input = { 0 };        // Read on the main thread, for the ticks of the frame being recorded
+static int frameTicks = 0;
+static float frameAlpha = 0.0f;
+static Replay replay = { 0 };      // This session, saved as breakout.replay on exit for breakout_headless --replay
+static int botSkill = -1;          // --bot SKILL, negative when the keyboard plays
+static Bot bot = { 0 };
 
 static void InitGame(void);
+static void ReadInput(void);
+static void RunFrame(void *user, DrawList *list);
 static void UpdateGame(void);
-static void DrawGame(void);
+static void DrawGame(DrawList *list, float alpha);
+static void DrawFrame(void);
 static void UnloadGame(void);
 
-int main(void)
+int main(int argc, char *argv[])
 {
+    // --profile FILE writes a Chrome trace of the session on exit, F3 shows the frame-time graph
+    // --counters FILE streams the workload counters of every frame (see counters.h), F4 shows them
+    // --bot SKILL plays by itself, 0 to 100 (see bot.h)
+    // --soak SECONDS ends the session after that long, --soak-log FILE logs its frame times and memory (see soak.h)
+    const char *profileFile = NULL, *countersFile = NULL, *soakLogFile = NULL;
+    double soakSeconds = 0.0;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--profile") == 0) profileFile = argv[++i];
+        else if (strcmp(argv[i], "--counters") == 0) countersFile = argv[++i];
+        else if (strcmp(argv[i], "--bot") == 0) botSkill = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--soak") == 0) soakSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--soak-log") == 0) soakLogFile = argv[++i];
+    }
+    InitProfiler(profileFile);
+    if (countersFile != NULL) OpenCounterStream(countersFile);
+
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "classic game: breakout");
     InitGame();
-    SetTargetFPS(60);
+    SetTargetFPS(GetMonitorRefreshRate(GetCurrentMonitor()));   // Draw at the display rate, the game ticks at GAMELOOP_TICK_RATE
+
+    SoakRun soak;
+    StartSoakRun(&soak, soakSeconds, soakLogFile);
 
-    while (!WindowShouldClose())
+    while (!WindowShouldClose() && UpdateSoakRun(&soak, GetTime()))
     {
-        UpdateGame();
-        DrawGame();
+        ProfileFrame();
+        UpdateProfilerGraph();     // Once per frame, a frame can run no tick or several
+        UpdateCounterOverlay();
+        ReadInput();
+        frameTicks = AdvanceGameLoop(&loop, GetTime());
+        frameAlpha = GetGameLoopAlpha(&loop);
+
+        StartPipelineFrame(&pipeline);      // The next frame updates and records on the worker...
+        DrawFrame();                        // ...while this one is drawn
+        FinishPipelineFrame(&pipeline);
+        CounterFrame();
     }
 
     UnloadGame();
     CloseWindow();
+    CloseProfiler();
+    CloseCounterStream();
+    FinishSoakRun(&soak, "breakout");
     return 0;
 }
 
 void InitGame(void)
 {
-    // Paddle
-    paddle.width = PADDLE_WIDTH;
-    paddle.height = PADDLE_HEIGHT;
-    paddle.x = (SCREEN_WIDTH - PADDLE_WIDTH) / 2;
-    paddle.y = SCREEN_HEIGHT - 60;
-
-    // Ball
-    ballPosition = (Vector2){ paddle.x + PADDLE_WIDTH / 2, paddle.y - BALL_RADIUS - 2 };
-    ballSpeed = (Vector2){ BALL_SPEED, -BALL_SPEED };
-    ballActive = false;
-
-    // Bricks
-    for (int r = 0; r < BRICK_ROWS; r++) {
-        for (int c = 0; c < BRICK_COLS; c++) {
-            bricks[r][c].rect.x = BRICK_OFFSET_LEFT + c * (BRICK_WIDTH + BRICK_PADDING);
-            bricks[r][c].rect.y = BRICK_OFFSET_TOP + r * (BRICK_HEIGHT + BRICK_PADDING);
-            bricks[r][c].rect.width = BRICK_WIDTH;
-            bricks[r][c].rect.height = BRICK_HEIGHT;
-            bricks[r][c].active = true;
-        }
-    }
+    InitBreakout(&game);
+    InitReplay(&replay, "breakout", 0, 0);
+    if (botSkill >= 0) InitBot(&bot, botSkill, (unsigned int)GetRandomValue(0, 0x7fffffff));
+    InitGameLoop(&loop, GAMELOOP_TICK_RATE, GAMELOOP_MAX_CATCH_UP);
+    InitFramePipeline(&pipeline, RunFrame, NULL);
+}
 
-    lives = 3;
-    score = 0;
-    gameOver = false;
-    gameWon = false;
+void ReadInput(void)
+{
+    ProfileBegin("input");
+    input = (BreakoutInput){ 0 };
+    if (IsKeyDown(KEY_LEFT)) input.buttons |= BREAKOUT_INPUT_LEFT;
+    if (IsKeyDown(KEY_RIGHT)) input.buttons |= BREAKOUT_INPUT_RIGHT;
+    if (IsKeyDown(KEY_SPACE)) input.buttons |= BREAKOUT_INPUT_LAUNCH;
+    if (IsKeyDown(KEY_ENTER)) input.buttons |= BREAKOUT_INPUT_RESTART;
+    ProfileEnd();
 }
 
-void UpdateGame(void)
+// Worker side of the pipeline
+void RunFrame(void *user, DrawList *list)
 {
-    if (gameOver || gameWon) {
-        if (IsKeyPressed(KEY_ENTER)) InitGame();
-        return;
-    }
+    (void)user;
+    for (int i = 0; i < frameTicks; i++) UpdateGame();
+    DrawGame(list, frameAlpha);
+}
 
-    // Paddle movement
-    if (IsKeyDown(KEY_LEFT)) paddle.x -= PADDLE_SPEED;
-    if (IsKeyDown(KEY_RIGHT)) paddle.x += PADDLE_SPEED;
-    if (paddle.x < 0) paddle.x = 0;
-    if (paddle.x > SCREEN_WIDTH - paddle.width) paddle.x = SCREEN_WIDTH - paddle.width;
-
-    // Launch ball
-    if (!ballActive) {
-        ballPosition.x = paddle.x + paddle.width / 2;
-        ballPosition.y = paddle.y - BALL_RADIUS - 2;
-        if (IsKeyPressed(KEY_SPACE)) ballActive = true;
-    }
+void UpdateGame(void)
+{
+    BreakoutInput tickInput = input;
+    if (botSkill >= 0) tickInput.buttons = NextBotButtons(&bot, GetBreakoutBotButtons(&game), BREAKOUT_INPUT_ALL);  // Every tick, from the state it starts from
 
-    // Ball movement
-    if (ballActive) {
-        ballPosition.x += ballSpeed.x;
-        ballPosition.y += ballSpeed.y;
-
-        // Wall collision
-        if (ballPosition.x < BALL_RADIUS) {
-            ballPosition.x = BALL_RADIUS;
-            ballSpeed.x *= -1;
-        }
-        if (ballPosition.x > SCREEN_WIDTH - BALL_RADIUS) {
-            ballPosition.x = SCREEN_WIDTH - BALL_RADIUS;
-            ballSpeed.x *= -1;
-        }
-        if (ballPosition.y < BALL_RADIUS) {
-            ballPosition.y = BALL_RADIUS;
-            ballSpeed.y *= -1;
-        }
-
-        // Paddle collision
-        if (CheckCollisionCircleRec(ballPosition, BALL_RADIUS, paddle)) {
-            ballPosition.y = paddle.y - BALL_RADIUS - 1;
-            ballSpeed.y *= -1;
-            
-            float hitPos = (ballPosition.x - (paddle.x + paddle.width / 2)) / (paddle.width / 2);
-            ballSpeed.x = BALL_SPEED * hitPos;
-        }
-
-        // Brick collision
-        for (int r = 0; r < BRICK_ROWS; r++) {
-            for (int c = 0; c < BRICK_COLS; c++) {
-                if (bricks[r][c].active && CheckCollisionCircleRec(ballPosition, BALL_RADIUS, bricks[r][c].rect)) {
-                    bricks[r][c].active = false;
-                    score += 10;
-                    // Simple collision response
-                    float bx = ballPosition.x;
-                    float by = ballPosition.y;
-                    Rectangle brick = bricks[r][c].rect;
-                    if (bx < brick.x || bx > brick.x + brick.width) ballSpeed.x *= -1;
-                    else ballSpeed.y *= -1;
-                }
-            }
-        }
-
-        // Ball lost
-        if (ballPosition.y > SCREEN_HEIGHT) {
-            lives--;
-            ballActive = false;
-            if (lives <= 0) gameOver = true;
-        }
-    }
+    previous = game;
+    PROFILE_ZONE("update") StepBreakout(&game, tickInput);
+    RecordReplayTick(&replay, tickInput.buttons, HashBreakout(&game));
+}
 
-    // Win check
-    int bricksLeft = 0;
-    for (int r = 0; r < BRICK_ROWS; r++)
-        for (int c = 0; c < BRICK_COLS; c++)
-            if (bricks[r][c].active) bricksLeft++;
-    if (bricksLeft == 0) gameWon = true;
+void DrawGame(DrawList *list, float alpha)
+{
+    ProfileBegin("record");
+    RecordBreakout(list, &game, &previous, alpha);
+    COUNT("draw calls", list->draws);
+    ProfileEnd();
 }
 
-void DrawGame(void)
+// Main thread side: the frame recorded before, then the overlays
+void DrawFrame(void)
 {
+    ProfileBegin("draw");
     BeginDrawing();
-    ClearBackground(BLACK);
-
-    // Draw bricks
-    for (int r = 0; r < BRICK_ROWS; r++) {
-        for (int c = 0; c < BRICK_COLS; c++) {
-            if (bricks[r][c].active) {
-                Color color = (Color){ 200, 200 - r * 30, 100 + r * 20, 255 };
-                DrawRectangleRec(bricks[r][c].rect, color);
-            }
-        }
-    }
-
-    // Draw paddle
-    DrawRectangleRec(paddle, WHITE);
-
-    // Draw ball
-    DrawCircleV(ballPosition, BALL_RADIUS, YELLOW);
-
-    // Draw UI
-    DrawText(TextFormat("LIVES: %d", lives), 20, SCREEN_HEIGHT - 40, 24, LIGHTGRAY);
-    DrawText(TextFormat("SCORE: %d", score), SCREEN_WIDTH - 180, SCREEN_HEIGHT - 40, 24, LIGHTGRAY);
-
-    if (!ballActive && !gameOver && !gameWon)
-        DrawText("PRESS SPACE TO LAUNCH", SCREEN_WIDTH/2 - 160, SCREEN_HEIGHT/2, 28, GRAY);
-
-    if (gameOver)
-        DrawText("GAME OVER! PRESS ENTER TO RESTART", SCREEN_WIDTH/2 - 260, SCREEN_HEIGHT/2, 32, RED);
-
-    if (gameWon)
-        DrawText("YOU WIN! PRESS ENTER TO RESTART", SCREEN_WIDTH/2 - 220, SCREEN_HEIGHT/2, 32, GREEN);
-
+    ReplayDrawList(GetPipelineFrame(&pipeline));
+    ProfileEnd();
+    DrawProfilerGraph(10, 100);
+    DrawCounterOverlay(SCREEN_WIDTH - 258, 100);
     EndDrawing();
 }
 
 void UnloadGame(void)
 {
-    // No dynamic resources to unload
+    CloseFramePipeline(&pipeline);
+
+    SaveReplay(&replay, "breakout.replay");
+    UnloadReplay(&replay);
 }
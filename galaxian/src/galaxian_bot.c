@@ -0,0 +1,28 @@
+#include "galaxian_bot.h"
+#include <stddef.h>
+
+unsigned int GetGalaxianBotButtons(const GalaxianGame *game)
+{
+    // Lowest enemy first, it is the next to reach the player, the leftmost of a row
+    const Rectangle *target = NULL;
+    EcsIter it = IterateQuery(&game->world, game->enemies);
+    while (NextQueryChunk(&it)) {
+        const Rectangle *body = GetQueryColumn(&it, GALAXIAN_BODY);
+        for (int i = 0; i < it.count; i++) {
+            if (target == NULL || body[i].y > target->y || (body[i].y == target->y && body[i].x < target->x)) target = &body[i];
+        }
+    }
+    if (target == NULL) return 0;
+
+    unsigned int buttons = 0;
+    float targetX = target->x + ENEMY_WIDTH/2;
+    float playerX = game->player.x + PLAYER_WIDTH/2;
+    if (targetX < playerX - PLAYER_SPEED) buttons |= GALAXIAN_INPUT_LEFT;
+    else if (targetX > playerX + PLAYER_SPEED) buttons |= GALAXIAN_INPUT_RIGHT;
+
+    // Fire acts on the press, let go for a tick after each
+    bool lined = (targetX - playerX < ENEMY_WIDTH/2) && (playerX - targetX < ENEMY_WIDTH/2);
+    if (lined && !game->bullet.active && !(game->previousButtons & GALAXIAN_INPUT_FIRE)) buttons |= GALAXIAN_INPUT_FIRE;
+
+    return buttons;
+}
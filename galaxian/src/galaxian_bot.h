@@ -0,0 +1,11 @@
+#ifndef GALAXIAN_BOT_H
+#define GALAXIAN_BOT_H
+
+// Autoplayer policy for soak and performance runs (see bot.h): sweeps under the lowest enemy of the formation and
+// fires whenever it is lined up and the bullet is free
+
+#include "galaxian_sim.h"
+
+unsigned int GetGalaxianBotButtons(const GalaxianGame *game);   // Buttons a player would hold this tick
+
+#endif // GALAXIAN_BOT_H
@@ -0,0 +1,28 @@
+#include "galaxian_draw.h"
+#include "gameloop.h"
+
+void RecordGalaxian(DrawList *list, const GalaxianGame *game, const GalaxianGame *previous, float alpha)
+{
+    Rectangle player = InterpolateRectangle(previous->player, game->player, alpha, PLAYER_SPEED*2);
+
+    RecordClear(list, BLACK);
+
+    // Draw player
+    RecordRectangle(list, player, SKYBLUE);
+
+    // Draw bullet
+    if (game->bullet.active) {
+        Rectangle bullet = previous->bullet.active? InterpolateRectangle(previous->bullet.rect, game->bullet.rect, alpha, BULLET_SPEED*2) : game->bullet.rect;
+        RecordRectangle(list, bullet, YELLOW);
+    }
+
+    // Draw enemies
+    EcsIter it = IterateQuery(&game->world, game->enemies);
+    while (NextQueryChunk(&it)) {
+        const Rectangle *body = GetQueryColumn(&it, GALAXIAN_BODY);
+        for (int i = 0; i < it.count; i++) RecordRectangle(list, body[i], (Color){255, 0, 128, 255});
+    }
+
+    RecordTextFormat(list, 20, 20, 32, WHITE, "Score: %d", game->score);
+    RecordTextFormat(list, SCREEN_WIDTH - 160, 20, 32, WHITE, "Lives: %d", game->lives);
+}
@@ -0,0 +1,13 @@
+#ifndef GALAXIAN_DRAW_H
+#define GALAXIAN_DRAW_H
+
+// Galaxian's picture, recorded in a draw list: replayed to raylib by the game, rasterized on the CPU by
+// galaxian_headless --frames and the benchmarks
+
+#include "galaxian_sim.h"
+#include "drawlist.h"
+
+// Moving objects are drawn alpha of the way from previous to game (see gameloop.h), pass game twice for a tick as is
+void RecordGalaxian(DrawList *list, const GalaxianGame *game, const GalaxianGame *previous, float alpha);
+
+#endif // GALAXIAN_DRAW_H
@@ -0,0 +1,156 @@
+#include "galaxian_sim.h"
+#include "replay.h"
+#include "collision.h"
+
+static void PushEvent(GalaxianGame *game, GalaxianEventType type, Vector2 position);
+
+void InitGalaxian(GalaxianGame *game)
+{
+    EcsWorld *world = &game->world;
+    if (world->queryCount == 0) {
+        InitEcsWorld(world);
+        RegisterComponent(world, GALAXIAN_BODY, sizeof(Rectangle));
+        game->enemies = AddQuery(world, ECS_BIT(GALAXIAN_BODY), 0);
+    }
+
+    // Player
+    game->player.width = PLAYER_WIDTH;
+    game->player.height = PLAYER_HEIGHT;
+    game->player.x = (SCREEN_WIDTH - PLAYER_WIDTH) / 2;
+    game->player.y = SCREEN_HEIGHT - PLAYER_HEIGHT - 40;
+
+    // Bullet
+    game->bullet.active = false;
+
+    // Enemies
+    ClearEcsWorld(world);
+    for (int r = 0; r < ENEMY_ROWS; r++) {
+        for (int c = 0; c < ENEMY_COLS; c++) {
+            Rectangle *body = GetComponent(world, CreateEntity(world, ECS_BIT(GALAXIAN_BODY)), GALAXIAN_BODY);
+            body->x = 80 + c * (ENEMY_WIDTH + ENEMY_HORZ_SPACING);
+            body->y = 80 + r * (ENEMY_HEIGHT + ENEMY_VERT_SPACING);
+            body->width = ENEMY_WIDTH;
+            body->height = ENEMY_HEIGHT;
+        }
+    }
+    game->enemyDir = 1;
+    game->enemyMoveDown = 0;
+    game->score = 0;
+    game->lives = STARTING_LIVES;
+}
+
+void StepGalaxian(GalaxianGame *game, GalaxianInput input)
+{
+    Rectangle *player = &game->player;
+    Bullet *bullet = &game->bullet;
+    EcsWorld *world = &game->world;
+    unsigned int pressed = input.buttons & ~game->previousButtons;
+
+    game->previousButtons = input.buttons;
+    game->eventCount = 0;
+
+    // Player movement
+    if (input.buttons & GALAXIAN_INPUT_LEFT) player->x -= PLAYER_SPEED;
+    if (input.buttons & GALAXIAN_INPUT_RIGHT) player->x += PLAYER_SPEED;
+    if (player->x < 0) player->x = 0;
+    if (player->x > SCREEN_WIDTH - PLAYER_WIDTH) player->x = SCREEN_WIDTH - PLAYER_WIDTH;
+
+    // Shooting
+    if ((pressed & GALAXIAN_INPUT_FIRE) && !bullet->active) {
+        bullet->rect.x = player->x + PLAYER_WIDTH/2 - BULLET_WIDTH/2;
+        bullet->rect.y = player->y - BULLET_HEIGHT;
+        bullet->rect.width = BULLET_WIDTH;
+        bullet->rect.height = BULLET_HEIGHT;
+        bullet->active = true;
+        PushEvent(game, GALAXIAN_EVENT_SHOT, (Vector2){ bullet->rect.x, bullet->rect.y });
+    }
+
+    // Bullet movement
+    if (bullet->active) {
+        bullet->rect.y -= BULLET_SPEED;
+        if (bullet->rect.y + BULLET_HEIGHT < 0) bullet->active = false;
+    }
+
+    // Bullet-enemy collision
+    if (bullet->active) {
+        EcsIter it = IterateQuery(world, game->enemies);
+        while (NextQueryChunk(&it)) {
+            const Rectangle *body = GetQueryColumn(&it, GALAXIAN_BODY);
+            for (int i = 0; i < it.count; i++) {
+                if (OverlapRecs(bullet->rect, body[i])) {
+                    DestroyEntityLater(world, it.entities[i]);
+                    bullet->active = false;
+                    game->score += 100;
+                    PushEvent(game, GALAXIAN_EVENT_ENEMY_KILLED, (Vector2){ body[i].x, body[i].y });
+                }
+            }
+        }
+        FlushEcsWorld(world);
+    }
+
+    // Enemy-player collision (lose life)
+    EcsIter it = IterateQuery(world, game->enemies);
+    while (NextQueryChunk(&it)) {
+        const Rectangle *body = GetQueryColumn(&it, GALAXIAN_BODY);
+        for (int i = 0; i < it.count; i++) {
+            if (body[i].y + ENEMY_HEIGHT >= player->y) {
+                game->lives--;
+                PushEvent(game, GALAXIAN_EVENT_PLAYER_HIT, (Vector2){ player->x, player->y });
+                InitGalaxian(game);
+                return;
+            }
+        }
+    }
+
+    // Win condition: all enemies dead
+    if (CountQueryEntities(world, game->enemies) == 0) {
+        PushEvent(game, GALAXIAN_EVENT_WAVE_CLEARED, (Vector2){ player->x, player->y });
+        InitGalaxian(game);
+    }
+
+    // Lose condition
+    if (game->lives <= 0) {
+        InitGalaxian(game);
+    }
+}
+
+void PushEvent(GalaxianGame *game, GalaxianEventType type, Vector2 position)
+{
+    if (game->eventCount < GALAXIAN_MAX_EVENTS) game->events[game->eventCount++] = (GalaxianEvent){ type, position };
+}
+
+unsigned long long HashGalaxian(const GalaxianGame *game)
+{
+    unsigned long long hash = REPLAY_HASH_SEED;
+    hash = HashInt(hash, game->score);
+    hash = HashInt(hash, game->hiScore);
+    hash = HashInt(hash, game->lives);
+    hash = HashBytes(hash, &game->player, sizeof(Rectangle));
+    hash = HashInt(hash, game->bullet.active);
+    hash = HashBytes(hash, &game->bullet.rect, sizeof(Rectangle));
+    hash = HashInt(hash, game->enemyDir);
+    hash = HashInt(hash, game->enemyMoveDown);
+    hash = HashInt(hash, (int)game->previousButtons);
+
+    hash = HashInt(hash, CountQueryEntities(&game->world, game->enemies));
+    EcsIter it = IterateQuery(&game->world, game->enemies);
+    while (NextQueryChunk(&it)) {
+        const Rectangle *body = GetQueryColumn(&it, GALAXIAN_BODY);
+        hash = HashBytes(hash, body, it.count*sizeof(Rectangle));
+    }
+
+    return hash;
+}
+
+void CopyGalaxian(GalaxianGame *dst, const GalaxianGame *src)
+{
+    EcsWorld world = dst->world;        // Its chunks are reused
+    *dst = *src;
+    dst->world = world;
+    CopyEcsWorld(&dst->world, &src->world);
+}
+
+void UnloadGalaxian(GalaxianGame *game)
+{
+    UnloadEcsWorld(&game->world);
+}
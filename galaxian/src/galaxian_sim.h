@@ -0,0 +1,89 @@
+#ifndef GALAXIAN_SIM_H
+#define GALAXIAN_SIM_H
+
+// Galaxian simulation: game state and the per-tick step, with no window, input or audio calls.
+// Only the raylib.h types are used, so it also builds into the headless target. The enemies are entities of an ECS
+// world (see ecs.h), the game holds a heap: copy it with CopyGalaxian(), free it with UnloadGalaxian()
+
+#include "raylib.h"
+#include "ecs.h"
+
+#define SCREEN_WIDTH 720
+#define SCREEN_HEIGHT 900
+#define STARTING_LIVES 3
+
+#define PLAYER_WIDTH 48
+#define PLAYER_HEIGHT 32
+#define PLAYER_SPEED 6
+
+#define BULLET_WIDTH 4
+#define BULLET_HEIGHT 16
+#define BULLET_SPEED 12
+
+#define ENEMY_COLS 8
+#define ENEMY_ROWS 4
+#define ENEMY_WIDTH 40
+#define ENEMY_HEIGHT 32
+#define ENEMY_HORZ_SPACING 16
+#define ENEMY_VERT_SPACING 16
+#define ENEMY_SPEED 2
+
+#define GALAXIAN_MAX_EVENTS 16
+
+// Buttons held this tick, fire acts on the press
+enum {
+    GALAXIAN_INPUT_LEFT = 1,
+    GALAXIAN_INPUT_RIGHT = 2,
+    GALAXIAN_INPUT_FIRE = 4,
+    GALAXIAN_INPUT_ALL = 7
+};
+
+typedef struct {
+    unsigned int buttons;
+} GalaxianInput;
+
+typedef enum {
+    GALAXIAN_EVENT_SHOT = 0,
+    GALAXIAN_EVENT_ENEMY_KILLED,
+    GALAXIAN_EVENT_PLAYER_HIT,
+    GALAXIAN_EVENT_WAVE_CLEARED
+} GalaxianEventType;
+
+typedef struct {
+    GalaxianEventType type;
+    Vector2 position;
+} GalaxianEvent;
+
+typedef struct {
+    Rectangle rect;
+    bool active;
+} Bullet;
+
+// Components of the enemies
+enum {
+    GALAXIAN_BODY = 0                   // Rectangle
+};
+
+typedef struct {
+    int score;
+    int hiScore;
+    int lives;
+    Rectangle player;
+    Bullet bullet;
+    EcsWorld world;                 // The enemies
+    int enemies;                    // Query of the world
+    int enemyDir;
+    int enemyMoveDown;
+    unsigned int previousButtons;
+
+    GalaxianEvent events[GALAXIAN_MAX_EVENTS];
+    int eventCount;
+} GalaxianGame;
+
+void InitGalaxian(GalaxianGame *game);                            // New game, creates the world on first use
+void StepGalaxian(GalaxianGame *game, GalaxianInput input);       // One tick, events are replaced
+unsigned long long HashGalaxian(const GalaxianGame *game);        // For replays, see replay.h
+void CopyGalaxian(GalaxianGame *dst, const GalaxianGame *src);    // dst zeroed or a game, its world's memory is reused
+void UnloadGalaxian(GalaxianGame *game);
+
+#endif // GALAXIAN_SIM_H
@@ -0,0 +1,51 @@
+// Galaxian simulation without window or audio, on random, bot or replayed input: galaxian_headless [--ticks N] [--seed N] [--replay FILE]
+// (all options in headless.h). --frames DIR draws pictures of the game with the software rasterizer
+#define HEADLESS_IMPLEMENTATION
+#define REPLAY_IMPLEMENTATION
+#define COUNTERS_IMPLEMENTATION
+#define ECS_IMPLEMENTATION
+#define SOAK_IMPLEMENTATION
+#define DRAWLIST_IMPLEMENTATION
+#define SOFTRASTER_IMPLEMENTATION
+#include "headless.h"
+#include "galaxian_sim.h"
+#include "galaxian_bot.h"
+#include "galaxian_draw.h"
+#include "softraster.h"
+
+int main(int argc, char *argv[])
+{
+    HeadlessRun run;
+    static GalaxianGame game;
+    DrawList list = { 0 };
+    RasterFrame frame = { 0 };
+
+    if (!StartHeadlessRun(&run, argc, argv, "galaxian", 0)) return 1;
+    InitGalaxian(&game);
+    if (run.options.framesDir != NULL) {
+        InitJobSystem(0);
+        frame = LoadRasterFrame(SCREEN_WIDTH, SCREEN_HEIGHT);
+    }
+
+    while (run.tick < run.options.ticks) {
+        GalaxianInput input = { run.botting? NextHeadlessBotButtons(&run, GetGalaxianBotButtons(&game), GALAXIAN_INPUT_ALL) : NextHeadlessButtons(&run, GALAXIAN_INPUT_ALL) };
+        StepGalaxian(&game, input);
+        if (!EndHeadlessTick(&run, game.eventCount, run.hashing? HashGalaxian(&game) : 0)) break;
+
+        if (IsHeadlessFrameDue(&run)) {
+            ResetDrawList(&list);
+            RecordGalaxian(&list, &game, &game, 0.0f);
+            RasterizeDrawList(&frame, &list);
+            SaveRasterFrame(&frame, GetHeadlessFramePath(&run));
+        }
+    }
+
+    if (run.options.framesDir != NULL) {
+        UnloadRasterFrame(&frame);
+        UnloadDrawList(&list);
+        CloseJobSystem();
+    }
+
+    UnloadGalaxian(&game);
+    return FinishHeadlessRun(&run);
+}
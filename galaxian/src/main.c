@@ -1,195 +1,192 @@
 #include "raylib.h"
+#include "galaxian_sim.h"
+#include "galaxian_draw.h"
+#include "galaxian_bot.h"
+#include "bot.h"
+
+#define REPLAY_IMPLEMENTATION
+#include "replay.h"
+#define ECS_IMPLEMENTATION
+#include "ecs.h"
+#define PROFILER_GRAPH_IMPLEMENTATION
+#include "profiler.h"
+#define GAMELOOP_IMPLEMENTATION
+#include "gameloop.h"
+#define DRAWLIST_IMPLEMENTATION
+#define DRAWLIST_REPLAY_IMPLEMENTATION
+#include "drawlist.h"
+#define SOAK_IMPLEMENTATION
+#include "soak.h"
+#define PAK_LOADERS_IMPLEMENTATION
+#include "pak.h"
+#define ATLAS_IMPLEMENTATION
+#include "atlas.h"
+#define MIXER_IMPLEMENTATION
+#include "mixer.h"
+#define MUSIC_IMPLEMENTATION
+#include "music.h"
+#define ASSETS_IMPLEMENTATION
+#include "assets.h"
+#define STARTUP_IMPLEMENTATION
+#include "startup.h"
 #include <stdlib.h>
+#include <string.h>
 #include <stdbool.h>
 
-#define SCREEN_WIDTH 720
-#define SCREEN_HEIGHT 900
-#define STARTING_LIVES 3
-
-#define PLAYER_WIDTH 48
-#define PLAYER_HEIGHT 32
-#define PLAYER_SPEED 6
-
-#define BULLET_WIDTH 4
-#define BULLET_HEIGHT 16
-#define BULLET_SPEED 12
-
-#define ENEMY_COLS 8
-#define ENEMY_ROWS 4
-#define ENEMY_WIDTH 40
-#define ENEMY_HEIGHT 32
-#define ENEMY_HORZ_SPACING 16
-#define ENEMY_VERT_SPACING 16
-#define ENEMY_SPEED 2
-
-typedef struct {
-    Rectangle rect;
-    bool active;
-} Bullet;
-
-typedef struct {
-    Rectangle rect;
-    bool alive;
-} Enemy;
-
-static int score = 0;
-static int hiScore = 0;
-static int lives = STARTING_LIVES;
-
 Music music = { 0 };
-Sound sfxLaser = { 0 };
-
-static Rectangle player;
-static Bullet bullet = {0};
-static Enemy enemies[ENEMY_ROWS][ENEMY_COLS];
-static int enemyDir = 1;
-static int enemyMoveDown = 0;
+MixerSound sfxLaser = { 0 };
+
+static GalaxianGame game = { 0 };
+static GalaxianGame previous = { 0 };  // State of the tick before, drawing interpolates from it
+static GameLoop loop = { 0 };
+static FramePipeline pipeline = { 0 };
+static GalaxianInput input = { 0 };        // Read on the main thread, for the ticks of the frame being recorded
+static int frameTicks = 0;
+static float frameAlpha = 0.0f;
+static Replay replay = { 0 };      // This session, saved as galaxian.replay on exit for galaxian_headless --replay
+static int botSkill = -1;          // --bot SKILL, negative when the keyboard plays
+static Bot bot = { 0 };
+static Pak pak = { 0 };            // resources.pak, mapped until the music stream is unloaded
+static AssetCache assets = { 0 };  // Owns every asset loaded (see assets.h)
+static Startup startup = { 0 };
 
 static void InitGame(void);
-static void UpdateGame(void);
-static void DrawGame(void);
+static void ReadInput(void);
+static void RunFrame(void *user, DrawList *list);
+static void UpdateGame(DrawList *list);
+static void DrawGame(DrawList *list, float alpha);
+static void DrawFrame(void);
 static void UnloadGame(void);
 
-int main(void)
+int main(int argc, char *argv[])
 {
-    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "galaxian");
-    InitAudioDevice();    
-    music = LoadMusicStream("resources/background_music.ogg"); 
-    sfxLaser = LoadSound("resources/laser.wav");
-
-    SetMusicVolume(music, 1.0f);
-    PlayMusicStream(music);
+    // --profile FILE writes a Chrome trace of the session on exit, F3 shows the frame-time graph
+    // --bot SKILL plays by itself, 0 to 100 (see bot.h)
+    // --soak SECONDS ends the session after that long, --soak-log FILE logs its frame times and memory (see soak.h)
+    const char *profileFile = NULL, *soakLogFile = NULL;
+    double soakSeconds = 0.0;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--profile") == 0) profileFile = argv[++i];
+        else if (strcmp(argv[i], "--bot") == 0) botSkill = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--soak") == 0) soakSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--soak-log") == 0) soakLogFile = argv[++i];
+    }
+    InitProfiler(profileFile);
+
+    // Assets decode and the audio device starts while the window opens (see startup.h)
+    pak = LoadPak(TextFormat("%sresources.pak", GetApplicationDirectory()), "resources/");
+    InitAssetCache(&assets, &pak);
+    InitStartup(&startup, &assets);
+    AddStartupMusic(&startup, "background_music.ogg", &music, 1.0f);
+    AddStartupMixerSound(&startup, "laser.wav", &sfxLaser);
+    AddStartupMixer(&startup);
+    InitMusicPlayer();             // The music decodes on its own thread (see music.h)
+    BeginStartup(&startup, true);
 
+    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "galaxian");
+    MarkStartup(&startup, "window");
     InitGame();
-    SetTargetFPS(60);
+    MarkStartup(&startup, "game");
+    WaitStartup(&startup);
+    SetTargetFPS(GetMonitorRefreshRate(GetCurrentMonitor()));   // Draw at the display rate, the game ticks at GAMELOOP_TICK_RATE
+
+    SoakRun soak;
+    StartSoakRun(&soak, soakSeconds, soakLogFile);
 
-    while (!WindowShouldClose())
+    while (!WindowShouldClose() && UpdateSoakRun(&soak, GetTime()))
     {
-        UpdateGame();
-        DrawGame();
-        UpdateMusicStream(music);
+        ProfileFrame();
+        UpdateStartup(&startup);   // Uploads the assets decoded since the last frame
+        UpdateProfilerGraph();     // Once per frame, a frame can run no tick or several
+        ReadInput();
+        frameTicks = AdvanceGameLoop(&loop, GetTime());
+        frameAlpha = GetGameLoopAlpha(&loop);
+
+        StartPipelineFrame(&pipeline);      // The next frame updates and records on the worker...
+        DrawFrame();                        // ...while this one is drawn
+        UpdateMusicPlayer();
+        FinishPipelineFrame(&pipeline);
     }
 
     UnloadGame();
     CloseWindow();
+    CloseProfiler();
+    FinishSoakRun(&soak, "galaxian");
     return 0;
 }
 
 void InitGame(void)
 {
-    // Player
-    player.width = PLAYER_WIDTH;
-    player.height = PLAYER_HEIGHT;
-    player.x = (SCREEN_WIDTH - PLAYER_WIDTH) / 2;
-    player.y = SCREEN_HEIGHT - PLAYER_HEIGHT - 40;
-
-    // Bullet
-    bullet.active = false;
-
-    // Enemies
-    for (int r = 0; r < ENEMY_ROWS; r++) {
-        for (int c = 0; c < ENEMY_COLS; c++) {
-            enemies[r][c].rect.x = 80 + c * (ENEMY_WIDTH + ENEMY_HORZ_SPACING);
-            enemies[r][c].rect.y = 80 + r * (ENEMY_HEIGHT + ENEMY_VERT_SPACING);
-            enemies[r][c].rect.width = ENEMY_WIDTH;
-            enemies[r][c].rect.height = ENEMY_HEIGHT;
-            enemies[r][c].alive = true;
-        }
-    }
-    enemyDir = 1;
-    enemyMoveDown = 0;
-    score = 0;
-    lives = STARTING_LIVES;
+    InitGalaxian(&game);
+    InitReplay(&replay, "galaxian", 0, 0);
+    if (botSkill >= 0) InitBot(&bot, botSkill, (unsigned int)GetRandomValue(0, 0x7fffffff));
+    InitGameLoop(&loop, GAMELOOP_TICK_RATE, GAMELOOP_MAX_CATCH_UP);
+    InitFramePipeline(&pipeline, RunFrame, NULL);
 }
 
-void UpdateGame(void)
+void ReadInput(void)
 {
-    // Player movement
-    if (IsKeyDown(KEY_LEFT)) player.x -= PLAYER_SPEED;
-    if (IsKeyDown(KEY_RIGHT)) player.x += PLAYER_SPEED;
-    if (player.x < 0) player.x = 0;
-    if (player.x > SCREEN_WIDTH - PLAYER_WIDTH) player.x = SCREEN_WIDTH - PLAYER_WIDTH;
-
-    // Shooting
-    if (IsKeyPressed(KEY_SPACE) && !bullet.active) {
-        bullet.rect.x = player.x + PLAYER_WIDTH/2 - BULLET_WIDTH/2;
-        bullet.rect.y = player.y - BULLET_HEIGHT;
-        bullet.rect.width = BULLET_WIDTH;
-        bullet.rect.height = BULLET_HEIGHT;
-        bullet.active = true;
-        PlaySound(sfxLaser);
-    }
-
-    // Bullet movement
-    if (bullet.active) {
-        bullet.rect.y -= BULLET_SPEED;
-        if (bullet.rect.y + BULLET_HEIGHT < 0) bullet.active = false;
-    }
-
-    // Bullet-enemy collision
-    if (bullet.active) {
-        for (int r = 0; r < ENEMY_ROWS; r++) {
-            for (int c = 0; c < ENEMY_COLS; c++) {
-                if (enemies[r][c].alive && CheckCollisionRecs(bullet.rect, enemies[r][c].rect)) {
-                    enemies[r][c].alive = false;
-                    bullet.active = false;
-                    score += 100;
-                }
-            }
-        }
-    }
-
-    // Enemy-player collision (lose life)
-    for (int r = 0; r < ENEMY_ROWS; r++) {
-        for (int c = 0; c < ENEMY_COLS; c++) {
-            if (enemies[r][c].alive && enemies[r][c].rect.y + ENEMY_HEIGHT >= player.y) {
-                lives--;
-                InitGame();
-                return;
-            }
-        }
-    }
-
-    // Win condition: all enemies dead
-    bool allDead = true;
-    for (int r = 0; r < ENEMY_ROWS; r++)
-        for (int c = 0; c < ENEMY_COLS; c++)
-            if (enemies[r][c].alive) allDead = false;
-    if (allDead) InitGame();
-
-    // Lose condition
-    if (lives <= 0) {
-        InitGame();
-    }
+    ProfileBegin("input");
+    input = (GalaxianInput){ 0 };
+    if (IsKeyDown(KEY_LEFT)) input.buttons |= GALAXIAN_INPUT_LEFT;
+    if (IsKeyDown(KEY_RIGHT)) input.buttons |= GALAXIAN_INPUT_RIGHT;
+    if (IsKeyDown(KEY_SPACE)) input.buttons |= GALAXIAN_INPUT_FIRE;
+    ProfileEnd();
 }
 
-void DrawGame(void)
+// Worker side of the pipeline
+void RunFrame(void *user, DrawList *list)
 {
-    BeginDrawing();
-    ClearBackground(BLACK);
+    (void)user;
+    for (int i = 0; i < frameTicks; i++) UpdateGame(list);
+    DrawGame(list, frameAlpha);
+}
 
-    // Draw player
-    DrawRectangleRec(player, SKYBLUE);
+void UpdateGame(DrawList *list)
+{
+    GalaxianInput tickInput = input;
+    if (botSkill >= 0) tickInput.buttons = NextBotButtons(&bot, GetGalaxianBotButtons(&game), GALAXIAN_INPUT_ALL);  // Every tick, from the state it starts from
 
-    // Draw bullet
-    if (bullet.active) DrawRectangleRec(bullet.rect, YELLOW);
+    CopyGalaxian(&previous, &game);
+    PROFILE_ZONE("update") StepGalaxian(&game, tickInput);
+    RecordReplayTick(&replay, tickInput.buttons, HashGalaxian(&game));
 
-    // Draw enemies
-    for (int r = 0; r < ENEMY_ROWS; r++) {
-        for (int c = 0; c < ENEMY_COLS; c++) {
-            if (enemies[r][c].alive)
-                DrawRectangleRec(enemies[r][c].rect, (Color){255, 0, 128, 255});
-        }
+    for (int i = 0; i < game.eventCount; i++) {
+        if (game.events[i].type == GALAXIAN_EVENT_SHOT) RecordMixerSound(list, &sfxLaser, 0.6f, 0);   // Rapid fire overlaps (see mixer.h)
     }
+}
 
-    DrawText(TextFormat("Score: %d", score), 20, 20, 32, WHITE);
-    DrawText(TextFormat("Lives: %d", lives), SCREEN_WIDTH - 160, 20, 32, WHITE);
+void DrawGame(DrawList *list, float alpha)
+{
+    ProfileBegin("record");
+    RecordGalaxian(list, &game, &previous, alpha);
+    ProfileEnd();
+}
 
+// Main thread side: the frame recorded before, then the overlays
+void DrawFrame(void)
+{
+    ProfileBegin("draw");
+    BeginDrawing();
+    ReplayDrawList(GetPipelineFrame(&pipeline));
+    ProfileEnd();
+    DrawProfilerGraph(10, 100);
     EndDrawing();
 }
 
 void UnloadGame(void)
 {
-    UnloadMusicStream(music);
-    UnloadSound(sfxLaser);
-}
\ No newline at end of file
+    CloseFramePipeline(&pipeline);
+    CloseStartup(&startup);
+    CloseMixer();
+    CloseMusicPlayer();
+
+    LogAssetCache(&assets);
+    UnloadAssetCache(&assets);
+    UnloadPak(&pak);
+
+    SaveReplay(&replay, "galaxian.replay");
+    UnloadReplay(&replay);
+    UnloadGalaxian(&game);
+    UnloadGalaxian(&previous);
+}
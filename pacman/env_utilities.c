@@ -0,0 +1,8 @@
+// Implementations of the shared utilities for the pacman_env library, which has neither pacman.c nor
+// headless.c to carry them
+#define REPLAY_IMPLEMENTATION
+#define COUNTERS_IMPLEMENTATION
+#define VECENV_IMPLEMENTATION
+#include "replay.h"
+#include "counters.h"
+#include "vecenv.h"
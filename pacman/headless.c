@@ -0,0 +1,27 @@
+// Pacman simulation without window or audio, on random, bot or replayed input: pacman_headless [--ticks N] [--seed N] [--replay FILE]
+// (all options in headless.h)
+#define HEADLESS_IMPLEMENTATION
+#define REPLAY_IMPLEMENTATION
+#define COUNTERS_IMPLEMENTATION
+#define SOAK_IMPLEMENTATION
+#define PROFILER_IMPLEMENTATION
+#include "headless.h"
+#include "pacman_sim.h"
+#include "pacman_bot.h"
+
+int main(int argc, char *argv[])
+{
+    HeadlessRun run;
+    static PacmanGame game;
+
+    if (!StartHeadlessRun(&run, argc, argv, "pacman", 0)) return 1;
+    InitPacman(&game, run.options.seed);
+
+    while (run.tick < run.options.ticks) {
+        PacmanInput input = { run.botting? NextHeadlessBotButtons(&run, GetPacmanBotButtons(&game), PACMAN_INPUT_ALL) : NextHeadlessButtons(&run, PACMAN_INPUT_ALL) };
+        StepPacman(&game, input);
+        if (!EndHeadlessTick(&run, game.eventCount, run.hashing? HashPacman(&game) : 0)) break;
+    }
+
+    return FinishHeadlessRun(&run);
+}
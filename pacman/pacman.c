@@ -1,5 +1,36 @@
 #include "raylib.h"
+#include "pacman_sim.h"
+#include "pacman_bot.h"
+#include "bot.h"
+#define REPLAY_IMPLEMENTATION
+#include "replay.h"
+#define PROFILER_GRAPH_IMPLEMENTATION
+#include "profiler.h"
+#define COUNTERS_IMPLEMENTATION
+#define COUNTERS_OVERLAY_IMPLEMENTATION
+#include "counters.h"
+#define GAMELOOP_IMPLEMENTATION
+#include "gameloop.h"
+#define DRAWLIST_IMPLEMENTATION
+#define DRAWLIST_REPLAY_IMPLEMENTATION
+#include "drawlist.h"
+#define SOAK_IMPLEMENTATION
+#include "soak.h"
+#define PAK_LOADERS_IMPLEMENTATION
+#include "pak.h"
+#define ATLAS_IMPLEMENTATION
+#include "atlas.h"
+#define MIXER_IMPLEMENTATION
+#include "mixer.h"
+#define MUSIC_IMPLEMENTATION
+#include "music.h"
+#define ASSETS_IMPLEMENTATION
+#include "assets.h"
+#define STARTUP_IMPLEMENTATION
+#include "startup.h"
 #include "math.h"
+#include <stdlib.h>
+#include <string.h>
 
 #if defined(PLATFORM_WEB)
     #include <emscripten/emscripten.h>
@@ -8,396 +39,240 @@
 // Shared Variables Definition (global)
 Font font = { 0 };
 Music music = { 0 };
-Sound fxCoin = { 0 };
+MixerSound fxCoin = { 0 };
+Atlas atlas = { 0 };             // Every sprite, drawn in one batch
 
 static const int screenWidth = 800;
 static const int screenHeight = 1000;
 
-typedef struct {
-    Vector2 position;   
-    Vector2 direction;
-    float speed;
-    float radius; 
-    Texture2D sprite;
-} Pacman;
-
-typedef struct {
-    Vector2 position;
-    Vector2 direction;
-    float speed;
-    float radius;
-    Color color;
-} Ghost;
-
-Pacman InitPacman(float x, float y)
-{
-    Pacman p;
-    p.position = (Vector2){ x, y };
-    p.direction = (Vector2){ 0, 0 };
-    p.speed = 4.0f;
-    p.radius = 16.0f;
-    p.sprite = LoadTexture(RESOURCES_PATH"/pacman.png");
-    return p;
-}
-Pacman pacman;
-Vector2 desiredDirection = {0,0};
-
-#define MAZE_ROWS 31
-#define MAZE_COLS 28
-#define TILE_SIZE 28
-// 0 = empty, 1 = wall, 2 = pellet
-int maze[MAZE_ROWS][MAZE_COLS] = {
-    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
-    {1,2,2,2,2,2,2,2,2,2,2,2,2,1,1,2,2,2,2,2,2,2,2,2,2,2,2,1},
-    {1,2,1,1,1,1,2,1,1,1,1,1,2,1,1,2,1,1,1,1,1,2,1,1,1,1,2,1},
-    {1,2,1,1,1,1,2,1,1,1,1,1,2,1,1,2,1,1,1,1,1,2,1,1,1,1,2,1},
-    {1,2,1,1,1,1,2,1,1,1,1,1,2,1,1,2,1,1,1,1,1,2,1,1,1,1,2,1},
-    {1,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,1},
-    {1,2,1,1,1,1,2,1,1,2,1,1,1,1,1,1,1,1,2,1,1,2,1,1,1,1,2,1},
-    {1,2,1,1,1,1,2,1,1,2,1,1,1,1,1,1,1,1,2,1,1,2,1,1,1,1,2,1},
-    {1,2,2,2,2,2,2,1,1,2,2,2,2,1,1,2,2,2,2,1,1,2,2,2,2,2,2,1},
-    {1,1,1,1,1,1,2,1,1,1,1,1,0,1,1,0,1,1,1,1,1,2,1,1,1,1,1,1},
-    {0,0,0,0,0,1,2,1,1,1,1,1,0,1,1,0,1,1,1,1,1,2,1,0,0,0,0,0},
-    {0,0,0,0,0,1,2,1,1,0,0,0,0,0,0,0,0,0,0,1,1,2,1,0,0,0,0,0},
-    {0,0,0,0,0,1,2,1,1,0,1,1,1,0,0,1,1,1,0,1,1,2,1,0,0,0,0,0},
-    {1,1,1,1,1,1,2,1,1,0,1,0,0,0,0,0,0,1,0,1,1,2,1,1,1,1,1,1},
-    {0,0,0,0,0,0,2,0,0,0,1,0,0,0,0,0,0,1,0,0,0,2,0,0,0,0,0,0},
-    {1,1,1,1,1,1,2,1,1,0,1,0,0,0,0,0,0,1,0,1,1,2,1,1,1,1,1,1},
-    {0,0,0,0,0,1,2,1,1,0,1,1,1,1,1,1,1,1,0,1,1,2,1,0,0,0,0,0},
-    {0,0,0,0,0,1,2,1,1,0,0,0,0,0,0,0,0,0,0,1,1,2,1,0,0,0,0,0},
-    {0,0,0,0,0,1,2,1,1,0,1,1,1,1,1,1,1,1,0,1,1,2,1,0,0,0,0,0},
-    {1,1,1,1,1,1,2,1,1,0,1,1,1,1,1,1,1,1,0,1,1,2,1,1,1,1,1,1},
-    {1,2,2,2,2,2,2,2,2,2,2,2,2,1,1,2,2,2,2,2,2,2,2,2,2,2,2,1},
-    {1,2,1,1,1,1,2,1,1,1,1,1,2,1,1,2,1,1,1,1,1,2,1,1,1,1,2,1},
-    {1,2,1,1,1,1,2,1,1,1,1,1,2,1,1,2,1,1,1,1,1,2,1,1,1,1,2,1},
-    {1,2,2,2,1,1,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,1,1,2,2,2,1},
-    {1,1,1,2,1,1,2,1,1,2,1,1,1,1,1,1,1,1,2,1,1,2,1,1,2,1,1,1},
-    {1,1,1,2,1,1,2,1,1,2,1,1,1,1,1,1,1,1,2,1,1,2,1,1,2,1,1,1},
-    {1,2,2,2,2,2,2,1,1,2,2,2,2,1,1,2,2,2,2,1,1,2,2,2,2,2,2,1},
-    {1,2,1,1,1,1,1,1,1,1,1,1,2,1,1,2,1,1,1,1,1,1,1,1,1,1,2,1},
-    {1,2,1,1,1,1,1,1,1,1,1,1,2,1,1,2,1,1,1,1,1,1,1,1,1,1,2,1},
-    {1,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,1},
-    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
-};
-
-#define GHOST_COUNT 4
-Ghost ghosts[GHOST_COUNT];
-
-void InitGhosts() {
-    Color ghostColors[GHOST_COUNT] = { RED, GREEN, BLUE, MAGENTA };
-    for (int i = 0; i < GHOST_COUNT; i++) {
-        ghosts[i].position = (Vector2){ 14 * TILE_SIZE + TILE_SIZE/2, 14 * TILE_SIZE + TILE_SIZE/2 + i*10 };
-        ghosts[i].direction = (Vector2){ 0, -1 };
-        ghosts[i].speed = 3.0f;
-        ghosts[i].radius = 16.0f;
-        ghosts[i].color = ghostColors[i];
-    }
-}
+static PacmanGame game = { 0 };
+static PacmanGame previous = { 0 };    // State of the tick before, drawing interpolates from it
+static GameLoop loop = { 0 };
+static FramePipeline pipeline = { 0 };
+static PacmanInput input = { 0 };      // Read on the main thread, for the ticks of the frame being recorded
+static int frameTicks = 0;
+static float frameAlpha = 0.0f;
+static Replay replay = { 0 };      // This session, saved as pacman.replay on exit for pacman_headless --replay
+static Pak pak = { 0 };            // resources.pak, mapped until the music stream is unloaded
+static AssetCache assets = { 0 };  // Owns every asset loaded (see assets.h)
+static Startup startup = { 0 };
+static SpriteBatch batch = { 0 };
+static Rectangle pacmanSprite, ghostSprite, pelletSprite, wallSprite;
+static int botSkill = -1;          // --bot SKILL, negative when the keyboard plays
+static Bot bot = { 0 };
 
 // Local Functions Declaration
 static void UpdateDrawFrame(void);
-void UpdateGhosts();
+static void ReadInput(void);
+static void RunFrame(void *user, DrawList *list);
+static void UpdateGame(DrawList *list);
+static void DrawGame(DrawList *list, float alpha);
+static void DrawFrame(void);
 
-int main(void)
+int main(int argc, char *argv[])
 {
     // Initialization
     //---------------------------------------------------------
-    InitWindow(screenWidth, screenHeight, "Pacman");
-
-    InitAudioDevice();      // Initialize audio device
-
-    pacman = InitPacman(
-        20 * TILE_SIZE + TILE_SIZE /2, 
-        20 * TILE_SIZE + TILE_SIZE /2
-    );
-    
-    InitGhosts();
-
-    font = LoadFont("resources/mecha.png");
-    //music = LoadMusicStream("resources/ambient.ogg"); // TODO: Load music
-    fxCoin = LoadSound("resources/coin.wav");
+    // --profile FILE writes a Chrome trace of the session on exit, F3 shows the frame-time graph
+    // --counters FILE streams the workload counters of every frame (see counters.h), F4 shows them
+    // --bot SKILL plays by itself, 0 to 100 (see bot.h)
+    // --soak SECONDS ends the session after that long, --soak-log FILE logs its frame times and memory (see soak.h)
+    const char *profileFile = NULL, *countersFile = NULL, *soakLogFile = NULL;
+    double soakSeconds = 0.0;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--profile") == 0) profileFile = argv[++i];
+        else if (strcmp(argv[i], "--counters") == 0) countersFile = argv[++i];
+        else if (strcmp(argv[i], "--bot") == 0) botSkill = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--soak") == 0) soakSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--soak-log") == 0) soakLogFile = argv[++i];
+    }
+    InitProfiler(profileFile);
+    if (countersFile != NULL) OpenCounterStream(countersFile);
+
+    // Assets decode and the audio device starts while the window opens (see startup.h)
+    pak = LoadPak(TextFormat("%sresources.pak", GetApplicationDirectory()), RESOURCES_PATH);
+    InitAssetCache(&assets, &pak);
+    InitStartup(&startup, &assets);
+    AddStartupAtlas(&startup, "sprites", &atlas, true);
+    AddStartupFont(&startup, "mecha.png", &font, false);
+    //AddStartupMusic(&startup, "ambient.ogg", &music, 1.0f); // TODO: Load music
+    AddStartupMixerSound(&startup, "coin.wav", &fxCoin);
+    AddStartupMixer(&startup);
+    BeginStartup(&startup, true);
 
-    SetMusicVolume(music, 1.0f);
-    PlayMusicStream(music);
+    InitWindow(screenWidth, screenHeight, "Pacman");
+    MarkStartup(&startup, "window");
+
+    unsigned int seed = (unsigned int)GetRandomValue(0, 0x7fffffff);
+    InitPacman(&game, seed);
+    InitReplay(&replay, "pacman", seed, 0);
+    if (botSkill >= 0) InitBot(&bot, botSkill, seed);
+    InitGameLoop(&loop, GAMELOOP_TICK_RATE, GAMELOOP_MAX_CATCH_UP);
+    InitFramePipeline(&pipeline, RunFrame, NULL);
+    MarkStartup(&startup, "game");
+    WaitStartup(&startup);         // The sprites are drawn from the first frame
+    pacmanSprite = GetAtlasRegion(&atlas, "pacman");
+    ghostSprite = GetAtlasRegion(&atlas, "ghost");
+    pelletSprite = GetAtlasRegion(&atlas, "pellet");
+    wallSprite = GetAtlasWhite(&atlas);
 
 #if defined(PLATFORM_WEB)
-    emscripten_set_main_loop(UpdateDrawFrame, 60, 1);
+    emscripten_set_main_loop(UpdateDrawFrame, 0, 1);     // On requestAnimationFrame, the game ticks at GAMELOOP_TICK_RATE
 #else
-    SetTargetFPS(60);
+    SetTargetFPS(GetMonitorRefreshRate(GetCurrentMonitor()));   // Draw at the display rate, the game ticks at GAMELOOP_TICK_RATE
+
+    SoakRun soak;
+    StartSoakRun(&soak, soakSeconds, soakLogFile);
 
     // Main game loop
-    while (!WindowShouldClose())    // Detect window close button or ESC key
+    while (!WindowShouldClose() && UpdateSoakRun(&soak, GetTime()))    // Detect window close button or ESC key
     {
         UpdateDrawFrame();
     }
 #endif
 
+    CloseFramePipeline(&pipeline);
+    CloseStartup(&startup);
+    CloseMixer();
+
     // Unload global data loaded
-    UnloadFont(font);
-    UnloadMusicStream(music);
-    UnloadSound(fxCoin);
-    UnloadTexture(pacman.sprite); 
+    UnloadSpriteBatch(&batch);
+    LogAssetCache(&assets);
+    UnloadAssetCache(&assets);
+    UnloadPak(&pak);
+
+    SaveReplay(&replay, "pacman.replay");
+    UnloadReplay(&replay);
 
     CloseAudioDevice();     // Close audio context
     CloseWindow();          // Close window and OpenGL context
+    CloseProfiler();
+    CloseCounterStream();
+#if !defined(PLATFORM_WEB)
+    FinishSoakRun(&soak, "pacman");
+#endif
 
     return 0;
 }
 
 static void UpdateDrawFrame(void)
 {
-    // Update
-    //----------------------------------------------------------------------------------
     //UpdateMusicStream(music);       
-    
-    // Keyboard input for Pacman movement
-    if (IsKeyDown(KEY_RIGHT)) desiredDirection = (Vector2){ 1, 0 };
-    else if (IsKeyDown(KEY_LEFT)) desiredDirection = (Vector2){ -1, 0 };
-    else if (IsKeyDown(KEY_UP)) desiredDirection = (Vector2) { 0, -1 };
-    else if (IsKeyDown(KEY_DOWN)) desiredDirection = (Vector2) { 0, 1 };
-
-    Vector2 pacmanGridPos = {
-        (int)(pacman.position.x / TILE_SIZE),
-        (int)(pacman.position.y / TILE_SIZE)
-    };
-
-    if (pacmanGridPos.y >= 0 && pacmanGridPos.y < MAZE_ROWS && pacmanGridPos.x >= 0 && pacmanGridPos.x < MAZE_COLS) {
-        if (maze[(int)pacmanGridPos.y][(int)pacmanGridPos.x] == 2) {
-            maze[(int)pacmanGridPos.y][(int)pacmanGridPos.x] = 0; // Remove pellet
-            PlaySound(fxCoin);
-        }
-    }
+    ProfileFrame();
+    UpdateStartup(&startup);       // Uploads the assets decoded since the last frame
+    UpdateProfilerGraph();
+    UpdateCounterOverlay();
 
-    // Calculate center of current grid cell
-    Vector2 cellCenter = {
-        pacmanGridPos.x * TILE_SIZE + TILE_SIZE / 2.0f,
-        pacmanGridPos.y * TILE_SIZE + TILE_SIZE / 2.0f
-    };
+    ReadInput();
+    frameTicks = AdvanceGameLoop(&loop, GetTime());
+    frameAlpha = GetGameLoopAlpha(&loop);
 
-    // Calculate distance from Pacman to center of grid cell
-    float distToCenter = sqrtf(
-        (pacman.position.x - cellCenter.x) * (pacman.position.x - cellCenter.x) +
-        (pacman.position.y - cellCenter.y) * (pacman.position.y - cellCenter.y)
-    );
+    StartPipelineFrame(&pipeline);      // The next frame updates and records on the worker...
+    DrawFrame();                        // ...while this one is drawn
+    FinishPipelineFrame(&pipeline);
 
-    if(distToCenter <= 2.0)
-    {
-        // Check if the next cell in the desired direction is a wall
-        int nextRow = (int)pacmanGridPos.y + (int)desiredDirection.y;
-        int nextCol = (int)pacmanGridPos.x + (int)desiredDirection.x;
-        if (nextRow >= 0 && nextRow < MAZE_ROWS && nextCol >= 0 && nextCol < MAZE_COLS)
-        {
-            if (maze[nextRow][nextCol] != 1)
-            {
-                pacman.direction = desiredDirection;
-                pacman.position = cellCenter;
-            }
-            else
-            {
-                // Only stop if the wall is directly in front of Pacman's current direction
-                if ((int)desiredDirection.x == (int)pacman.direction.x && (int)desiredDirection.y == (int)pacman.direction.y)
-                {
-                    pacman.direction = (Vector2){0, 0};
-                }
-                // Otherwise, keep moving in the current direction
-            }
-        }
+    CounterFrame();
+}
 
-        else
-        {
-            pacman.direction = (Vector2){0, 0}; // Stop if out of bounds
-        }
-    }
+static void ReadInput(void)
+{
+    // Keyboard input for Pacman movement
+    ProfileBegin("input");
+    input = (PacmanInput){ 0 };
+    if (IsKeyDown(KEY_RIGHT)) input.buttons |= PACMAN_INPUT_RIGHT;
+    if (IsKeyDown(KEY_LEFT)) input.buttons |= PACMAN_INPUT_LEFT;
+    if (IsKeyDown(KEY_UP)) input.buttons |= PACMAN_INPUT_UP;
+    if (IsKeyDown(KEY_DOWN)) input.buttons |= PACMAN_INPUT_DOWN;
+    ProfileEnd();
+}
 
-    // Update Pacman's position
-    pacman.position.x += pacman.direction.x * pacman.speed;
-    pacman.position.y += pacman.direction.y * pacman.speed;
+// Worker side of the pipeline
+static void RunFrame(void *user, DrawList *list)
+{
+    (void)user;
+    for (int i = 0; i < frameTicks; i++) UpdateGame(list);
+    DrawGame(list, frameAlpha);
+}
 
-    UpdateGhosts();
+static void UpdateGame(DrawList *list)
+{
+    PacmanInput tickInput = input;
+    if (botSkill >= 0) tickInput.buttons = NextBotButtons(&bot, GetPacmanBotButtons(&game), PACMAN_INPUT_ALL);  // Every tick, from the state it starts from
 
+    previous = game;
+    PROFILE_ZONE("update") StepPacman(&game, tickInput);
+    RecordReplayTick(&replay, tickInput.buttons, HashPacman(&game));
 
-    // Draw
-    //----------------------------------------------------------------------------------
-    BeginDrawing();
-    ClearBackground(BLACK);
+    for (int i = 0; i < game.eventCount; i++) {
+        if (game.events[i].type == PACMAN_EVENT_PELLET_EATEN) RecordMixerSound(list, &fxCoin, 1.0f, 0);     // One voice per pellet (see mixer.h)
+    }
+}
+
+static void DrawGame(DrawList *list, float alpha)
+{
+    // A move longer than two tiles is the tunnel wrapping round, or a restart
+    const Pacman *pacman = &game.pacman;
+    Vector2 pacmanPosition = InterpolatePosition(previous.pacman.position, pacman->position, alpha, 2*TILE_SIZE);
 
-    // Draw Maze
+    ProfileBegin("record");
+    RecordClear(list, BLACK);
+
+    // Draw Maze: the maze on layer 0, the actors on layer 1, all from the atlas so the whole board is one draw
     for (int row = 0; row < MAZE_ROWS; row++)
     {
         for (int col = 0; col < MAZE_COLS; col++)
         {
-            int x = col * TILE_SIZE;
-            int y = row * TILE_SIZE;
-            if (maze[row][col] == 1)
-                DrawRectangle(x, y, TILE_SIZE, TILE_SIZE, DARKGRAY);
-            else if (maze[row][col] == 2)
-                DrawCircle(x + TILE_SIZE/2, y + TILE_SIZE/2, 4, WHITE);
+            float x = col * TILE_SIZE;
+            float y = row * TILE_SIZE;
+            if (game.maze[row][col] == 1)
+                AddSprite(&batch, 0, atlas.texture, wallSprite, (Rectangle){ x, y, TILE_SIZE, TILE_SIZE }, (Vector2){ 0, 0 }, 0.0f, DARKGRAY);
+            else if (game.maze[row][col] == 2)
+                AddSprite(&batch, 0, atlas.texture, pelletSprite,
+                    (Rectangle){ x + (TILE_SIZE - pelletSprite.width)/2, y + (TILE_SIZE - pelletSprite.height)/2, pelletSprite.width, pelletSprite.height },
+                    (Vector2){ 0, 0 }, 0.0f, WHITE);
         }
     }
 
     float scale = 0.3f;
-    float rotationAngle = atan2f(pacman.direction.y, pacman.direction.x) * (180.0f / PI);
+    float rotationAngle = atan2f(pacman->direction.y, pacman->direction.x) * (180.0f / PI);
     if (rotationAngle < 0) {
         rotationAngle += 360.0;
     }
 
-    // Use DrawTexturePro to rotate the sprite along its center
-    DrawTexturePro(
-        pacman.sprite,
-        (Rectangle) { 0, 0, pacman.sprite.width, pacman.sprite.height },
-        (Rectangle) { pacman.position.x, pacman.position.y, pacman.sprite.width* scale, pacman.sprite.height* scale }, 
-        (Vector2) { (pacman.sprite.width * scale) / 2, (pacman.sprite.height * scale) / 2 }, 
+    // Rotated along its center
+    AddSprite(
+        &batch,
+        1,
+        atlas.texture,
+        pacmanSprite,
+        (Rectangle) { pacmanPosition.x, pacmanPosition.y, pacmanSprite.width* scale, pacmanSprite.height* scale }, 
+        (Vector2) { (pacmanSprite.width * scale) / 2, (pacmanSprite.height * scale) / 2 }, 
         rotationAngle,
         WHITE
     );
 
-    // For debugging Pacman's position in the grid
-    /*if (distToCenter <= 2.0)
-    {
-        DrawRectangle((int)pacmanGridPos.x * TILE_SIZE, (int)pacmanGridPos.y * TILE_SIZE, TILE_SIZE, TILE_SIZE, RED);
-    }
-    else
-    {
-        DrawRectangle((int)pacmanGridPos.x * TILE_SIZE, (int)pacmanGridPos.y * TILE_SIZE, TILE_SIZE, TILE_SIZE, YELLOW);
-    }*/
-    
-    // For debugging:
-    // DrawText(TextFormat("Dist: %.2f", distToCenter), 10, 10, 20, WHITE);
-     
     // Draw Ghosts
     for (int i = 0; i < GHOST_COUNT; i++) {
-        DrawCircleV(ghosts[i].position, ghosts[i].radius, ghosts[i].color);
+        Vector2 position = InterpolatePosition(previous.ghosts[i].position, game.ghosts[i].position, alpha, 2*TILE_SIZE);
+        float radius = game.ghosts[i].radius;
+        AddSprite(&batch, 1, atlas.texture, ghostSprite, (Rectangle){ position.x, position.y, 2*radius, 2*radius },
+            (Vector2){ radius, radius }, 0.0f, game.ghosts[i].color);
     }
+    RecordSpriteBatch(list, &batch);
 
-    //DrawFPS(10, 10);
-
-    EndDrawing();
-    //----------------------------------------------------------------------------------
+    COUNT("draw calls", list->draws);
+    ProfileEnd();
 }
 
-void UpdateGhosts()
+// Main thread side: the frame recorded before, then the overlays
+static void DrawFrame(void)
 {
-    const float CHASE_DISTANCE = 200.0f; // Only chase if Pacman is within 200 pixels
-
-    // Update Ghosts
-    for (int i = 0; i < GHOST_COUNT; i++) 
-    {
-        // Get ghost's grid position
-        Vector2 ghostGridPos = {
-            (int)(ghosts[i].position.x / TILE_SIZE),
-            (int)(ghosts[i].position.y / TILE_SIZE)
-        };
-
-        // Calculate center of current grid cell
-        Vector2 cellCenter = {
-            ghostGridPos.x * TILE_SIZE + TILE_SIZE / 2.0f,
-            ghostGridPos.y * TILE_SIZE + TILE_SIZE / 2.0f
-        };
-
-        // Calculate distance from ghost to center of grid cell
-        float distToCenter = sqrtf(
-            (ghosts[i].position.x - cellCenter.x) * (ghosts[i].position.x - cellCenter.x) +
-            (ghosts[i].position.y - cellCenter.y) * (ghosts[i].position.y - cellCenter.y)
-        );
-
-        const float CHASE_DISTANCE = 200.0f;
-        Vector2 diff = {
-            pacman.position.x - ghosts[i].position.x,
-            pacman.position.y - ghosts[i].position.y
-        };
-        float distance = sqrtf(diff.x * diff.x + diff.y * diff.y);
-
-        if (distToCenter <= 2.0f) {
-            // Only pick a new direction when at the center of a tile
-            Vector2 newDir = ghosts[i].direction;
-
-            if (distance <= CHASE_DISTANCE) {
-                // --- BFS shortest path to Pacman ---
-                typedef struct { int x, y; } Point;
-                Point queue[MAZE_ROWS * MAZE_COLS];
-                int front = 0, back = 0;
-                int visited[MAZE_ROWS][MAZE_COLS] = {0};
-                Point prev[MAZE_ROWS][MAZE_COLS] = {0};
-
-                int startX = (int)ghostGridPos.x, startY = (int)ghostGridPos.y;
-                int goalX = (int)(pacman.position.x / TILE_SIZE), goalY = (int)(pacman.position.y / TILE_SIZE);
-
-                queue[back++] = (Point){startX, startY};
-                visited[startY][startX] = 1;
-
-                int found = 0;
-                while (front < back && !found) {
-                    Point cur = queue[front++];
-                    Point dirs[4] = { {1,0}, {-1,0}, {0,1}, {0,-1} };
-                    for (int d = 0; d < 4; d++) {
-                        int nx = cur.x + dirs[d].x, ny = cur.y + dirs[d].y;
-                        if (nx >= 0 && nx < MAZE_COLS && ny >= 0 && ny < MAZE_ROWS &&
-                            !visited[ny][nx] && maze[ny][nx] != 1) {
-                            queue[back++] = (Point){nx, ny};
-                            visited[ny][nx] = 1;
-                            prev[ny][nx] = cur;
-                            if (nx == goalX && ny == goalY) { found = 1; break; }
-                        }
-                    }
-                }
-                // Trace back from Pacman to ghost to find next step
-                if (visited[goalY][goalX]) {
-                    int cx = goalX, cy = goalY;
-                    Point before = {startX, startY};
-                    while (!(prev[cy][cx].x == startX && prev[cy][cx].y == startY)) {
-                        Point p = prev[cy][cx];
-                        cx = p.x; cy = p.y;
-                    }
-                    int dx = cx - startX, dy = cy - startY;
-                    newDir = (Vector2){ dx, dy };
-                } else {
-                    newDir = ghosts[i].direction; // fallback: keep current direction
-                }
-            } else {
-                // Move in a less random direction if Pacman is too far
-                Vector2 possibleDirs[4] = { {1,0}, {-1,0}, {0,1}, {0,-1} };
-                int validDirs[4] = {0};
-                int validCount = 0;
-                int currentDirIndex = -1;
-
-                // Check which directions are valid (not a wall)
-                for (int d = 0; d < 4; d++) {
-                    int testRow = (int)ghostGridPos.y + (int)possibleDirs[d].y;
-                    int testCol = (int)ghostGridPos.x + (int)possibleDirs[d].x;
-                    if (testRow >= 0 && testRow < MAZE_ROWS && testCol >= 0 && testCol < MAZE_COLS && maze[testRow][testCol] != 1) {
-                        validDirs[validCount++] = d;
-                        // Check if this is the current direction
-                        if ((int)ghosts[i].direction.x == (int)possibleDirs[d].x && (int)ghosts[i].direction.y == (int)possibleDirs[d].y) {
-                            currentDirIndex = d;
-                        }
-                    }
-                }
-
-                if (currentDirIndex != -1) {
-                    // Continue in the same direction if possible
-                    newDir = possibleDirs[currentDirIndex];
-                } else if (validCount > 0) {
-                    // Otherwise, pick a new direction (randomly, but less often)
-                    int choice = GetRandomValue(0, validCount - 1);
-                    newDir = possibleDirs[validDirs[choice]];
-                } else {
-                    newDir = (Vector2){ 0, 0 }; // No valid moves
-                }
-            }
-
-            // Check if the next cell in the chosen direction is a wall
-            int nextRow = (int)ghostGridPos.y + (int)newDir.y;
-            int nextCol = (int)ghostGridPos.x + (int)newDir.x;
-            if (nextRow >= 0 && nextRow < MAZE_ROWS && nextCol >= 0 && nextCol < MAZE_COLS && maze[nextRow][nextCol] != 1) {
-                ghosts[i].direction = newDir;
-                ghosts[i].position = cellCenter; // Snap to center
-            } else {
-                ghosts[i].direction = (Vector2){ 0, 0 }; // Stop if wall or out of bounds
-            }
-        }
+    ProfileBegin("draw");
+    BeginDrawing();
+    ReplayDrawList(GetPipelineFrame(&pipeline));
+    ProfileEnd();
+    DrawProfilerGraph(10, 10);
+    DrawCounterOverlay(screenWidth - 258, 10);
 
-        // Move ghost along the grid
-        ghosts[i].position.x += ghosts[i].direction.x * ghosts[i].speed;
-        ghosts[i].position.y += ghosts[i].direction.y * ghosts[i].speed;
-    }
+    EndDrawing();
 }
\ No newline at end of file
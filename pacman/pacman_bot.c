@@ -0,0 +1,52 @@
+#include "pacman_bot.h"
+
+typedef struct { int x, y; } Tile;
+
+unsigned int GetPacmanBotButtons(const PacmanGame *game)
+{
+    const int (*maze)[MAZE_COLS] = game->maze;
+    int startX = (int)(game->pacman.position.x/TILE_SIZE), startY = (int)(game->pacman.position.y/TILE_SIZE);
+    if (startX < 0 || startX >= MAZE_COLS || startY < 0 || startY >= MAZE_ROWS) return 0;
+
+    // Ghost tiles and their neighbours are walls for the search
+    unsigned char blocked[MAZE_ROWS][MAZE_COLS] = { 0 };
+    for (int i = 0; i < GHOST_COUNT; i++) {
+        int gx = (int)(game->ghosts[i].position.x/TILE_SIZE), gy = (int)(game->ghosts[i].position.y/TILE_SIZE);
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int tx = gx + dx, ty = gy + dy;
+                if ((dx != 0 && dy != 0) || tx < 0 || tx >= MAZE_COLS || ty < 0 || ty >= MAZE_ROWS) continue;
+                blocked[ty][tx] = 1;
+            }
+        }
+    }
+
+    // Breadth first from Pacman, each tile remembers the first step that led to it
+    static const Tile dirs[4] = { { 1, 0 }, { -1, 0 }, { 0, -1 }, { 0, 1 } };
+    static const unsigned int dirButtons[4] = { PACMAN_INPUT_RIGHT, PACMAN_INPUT_LEFT, PACMAN_INPUT_UP, PACMAN_INPUT_DOWN };
+    Tile queue[MAZE_ROWS*MAZE_COLS];
+    signed char firstStep[MAZE_ROWS][MAZE_COLS];
+    for (int row = 0; row < MAZE_ROWS; row++)
+        for (int col = 0; col < MAZE_COLS; col++) firstStep[row][col] = -1;
+
+    int front = 0, back = 0;
+    queue[back++] = (Tile){ startX, startY };
+    firstStep[startY][startX] = 4;
+
+    while (front < back) {
+        Tile tile = queue[front++];
+        for (int d = 0; d < 4; d++) {
+            int nx = tile.x + dirs[d].x, ny = tile.y + dirs[d].y;
+            if (nx < 0 || nx >= MAZE_COLS || ny < 0 || ny >= MAZE_ROWS) continue;
+            if (firstStep[ny][nx] >= 0 || maze[ny][nx] == 1 || blocked[ny][nx]) continue;
+
+            int step = (firstStep[tile.y][tile.x] == 4)? d : firstStep[tile.y][tile.x];
+            if (maze[ny][nx] == 2) return dirButtons[step];
+
+            firstStep[ny][nx] = (signed char)step;
+            queue[back++] = (Tile){ nx, ny };
+        }
+    }
+
+    return 0;   // No pellet left, or none reachable without passing a ghost
+}
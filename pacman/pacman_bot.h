@@ -0,0 +1,11 @@
+#ifndef PACMAN_BOT_H
+#define PACMAN_BOT_H
+
+// Autoplayer policy for soak and performance runs (see bot.h): heads for the nearest pellet through the maze,
+// around the tiles next to a ghost
+
+#include "pacman_sim.h"
+
+unsigned int GetPacmanBotButtons(const PacmanGame *game);   // Buttons a player would hold this tick
+
+#endif // PACMAN_BOT_H
@@ -0,0 +1,142 @@
+#include "pacman_env.h"
+#include <stdlib.h>
+#include <string.h>
+
+static void StartEpisode(PacmanEnv *env, int instance);
+static void WritePositions(PacmanEnv *env, int instance);
+static void MarkTiles(PacmanEnv *env, int instance, int amount);
+static void StepInstances(void *data, int first, int last);
+static void ResetInstances(void *data, int first, int last);
+
+PacmanEnv LoadPacmanEnv(int count, unsigned long long seed)
+{
+    PacmanEnv env = { 0 };
+    env.base = LoadVecEnv(count, seed, PACMAN_ENV_MAX_EPISODE_TICKS);
+    env.games = (PacmanGame *)calloc(count, sizeof(PacmanGame));
+    env.pelletsLeft = (int *)calloc(count, sizeof(int));
+    env.planes = (unsigned char *)calloc((size_t)count*PACMAN_ENV_PLANES*PACMAN_ENV_PLANE_SIZE, 1);
+    env.positions = (float *)calloc((size_t)count*PACMAN_ENV_POSITIONS*2, sizeof(float));
+
+    ResetPacmanEnv(&env);
+    return env;
+}
+
+void UnloadPacmanEnv(PacmanEnv *env)
+{
+    UnloadVecEnv(&env->base);
+    free(env->games);
+    free(env->pelletsLeft);
+    free(env->planes);
+    free(env->positions);
+    *env = (PacmanEnv){ 0 };
+}
+
+void ResetPacmanEnv(PacmanEnv *env)
+{
+    RunParallelFor(ResetInstances, env, env->base.count, VECENV_BATCH_SIZE);
+}
+
+void StepPacmanEnv(PacmanEnv *env)
+{
+    RunVecEnv(&env->base, StepInstances, env);
+}
+
+// New game and all of its planes
+void StartEpisode(PacmanEnv *env, int instance)
+{
+    PacmanGame *game = &env->games[instance];
+    unsigned char *planes = &env->planes[(size_t)instance*PACMAN_ENV_PLANES*PACMAN_ENV_PLANE_SIZE];
+
+    InitPacman(game, NextRandom(&env->base.rngs[instance]));
+
+    memset(planes, 0, PACMAN_ENV_PLANES*PACMAN_ENV_PLANE_SIZE);
+    int pellets = 0;
+    for (int row = 0; row < MAZE_ROWS; row++) {
+        for (int col = 0; col < MAZE_COLS; col++) {
+            planes[PACMAN_ENV_WALLS*PACMAN_ENV_PLANE_SIZE + row*MAZE_COLS + col] = (game->maze[row][col] == 1);
+            planes[PACMAN_ENV_PELLETS*PACMAN_ENV_PLANE_SIZE + row*MAZE_COLS + col] = (game->maze[row][col] == 2);
+            pellets += (game->maze[row][col] == 2);
+        }
+    }
+    env->pelletsLeft[instance] = pellets;
+
+    WritePositions(env, instance);
+    MarkTiles(env, instance, 1);
+}
+
+void WritePositions(PacmanEnv *env, int instance)
+{
+    const PacmanGame *game = &env->games[instance];
+    float *positions = &env->positions[(size_t)instance*PACMAN_ENV_POSITIONS*2];
+
+    positions[0] = game->pacman.position.x/TILE_SIZE;
+    positions[1] = game->pacman.position.y/TILE_SIZE;
+    for (int i = 0; i < GHOST_COUNT; i++) {
+        positions[2 + i*2] = game->ghosts[i].position.x/TILE_SIZE;
+        positions[3 + i*2] = game->ghosts[i].position.y/TILE_SIZE;
+    }
+}
+
+// Adds amount to the pacman and ghost planes at the tiles of the positions written last, so a step only
+// touches the tiles that change
+void MarkTiles(PacmanEnv *env, int instance, int amount)
+{
+    unsigned char *planes = &env->planes[(size_t)instance*PACMAN_ENV_PLANES*PACMAN_ENV_PLANE_SIZE];
+    const float *positions = &env->positions[(size_t)instance*PACMAN_ENV_POSITIONS*2];
+
+    for (int i = 0; i < PACMAN_ENV_POSITIONS; i++) {
+        int col = (int)positions[i*2], row = (int)positions[i*2 + 1];
+        if (row < 0 || row >= MAZE_ROWS || col < 0 || col >= MAZE_COLS) continue;     // In the side tunnel
+
+        int plane = (i == 0)? PACMAN_ENV_PACMAN : PACMAN_ENV_GHOSTS;
+        planes[plane*PACMAN_ENV_PLANE_SIZE + row*MAZE_COLS + col] += (unsigned char)amount;
+    }
+}
+
+void StepInstances(void *data, int first, int last)
+{
+    PacmanEnv *env = (PacmanEnv *)data;
+
+    for (int i = first; i < last; i++) {
+        PacmanGame *game = &env->games[i];
+        unsigned char *pellets = &env->planes[((size_t)i*PACMAN_ENV_PLANES + PACMAN_ENV_PELLETS)*PACMAN_ENV_PLANE_SIZE];
+
+        PacmanInput input = { env->base.actions[i] };
+        StepPacman(game, input);
+
+        for (int e = 0; e < game->eventCount; e++) {
+            if (game->events[e].type != PACMAN_EVENT_PELLET_EATEN) continue;
+            int col = (int)(game->events[e].position.x/TILE_SIZE), row = (int)(game->events[e].position.y/TILE_SIZE);
+            pellets[row*MAZE_COLS + col] = 0;
+        }
+        env->pelletsLeft[i] -= game->eventCount;
+
+        bool caught = false;
+        for (int g = 0; g < GHOST_COUNT; g++) {
+            float dx = game->ghosts[g].position.x - game->pacman.position.x, dy = game->ghosts[g].position.y - game->pacman.position.y;
+            if (dx*dx + dy*dy < game->pacman.radius*game->pacman.radius) caught = true;
+        }
+
+        bool terminal = caught || (env->pelletsLeft[i] <= 0);
+        if (EndVecEnvStep(&env->base, i, (float)game->eventCount, terminal)) StartEpisode(env, i);
+        else {
+            MarkTiles(env, i, -1);
+            WritePositions(env, i);
+            MarkTiles(env, i, 1);
+        }
+    }
+}
+
+void ResetInstances(void *data, int first, int last)
+{
+    PacmanEnv *env = (PacmanEnv *)data;
+
+    for (int i = first; i < last; i++) {
+        StartEpisode(env, i);
+        env->base.rewards[i] = 0.0f;
+        env->base.dones[i] = 0;
+        env->base.truncated[i] = 0;
+        env->base.episodeReturns[i] = 0.0f;
+        env->base.episodeTicks[i] = 0;
+    }
+}
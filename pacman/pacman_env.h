@@ -0,0 +1,39 @@
+#ifndef PACMAN_ENV_H
+#define PACMAN_ENV_H
+
+// Pacman as a vectorized environment (see vecenv.h): N games stepped in lockstep, observations in contiguous
+// arrays the caller reads in place. Actions are PACMAN_INPUT_* buttons, the reward is the pellets eaten.
+// The game itself never ends, so an episode ends when the maze is cleared or a ghost reaches pacman.
+// Every episode seeds its ghosts from the instance's own random stream
+
+#include "pacman_sim.h"
+#include "vecenv.h"
+
+#define PACMAN_ENV_MAX_EPISODE_TICKS 18000      // Five minutes at 60 ticks per second
+
+// Maze planes of an instance, a byte per tile
+enum {
+    PACMAN_ENV_WALLS = 0,                       // 1 for a wall
+    PACMAN_ENV_PELLETS,                         // 1 for a pellet
+    PACMAN_ENV_PACMAN,                          // 1 on pacman's tile
+    PACMAN_ENV_GHOSTS,                          // Ghosts on the tile
+    PACMAN_ENV_PLANES
+};
+
+#define PACMAN_ENV_PLANE_SIZE (MAZE_ROWS*MAZE_COLS)
+#define PACMAN_ENV_POSITIONS (1 + GHOST_COUNT)  // Pacman, then the ghosts
+
+typedef struct {
+    VecEnv base;                                // Actions in, rewards and dones out
+    PacmanGame *games;                          // [count]
+    int *pelletsLeft;                           // [count]
+    unsigned char *planes;                      // [count][PACMAN_ENV_PLANES][MAZE_ROWS][MAZE_COLS]
+    float *positions;                           // [count][PACMAN_ENV_POSITIONS][2], x and y in tiles
+} PacmanEnv;
+
+PacmanEnv LoadPacmanEnv(int count, unsigned long long seed);        // Every instance starts an episode
+void UnloadPacmanEnv(PacmanEnv *env);
+void ResetPacmanEnv(PacmanEnv *env);            // New episode for every instance, without a done flag
+void StepPacmanEnv(PacmanEnv *env);             // One tick of every instance on its action
+
+#endif // PACMAN_ENV_H
@@ -0,0 +1,305 @@
+#include "pacman_sim.h"
+#include "replay.h"
+#include "profiler.h"
+#include "counters.h"
+#include <math.h>
+
+static const int mazeLayout[MAZE_ROWS][MAZE_COLS] = {
+    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
+    {1,2,2,2,2,2,2,2,2,2,2,2,2,1,1,2,2,2,2,2,2,2,2,2,2,2,2,1},
+    {1,2,1,1,1,1,2,1,1,1,1,1,2,1,1,2,1,1,1,1,1,2,1,1,1,1,2,1},
+    {1,2,1,1,1,1,2,1,1,1,1,1,2,1,1,2,1,1,1,1,1,2,1,1,1,1,2,1},
+    {1,2,1,1,1,1,2,1,1,1,1,1,2,1,1,2,1,1,1,1,1,2,1,1,1,1,2,1},
+    {1,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,1},
+    {1,2,1,1,1,1,2,1,1,2,1,1,1,1,1,1,1,1,2,1,1,2,1,1,1,1,2,1},
+    {1,2,1,1,1,1,2,1,1,2,1,1,1,1,1,1,1,1,2,1,1,2,1,1,1,1,2,1},
+    {1,2,2,2,2,2,2,1,1,2,2,2,2,1,1,2,2,2,2,1,1,2,2,2,2,2,2,1},
+    {1,1,1,1,1,1,2,1,1,1,1,1,0,1,1,0,1,1,1,1,1,2,1,1,1,1,1,1},
+    {0,0,0,0,0,1,2,1,1,1,1,1,0,1,1,0,1,1,1,1,1,2,1,0,0,0,0,0},
+    {0,0,0,0,0,1,2,1,1,0,0,0,0,0,0,0,0,0,0,1,1,2,1,0,0,0,0,0},
+    {0,0,0,0,0,1,2,1,1,0,1,1,1,0,0,1,1,1,0,1,1,2,1,0,0,0,0,0},
+    {1,1,1,1,1,1,2,1,1,0,1,0,0,0,0,0,0,1,0,1,1,2,1,1,1,1,1,1},
+    {0,0,0,0,0,0,2,0,0,0,1,0,0,0,0,0,0,1,0,0,0,2,0,0,0,0,0,0},
+    {1,1,1,1,1,1,2,1,1,0,1,0,0,0,0,0,0,1,0,1,1,2,1,1,1,1,1,1},
+    {0,0,0,0,0,1,2,1,1,0,1,1,1,1,1,1,1,1,0,1,1,2,1,0,0,0,0,0},
+    {0,0,0,0,0,1,2,1,1,0,0,0,0,0,0,0,0,0,0,1,1,2,1,0,0,0,0,0},
+    {0,0,0,0,0,1,2,1,1,0,1,1,1,1,1,1,1,1,0,1,1,2,1,0,0,0,0,0},
+    {1,1,1,1,1,1,2,1,1,0,1,1,1,1,1,1,1,1,0,1,1,2,1,1,1,1,1,1},
+    {1,2,2,2,2,2,2,2,2,2,2,2,2,1,1,2,2,2,2,2,2,2,2,2,2,2,2,1},
+    {1,2,1,1,1,1,2,1,1,1,1,1,2,1,1,2,1,1,1,1,1,2,1,1,1,1,2,1},
+    {1,2,1,1,1,1,2,1,1,1,1,1,2,1,1,2,1,1,1,1,1,2,1,1,1,1,2,1},
+    {1,2,2,2,1,1,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,1,1,2,2,2,1},
+    {1,1,1,2,1,1,2,1,1,2,1,1,1,1,1,1,1,1,2,1,1,2,1,1,2,1,1,1},
+    {1,1,1,2,1,1,2,1,1,2,1,1,1,1,1,1,1,1,2,1,1,2,1,1,2,1,1,1},
+    {1,2,2,2,2,2,2,1,1,2,2,2,2,1,1,2,2,2,2,1,1,2,2,2,2,2,2,1},
+    {1,2,1,1,1,1,1,1,1,1,1,1,2,1,1,2,1,1,1,1,1,1,1,1,1,1,2,1},
+    {1,2,1,1,1,1,1,1,1,1,1,1,2,1,1,2,1,1,1,1,1,1,1,1,1,1,2,1},
+    {1,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,1},
+    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
+};
+
+static void InitGhosts(PacmanGame *game);
+static void UpdateGhosts(PacmanGame *game);
+
+void InitPacman(PacmanGame *game, unsigned int seed)
+{
+    for (int i = 0; i < GHOST_COUNT; i++) SeedRng(&game->ghostRng[i], seed, (unsigned int)i);
+    game->eventCount = 0;
+    game->desiredDirection = (Vector2){ 0, 0 };
+
+    for (int row = 0; row < MAZE_ROWS; row++)
+        for (int col = 0; col < MAZE_COLS; col++) game->maze[row][col] = mazeLayout[row][col];
+
+    Pacman *pacman = &game->pacman;
+    pacman->position = (Vector2){ 20 * TILE_SIZE + TILE_SIZE /2, 20 * TILE_SIZE + TILE_SIZE /2 };
+    pacman->direction = (Vector2){ 0, 0 };
+    pacman->speed = 4.0f;
+    pacman->radius = 16.0f;
+
+    InitGhosts(game);
+
+    // Ghosts only search while chasing, register their counters now so a CSV stream has them from the start
+#if !defined(COUNTERS_DISABLED)
+    GetCounterId("ghost searches");
+    GetCounterId("bfs nodes");
+#endif
+}
+
+void InitGhosts(PacmanGame *game)
+{
+    Color ghostColors[GHOST_COUNT] = { RED, GREEN, BLUE, MAGENTA };
+    for (int i = 0; i < GHOST_COUNT; i++) {
+        Ghost *ghost = &game->ghosts[i];
+        ghost->position = (Vector2){ 14 * TILE_SIZE + TILE_SIZE/2, 14 * TILE_SIZE + TILE_SIZE/2 + i*10 };
+        ghost->direction = (Vector2){ 0, -1 };
+        ghost->speed = 3.0f;
+        ghost->radius = 16.0f;
+        ghost->color = ghostColors[i];
+    }
+}
+
+void StepPacman(PacmanGame *game, PacmanInput input)
+{
+    Pacman *pacman = &game->pacman;
+    int (*maze)[MAZE_COLS] = game->maze;
+
+    game->eventCount = 0;
+
+    // Input for Pacman movement
+    if (input.buttons & PACMAN_INPUT_RIGHT) game->desiredDirection = (Vector2){ 1, 0 };
+    else if (input.buttons & PACMAN_INPUT_LEFT) game->desiredDirection = (Vector2){ -1, 0 };
+    else if (input.buttons & PACMAN_INPUT_UP) game->desiredDirection = (Vector2) { 0, -1 };
+    else if (input.buttons & PACMAN_INPUT_DOWN) game->desiredDirection = (Vector2) { 0, 1 };
+
+    Vector2 desiredDirection = game->desiredDirection;
+    Vector2 pacmanGridPos = {
+        (int)(pacman->position.x / TILE_SIZE),
+        (int)(pacman->position.y / TILE_SIZE)
+    };
+
+    if (pacmanGridPos.y >= 0 && pacmanGridPos.y < MAZE_ROWS && pacmanGridPos.x >= 0 && pacmanGridPos.x < MAZE_COLS) {
+        if (maze[(int)pacmanGridPos.y][(int)pacmanGridPos.x] == 2) {
+            maze[(int)pacmanGridPos.y][(int)pacmanGridPos.x] = 0; // Remove pellet
+            if (game->eventCount < PACMAN_MAX_EVENTS) game->events[game->eventCount++] = (PacmanEvent){ PACMAN_EVENT_PELLET_EATEN, pacman->position };
+        }
+    }
+
+    // Calculate center of current grid cell
+    Vector2 cellCenter = {
+        pacmanGridPos.x * TILE_SIZE + TILE_SIZE / 2.0f,
+        pacmanGridPos.y * TILE_SIZE + TILE_SIZE / 2.0f
+    };
+
+    // Calculate distance from Pacman to center of grid cell
+    float distToCenter = sqrtf(
+        (pacman->position.x - cellCenter.x) * (pacman->position.x - cellCenter.x) +
+        (pacman->position.y - cellCenter.y) * (pacman->position.y - cellCenter.y)
+    );
+
+    if(distToCenter <= 2.0)
+    {
+        // Check if the next cell in the desired direction is a wall
+        int nextRow = (int)pacmanGridPos.y + (int)desiredDirection.y;
+        int nextCol = (int)pacmanGridPos.x + (int)desiredDirection.x;
+        if (nextRow >= 0 && nextRow < MAZE_ROWS && nextCol >= 0 && nextCol < MAZE_COLS)
+        {
+            if (maze[nextRow][nextCol] != 1)
+            {
+                pacman->direction = desiredDirection;
+                pacman->position = cellCenter;
+            }
+            else
+            {
+                // Only stop if the wall is directly in front of Pacman's current direction
+                if ((int)desiredDirection.x == (int)pacman->direction.x && (int)desiredDirection.y == (int)pacman->direction.y)
+                {
+                    pacman->direction = (Vector2){0, 0};
+                }
+                // Otherwise, keep moving in the current direction
+            }
+        }
+
+        else
+        {
+            pacman->direction = (Vector2){0, 0}; // Stop if out of bounds
+        }
+    }
+
+    // Update Pacman's position
+    pacman->position.x += pacman->direction.x * pacman->speed;
+    pacman->position.y += pacman->direction.y * pacman->speed;
+
+    PROFILE_ZONE("ai") UpdateGhosts(game);
+}
+
+void UpdateGhosts(PacmanGame *game)
+{
+    const Pacman *pacman = &game->pacman;
+    Ghost *ghosts = game->ghosts;
+    int (*maze)[MAZE_COLS] = game->maze;
+
+    // Update Ghosts
+    for (int i = 0; i < GHOST_COUNT; i++) 
+    {
+        // Get ghost's grid position
+        Vector2 ghostGridPos = {
+            (int)(ghosts[i].position.x / TILE_SIZE),
+            (int)(ghosts[i].position.y / TILE_SIZE)
+        };
+
+        // Calculate center of current grid cell
+        Vector2 cellCenter = {
+            ghostGridPos.x * TILE_SIZE + TILE_SIZE / 2.0f,
+            ghostGridPos.y * TILE_SIZE + TILE_SIZE / 2.0f
+        };
+
+        // Calculate distance from ghost to center of grid cell
+        float distToCenter = sqrtf(
+            (ghosts[i].position.x - cellCenter.x) * (ghosts[i].position.x - cellCenter.x) +
+            (ghosts[i].position.y - cellCenter.y) * (ghosts[i].position.y - cellCenter.y)
+        );
+
+        const float CHASE_DISTANCE = 200.0f; // Only chase if Pacman is within 200 pixels
+        Vector2 diff = {
+            pacman->position.x - ghosts[i].position.x,
+            pacman->position.y - ghosts[i].position.y
+        };
+        float distance = sqrtf(diff.x * diff.x + diff.y * diff.y);
+
+        if (distToCenter <= 2.0f) {
+            // Only pick a new direction when at the center of a tile
+            Vector2 newDir = ghosts[i].direction;
+
+            if (distance <= CHASE_DISTANCE) {
+                int goalX = (int)(pacman->position.x / TILE_SIZE), goalY = (int)(pacman->position.y / TILE_SIZE);
+                if (!FindGhostStep(game, (int)ghostGridPos.x, (int)ghostGridPos.y, goalX, goalY, &newDir)) {
+                    newDir = ghosts[i].direction; // fallback: keep current direction
+                }
+            } else {
+                // Move in a less random direction if Pacman is too far
+                Vector2 possibleDirs[4] = { {1,0}, {-1,0}, {0,1}, {0,-1} };
+                int validDirs[4] = {0};
+                int validCount = 0;
+                int currentDirIndex = -1;
+
+                // Check which directions are valid (not a wall)
+                for (int d = 0; d < 4; d++) {
+                    int testRow = (int)ghostGridPos.y + (int)possibleDirs[d].y;
+                    int testCol = (int)ghostGridPos.x + (int)possibleDirs[d].x;
+                    if (testRow >= 0 && testRow < MAZE_ROWS && testCol >= 0 && testCol < MAZE_COLS && maze[testRow][testCol] != 1) {
+                        validDirs[validCount++] = d;
+                        // Check if this is the current direction
+                        if ((int)ghosts[i].direction.x == (int)possibleDirs[d].x && (int)ghosts[i].direction.y == (int)possibleDirs[d].y) {
+                            currentDirIndex = d;
+                        }
+                    }
+                }
+
+                if (currentDirIndex != -1) {
+                    // Continue in the same direction if possible
+                    newDir = possibleDirs[currentDirIndex];
+                } else if (validCount > 0) {
+                    // Otherwise, pick a new direction (randomly, but less often)
+                    int choice = RandomRange(&game->ghostRng[i], 0, validCount - 1);
+                    newDir = possibleDirs[validDirs[choice]];
+                } else {
+                    newDir = (Vector2){ 0, 0 }; // No valid moves
+                }
+            }
+
+            // Check if the next cell in the chosen direction is a wall
+            int nextRow = (int)ghostGridPos.y + (int)newDir.y;
+            int nextCol = (int)ghostGridPos.x + (int)newDir.x;
+            if (nextRow >= 0 && nextRow < MAZE_ROWS && nextCol >= 0 && nextCol < MAZE_COLS && maze[nextRow][nextCol] != 1) {
+                ghosts[i].direction = newDir;
+                ghosts[i].position = cellCenter; // Snap to center
+            } else {
+                ghosts[i].direction = (Vector2){ 0, 0 }; // Stop if wall or out of bounds
+            }
+        }
+
+        // Move ghost along the grid
+        ghosts[i].position.x += ghosts[i].direction.x * ghosts[i].speed;
+        ghosts[i].position.y += ghosts[i].direction.y * ghosts[i].speed;
+    }
+}
+
+// BFS shortest path through the maze, direction of its first step from start into *direction.
+// False when there is no path to follow: goal in the start tile, unreachable or off the grid in the tunnel
+bool FindGhostStep(const PacmanGame *game, int startX, int startY, int goalX, int goalY, Vector2 *direction)
+{
+    const int (*maze)[MAZE_COLS] = game->maze;
+
+    typedef struct { int x, y; } Point;
+    Point queue[MAZE_ROWS * MAZE_COLS];
+    int front = 0, back = 0;
+    int visited[MAZE_ROWS][MAZE_COLS] = {0};
+    Point prev[MAZE_ROWS][MAZE_COLS] = {0};
+
+    if (startX < 0 || startX >= MAZE_COLS || startY < 0 || startY >= MAZE_ROWS) return false;
+    COUNT("ghost searches", 1);
+
+    queue[back++] = (Point){startX, startY};
+    visited[startY][startX] = 1;
+
+    int found = 0;
+    while (front < back && !found) {
+        Point cur = queue[front++];
+        Point dirs[4] = { {1,0}, {-1,0}, {0,1}, {0,-1} };
+        for (int d = 0; d < 4; d++) {
+            int nx = cur.x + dirs[d].x, ny = cur.y + dirs[d].y;
+            if (nx >= 0 && nx < MAZE_COLS && ny >= 0 && ny < MAZE_ROWS &&
+                !visited[ny][nx] && maze[ny][nx] != 1) {
+                queue[back++] = (Point){nx, ny};
+                visited[ny][nx] = 1;
+                prev[ny][nx] = cur;
+                if (nx == goalX && ny == goalY) { found = 1; break; }
+            }
+        }
+    }
+    COUNT("bfs nodes", front);
+
+    // Trace back from the goal to find the step out of start
+    bool goalOnGrid = (goalX >= 0 && goalX < MAZE_COLS && goalY >= 0 && goalY < MAZE_ROWS);
+    if (!goalOnGrid || (goalX == startX && goalY == startY) || !visited[goalY][goalX]) return false;
+
+    int cx = goalX, cy = goalY;
+    while (!(prev[cy][cx].x == startX && prev[cy][cx].y == startY)) {
+        Point p = prev[cy][cx];
+        cx = p.x; cy = p.y;
+    }
+    *direction = (Vector2){ cx - startX, cy - startY };
+    return true;
+}
+
+unsigned long long HashPacman(const PacmanGame *game)
+{
+    // Floats, ints and colors only, none of these have padding
+    unsigned long long hash = REPLAY_HASH_SEED;
+    hash = HashBytes(hash, &game->pacman, sizeof(Pacman));
+    hash = HashBytes(hash, &game->desiredDirection, sizeof(Vector2));
+    hash = HashBytes(hash, game->maze, sizeof(game->maze));
+    hash = HashBytes(hash, game->ghosts, sizeof(game->ghosts));
+    hash = HashBytes(hash, game->ghostRng, sizeof(game->ghostRng));
+    return hash;
+}
@@ -0,0 +1,69 @@
+#ifndef PACMAN_SIM_H
+#define PACMAN_SIM_H
+
+// Pacman simulation: game state and the per-tick step, with no window, input or audio calls.
+// Only the raylib.h types are used, so it also builds into the headless target
+
+#include "raylib.h"
+#include "rng.h"
+
+#define MAZE_ROWS 31
+#define MAZE_COLS 28
+#define TILE_SIZE 28
+#define GHOST_COUNT 4
+#define PACMAN_MAX_EVENTS 8
+
+// Buttons held this tick
+enum {
+    PACMAN_INPUT_RIGHT = 1,
+    PACMAN_INPUT_LEFT = 2,
+    PACMAN_INPUT_UP = 4,
+    PACMAN_INPUT_DOWN = 8,
+    PACMAN_INPUT_ALL = 15
+};
+
+typedef struct {
+    unsigned int buttons;
+} PacmanInput;
+
+typedef enum {
+    PACMAN_EVENT_PELLET_EATEN = 0
+} PacmanEventType;
+
+typedef struct {
+    PacmanEventType type;
+    Vector2 position;
+} PacmanEvent;
+
+typedef struct {
+    Vector2 position;   
+    Vector2 direction;
+    float speed;
+    float radius; 
+} Pacman;
+
+typedef struct {
+    Vector2 position;
+    Vector2 direction;
+    float speed;
+    float radius;
+    Color color;
+} Ghost;
+
+typedef struct {
+    Pacman pacman;
+    Vector2 desiredDirection;
+    int maze[MAZE_ROWS][MAZE_COLS];     // 0 = empty, 1 = wall, 2 = pellet
+    Ghost ghosts[GHOST_COUNT];
+    Rng ghostRng[GHOST_COUNT];          // Wandering turns, a stream per ghost
+
+    PacmanEvent events[PACMAN_MAX_EVENTS];
+    int eventCount;
+} PacmanGame;
+
+void InitPacman(PacmanGame *game, unsigned int seed);     // New game
+void StepPacman(PacmanGame *game, PacmanInput input);     // One tick, events are replaced
+unsigned long long HashPacman(const PacmanGame *game);    // For replays, see replay.h
+bool FindGhostStep(const PacmanGame *game, int startX, int startY, int goalX, int goalY, Vector2 *direction);   // Ghost chase path, first step
+
+#endif // PACMAN_SIM_H
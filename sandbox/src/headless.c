@@ -0,0 +1,30 @@
+// Sandbox simulation without window or audio, on random or replayed input: sandbox_headless [--ticks N] [--seed N] [--replay FILE]
+// (all options in headless.h). The simulation's log goes to sandbox_headless.log, stdout only gets the report
+#define HEADLESS_IMPLEMENTATION
+#define REPLAY_IMPLEMENTATION
+#define COUNTERS_IMPLEMENTATION
+#define SOAK_IMPLEMENTATION
+#include "headless.h"
+#include "sandbox_sim.h"
+#include "logger.h"
+
+int main(int argc, char *argv[])
+{
+    HeadlessRun run;
+    static SandboxGame game;
+
+    if (!StartHeadlessRun(&run, argc, argv, "sandbox", 0)) return 1;
+    InitLogger("sandbox_headless.log");
+    InitSandbox(&game);
+
+    while (run.tick < run.options.ticks) {
+        SandboxInput input = { NextHeadlessButtons(&run, SANDBOX_INPUT_ALL) };
+        StepSandbox(&game, input);
+        if (!EndHeadlessTick(&run, game.eventCount, run.hashing? HashSandbox(&game) : 0)) break;
+    }
+
+    UnloadSandbox(&game);
+    CloseLogger();
+
+    return FinishHeadlessRun(&run);
+}
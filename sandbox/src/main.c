@@ -1,213 +1,189 @@
 #include "raylib.h"
 #include <stdlib.h>
 #include <stdbool.h>
-
-#define SCREEN_WIDTH 720
-#define SCREEN_HEIGHT 900
-#define STARTING_LIVES 3
-
-#define PLAYER_WIDTH 48
-#define PLAYER_HEIGHT 32
-#define PLAYER_SPEED 6
-
-#define BULLET_WIDTH 4
-#define BULLET_HEIGHT 16
-#define BULLET_SPEED 12
-
-#define ENEMY_WIDTH 40
-#define ENEMY_HEIGHT 32
-#define ENEMY_SPEED 20
-
-typedef struct {
-    Rectangle rect;
-    bool active;
-} Bullet;
-
-typedef struct {
-    Rectangle rect;
-    bool alive;
-    bool isAttacking;
-} Enemy;
-
-typedef struct Timer {
-    double startTime;   // Start time (seconds)
-    double lifeTime;    // Lifetime (seconds)
-} Timer;
-
-static int score = 0;
-static int hiScore = 0;
-static int lives = STARTING_LIVES;
+#include <string.h>
+
+#include "sandbox_sim.h"
+#include "logger.h"
+
+#define REPLAY_IMPLEMENTATION
+#include "replay.h"
+#define PROFILER_GRAPH_IMPLEMENTATION
+#include "profiler.h"
+#define GAMELOOP_IMPLEMENTATION
+#include "gameloop.h"
+#define DRAWLIST_IMPLEMENTATION
+#define DRAWLIST_REPLAY_IMPLEMENTATION
+#include "drawlist.h"
+#define PAK_LOADERS_IMPLEMENTATION
+#include "pak.h"
+#define ATLAS_IMPLEMENTATION
+#include "atlas.h"
+#define MIXER_IMPLEMENTATION
+#include "mixer.h"
+#define MUSIC_IMPLEMENTATION
+#include "music.h"
+#define ASSETS_IMPLEMENTATION
+#include "assets.h"
+#define STARTUP_IMPLEMENTATION
+#include "startup.h"
 
 Music music = { 0 };
-Sound sfxLaser = { 0 };
-
-static Rectangle player;
-static Bullet bullet = {0};
-static Enemy enemy = {0};
-static Timer timer = {0};
+MixerSound sfxLaser = { 0 };
+
+static SandboxGame game = { 0 };
+static SandboxGame previous = { 0 };   // State of the tick before, drawing interpolates from it
+static GameLoop loop = { 0 };
+static FramePipeline pipeline = { 0 };
+static SandboxInput input = { 0 };         // Read on the main thread, for the ticks of the frame being recorded
+static int frameTicks = 0;
+static float frameAlpha = 0.0f;
+static Replay replay = { 0 };      // This session, saved as sandbox.replay on exit for sandbox_headless --replay
+static Pak pak = { 0 };            // resources.pak, mapped until the music stream is unloaded
+static AssetCache assets = { 0 };  // Owns every asset loaded (see assets.h)
+static Startup startup = { 0 };
 
 static void InitGame(void);
-static void UpdateGame(void);
-static void DrawGame(void);
+static void ReadInput(void);
+static void RunFrame(void *user, DrawList *list);
+static void UpdateGame(DrawList *list);
+static void DrawGame(DrawList *list, float alpha);
+static void DrawFrame(void);
 static void UnloadGame(void);
-static void StartTimer(Timer *timer, double lifetime);
-static bool TimerDone(Timer timer);
 
-int main(void)
+int main(int argc, char *argv[])
 {
-    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "galaxian");
-    InitAudioDevice();    
-    music = LoadMusicStream("resources/background_music.ogg"); 
-    sfxLaser = LoadSound("resources/laser.wav");
-
-    SetMusicVolume(music, 1.0f);
-    PlayMusicStream(music);
+    // --profile FILE writes a Chrome trace of the session on exit, F3 shows the frame-time graph
+    const char *profileFile = NULL;
+    for (int i = 1; i + 1 < argc; i++) if (strcmp(argv[i], "--profile") == 0) profileFile = argv[++i];
+    InitProfiler(profileFile);
+
+    InitLogger(NULL);
+
+    // Assets decode and the audio device starts while the window opens (see startup.h)
+    pak = LoadPak(TextFormat("%sresources.pak", GetApplicationDirectory()), "resources/");
+    InitAssetCache(&assets, &pak);
+    InitStartup(&startup, &assets);
+    AddStartupMusic(&startup, "background_music.ogg", &music, 1.0f);
+    AddStartupMixerSound(&startup, "laser.wav", &sfxLaser);
+    AddStartupMixer(&startup);
+    InitMusicPlayer();             // The music decodes on its own thread (see music.h)
+    BeginStartup(&startup, true);
 
+    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "galaxian");
+    MarkStartup(&startup, "window");
     InitGame();
-    SetTargetFPS(60);
+    MarkStartup(&startup, "game");
+    WaitStartup(&startup);
+    SetTargetFPS(GetMonitorRefreshRate(GetCurrentMonitor()));   // Draw at the display rate, the game ticks at GAMELOOP_TICK_RATE
 
     while (!WindowShouldClose())
     {
-        UpdateGame();
-        DrawGame();
-        UpdateMusicStream(music);
+        ProfileFrame();
+        UpdateStartup(&startup);   // Uploads the assets decoded since the last frame
+        UpdateProfilerGraph();     // Once per frame, a frame can run no tick or several
+        ReadInput();
+        frameTicks = AdvanceGameLoop(&loop, GetTime());
+        frameAlpha = GetGameLoopAlpha(&loop);
+
+        StartPipelineFrame(&pipeline);      // The next frame updates and records on the worker...
+        DrawFrame();                        // ...while this one is drawn
+        UpdateMusicPlayer();
+        FinishPipelineFrame(&pipeline);
     }
 
     UnloadGame();
     CloseWindow();
+    CloseProfiler();
+    CloseLogger();
     return 0;
 }
 
 void InitGame(void)
 {
-    // Player
-    player.width = PLAYER_WIDTH;
-    player.height = PLAYER_HEIGHT;
-    player.x = (SCREEN_WIDTH - PLAYER_WIDTH) / 2;
-    player.y = SCREEN_HEIGHT - PLAYER_HEIGHT - 40;
-
-    // Bullet
-    bullet.active = false;
-
-    // Enemy - place in the middle of the screen
-    enemy.rect.width = ENEMY_WIDTH;
-    enemy.rect.height = ENEMY_HEIGHT;
-    enemy.rect.x = (SCREEN_WIDTH - ENEMY_WIDTH) / 2;
-    enemy.rect.y = SCREEN_HEIGHT / 2 - ENEMY_HEIGHT / 2;
-    enemy.alive = true;
-
-    StartTimer(&timer, 1.0f);
-
-    score = 0;
-    lives = STARTING_LIVES;
+    InitSandbox(&game);
+    InitReplay(&replay, "sandbox", 0, 0);
+    InitGameLoop(&loop, GAMELOOP_TICK_RATE, GAMELOOP_MAX_CATCH_UP);
+    InitFramePipeline(&pipeline, RunFrame, NULL);
 }
 
-void UpdateGame(void)
+void ReadInput(void)
 {
-    DrawText(TextFormat("Timer done: %s", TimerDone(timer) ? "true" : "false"), 20, 60, 32, WHITE);
-    if (TimerDone(timer))
-    {
-        // Move enemy along a curved path (arc up-right, then down-left)
-        if (enemy.alive) {
-            // Parameters for the curve
-            static float t = 0.0f;
-            const float curveDuration = 2.0f; // seconds for a full curve
-            const float arcRadius = 200.0f;
-            const float centerX = SCREEN_WIDTH / 2.0f;
-            const float centerY = SCREEN_HEIGHT / 2.0f;
-
-            t += GetFrameTime() / curveDuration;
-            
-            // Arc up-right (first half), then down-left (second half)
-            float angle;
-            if (t < 0.5f) {
-            // Move from bottom center, arc up and right (0.75pi to 0.25pi)
-            angle = Lerp(3.0f * PI / 4.0f, PI / 4.0f, t * 2.0f);
-            } else {
-            // Move from top right, arc down and left (0.25pi to 1.25pi)
-            angle = Lerp(PI / 4.0f, 5.0f * PI / 4.0f, (t - 0.5f) * 2.0f);
-            }
-
-            TraceLog(LOG_INFO, TextFormat("t: %.2f", angle));
-
-            enemy.rect.x = centerX + arcRadius * cosf(angle) - ENEMY_WIDTH / 2.0f;
-            enemy.rect.y = centerY + arcRadius * sinf(angle) - ENEMY_HEIGHT / 2.0f;
-
-            // If enemy reaches bottom of the screen, reset
-            if (enemy.rect.y > SCREEN_HEIGHT - ENEMY_HEIGHT) {
-            enemy.rect.x = (SCREEN_WIDTH - ENEMY_WIDTH) / 2;
-            enemy.rect.y = SCREEN_HEIGHT / 2 - ENEMY_HEIGHT / 2;
-            t = 0.0f;
-            StartTimer(&timer, 1.0f);
-            }
-        }
-    }
+    ProfileBegin("input");
+    input = (SandboxInput){ 0 };
+    if (IsKeyDown(KEY_LEFT)) input.buttons |= SANDBOX_INPUT_LEFT;
+    if (IsKeyDown(KEY_RIGHT)) input.buttons |= SANDBOX_INPUT_RIGHT;
+    if (IsKeyDown(KEY_SPACE)) input.buttons |= SANDBOX_INPUT_FIRE;
+    ProfileEnd();
+}
 
-    // Player movement
-    if (IsKeyDown(KEY_LEFT)) player.x -= PLAYER_SPEED;
-    if (IsKeyDown(KEY_RIGHT)) player.x += PLAYER_SPEED;
-    if (player.x < 0) player.x = 0;
-    if (player.x > SCREEN_WIDTH - PLAYER_WIDTH) player.x = SCREEN_WIDTH - PLAYER_WIDTH;
-
-    // Shooting
-    if (IsKeyPressed(KEY_SPACE) && !bullet.active) {
-        bullet.rect.x = player.x + PLAYER_WIDTH/2 - BULLET_WIDTH/2;
-        bullet.rect.y = player.y - BULLET_HEIGHT;
-        bullet.rect.width = BULLET_WIDTH;
-        bullet.rect.height = BULLET_HEIGHT;
-        bullet.active = true;
-        PlaySound(sfxLaser);
-    }
+// Worker side of the pipeline
+void RunFrame(void *user, DrawList *list)
+{
+    (void)user;
+    for (int i = 0; i < frameTicks; i++) UpdateGame(list);
+    DrawGame(list, frameAlpha);
+}
 
-    // Bullet movement
-    if (bullet.active) {
-        bullet.rect.y -= BULLET_SPEED;
-        if (bullet.rect.y + BULLET_HEIGHT < 0) bullet.active = false;
-    }
+void UpdateGame(DrawList *list)
+{
+    previous = game;
+    PROFILE_ZONE("update") StepSandbox(&game, input);
+    RecordReplayTick(&replay, input.buttons, HashSandbox(&game));
 
-    // Lose condition
-    if (lives <= 0) {
-        InitGame();
+    for (int i = 0; i < game.eventCount; i++) {
+        if (game.events[i].type == SANDBOX_EVENT_SHOT) RecordMixerSound(list, &sfxLaser, 0.6f, 0);   // Rapid fire overlaps (see mixer.h)
     }
 }
 
-void DrawGame(void)
+void DrawGame(DrawList *list, float alpha)
 {
-    BeginDrawing();
-    ClearBackground(BLACK);
+    Rectangle player = InterpolateRectangle(previous.player, game.player, alpha, PLAYER_SPEED*2);
+
+    ProfileBegin("record");
+    RecordClear(list, BLACK);
 
     // Draw player
-    DrawRectangleRec(player, SKYBLUE);
+    RecordRectangle(list, player, SKYBLUE);
 
     // Draw bullet
-    if (bullet.active) DrawRectangleRec(bullet.rect, YELLOW);
-
-    if (enemy.alive) DrawRectangleRec(enemy.rect, RED);
+    if (game.bullet.active) {
+        Rectangle bullet = previous.bullet.active? InterpolateRectangle(previous.bullet.rect, game.bullet.rect, alpha, BULLET_SPEED*2) : game.bullet.rect;
+        RecordRectangle(list, bullet, YELLOW);
+    }
 
-    DrawText(TextFormat("Score: %d", score), 20, 20, 32, WHITE);
-    DrawText(TextFormat("Lives: %d", lives), SCREEN_WIDTH - 160, 20, 32, WHITE);
+    if (game.enemy.alive) RecordRectangle(list, InterpolateRectangle(previous.enemy.rect, game.enemy.rect, alpha, ENEMY_SPEED*2), RED);
 
-    EndDrawing();
-}
+    RecordTextFormat(list, 20, 20, 32, WHITE, "Score: %d", game.score);
+    RecordTextFormat(list, SCREEN_WIDTH - 160, 20, 32, WHITE, "Lives: %d", game.lives);
+    RecordTextFormat(list, 20, 60, 32, WHITE, "Timer done: %s", game.enemyMoving ? "true" : "false");
 
-void UnloadGame(void)
-{
-    UnloadMusicStream(music);
-    UnloadSound(sfxLaser);
+    ProfileEnd();
 }
 
-void StartTimer(Timer *timer, double lifetime)
+// Main thread side: the frame recorded before, then the overlays
+void DrawFrame(void)
 {
-    timer->startTime = GetTime();
-    timer->lifeTime = lifetime;
+    ProfileBegin("draw");
+    BeginDrawing();
+    ReplayDrawList(GetPipelineFrame(&pipeline));
+    ProfileEnd();
+    DrawProfilerGraph(10, 100);
+    EndDrawing();
 }
 
-bool TimerDone(Timer timer)
+void UnloadGame(void)
 {
-    return GetTime() - timer.startTime >= timer.lifeTime;
+    CloseFramePipeline(&pipeline);
+    CloseStartup(&startup);
+    CloseMixer();
+    CloseMusicPlayer();
+
+    LogAssetCache(&assets);
+    UnloadAssetCache(&assets);
+    UnloadPak(&pak);
+    UnloadSandbox(&game);
+
+    SaveReplay(&replay, "sandbox.replay");
+    UnloadReplay(&replay);
 }
-
-double GetElapsed(Timer timer)
-{
-    return GetTime() - timer.startTime;
-}
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "sandbox_sim.h"
+#include "replay.h"
+#include <math.h>
+
+#define RAYMATH_STATIC_INLINE
+#include "raymath.h"
+
+#define TIMER_IMPLEMENTATION
+#include "timer.h"
+#include "logger.h"
+
+static void StartEnemyMoving(void *user, int tag);
+
+void InitSandbox(SandboxGame *game)
+{
+    // Player
+    game->player.width = PLAYER_WIDTH;
+    game->player.height = PLAYER_HEIGHT;
+    game->player.x = (SCREEN_WIDTH - PLAYER_WIDTH) / 2;
+    game->player.y = SCREEN_HEIGHT - PLAYER_HEIGHT - 40;
+
+    // Bullet
+    game->bullet.active = false;
+
+    // Enemy - place in the middle of the screen
+    game->enemy.rect.width = ENEMY_WIDTH;
+    game->enemy.rect.height = ENEMY_HEIGHT;
+    game->enemy.rect.x = (SCREEN_WIDTH - ENEMY_WIDTH) / 2;
+    game->enemy.rect.y = SCREEN_HEIGHT / 2 - ENEMY_HEIGHT / 2;
+    game->enemy.alive = true;
+
+    if (game->timers == NULL) game->timers = CreateTimerWheel(SANDBOX_TICK);
+    ClearTimerWheel(game->timers);
+    game->enemyMoving = false;
+    game->t = 0.0f;
+    ScheduleTimer(game->timers, 1.0, 0.0, StartEnemyMoving, game, 0);
+
+    game->score = 0;
+    game->lives = STARTING_LIVES;
+    game->previousButtons = 0;
+    game->eventCount = 0;
+}
+
+void StepSandbox(SandboxGame *game, SandboxInput input)
+{
+    Rectangle *player = &game->player;
+    Bullet *bullet = &game->bullet;
+    Enemy *enemy = &game->enemy;
+    unsigned int pressed = input.buttons & ~game->previousButtons;
+    game->previousButtons = input.buttons;
+    game->eventCount = 0;
+
+    AdvanceTimerWheel(game->timers, SANDBOX_TICK);
+
+    if (game->enemyMoving)
+    {
+        // Move enemy along a curved path (arc up-right, then down-left)
+        if (enemy->alive) {
+            // Parameters for the curve
+            const float curveDuration = 2.0f; // seconds for a full curve
+            const float arcRadius = 200.0f;
+            const float centerX = SCREEN_WIDTH / 2.0f;
+            const float centerY = SCREEN_HEIGHT / 2.0f;
+
+            game->t += (float)SANDBOX_TICK / curveDuration;
+
+            // Arc up-right (first half), then down-left (second half)
+            float angle;
+            if (game->t < 0.5f) {
+            // Move from bottom center, arc up and right (0.75pi to 0.25pi)
+            angle = Lerp(3.0f * PI / 4.0f, PI / 4.0f, game->t * 2.0f);
+            } else {
+            // Move from top right, arc down and left (0.25pi to 1.25pi)
+            angle = Lerp(PI / 4.0f, 5.0f * PI / 4.0f, (game->t - 0.5f) * 2.0f);
+            }
+
+            LogInfo("t: %.2f", angle);
+
+            enemy->rect.x = centerX + arcRadius * cosf(angle) - ENEMY_WIDTH / 2.0f;
+            enemy->rect.y = centerY + arcRadius * sinf(angle) - ENEMY_HEIGHT / 2.0f;
+
+            // If enemy reaches bottom of the screen, reset
+            if (enemy->rect.y > SCREEN_HEIGHT - ENEMY_HEIGHT) {
+            enemy->rect.x = (SCREEN_WIDTH - ENEMY_WIDTH) / 2;
+            enemy->rect.y = SCREEN_HEIGHT / 2 - ENEMY_HEIGHT / 2;
+            game->t = 0.0f;
+            game->enemyMoving = false;
+            ScheduleTimer(game->timers, 1.0, 0.0, StartEnemyMoving, game, 0);
+            }
+        }
+    }
+
+    // Player movement
+    if (input.buttons & SANDBOX_INPUT_LEFT) player->x -= PLAYER_SPEED;
+    if (input.buttons & SANDBOX_INPUT_RIGHT) player->x += PLAYER_SPEED;
+    if (player->x < 0) player->x = 0;
+    if (player->x > SCREEN_WIDTH - PLAYER_WIDTH) player->x = SCREEN_WIDTH - PLAYER_WIDTH;
+
+    // Shooting
+    if ((pressed & SANDBOX_INPUT_FIRE) && !bullet->active) {
+        bullet->rect.x = player->x + PLAYER_WIDTH/2 - BULLET_WIDTH/2;
+        bullet->rect.y = player->y - BULLET_HEIGHT;
+        bullet->rect.width = BULLET_WIDTH;
+        bullet->rect.height = BULLET_HEIGHT;
+        bullet->active = true;
+        if (game->eventCount < SANDBOX_MAX_EVENTS) game->events[game->eventCount++] = (SandboxEvent){ SANDBOX_EVENT_SHOT, (Vector2){ bullet->rect.x, bullet->rect.y } };
+    }
+
+    // Bullet movement
+    if (bullet->active) {
+        bullet->rect.y -= BULLET_SPEED;
+        if (bullet->rect.y + BULLET_HEIGHT < 0) bullet->active = false;
+    }
+
+    // Lose condition
+    if (game->lives <= 0) {
+        InitSandbox(game);
+    }
+}
+
+void UnloadSandbox(SandboxGame *game)
+{
+    DestroyTimerWheel(game->timers);
+    game->timers = NULL;
+}
+
+void StartEnemyMoving(void *user, int tag)
+{
+    SandboxGame *game = (SandboxGame *)user;
+    (void)tag;
+    game->enemyMoving = true;
+}
+
+unsigned long long HashSandbox(const SandboxGame *game)
+{
+    unsigned long long hash = REPLAY_HASH_SEED;
+    hash = HashInt(hash, game->score);
+    hash = HashInt(hash, game->lives);
+    hash = HashBytes(hash, &game->player, sizeof(Rectangle));
+    hash = HashInt(hash, game->bullet.active);
+    hash = HashBytes(hash, &game->bullet.rect, sizeof(Rectangle));
+    hash = HashInt(hash, game->enemy.alive);
+    hash = HashBytes(hash, &game->enemy.rect, sizeof(Rectangle));
+    hash = HashInt(hash, game->enemyMoving);
+    hash = HashFloat(hash, game->t);
+    hash = HashInt(hash, (int)game->previousButtons);
+
+    double timerTime = GetTimerWheelTime(game->timers);
+    hash = HashBytes(hash, &timerTime, sizeof(timerTime));
+    return hash;
+}
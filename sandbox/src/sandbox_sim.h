@@ -0,0 +1,83 @@
+#ifndef SANDBOX_SIM_H
+#define SANDBOX_SIM_H
+
+// Sandbox simulation: game state and the per-tick step, with no window, input or audio calls.
+// Only the raylib.h types are used, so it also builds into the headless target
+
+#include "raylib.h"
+#include "timer.h"
+
+#define SCREEN_WIDTH 720
+#define SCREEN_HEIGHT 900
+#define STARTING_LIVES 3
+
+#define PLAYER_WIDTH 48
+#define PLAYER_HEIGHT 32
+#define PLAYER_SPEED 6
+
+#define BULLET_WIDTH 4
+#define BULLET_HEIGHT 16
+#define BULLET_SPEED 12
+
+#define ENEMY_WIDTH 40
+#define ENEMY_HEIGHT 32
+#define ENEMY_SPEED 20
+
+#define SANDBOX_TICK (1.0/60.0)     // Seconds per step
+#define SANDBOX_MAX_EVENTS 8
+
+// Buttons held this tick
+enum {
+    SANDBOX_INPUT_LEFT = 1,
+    SANDBOX_INPUT_RIGHT = 2,
+    SANDBOX_INPUT_FIRE = 4,
+    SANDBOX_INPUT_ALL = 7
+};
+
+typedef struct {
+    unsigned int buttons;
+} SandboxInput;
+
+// What happened during the last step, for sounds and effects
+typedef enum {
+    SANDBOX_EVENT_SHOT = 0
+} SandboxEventType;
+
+typedef struct {
+    SandboxEventType type;
+    Vector2 position;
+} SandboxEvent;
+
+typedef struct {
+    Rectangle rect;
+    bool active;
+} Bullet;
+
+typedef struct {
+    Rectangle rect;
+    bool alive;
+    bool isAttacking;
+} Enemy;
+
+typedef struct {
+    int score;
+    int hiScore;
+    int lives;
+    Rectangle player;
+    Bullet bullet;
+    Enemy enemy;
+    TimerWheel *timers;
+    bool enemyMoving;
+    float t;                        // Progress along the enemy's curve, 0..1
+    unsigned int previousButtons;
+
+    SandboxEvent events[SANDBOX_MAX_EVENTS];
+    int eventCount;
+} SandboxGame;
+
+void InitSandbox(SandboxGame *game);                            // New game, creates the timer wheel on first use
+void StepSandbox(SandboxGame *game, SandboxInput input);        // One tick, events are replaced
+unsigned long long HashSandbox(const SandboxGame *game);        // For replays, see replay.h
+void UnloadSandbox(SandboxGame *game);
+
+#endif // SANDBOX_SIM_H
@@ -0,0 +1,27 @@
+// Space invaders simulation without window or audio, on random, bot or replayed input: space-invaders_headless [--ticks N] [--seed N] [--replay FILE]
+// (all options in headless.h)
+#define HEADLESS_IMPLEMENTATION
+#define REPLAY_IMPLEMENTATION
+#define COUNTERS_IMPLEMENTATION
+#define SOAK_IMPLEMENTATION
+#define PROFILER_IMPLEMENTATION
+#include "headless.h"
+#include "invaders_sim.h"
+#include "invaders_bot.h"
+
+int main(int argc, char *argv[])
+{
+    HeadlessRun run;
+    static InvadersGame game;
+
+    if (!StartHeadlessRun(&run, argc, argv, "space-invaders", 0)) return 1;
+    InitInvaders(&game);
+
+    while (run.tick < run.options.ticks) {
+        InvadersInput input = { run.botting? NextHeadlessBotButtons(&run, GetInvadersBotButtons(&game), INVADERS_INPUT_ALL) : NextHeadlessButtons(&run, INVADERS_INPUT_ALL) };
+        StepInvaders(&game, input);
+        if (!EndHeadlessTick(&run, game.eventCount, run.hashing? HashInvaders(&game) : 0)) break;
+    }
+
+    return FinishHeadlessRun(&run);
+}
@@ -0,0 +1,41 @@
+#include "invaders_bot.h"
+#include <stddef.h>
+
+unsigned int GetInvadersBotButtons(const InvadersGame *game)
+{
+    const Rectangle *player = &game->player.rec;
+
+    // Restart acts on the press, let go for a tick after each
+    if (game->gameOver) return (game->previousButtons & INVADERS_INPUT_RESTART)? 0 : INVADERS_INPUT_RESTART;
+    if (game->pause) return (game->previousButtons & INVADERS_INPUT_PAUSE)? 0 : INVADERS_INPUT_PAUSE;
+
+    const Enemy *target = NULL;
+    const Enemy *threat = NULL;
+    for (int i = 0; i < game->activeEnemies; i++) {
+        const Enemy *enemy = &game->enemy[i];
+        if (!enemy->active) continue;
+        if (target == NULL || enemy->rec.y > target->rec.y) target = enemy;
+
+        // Close above the ship and overlapping it sideways
+        bool above = (enemy->rec.y + enemy->rec.height > player->y - 2*player->height) && (enemy->rec.y < player->y + player->height);
+        bool across = (enemy->rec.x < player->x + player->width) && (enemy->rec.x + enemy->rec.width > player->x);
+        if (above && across) threat = enemy;
+    }
+    if (target == NULL) return 0;
+
+    // Shots leave from a quarter of the ship's width
+    float shotX = player->x + player->width/4;
+    unsigned int buttons = INVADERS_INPUT_FIRE;
+
+    if (threat != NULL) {
+        bool threatLeft = threat->rec.x + threat->rec.width/2 < player->x + player->width/2;
+        buttons |= threatLeft? INVADERS_INPUT_RIGHT : INVADERS_INPUT_LEFT;
+    }
+    else {
+        float targetX = target->rec.x + target->rec.width/2;
+        if (targetX < shotX - game->player.speed.x) buttons |= INVADERS_INPUT_LEFT;
+        else if (targetX > shotX + game->player.speed.x) buttons |= INVADERS_INPUT_RIGHT;
+    }
+
+    return buttons;
+}
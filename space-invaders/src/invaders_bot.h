@@ -0,0 +1,11 @@
+#ifndef INVADERS_BOT_H
+#define INVADERS_BOT_H
+
+// Autoplayer policy for soak and performance runs (see bot.h): sweeps under the lowest invader with fire held,
+// steps aside from invaders about to land on the ship, and restarts finished games
+
+#include "invaders_sim.h"
+
+unsigned int GetInvadersBotButtons(const InvadersGame *game);   // Buttons a player would hold this tick
+
+#endif // INVADERS_BOT_H
@@ -0,0 +1,259 @@
+#include "invaders_sim.h"
+#include "replay.h"
+#include "profiler.h"
+#include "counters.h"
+#include "collision.h"
+#include <math.h>
+
+static void PushEvent(InvadersGame *game, InvadersEventType type, Vector2 position);
+
+void InitInvaders(InvadersGame *game)
+{
+    Player *player = &game->player;
+
+    // Initialize game variables
+    game->shootRate = 0;
+    game->pause = false;
+    game->gameOver = false;
+    game->victory = false;
+    game->smooth = false;
+    game->activeEnemies = 50;
+    game->enemiesKill = 0;
+    game->score = 0;
+    game->alpha = 0;
+    game->direction = 1;
+    game->eventCount = 0;
+
+    // Initialize player
+    player->rec.x = screenWidth / 2;
+    player->rec.y = screenHeight - 50;
+    player->rec.width = 40;
+    player->rec.height = 40;
+    player->speed.x = 5;
+    player->speed.y = 5;
+    player->color = BLACK;
+
+    // Initialize enemies in a grid
+    for (int i = 0; i < GRID_WIDTH * GRID_HEIGHT; i++) {
+        Enemy *enemy = &game->enemy[i];
+        enemy->rec.width = 20;
+        enemy->rec.height = 20;
+
+        enemy->speed.x = 0.5;
+        enemy->speed.y = 0.5;
+        enemy->baseSpeed = 0.5;
+        enemy->active = true;
+        enemy->color = GRAY;
+
+        int row = i / GRID_WIDTH;
+        int col = i % GRID_WIDTH;
+        enemy->rec.x = col * GRID_SPACING_X + GRID_OFFSET_X;
+        enemy->rec.y = row * GRID_SPACING_Y + GRID_OFFSET_Y;
+    }
+
+    // Initialize shoots
+    for (int i = 0; i < NUM_SHOOTS; i++)
+    {
+        Shoot *shoot = &game->shoot[i];
+        shoot->rec.y = player->rec.y;
+        shoot->rec.x = player->rec.x + player->rec.width / 4;
+        shoot->rec.width = 5;
+        shoot->rec.height = 10;
+        shoot->speed.x = 0;
+        shoot->speed.y = 7;
+        shoot->active = false;
+        shoot->color = MAROON;
+    }
+}
+
+void StepInvaders(InvadersGame *game, InvadersInput input)
+{
+    Player *player = &game->player;
+    Enemy *enemy = game->enemy;
+    Shoot *shoot = game->shoot;
+    unsigned int pressed = input.buttons & ~game->previousButtons;
+
+    game->previousButtons = input.buttons;
+    game->eventCount = 0;
+
+    if (!game->gameOver)
+    {
+        if (pressed & INVADERS_INPUT_PAUSE) game->pause = !game->pause;
+
+        if (!game->pause)
+        {
+            // Player movement
+            if (input.buttons & INVADERS_INPUT_RIGHT) player->rec.x += player->speed.x;
+            if (input.buttons & INVADERS_INPUT_LEFT) player->rec.x -= player->speed.x;
+            if (input.buttons & INVADERS_INPUT_UP) player->rec.y -= player->speed.y;
+            if (input.buttons & INVADERS_INPUT_DOWN) player->rec.y += player->speed.y;
+
+            int pairs = 0;
+
+            // Player collision with enemy
+            pairs += game->activeEnemies;
+            for (int i = 0; i < game->activeEnemies; i++)
+            {
+                if (OverlapRecs(player->rec, enemy[i].rec))
+                {
+                    if (!game->gameOver) PushEvent(game, INVADERS_EVENT_PLAYER_HIT, (Vector2){ player->rec.x, player->rec.y });
+                    game->gameOver = true;
+                }
+            }
+
+            PROFILE_ZONE("ai") MoveInvaders(game);
+
+            // Wall behaviour
+            if (player->rec.x <= 0) player->rec.x = 0;
+            if (player->rec.x + player->rec.width >= screenWidth) player->rec.x = screenWidth - player->rec.width;
+            if (player->rec.y <= 0) player->rec.y = 0;
+            if (player->rec.y + player->rec.height >= screenHeight) player->rec.y = screenHeight - player->rec.height;
+
+            // Shoot initialization
+            if (input.buttons & INVADERS_INPUT_FIRE)
+            {
+                game->shootRate += 5;
+
+                for (int i = 0; i < NUM_SHOOTS; i++)
+                {
+                    if (!shoot[i].active && game->shootRate%20 == 0)
+                    {
+                        shoot[i].rec.x = player->rec.x + player->rec.width / 4;
+                        shoot[i].rec.y = player->rec.y;
+                        shoot[i].active = true;
+                        PushEvent(game, INVADERS_EVENT_SHOT, (Vector2){ shoot[i].rec.x, shoot[i].rec.y });
+                        break;
+                    }
+                }
+            }
+
+            // Shoot logic
+            for (int i = 0; i < NUM_SHOOTS; i++)
+            {
+                if (shoot[i].active)
+                {
+                    // Movement
+                    shoot[i].rec.y -= shoot[i].speed.y;
+
+                    // Collision with enemy
+                    for (int j = 0; j < game->activeEnemies; j++)
+                    {
+                        if (enemy[j].active)
+                        {
+                            pairs++;
+                            if (OverlapRecs(shoot[i].rec, enemy[j].rec))
+                            {
+                                PushEvent(game, INVADERS_EVENT_ENEMY_KILLED, (Vector2){ enemy[j].rec.x, enemy[j].rec.y });
+                                shoot[i].active = false;
+                                enemy[j].active = false;
+                                enemy[j].rec.x = 0;
+                                enemy[j].rec.y = 0;
+                                game->shootRate = 0;
+                                game->enemiesKill++;
+                                game->score += 100;
+
+                                // Adjust all enemies' speed for every enemy killed
+                                for (int k = 0; k < game->activeEnemies; k++)
+                                {
+                                    enemy[k].speed.x = enemy[k].baseSpeed * (1 + pow(((game->enemiesKill * 2.0f) / NUM_MAX_ENEMIES), 4) );
+                                }
+                            }
+
+                            if (shoot[i].rec.y + shoot[i].rec.height < 0)
+                            {
+                                shoot[i].active = false;
+                                game->shootRate = 0;
+                            }
+                        }
+                    }
+                }
+            }
+
+            COUNT("collision pairs", pairs);
+        }
+    }
+    else
+    {
+        if (pressed & INVADERS_INPUT_RESTART)
+        {
+            InitInvaders(game);
+            game->gameOver = false;
+        }
+    }
+}
+
+// Formation march: sideways until an edge is reached, then down a bit and back
+void MoveInvaders(InvadersGame *game)
+{
+    Enemy *enemy = game->enemy;
+    float moveDown = 0;
+    bool reachedEdge = false;
+    int live = 0;
+
+    for (int i = 0; i < game->activeEnemies; i++)
+    {
+        if (enemy[i].active)
+        {
+            live++;
+            enemy[i].rec.x += enemy[i].speed.x * game->direction;
+
+            if (enemy[i].rec.x <= 0 || enemy[i].rec.x + enemy[i].rec.width >= screenWidth)
+            {
+                reachedEdge = true;
+            }
+        }
+    }
+
+    if (reachedEdge)
+    {
+        game->direction *= -1; // change direction
+        moveDown += 10; // move down a bit
+    }
+
+    for (int i = 0; i < game->activeEnemies; i++)
+    {
+        if (enemy[i].active)
+        {
+            enemy[i].rec.y += moveDown;
+        }
+    }
+
+    COUNT("invaders", live);
+}
+
+void PushEvent(InvadersGame *game, InvadersEventType type, Vector2 position)
+{
+    if (game->eventCount < INVADERS_MAX_EVENTS) game->events[game->eventCount++] = (InvadersEvent){ type, position };
+}
+
+unsigned long long HashInvaders(const InvadersGame *game)
+{
+    unsigned long long hash = REPLAY_HASH_SEED;
+    hash = HashInt(hash, game->gameOver);
+    hash = HashInt(hash, game->pause);
+    hash = HashInt(hash, game->score);
+    hash = HashInt(hash, game->highScore);
+    hash = HashInt(hash, game->victory);
+    hash = HashBytes(hash, &game->player.rec, sizeof(Rectangle));
+    hash = HashInt(hash, game->shootRate);
+    hash = HashFloat(hash, game->alpha);
+    hash = HashInt(hash, game->activeEnemies);
+    hash = HashInt(hash, game->enemiesKill);
+    hash = HashInt(hash, game->smooth);
+    hash = HashInt(hash, game->direction);
+    hash = HashInt(hash, (int)game->previousButtons);
+
+    for (int i = 0; i < NUM_MAX_ENEMIES; i++) {
+        const Enemy *enemy = &game->enemy[i];
+        hash = HashInt(hash, enemy->active);
+        hash = HashBytes(hash, &enemy->rec, sizeof(Rectangle));
+        hash = HashBytes(hash, &enemy->speed, sizeof(Vector2));
+    }
+    for (int i = 0; i < NUM_SHOOTS; i++) {
+        const Shoot *shoot = &game->shoot[i];
+        hash = HashInt(hash, shoot->active);
+        hash = HashBytes(hash, &shoot->rec, sizeof(Rectangle));
+    }
+
+    return hash;
+}
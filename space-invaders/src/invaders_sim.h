@@ -0,0 +1,102 @@
+#ifndef INVADERS_SIM_H
+#define INVADERS_SIM_H
+
+// Space invaders simulation: game state and the per-tick step, with no window, input or audio calls.
+// Only the raylib.h types are used, so it also builds into the headless target
+
+#include "raylib.h"
+
+#define NUM_SHOOTS 5
+#define NUM_MAX_ENEMIES 50
+#define FIRST_WAVE 50
+#define GRID_WIDTH 10
+#define GRID_HEIGHT 5
+#define GRID_SPACING_X 50  // Adjust this value for desired horizontal spacing
+#define GRID_SPACING_Y 50  // Adjust this value for desired vertical spacing
+#define GRID_OFFSET_X 65
+#define GRID_OFFSET_Y 120
+
+#define INVADERS_MAX_EVENTS 16
+
+static const int screenWidth = 600;
+static const int screenHeight = 800;
+
+// Buttons held this tick, pause and restart act on the press
+enum {
+    INVADERS_INPUT_LEFT = 1,
+    INVADERS_INPUT_RIGHT = 2,
+    INVADERS_INPUT_UP = 4,
+    INVADERS_INPUT_DOWN = 8,
+    INVADERS_INPUT_FIRE = 16,
+    INVADERS_INPUT_PAUSE = 32,
+    INVADERS_INPUT_RESTART = 64,
+    INVADERS_INPUT_ALL = 127
+};
+
+typedef struct {
+    unsigned int buttons;
+} InvadersInput;
+
+typedef enum {
+    INVADERS_EVENT_SHOT = 0,
+    INVADERS_EVENT_ENEMY_KILLED,
+    INVADERS_EVENT_PLAYER_HIT
+} InvadersEventType;
+
+typedef struct {
+    InvadersEventType type;
+    Vector2 position;
+} InvadersEvent;
+
+typedef struct Player{
+    Rectangle rec;
+    Vector2 speed;
+    Color color;
+} Player;
+
+typedef struct Enemy{
+    Rectangle rec;
+    Vector2 speed;
+    float baseSpeed;
+    bool active;
+    Color color;
+} Enemy;
+
+typedef struct Shoot{
+    Rectangle rec;
+    Vector2 speed;
+    bool active;
+    Color color;
+} Shoot;
+
+typedef struct {
+    bool gameOver;
+    bool pause;
+    int score;
+    int highScore;
+    bool victory;
+
+    Player player;
+    Enemy enemy[NUM_MAX_ENEMIES];
+    Shoot shoot[NUM_SHOOTS];
+
+    int shootRate;
+    float alpha;
+
+    int activeEnemies;
+    int enemiesKill;
+    bool smooth;
+
+    int direction;          // Formation heading, 1 for right, -1 for left
+    unsigned int previousButtons;
+
+    InvadersEvent events[INVADERS_MAX_EVENTS];
+    int eventCount;
+} InvadersGame;
+
+void InitInvaders(InvadersGame *game);                            // New game
+void StepInvaders(InvadersGame *game, InvadersInput input);       // One tick, events are replaced
+unsigned long long HashInvaders(const InvadersGame *game);        // For replays, see replay.h
+void MoveInvaders(InvadersGame *game);                            // Formation part of the step, on its own for the bench
+
+#endif // INVADERS_SIM_H
@@ -1,262 +1,244 @@
 #include "raylib.h"
+#define REPLAY_IMPLEMENTATION
 #include "main.h"
+#define PROFILER_GRAPH_IMPLEMENTATION
+#include "profiler.h"
+#define COUNTERS_IMPLEMENTATION
+#define COUNTERS_OVERLAY_IMPLEMENTATION
+#include "counters.h"
+#define GAMELOOP_IMPLEMENTATION
+#include "gameloop.h"
+#define DRAWLIST_IMPLEMENTATION
+#define DRAWLIST_REPLAY_IMPLEMENTATION
+#include "drawlist.h"
+#define SOAK_IMPLEMENTATION
+#include "soak.h"
+#define PAK_LOADERS_IMPLEMENTATION
+#include "pak.h"
+#define ATLAS_IMPLEMENTATION
+#include "atlas.h"
+#define MIXER_IMPLEMENTATION
+#include "mixer.h"
+#define MUSIC_IMPLEMENTATION
+#include "music.h"
+#define ASSETS_IMPLEMENTATION
+#include "assets.h"
+#define STARTUP_IMPLEMENTATION
+#include "startup.h"
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
-int main(void)
+int main(int argc, char *argv[])
 {
+    // --profile FILE writes a Chrome trace of the session on exit, F3 shows the frame-time graph
+    // --counters FILE streams the workload counters of every frame (see counters.h), F4 shows them
+    // --bot SKILL plays by itself, 0 to 100 (see bot.h)
+    // --soak SECONDS ends the session after that long, --soak-log FILE logs its frame times and memory (see soak.h)
+    const char *profileFile = NULL, *countersFile = NULL, *soakLogFile = NULL;
+    double soakSeconds = 0.0;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--profile") == 0) profileFile = argv[++i];
+        else if (strcmp(argv[i], "--counters") == 0) countersFile = argv[++i];
+        else if (strcmp(argv[i], "--bot") == 0) botSkill = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--soak") == 0) soakSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--soak-log") == 0) soakLogFile = argv[++i];
+    }
+    InitProfiler(profileFile);
+    if (countersFile != NULL) OpenCounterStream(countersFile);
+
+    // Assets decode while the window opens (see startup.h)
+    pak = LoadPak(TextFormat("%sresources.pak", GetApplicationDirectory()), "resources/");
+    InitAssetCache(&assets, &pak);
+    InitStartup(&startup, &assets);
+    AddStartupAtlas(&startup, "sprites", &atlas, true);
+    BeginStartup(&startup, false);
+
     InitWindow(screenWidth, screenHeight, "classic game: space invaders");
+    MarkStartup(&startup, "window");
     InitGame();
-    SetTargetFPS(60);
+    MarkStartup(&startup, "game");
+    WaitStartup(&startup);         // The sprites are drawn from the first frame
+    spritesHeld = true;            // The startup loader's reference
+    playerSprite = GetAtlasRegion(&atlas, "player-ship");
+    invaderSprite = GetAtlasRegion(&atlas, "invader");
+    shotSprite = GetAtlasWhite(&atlas);
+    SetTargetFPS(GetMonitorRefreshRate(GetCurrentMonitor()));   // Draw at the display rate, the game ticks at GAMELOOP_TICK_RATE
+
+    SoakRun soak;
+    StartSoakRun(&soak, soakSeconds, soakLogFile);
 
     // Main game loop
-    while (!WindowShouldClose())    // Detect window close button or ESC key
+    while (!WindowShouldClose() && UpdateSoakRun(&soak, GetTime()))    // Detect window close button or ESC key
     {
-        UpdateGame();
-        DrawGame();
+        ProfileFrame();
+        UpdateStartup(&startup);   // Uploads the assets decoded since the last frame
+        UpdateProfilerGraph();     // Once per frame, a frame can run no tick or several
+        UpdateCounterOverlay();
+        ReadInput();
+        frameTicks = AdvanceGameLoop(&loop, GetTime());
+        frameAlpha = GetGameLoopAlpha(&loop);
+        frameWidth = GetScreenWidth();
+        frameHeight = GetScreenHeight();
+
+        StartPipelineFrame(&pipeline);      // The next frame updates and records on the worker...
+        DrawFrame();                        // ...while this one is drawn
+        FinishPipelineFrame(&pipeline);
+        HoldSprites(!game.gameOver);        // The worker is idle, the atlas can change hands
+        CounterFrame();
     }
 
     UnloadGame();         // Unload loaded data (textures, sounds, models...)
     CloseWindow();        // Close window and OpenGL context
+    CloseProfiler();
+    CloseCounterStream();
+    FinishSoakRun(&soak, "space-invaders");
     return 0;
 }
 
 void InitGame(void)
 {
-    // Initialize game variables
-    shootRate = 0;
-    pause = false;
-    gameOver = false;
-    victory = false;
-    smooth = false;
-    activeEnemies = 50;
-    enemiesKill = 0;
-    score = 0;
-    alpha = 0;
-
-    // Initialize player
-    player.rec.x = screenWidth / 2;
-    player.rec.y = screenHeight - 50;
-    player.rec.width = 40;
-    player.rec.height = 40;
-    player.speed.x = 5;
-    player.speed.y = 5;
-    player.color = BLACK;
-    playerTexture = LoadTexture("resources/player-ship.png");
-
-    // Initialize enemies in a grid
-    for (int i = 0; i < GRID_WIDTH * GRID_HEIGHT; i++) {
-        enemy[i].rec.width = 20;
-        enemy[i].rec.height = 20;
-        
-        enemy[i].speed.x = 0.5;
-        enemy[i].speed.y = 0.5;
-        enemy[i].baseSpeed = 0.5;
-        enemy[i].active = true;
-        enemy[i].color = GRAY;
+    InitInvaders(&game);
+    InitReplay(&replay, "space-invaders", 0, 0);
+    if (botSkill >= 0) InitBot(&bot, botSkill, (unsigned int)GetRandomValue(0, 0x7fffffff));
+    InitGameLoop(&loop, GAMELOOP_TICK_RATE, GAMELOOP_MAX_CATCH_UP);
+    InitFramePipeline(&pipeline, RunFrame, NULL);
+
+    // The worker records the text, raylib is asked here
+    labelWidths.hiScore = MeasureText("HI-SCORE", 20);
+    labelWidths.score2 = MeasureText("SCORE<2>", 20);
+    labelWidths.win = MeasureText("YOU WIN", 40);
+    labelWidths.paused = MeasureText("GAME PAUSED", 40);
+    labelWidths.playAgain = MeasureText("PRESS [ENTER] TO PLAY AGAIN", 20);
+}
 
-        int row = i / GRID_WIDTH;
-        int col = i % GRID_WIDTH;
-        enemy[i].rec.x = col * GRID_SPACING_X + GRID_OFFSET_X;
-        enemy[i].rec.y = row * GRID_SPACING_Y + GRID_OFFSET_Y;
-    }
+void ReadInput(void)
+{
+    ProfileBegin("input");
+    input = (InvadersInput){ 0 };
+    if (IsKeyDown(KEY_RIGHT)) input.buttons |= INVADERS_INPUT_RIGHT;
+    if (IsKeyDown(KEY_LEFT)) input.buttons |= INVADERS_INPUT_LEFT;
+    if (IsKeyDown(KEY_UP)) input.buttons |= INVADERS_INPUT_UP;
+    if (IsKeyDown(KEY_DOWN)) input.buttons |= INVADERS_INPUT_DOWN;
+    if (IsKeyDown(KEY_SPACE)) input.buttons |= INVADERS_INPUT_FIRE;
+    if (IsKeyDown('P')) input.buttons |= INVADERS_INPUT_PAUSE;
+    if (IsKeyDown(KEY_ENTER)) input.buttons |= INVADERS_INPUT_RESTART;
+    ProfileEnd();
+}
 
-    // Initialize shoots
-    for (int i = 0; i < NUM_SHOOTS; i++)
-    {
-        shoot[i].rec.y = player.rec.y;
-        shoot[i].rec.x = player.rec.x + player.rec.width / 4;
-        shoot[i].rec.width = 5;
-        shoot[i].rec.height = 10;
-        shoot[i].speed.x = 0;
-        shoot[i].speed.y = 7;
-        shoot[i].active = false;
-        shoot[i].color = MAROON;
-    }
+// Worker side of the pipeline
+void RunFrame(void *user, DrawList *list)
+{
+    (void)user;
+    for (int i = 0; i < frameTicks; i++) UpdateGame();
+    DrawGame(list, frameAlpha);
 }
 
 void UpdateGame(void)
 {
-    if (!gameOver)
-    {
-        if (IsKeyPressed('P')) pause = !pause;
-
-        if (!pause)
-        {
-            
-
-            // Player movement
-            if (IsKeyDown(KEY_RIGHT)) player.rec.x += player.speed.x;
-            if (IsKeyDown(KEY_LEFT)) player.rec.x -= player.speed.x;
-            if (IsKeyDown(KEY_UP)) player.rec.y -= player.speed.y;
-            if (IsKeyDown(KEY_DOWN)) player.rec.y += player.speed.y;
+    InvadersInput tickInput = input;
+    if (botSkill >= 0) tickInput.buttons = NextBotButtons(&bot, GetInvadersBotButtons(&game), INVADERS_INPUT_ALL);  // Every tick, from the state it starts from
 
-            // Player collision with enemy
-            for (int i = 0; i < activeEnemies; i++)
-            {
-                if (CheckCollisionRecs(player.rec, enemy[i].rec)) 
-                      gameOver = true;
-            }
-
-            // Enemy behaviour ------------------------------------------
-            static int direction = 1; // 1 for right, -1 for left
-            static float moveDown = 0;
-            static bool reachedEdge = false;
-
-            for (int i = 0; i < activeEnemies; i++)
-            {
-                if (enemy[i].active)
-                {
-                    
-                    enemy[i].rec.x += enemy[i].speed.x * direction;
-
-                    if (enemy[i].rec.x <= 0 || enemy[i].rec.x + enemy[i].rec.width >= screenWidth)
-                    {
-                        reachedEdge = true;
-                    }
-                }
-            }
-
-            if (reachedEdge)
-            {
-                direction *= -1; // change direction
-                moveDown += 10; // move down a bit
-                reachedEdge = false;
-            }
-
-            for (int i = 0; i < activeEnemies; i++)
-            {
-                if (enemy[i].active)
-                {
-                    enemy[i].rec.y += moveDown;
-                }
-            }
+    previous = game;
+    PROFILE_ZONE("update") StepInvaders(&game, tickInput);
+    RecordReplayTick(&replay, tickInput.buttons, HashInvaders(&game));
+}
 
-            moveDown = 0; // reset moveDown for the next frame
+void DrawGame(DrawList *list, float alpha)
+{
+    // A move longer than a grid step is a restart or a new wave
+    Rectangle player = InterpolateRectangle(previous.player.rec, game.player.rec, alpha, GRID_SPACING_Y);
 
-            // ------------------------------------------------------
+    ProfileBegin("record");
 
-            // Wall behaviour
-            if (player.rec.x <= 0) player.rec.x = 0;
-            if (player.rec.x + player.rec.width >= screenWidth) player.rec.x = screenWidth - player.rec.width;
-            if (player.rec.y <= 0) player.rec.y = 0;
-            if (player.rec.y + player.rec.height >= screenHeight) player.rec.y = screenHeight - player.rec.height;
+        RecordClear(list, BLACK);
 
-            // Shoot initialization
-            if (IsKeyDown(KEY_SPACE))
+        if (!game.gameOver)
+        {
+            // Ships on layer 0, shots over them on layer 1, all from the atlas: one draw for the whole formation
+            float scale = player.width / playerSprite.width;
+            AddSprite(&batch, 0, atlas.texture, playerSprite,
+                (Rectangle){ player.x, player.y, playerSprite.width * scale, playerSprite.height * scale }, (Vector2){ 0, 0 }, 0.0f, WHITE);
+            for (int i = 0; i < game.activeEnemies; i++)
             {
-                shootRate += 5;
-
-                for (int i = 0; i < NUM_SHOOTS; i++)
+                if (game.enemy[i].active)
                 {
-                    if (!shoot[i].active && shootRate%20 == 0)
-                    {
-                        shoot[i].rec.x = player.rec.x + player.rec.width / 4;
-                        shoot[i].rec.y = player.rec.y;
-                        shoot[i].active = true;
-                        break;
-                    }
+                    Rectangle enemy = InterpolateRectangle(previous.enemy[i].rec, game.enemy[i].rec, alpha, GRID_SPACING_Y);
+                    AddSprite(&batch, 0, atlas.texture, invaderSprite, enemy, (Vector2){ 0, 0 }, 0.0f, game.enemy[i].color);
                 }
             }
 
-            // Shoot logic
             for (int i = 0; i < NUM_SHOOTS; i++)
             {
-                if (shoot[i].active)
+                if (game.shoot[i].active)
                 {
-                    // Movement
-                    shoot[i].rec.y -= shoot[i].speed.y;
-
-                    // Collision with enemy
-                    for (int j = 0; j < activeEnemies; j++)
-                    {
-                        if (enemy[j].active)
-                        {
-                            if (CheckCollisionRecs(shoot[i].rec, enemy[j].rec))
-                            {
-                                shoot[i].active = false;
-                                enemy[j].active = false;
-                                enemy[j].rec.x = 0;
-                                enemy[j].rec.y = 0;
-                                shootRate = 0;
-                                enemiesKill++;
-                                score += 100;
-
-                                // Adjust all enemies' speed for every enemy killed
-                                for (int k = 0; k < activeEnemies; k++)
-                                { 
-                                    enemy[k].speed.x = enemy[k].baseSpeed * (1 + pow(((enemiesKill * 2.0f) / NUM_MAX_ENEMIES), 4) );
-                                    
-                                }
-                                 
-                            }
-
-                            if (shoot[i].rec.y + shoot[i].rec.height < 0)
-                            {
-                                shoot[i].active = false;
-                                shootRate = 0;
-                            }
-                        }
-                    }
+                    Rectangle shoot = previous.shoot[i].active? InterpolateRectangle(previous.shoot[i].rec, game.shoot[i].rec, alpha, GRID_SPACING_Y) : game.shoot[i].rec;
+                    AddSprite(&batch, 1, atlas.texture, shotSprite, shoot, (Vector2){ 0, 0 }, 0.0f, game.shoot[i].color);
                 }
             }
-        }
-    }
-    else
-    {
-        if (IsKeyPressed(KEY_ENTER))
-        {
-            InitGame();
-            gameOver = false;
-        }
-    }
-}
-
-void DrawGame(void)
-{
-    BeginDrawing();
-
-        ClearBackground(BLACK);
-
-        if (!gameOver)
-        {
-            DrawTextureEx(
-                playerTexture,
-                (Vector2){ player.rec.x, player.rec.y },
-                0.0f,
-                player.rec.width / playerTexture.width,
-                WHITE
-            );
-            for (int i = 0; i < activeEnemies; i++)
-            {
-                if (enemy[i].active) DrawRectangleRec(enemy[i].rec, enemy[i].color);
-                
-            }
-
-            for (int i = 0; i < NUM_SHOOTS; i++)
-            {
-                if (shoot[i].active) DrawRectangleRec(shoot[i].rec, shoot[i].color);
-            }
+            RecordSpriteBatch(list, &batch);
 
              // --- Add these lines for the labels ---
-             DrawText("SCORE<1>", 20, 20, 25, LIGHTGRAY);
-             DrawText("HI-SCORE", screenWidth/2 - MeasureText("HI-SCORE", 20)/2, 20, 25, LIGHTGRAY);
-             DrawText("SCORE<2>", screenWidth - 40 - MeasureText("SCORE<2>", 20), 20, 25, LIGHTGRAY);
+             RecordText(list, "SCORE<1>", 20, 20, 25, LIGHTGRAY);
+             RecordText(list, "HI-SCORE", screenWidth/2 - labelWidths.hiScore/2, 20, 25, LIGHTGRAY);
+             RecordText(list, "SCORE<2>", screenWidth - 40 - labelWidths.score2, 20, 25, LIGHTGRAY);
              // --------------------------------------
             
-            DrawText(TextFormat("%04i", score), 30, 60, 25, LIGHTGRAY);
-            DrawText(TextFormat("%04i", highScore), screenWidth / 2 - MeasureText("HI-SCORE", 20) / 4, 60, 25, LIGHTGRAY);
-            DrawText("0000", screenWidth - 20 - MeasureText("SCORE<2>", 20), 60, 25, LIGHTGRAY);
+            RecordTextFormat(list, 30, 60, 25, LIGHTGRAY, "%04i", game.score);
+            RecordTextFormat(list, screenWidth / 2 - labelWidths.hiScore / 4, 60, 25, LIGHTGRAY, "%04i", game.highScore);
+            RecordText(list, "0000", screenWidth - 20 - labelWidths.score2, 60, 25, LIGHTGRAY);
 
-            if (victory) DrawText("YOU WIN", screenWidth/2 - MeasureText("YOU WIN", 40)/2, screenHeight/2 - 40, 40, BLACK);
+            if (game.victory) RecordText(list, "YOU WIN", screenWidth/2 - labelWidths.win/2, screenHeight/2 - 40, 40, BLACK);
 
-            if (pause) DrawText("GAME PAUSED", screenWidth/2 - MeasureText("GAME PAUSED", 40)/2, screenHeight/2 - 40, 40, GRAY);
+            if (game.pause) RecordText(list, "GAME PAUSED", screenWidth/2 - labelWidths.paused/2, screenHeight/2 - 40, 40, GRAY);
         }
-        else DrawText("PRESS [ENTER] TO PLAY AGAIN", GetScreenWidth()/2 - MeasureText("PRESS [ENTER] TO PLAY AGAIN", 20)/2, GetScreenHeight()/2 - 50, 20, GRAY);
+        else RecordText(list, "PRESS [ENTER] TO PLAY AGAIN", frameWidth/2 - labelWidths.playAgain/2, frameHeight/2 - 50, 20, GRAY);
 
+    COUNT("draw calls", list->draws);
+    ProfileEnd();
+}
+
+// Main thread side: the frame recorded before, then the overlays
+void DrawFrame(void)
+{
+    ProfileBegin("draw");
+    BeginDrawing();
+    ReplayDrawList(GetPipelineFrame(&pipeline));
+    ProfileEnd();
+    DrawProfilerGraph(10, 100);
+    DrawCounterOverlay(screenWidth - 258, 100);
     EndDrawing();
 }
 
+// The game over screen draws no sprite: the atlas is released, and a restart acquires it again, which the cache
+// serves without loading anything. It is unloaded by the trim on exit, with every other unreferenced asset
+void HoldSprites(bool hold)
+{
+    if (hold == spritesHeld) return;
+
+    if (hold) {
+        atlas = AcquireAtlas(&assets, "sprites");
+        playerSprite = GetAtlasRegion(&atlas, "player-ship");
+        invaderSprite = GetAtlasRegion(&atlas, "invader");
+        shotSprite = GetAtlasWhite(&atlas);
+    }
+    else ReleaseAsset(&assets, "sprites");
+    spritesHeld = hold;
+}
+
 void UnloadGame(void)
 {
-    // TODO: Unload all dynamic loaded data (textures, sounds, models...)
+    CloseFramePipeline(&pipeline);
+    CloseStartup(&startup);
+
+    UnloadSpriteBatch(&batch);
+    HoldSprites(false);
+    LogAssetCache(&assets);
+    TrimAssetCache(&assets);
+    if (assets.count > 0) TraceLog(LOG_WARNING, "ASSETS: %d assets still referenced on exit", assets.count);
+    UnloadAssetCache(&assets);
+    UnloadPak(&pak);
+
+    SaveReplay(&replay, "space-invaders.replay");
+    UnloadReplay(&replay);
 }
@@ -2,62 +2,43 @@
 #define MAIN_H
 
 #include "raylib.h"
-
-#define NUM_SHOOTS 5
-#define NUM_MAX_ENEMIES 50
-#define FIRST_WAVE 50
-#define GRID_WIDTH 10
-#define GRID_HEIGHT 5
-#define GRID_SPACING_X 50  // Adjust this value for desired horizontal spacing
-#define GRID_SPACING_Y 50  // Adjust this value for desired vertical spacing
-#define GRID_OFFSET_X 65
-#define GRID_OFFSET_Y 120
-
-typedef struct Player{
-    Rectangle rec;
-    Vector2 speed;
-    Color color;
-} Player;
-
-typedef struct Enemy{
-    Rectangle rec;
-    Vector2 speed;
-    float baseSpeed;
-    bool active;
-    Color color;
-} Enemy;
-
-typedef struct Shoot{
-    Rectangle rec;
-    Vector2 speed;
-    bool active;
-    Color color;
-} Shoot;
-
-static const int screenWidth = 600;
-static const int screenHeight = 800;
-
-static bool gameOver = false;
-static bool pause =  false;
-static int score = 0;
-static int highScore = 0;
-static bool victory = false;
-
-static Player player = { 0 };
-static Texture2D playerTexture;
-static Enemy enemy[NUM_MAX_ENEMIES] = { 0 };
-static Shoot shoot[NUM_SHOOTS] = { 0 };
-
-static int shootRate = 0;
-static float alpha = 0.0f;
-
-static int activeEnemies = 0;
-static int enemiesKill = 0;
-static bool smooth = false;
+#include "invaders_sim.h"
+#include "invaders_bot.h"
+#include "bot.h"
+#include "replay.h"
+#include "gameloop.h"
+#include "drawlist.h"
+#include "pak.h"
+#include "startup.h"
+#include "atlas.h"
+
+static InvadersGame game = { 0 };
+static InvadersGame previous = { 0 };   // State of the tick before, drawing interpolates from it
+static GameLoop loop = { 0 };
+static FramePipeline pipeline = { 0 };
+static InvadersInput input = { 0 };     // Read on the main thread, for the ticks of the frame being recorded
+static int frameTicks = 0;
+static float frameAlpha = 0.0f;
+static int frameWidth = 0, frameHeight = 0;    // Screen size of the frame being recorded, the worker can't ask raylib
+static struct { int hiScore, score2, win, paused, playAgain; } labelWidths;    // MeasureText() of the labels, once
+static Atlas atlas = { 0 };               // Every sprite, drawn in one batch
+static SpriteBatch batch = { 0 };
+static Rectangle playerSprite, invaderSprite, shotSprite;
+static Replay replay = { 0 };      // This session, saved as space-invaders.replay on exit for space-invaders_headless --replay
+static int botSkill = -1;          // --bot SKILL, negative when the keyboard plays
+static Bot bot = { 0 };
+static Pak pak = { 0 };            // resources.pak, mapped for the session
+static AssetCache assets = { 0 };  // Owns every asset loaded (see assets.h)
+static Startup startup = { 0 };
+static bool spritesHeld = false;   // A reference to the atlas while a game is on, see HoldSprites()
 
 static void InitGame(void);         
-static void UpdateGame(void);       
-static void DrawGame(void);         
+static void ReadInput(void);
+static void RunFrame(void *user, DrawList *list);
+static void UpdateGame(void);
+static void DrawGame(DrawList *list, float alpha);
+static void DrawFrame(void);
+static void HoldSprites(bool hold);
 static void UnloadGame(void);       
 static void UpdateDrawFrame(void);  
 
@@ -0,0 +1,8 @@
+// Implementations of the shared utilities that need platform headers.
+// Kept apart from main.c because <windows.h> clashes with raylib.h
+#define THREAD_IMPLEMENTATION
+#define PAK_IMPLEMENTATION
+#define PROFILER_IMPLEMENTATION
+#include "thread.h"
+#include "pak.h"
+#include "profiler.h"
@@ -0,0 +1,34 @@
+// Tank battle royale without window or audio, the two players on random, bot or replayed input: tank_headless [--ticks N] [--seed N] [--replay FILE]
+// (all options in headless.h). Bots and bullets run on the job system like in the game
+#define HEADLESS_IMPLEMENTATION
+#define REPLAY_IMPLEMENTATION
+#define COUNTERS_IMPLEMENTATION
+#define SOAK_IMPLEMENTATION
+#include "headless.h"
+#include "tank_sim.h"
+#include "tank_bot.h"
+#include "jobs.h"
+
+int main(int argc, char *argv[])
+{
+    HeadlessRun run;
+    static TankGame game;
+
+    if (!StartHeadlessRun(&run, argc, argv, "tank", ROYALE_TANKS)) return 1;     // Replays keep the tank count as mode
+
+    InitJobSystem(0);
+    InitTankGame(&game, run.replay.mode);
+
+    while (run.tick < run.options.ticks) {
+        unsigned int buttons = 0;       // Player 1 in the high byte
+        if (run.botting) buttons = NextHeadlessBotButtons(&run, GetTankBotButtons(&game, 0) | (GetTankBotButtons(&game, 1) << 8), TANK_INPUT_ALL | (TANK_INPUT_ALL << 8));
+        else buttons = NextHeadlessButtons(&run, TANK_INPUT_ALL | (TANK_INPUT_ALL << 8));
+        TankInput input = { { (unsigned char)(buttons & 0xff), (unsigned char)(buttons >> 8) } };
+        StepTankGame(&game, input);
+        if (!EndHeadlessTick(&run, game.eventCount, run.hashing? HashTankGame(&game) : 0)) break;
+    }
+
+    CloseJobSystem();
+
+    return FinishHeadlessRun(&run);
+}
@@ -1,200 +1,271 @@
 #include "raylib.h"
+#include "tank_sim.h"
+#include "tank_bot.h"
+#include "bot.h"
+#include "jobs.h"
+#include "rollback.h"
+
+#define REPLAY_IMPLEMENTATION
+#include "replay.h"
+#define PROFILER_GRAPH_IMPLEMENTATION
+#include "profiler.h"
+#define GAMELOOP_IMPLEMENTATION
+#include "gameloop.h"
+#define SOAK_IMPLEMENTATION
+#include "soak.h"
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
-#define SCREEN_WIDTH 720
-#define SCREEN_HEIGHT 900
+// Netplay over loopback: tank --host [port] / tank --join [port]
+#define NET_DEFAULT_PORT 7777
+#define NET_INPUT_DELAY 2
 
-#define TANK_SIZE 32
-#define TANK_SPEED 2.0f
-#define TANK_ROT_SPEED 2.5f
+// Arena tiles are rendered through a cached terrain layer, re-rasterized chunk by chunk
+#define ARENA_COLOR DARKGRAY
 
-#define BULLET_SPEED 5.0f
-#define BULLET_RADIUS 4
-#define MAX_BULLETS 3
+// Split screen: one viewport per player, stacked vertically
+#define VIEW_WIDTH SCREEN_WIDTH
+#define VIEW_HEIGHT (SCREEN_HEIGHT/2)
 
-#define MAX_OBSTACLES 6
-#define OBSTACLE_SIZE 64
+// Keys of each player: up, down, left, right, fire
+static const int playerKeys[PLAYER_TANKS][5] = {
+    { KEY_W, KEY_S, KEY_A, KEY_D, KEY_SPACE },
+    { KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT, KEY_ENTER }
+};
 
-typedef struct {
-    Rectangle rect;
-} Obstacle;
+static int tankCount = PLAYER_TANKS;
+static TankGame game = { 0 };
+static Tank previousTanks[MAX_TANKS] = { 0 };      // Of the tick before, drawing interpolates from them. The whole game is too big to copy every tick
+static Bullet previousBullets[MAX_TANKS*MAX_BULLETS] = { 0 };
+static GameLoop loop = { 0 };
+static Replay replay = { 0 };      // This session (not netplay), saved as tank.replay on exit for tank_headless --replay
+static int botSkill = -1;          // --bot [SKILL], both players, negative when the keyboard plays
+static Bot bot = { 0 };
+static RenderTexture2D terrain = { 0 };
 
-typedef struct {
-    Vector2 position;
-    float rotation;
-    Color color;
-    int upKey, downKey, leftKey, rightKey, fireKey;
-    int bulletCount;
-    struct Bullet *bullets[MAX_BULLETS];
-} Tank;
+static Camera2D cameras[2] = { 0 };
 
-typedef struct Bullet {
-    Vector2 position;
-    float rotation;
-    bool active;
-} Bullet;
-
-static Tank tank1, tank2;
-static Bullet bullets1[MAX_BULLETS], bullets2[MAX_BULLETS];
-static Obstacle obstacles[MAX_OBSTACLES];
+static RollbackSession *session = NULL;
+static bool netWaiting = false;
 
 static void InitGame(void);
 static void UpdateGame(void);
-static void DrawGame(void);
+static void DrawGame(float alpha);
 static void UnloadGame(void);
 
-static void UpdateTank(Tank *tank, Bullet *bullets[]);
-static void DrawTank(Tank *tank);
-static void UpdateBullets(Bullet *bullets[]);
-static void DrawBullets(Bullet *bullets[]);
+static void UpdateNetGame(void);
+static void SaveGameSnapshot(void *user, void *blob);
+static void LoadGameSnapshot(void *user, const void *blob);
+static void AdvanceNetFrame(void *user, const unsigned char inputs[2]);
+
+static unsigned char ReadPlayerButtons(int player);
+static Color GetTankColor(int index);
+static void DrawTank(const Tank *tank, Color color);
+static void DrawBullet(const Bullet *bullet);
+static void SavePreviousTick(void);
+static Tank GetDrawTank(int index, float alpha);
+static Bullet GetDrawBullet(int index, float alpha);
+
+static void UpdateTerrainLayer(void);
+static void DrawTerrain(Rectangle view);
 
-static void DrawObstacles(void);
-static bool CheckTankObstacleCollision(Vector2 nextPos);
+static void UpdateCameras(float alpha);
+static Rectangle GetCameraView(Camera2D camera);
+static void DrawViewport(Camera2D camera, Rectangle viewport, float alpha);
 
-int main(void)
+int main(int argc, char *argv[])
 {
-    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "tank");
+    // Battle royale: tank --royale [count]
+    // Netplay: tank --host [port] / tank --join [port], with --delay frames, --lag ms, --jitter ms, --loss percent
+    // --profile FILE writes a Chrome trace of the session on exit, F3 shows the frame-time graph
+    // Unattended: tank --bot [skill] for two bot players (see bot.h, not in netplay), --soak seconds and --soak-log FILE (see soak.h)
+    RollbackConfig netConfig = { .localPlayer = -1, .inputDelay = NET_INPUT_DELAY };
+    int port = NET_DEFAULT_PORT;
+    const char *profileFile = NULL, *soakLogFile = NULL;
+    double soakSeconds = 0.0;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = (i + 1 < argc) && (atoi(argv[i + 1]) > 0 || strcmp(argv[i + 1], "0") == 0);
+        if (strcmp(argv[i], "--royale") == 0) {
+            tankCount = ROYALE_TANKS;
+            if (hasValue) tankCount = atoi(argv[++i]);
+            if (tankCount < PLAYER_TANKS) tankCount = PLAYER_TANKS;
+            if (tankCount > MAX_TANKS) tankCount = MAX_TANKS;
+        }
+        else if (strcmp(argv[i], "--host") == 0 || strcmp(argv[i], "--join") == 0) {
+            netConfig.localPlayer = (strcmp(argv[i], "--host") == 0)? 0 : 1;
+            if (hasValue) port = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--delay") == 0 && hasValue) netConfig.inputDelay = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--lag") == 0 && hasValue) netConfig.lagMs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--jitter") == 0 && hasValue) netConfig.jitterMs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--loss") == 0 && hasValue) netConfig.lossPercent = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) profileFile = argv[++i];
+        else if (strcmp(argv[i], "--bot") == 0) botSkill = hasValue? atoi(argv[++i]) : BOT_DEFAULT_SKILL;
+        else if (strcmp(argv[i], "--soak") == 0 && hasValue) soakSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--soak-log") == 0 && i + 1 < argc) soakLogFile = argv[++i];
+    }
+
+    InitProfiler(profileFile);
+
+    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, (netConfig.localPlayer == 0)? "tank - host" : (netConfig.localPlayer == 1)? "tank - join" : "tank");
+    terrain = LoadRenderTexture(ARENA_COLS*TILE_SIZE, ARENA_ROWS*TILE_SIZE);
+    InitJobSystem(0);
+
+    if (netConfig.localPlayer >= 0) {
+        // Snapshots only cover a duel
+        if (tankCount != PLAYER_TANKS) TraceLog(LOG_WARNING, "TANK: Netplay only supports two tanks, ignoring --royale");
+        tankCount = PLAYER_TANKS;
+
+        netConfig.localPort = port + netConfig.localPlayer;
+        netConfig.remotePort = port + 1 - netConfig.localPlayer;
+        RollbackCallbacks callbacks = { sizeof(GameSnapshot), SaveGameSnapshot, LoadGameSnapshot, AdvanceNetFrame, &game };
+        session = RollbackStart(netConfig, callbacks);
+        if (session == NULL) TraceLog(LOG_WARNING, "TANK: Could not open UDP port %i, playing locally", netConfig.localPort);
+    }
+
     InitGame();
-    SetTargetFPS(60);
+    SetTargetFPS(GetMonitorRefreshRate(GetCurrentMonitor()));   // Draw at the display rate, the game ticks at GAMELOOP_TICK_RATE
 
-    while (!WindowShouldClose())
+    SoakRun soak;
+    StartSoakRun(&soak, soakSeconds, soakLogFile);
+
+    while (!WindowShouldClose() && UpdateSoakRun(&soak, GetTime()))
     {
-        UpdateGame();
-        DrawGame();
+        ProfileFrame();
+        UpdateProfilerGraph();
+
+        for (int ticks = AdvanceGameLoop(&loop, GetTime()); ticks > 0; ticks--) {
+            SavePreviousTick();
+            if (session != NULL) UpdateNetGame();
+            else UpdateGame();
+        }
+        DrawGame(GetGameLoopAlpha(&loop));
     }
 
     UnloadGame();
+    RollbackStop(session);
+    CloseJobSystem();
     CloseWindow();
+    CloseProfiler();
+    FinishSoakRun(&soak, "tank");
     return 0;
 }
 
 void InitGame(void)
 {
-    tank1.position = (Vector2){100, 100};
-    tank1.rotation = 0;
-    tank1.color = GREEN;
-    tank1.upKey = KEY_W;
-    tank1.downKey = KEY_S;
-    tank1.leftKey = KEY_A;
-    tank1.rightKey = KEY_D;
-    tank1.fireKey = KEY_SPACE;
-    tank1.bulletCount = 0;
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        bullets1[i].active = false;
-        tank1.bullets[i] = &bullets1[i];
-    }
-
-    tank2.position = (Vector2){SCREEN_WIDTH - 100, SCREEN_HEIGHT - 100};
-    tank2.rotation = 180;
-    tank2.color = YELLOW;
-    tank2.upKey = KEY_UP;
-    tank2.downKey = KEY_DOWN;
-    tank2.leftKey = KEY_LEFT;
-    tank2.rightKey = KEY_RIGHT;
-    tank2.fireKey = KEY_ENTER;
-    tank2.bulletCount = 0;
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        bullets2[i].active = false;
-        tank2.bullets[i] = &bullets2[i];
-    }
-
-    // Place obstacles at fixed positions (you can randomize or adjust as needed)
-    obstacles[0].rect = (Rectangle){ SCREEN_WIDTH/2 - OBSTACLE_SIZE/2, 200, OBSTACLE_SIZE, OBSTACLE_SIZE };
-    obstacles[1].rect = (Rectangle){ 100, 400, OBSTACLE_SIZE, OBSTACLE_SIZE };
-    obstacles[2].rect = (Rectangle){ SCREEN_WIDTH - 100 - OBSTACLE_SIZE, 400, OBSTACLE_SIZE, OBSTACLE_SIZE };
-    obstacles[3].rect = (Rectangle){ SCREEN_WIDTH/2 - OBSTACLE_SIZE/2, 600, OBSTACLE_SIZE, OBSTACLE_SIZE };
-    obstacles[4].rect = (Rectangle){ 200, 700, OBSTACLE_SIZE, OBSTACLE_SIZE };
-    obstacles[5].rect = (Rectangle){ SCREEN_WIDTH - 200 - OBSTACLE_SIZE, 700, OBSTACLE_SIZE, OBSTACLE_SIZE };
-
+    InitTankGame(&game, tankCount);
+    InitReplay(&replay, "tank", 0, tankCount);
+    if (botSkill >= 0) InitBot(&bot, botSkill, (unsigned int)GetRandomValue(0, 0x7fffffff));
+    InitGameLoop(&loop, GAMELOOP_TICK_RATE, GAMELOOP_MAX_CATCH_UP);
+    SavePreviousTick();
+    UpdateCameras(0.0f);
 }
 
 void UpdateGame(void)
 {
-    UpdateTank(&tank1, tank1.bullets);
-    UpdateTank(&tank2, tank2.bullets);
-    UpdateBullets(tank1.bullets);
-    UpdateBullets(tank2.bullets);
+    ProfileBegin("input");
+    TankInput input = { 0 };
+    if (botSkill >= 0) {
+        // One bot drives both players, player 1 in the high byte like in the replays
+        unsigned int wanted = GetTankBotButtons(&game, 0) | (GetTankBotButtons(&game, 1) << 8);
+        unsigned int buttons = NextBotButtons(&bot, wanted, TANK_INPUT_ALL | (TANK_INPUT_ALL << 8));
+        input = (TankInput){ { (unsigned char)(buttons & 0xff), (unsigned char)(buttons >> 8) } };
+    }
+    else for (int i = 0; i < PLAYER_TANKS; i++) input.buttons[i] = ReadPlayerButtons(i);
+    ProfileEnd();
+
+    PROFILE_ZONE("update") StepTankGame(&game, input);
+    RecordReplayTick(&replay, input.buttons[0] | (input.buttons[1] << 8), HashTankGame(&game));
 }
 
-void DrawGame(void)
+void DrawGame(float alpha)
 {
+    ProfileBegin("draw");
+    UpdateTerrainLayer();
+    UpdateCameras(alpha);
+
     BeginDrawing();
-    ClearBackground(DARKGRAY);
+    ClearBackground(BLACK);
 
-    DrawTank(&tank1);
-    DrawTank(&tank2);
-    DrawBullets(tank1.bullets);
-    DrawBullets(tank2.bullets);
-    DrawObstacles();
+    DrawViewport(cameras[0], (Rectangle){ 0, 0, VIEW_WIDTH, VIEW_HEIGHT }, alpha);
+    DrawViewport(cameras[1], (Rectangle){ 0, VIEW_HEIGHT, VIEW_WIDTH, VIEW_HEIGHT }, alpha);
+    DrawLine(0, VIEW_HEIGHT, VIEW_WIDTH, VIEW_HEIGHT, BLACK);
+
+    if (game.tankCount > PLAYER_TANKS) {
+        int aliveCount = 0;
+        for (int i = 0; i < game.tankCount; i++) if (game.tanks[i].alive) aliveCount++;
+        DrawText(TextFormat("Tanks left: %d", aliveCount), 10, 10, 20, WHITE);
+    }
+
+    if (session != NULL) {
+        RollbackStats stats = RollbackGetStats(session);
+        DrawText(TextFormat("Frame %d, confirmed %d, rollback %d frames in %.2f ms (max %d in %.2f ms), desyncs %d",
+            stats.frame, stats.confirmedFrame, stats.lastRollback, stats.lastRollbackMs, stats.maxRollback, stats.maxRollbackMs, stats.desyncs),
+            10, SCREEN_HEIGHT - 20, 10, WHITE);
+        if (netWaiting) DrawText("WAITING FOR OTHER PLAYER", SCREEN_WIDTH/2 - MeasureText("WAITING FOR OTHER PLAYER", 30)/2, VIEW_HEIGHT - 15, 30, RED);
+    }
 
+    ProfileEnd();
+    DrawProfilerGraph(10, 40);
     EndDrawing();
 }
 
 void UnloadGame(void)
 {
-    // No dynamic resources to unload
+    UnloadRenderTexture(terrain);
+
+    if (replay.tickCount > 0) SaveReplay(&replay, "tank.replay");
+    UnloadReplay(&replay);
 }
 
-void UpdateTank(Tank *tank, Bullet *bullets[])
+// Netplay frame: the local player may use either set of keys
+void UpdateNetGame(void)
 {
-    // Movement
-    float nextRot = tank->rotation;
-    if (IsKeyDown(tank->leftKey)) nextRot -= TANK_ROT_SPEED;
-    if (IsKeyDown(tank->rightKey)) nextRot += TANK_ROT_SPEED;
-
-    Vector2 forward = {
-        sinf(DEG2RAD * nextRot),
-        -cosf(DEG2RAD * nextRot)
-    };
+    ProfileBegin("input");
+    unsigned char local = ReadPlayerButtons(0) | ReadPlayerButtons(1);
+    ProfileEnd();
 
-    Vector2 nextPos = tank->position;
+    PROFILE_ZONE("update") netWaiting = !RollbackUpdate(session, local);
+}
 
-    if (IsKeyDown(tank->upKey)) {
-        Vector2 tryPos = {
-            tank->position.x + forward.x * TANK_SPEED,
-            tank->position.y + forward.y * TANK_SPEED
-        };
-        if (!CheckTankObstacleCollision(tryPos)) {
-            nextPos = tryPos;
-        }
-    }
-    if (IsKeyDown(tank->downKey)) {
-        Vector2 tryPos = {
-            tank->position.x - forward.x * TANK_SPEED,
-            tank->position.y - forward.y * TANK_SPEED
-        };
-        if (!CheckTankObstacleCollision(tryPos)) {
-            nextPos = tryPos;
-        }
-    }
+void SaveGameSnapshot(void *user, void *blob)
+{
+    SaveTankSnapshot((const TankGame *)user, (GameSnapshot *)blob);
+}
 
-    // Clamp to screen
-    if (nextPos.x < TANK_SIZE/2) nextPos.x = TANK_SIZE/2;
-    if (nextPos.x > SCREEN_WIDTH - TANK_SIZE/2) nextPos.x = SCREEN_WIDTH - TANK_SIZE/2;
-    if (nextPos.y < TANK_SIZE/2) nextPos.y = TANK_SIZE/2;
-    if (nextPos.y > SCREEN_HEIGHT - TANK_SIZE/2) nextPos.y = SCREEN_HEIGHT - TANK_SIZE/2;
-
-    // Only update rotation if not colliding
-    tank->rotation = nextRot;
-    tank->position = nextPos;
-
-    // Fire
-    if (IsKeyPressed(tank->fireKey)) {
-        for (int i = 0; i < MAX_BULLETS; i++) {
-            if (!bullets[i]->active) {
-                bullets[i]->active = true;
-                bullets[i]->position = (Vector2){
-                    tank->position.x + forward.x * (TANK_SIZE/2 + BULLET_RADIUS),
-                    tank->position.y + forward.y * (TANK_SIZE/2 + BULLET_RADIUS)
-                };
-                bullets[i]->rotation = tank->rotation;
-                break;
-            }
-        }
-    }
+void LoadGameSnapshot(void *user, const void *blob)
+{
+    LoadTankSnapshot((TankGame *)user, (const GameSnapshot *)blob);
+}
+
+void AdvanceNetFrame(void *user, const unsigned char inputs[2])
+{
+    TankInput input = { { inputs[0], inputs[1] } };
+    StepTankGame((TankGame *)user, input);
+}
+
+unsigned char ReadPlayerButtons(int player)
+{
+    const int *keys = playerKeys[player];
+    unsigned char buttons = 0;
+    if (IsKeyDown(keys[0])) buttons |= TANK_INPUT_UP;
+    if (IsKeyDown(keys[1])) buttons |= TANK_INPUT_DOWN;
+    if (IsKeyDown(keys[2])) buttons |= TANK_INPUT_LEFT;
+    if (IsKeyDown(keys[3])) buttons |= TANK_INPUT_RIGHT;
+    if (IsKeyDown(keys[4])) buttons |= TANK_INPUT_FIRE;
+    return buttons;
+}
+
+Color GetTankColor(int index)
+{
+    if (index == 0) return GREEN;
+    if (index == 1) return YELLOW;
+    return ColorFromHSV((float)(index*37%360), 0.6f, 0.9f);
 }
 
-void DrawTank(Tank *tank)
+void DrawTank(const Tank *tank, Color color)
 {
     Vector2 center = tank->position;
     float rot = tank->rotation;
@@ -204,7 +275,7 @@ void DrawTank(Tank *tank)
         (Rectangle){center.x, center.y, TANK_SIZE, TANK_SIZE * 0.6f},
         (Vector2){TANK_SIZE/2, TANK_SIZE*0.3f},
         rot,
-        tank->color
+        color
     );
     // Draw barrel
     Vector2 barrelEnd = {
@@ -214,51 +285,131 @@ void DrawTank(Tank *tank)
     DrawLineEx(center, barrelEnd, 6, BLACK);
 }
 
-void UpdateBullets(Bullet *bullets[])
+void DrawBullet(const Bullet *bullet)
 {
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        if (bullets[i]->active) {
-            bullets[i]->position.x += sinf(DEG2RAD * bullets[i]->rotation) * BULLET_SPEED;
-            bullets[i]->position.y -= cosf(DEG2RAD * bullets[i]->rotation) * BULLET_SPEED;
-
-            // Out of bounds
-            if (bullets[i]->position.x < 0 || bullets[i]->position.x > SCREEN_WIDTH ||
-                bullets[i]->position.y < 0 || bullets[i]->position.y > SCREEN_HEIGHT) {
-                bullets[i]->active = false;
+    DrawCircleV(bullet->position, BULLET_RADIUS, WHITE);
+}
+
+// Only the tanks and bullets are drawn between ticks, the rest of the game is drawn as it is now
+void SavePreviousTick(void)
+{
+    memcpy(previousTanks, game.tanks, game.tankCount*sizeof(Tank));
+    memcpy(previousBullets, game.bullets, game.tankCount*MAX_BULLETS*sizeof(Bullet));
+}
+
+// A move longer than a few ticks' worth is a respawn, or a rollback correction in netplay
+Tank GetDrawTank(int index, float alpha)
+{
+    Tank tank = game.tanks[index];
+    tank.position = InterpolatePosition(previousTanks[index].position, tank.position, alpha, TANK_SPEED*4);
+    tank.rotation = InterpolateAngle(previousTanks[index].rotation, tank.rotation, alpha);
+    return tank;
+}
+
+Bullet GetDrawBullet(int index, float alpha)
+{
+    Bullet bullet = game.bullets[index];
+    if (previousBullets[index].active) bullet.position = InterpolatePosition(previousBullets[index].position, bullet.position, alpha, BULLET_SPEED*4);
+    return bullet;
+}
+
+// Re-rasterize only the chunks touched since last frame into the cached terrain layer
+void UpdateTerrainLayer(void)
+{
+    if (game.dirtyChunkCount == 0) return;
+
+    BeginTextureMode(terrain);
+    for (int i = 0; i < game.dirtyChunkCount; i++) {
+        int r = game.dirtyChunks[i]/CHUNK_COLS, c = game.dirtyChunks[i]%CHUNK_COLS;
+        int firstRow = r*CHUNK_TILES, firstCol = c*CHUNK_TILES;
+        DrawRectangle(firstCol*TILE_SIZE, firstRow*TILE_SIZE, CHUNK_TILES*TILE_SIZE, CHUNK_TILES*TILE_SIZE, ARENA_COLOR);
+        for (int row = firstRow; row < firstRow + CHUNK_TILES && row < ARENA_ROWS; row++) {
+            for (int col = firstCol; col < firstCol + CHUNK_TILES && col < ARENA_COLS; col++) {
+                if (game.tiles[row][col] == 0) continue;
+                // Damaged tiles get darker
+                Color color = ColorBrightness(GRAY, -0.5f*(TILE_MAX_HP - game.tiles[row][col])/TILE_MAX_HP);
+                DrawRectangle(col*TILE_SIZE, row*TILE_SIZE, TILE_SIZE, TILE_SIZE, color);
             }
         }
+        game.chunkDirty[r][c] = false;
     }
+    EndTextureMode();
+
+    game.dirtyChunkCount = 0;
 }
 
-void DrawBullets(Bullet *bullets[])
+// Draw only the part of the terrain layer inside the view
+void DrawTerrain(Rectangle view)
 {
-    for (int i = 0; i < MAX_BULLETS; i++) {
-        if (bullets[i]->active) {
-            DrawCircleV(bullets[i]->position, BULLET_RADIUS, WHITE);
-        }
-    }
+    if (view.x < 0) { view.width += view.x; view.x = 0; }
+    if (view.y < 0) { view.height += view.y; view.y = 0; }
+    if (view.x + view.width > ARENA_WIDTH) view.width = ARENA_WIDTH - view.x;
+    if (view.y + view.height > ARENA_HEIGHT) view.height = ARENA_HEIGHT - view.y;
+    if (view.width <= 0 || view.height <= 0) return;
+
+    // Render textures are stored upside down, flip on draw
+    Rectangle source = { view.x, ARENA_HEIGHT - view.y - view.height, view.width, -view.height };
+    DrawTextureRec(terrain.texture, source, (Vector2){ view.x, view.y }, WHITE);
 }
 
-void DrawObstacles(void)
+void UpdateCameras(float alpha)
 {
-    for (int i = 0; i < MAX_OBSTACLES; i++) {
-        DrawRectangleRec(obstacles[i].rect, GRAY);
-        DrawRectangleLinesEx(obstacles[i].rect, 2, BLACK);
+    for (int i = 0; i < 2; i++) {
+        cameras[i].offset = (Vector2){ VIEW_WIDTH/2.0f, i*VIEW_HEIGHT + VIEW_HEIGHT/2.0f };
+        cameras[i].target = GetDrawTank(i, alpha).position;
+        cameras[i].rotation = 0.0f;
+        cameras[i].zoom = 1.0f;
+
+        // Keep the view inside the arena
+        if (cameras[i].target.x < VIEW_WIDTH/2.0f) cameras[i].target.x = VIEW_WIDTH/2.0f;
+        if (cameras[i].target.x > ARENA_WIDTH - VIEW_WIDTH/2.0f) cameras[i].target.x = ARENA_WIDTH - VIEW_WIDTH/2.0f;
+        if (cameras[i].target.y < VIEW_HEIGHT/2.0f) cameras[i].target.y = VIEW_HEIGHT/2.0f;
+        if (cameras[i].target.y > ARENA_HEIGHT - VIEW_HEIGHT/2.0f) cameras[i].target.y = ARENA_HEIGHT - VIEW_HEIGHT/2.0f;
     }
 }
 
-bool CheckTankObstacleCollision(Vector2 nextPos)
+// World-space rectangle covered by a camera's viewport
+Rectangle GetCameraView(Camera2D camera)
 {
-    Rectangle tankRect = {
-        nextPos.x - TANK_SIZE/2,
-        nextPos.y - TANK_SIZE*0.3f,
-        TANK_SIZE,
-        TANK_SIZE * 0.6f
+    return (Rectangle){
+        camera.target.x - VIEW_WIDTH/(2.0f*camera.zoom),
+        camera.target.y - VIEW_HEIGHT/(2.0f*camera.zoom),
+        VIEW_WIDTH/camera.zoom,
+        VIEW_HEIGHT/camera.zoom
     };
-    for (int i = 0; i < MAX_OBSTACLES; i++) {
-        if (CheckCollisionRecs(tankRect, obstacles[i].rect)) {
-            return true;
+}
+
+void DrawViewport(Camera2D camera, Rectangle viewport, float alpha)
+{
+    Rectangle view = GetCameraView(camera);
+
+    BeginScissorMode((int)viewport.x, (int)viewport.y, (int)viewport.width, (int)viewport.height);
+    BeginMode2D(camera);
+
+    DrawTerrain(view);
+
+    // Entities are bucketed by their center, widen the query so anything overlapping the edge is found
+    int minCol, minRow, maxCol, maxRow;
+    GetGridRange((Rectangle){ view.x - TANK_SIZE, view.y - TANK_SIZE, view.width + 2*TANK_SIZE, view.height + 2*TANK_SIZE },
+        &minCol, &minRow, &maxCol, &maxRow);
+
+    for (int row = minRow; row <= maxRow; row++) {
+        for (int col = minCol; col <= maxCol; col++) {
+            int cell = row*GRID_COLS + col;
+            for (int e = game.grid.cellStart[cell]; e < game.grid.cellStart[cell + 1]; e++) {
+                int index = game.grid.entries[e].index;
+                if (game.grid.entries[e].kind == ENTITY_TANK) {
+                    Tank tank = GetDrawTank(index, alpha);
+                    DrawTank(&tank, GetTankColor(index));
+                }
+                else {
+                    Bullet bullet = GetDrawBullet(index, alpha);
+                    DrawBullet(&bullet);
+                }
+            }
         }
     }
-    return false;
-}
\ No newline at end of file
+
+    EndMode2D();
+    EndScissorMode();
+}
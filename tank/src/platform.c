@@ -0,0 +1,14 @@
+// Implementations of the shared utilities that need platform headers.
+// Kept apart from main.c because <windows.h> clashes with raylib.h
+#define THREAD_IMPLEMENTATION
+#define JOBS_IMPLEMENTATION
+#define NET_IMPLEMENTATION
+#define ROLLBACK_IMPLEMENTATION
+#define PAK_IMPLEMENTATION
+#define PROFILER_IMPLEMENTATION
+#include "thread.h"
+#include "jobs.h"
+#include "net.h"
+#include "rollback.h"
+#include "pak.h"
+#include "profiler.h"
@@ -0,0 +1,46 @@
+#include "tank_bot.h"
+#include <math.h>
+
+#define BOT_AIM_DEGREES 5.0f
+#define BOT_DRIVE_DEGREES 45.0f         // Drives only when roughly facing the target
+
+unsigned char GetTankBotButtons(const TankGame *game, int player)
+{
+    const Tank *tank = &game->tanks[player];
+    if (!tank->alive) return 0;
+
+    int target = -1;
+    float targetDistance = 0.0f;
+    for (int i = 0; i < game->tankCount; i++) {
+        if (i == player || !game->tanks[i].alive) continue;
+        float dx = game->tanks[i].position.x - tank->position.x, dy = game->tanks[i].position.y - tank->position.y;
+        float distance = dx*dx + dy*dy;
+        if (target < 0 || distance < targetDistance) {
+            target = i;
+            targetDistance = distance;
+        }
+    }
+    if (target < 0) return 0;
+
+    // Forward is (sin, -cos) of the rotation, like the bots' in tank_sim.c
+    Vector2 diff = { game->tanks[target].position.x - tank->position.x, game->tanks[target].position.y - tank->position.y };
+    float angle = atan2f(diff.x, -diff.y)*RAD2DEG - tank->rotation;
+    angle = fmodf(angle + 540.0f, 360.0f) - 180.0f;
+    while (angle < -180.0f) angle += 360.0f;
+
+    unsigned char buttons = 0;
+    if (angle > TANK_ROT_SPEED) buttons |= TANK_INPUT_RIGHT;
+    else if (angle < -TANK_ROT_SPEED) buttons |= TANK_INPUT_LEFT;
+
+    Vector2 ahead = {
+        tank->position.x + sinf(DEG2RAD*tank->rotation)*LOOKAHEAD_DISTANCE,
+        tank->position.y - cosf(DEG2RAD*tank->rotation)*LOOKAHEAD_DISTANCE
+    };
+    bool blocked = RaycastTiles(game, tank->position, ahead, NULL);
+    if (!blocked && fabsf(angle) < BOT_DRIVE_DEGREES && targetDistance > BOT_PREFERRED_RANGE*BOT_PREFERRED_RANGE) buttons |= TANK_INPUT_UP;
+
+    // Fire acts on the press, let go for a tick after each
+    if (fabsf(angle) < BOT_AIM_DEGREES && !(game->previousButtons[player] & TANK_INPUT_FIRE)) buttons |= TANK_INPUT_FIRE;
+
+    return buttons;
+}
@@ -0,0 +1,11 @@
+#ifndef TANK_BOT_H
+#define TANK_BOT_H
+
+// Autoplayer policy for soak and performance runs (see bot.h): a player tank turns to the nearest tank, closes in
+// to BOT_PREFERRED_RANGE and fires when lined up. Walls in the way get shot through
+
+#include "tank_sim.h"
+
+unsigned char GetTankBotButtons(const TankGame *game, int player);   // Buttons player 0 or 1 would hold this tick
+
+#endif // TANK_BOT_H
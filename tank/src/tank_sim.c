@@ -0,0 +1,600 @@
+#include "tank_sim.h"
+#include "collision.h"
+#include "jobs.h"
+#include "replay.h"
+#include "profiler.h"
+#include <math.h>
+#include <string.h>
+
+// Obstacle layout of one screen-sized block, repeated over the whole arena
+static const Rectangle obstacles[MAX_OBSTACLES] = {
+    { SCREEN_WIDTH/2 - OBSTACLE_SIZE/2, 200, OBSTACLE_SIZE, OBSTACLE_SIZE },
+    { 100, 400, OBSTACLE_SIZE, OBSTACLE_SIZE },
+    { SCREEN_WIDTH - 100 - OBSTACLE_SIZE, 400, OBSTACLE_SIZE, OBSTACLE_SIZE },
+    { SCREEN_WIDTH/2 - OBSTACLE_SIZE/2, 600, OBSTACLE_SIZE, OBSTACLE_SIZE },
+    { 200, 700, OBSTACLE_SIZE, OBSTACLE_SIZE },
+    { SCREEN_WIDTH - 200 - OBSTACLE_SIZE, 700, OBSTACLE_SIZE, OBSTACLE_SIZE }
+};
+
+static void StartRound(TankGame *game);
+static void InitTank(TankGame *game, int index, Vector2 position, float rotation);
+static TankCommand GetPlayerCommand(unsigned char buttons, unsigned char previousButtons);
+static void ThinkTanks(void *data, int first, int last);
+static void SenseTank(TankGame *game, int index);
+static void ApplyTankCommand(TankGame *game, int index, TankCommand command);
+static void UpdateBullets(void *data, int first, int last);
+static void PushEvent(TankGame *game, TankEventType type, Vector2 position);
+
+static void StampObstacle(TankGame *game, Rectangle rect);
+static void DamageTiles(TankGame *game, Vector2 center, float radius);
+static void MarkTileDirty(TankGame *game, int col, int row);
+
+static int GetGridCell(Vector2 pos);
+static bool IsTileSolid(const TankGame *game, Vector2 pos);
+
+void InitTankGame(TankGame *game, int tankCount)
+{
+    game->tankCount = tankCount;
+    for (int i = 0; i < PLAYER_TANKS; i++) game->previousButtons[i] = 0;
+    game->eventCount = 0;
+    StartRound(game);
+}
+
+// Fresh arena and tanks, the tank count and the players' buttons carry over
+void StartRound(TankGame *game)
+{
+    game->tick = 0;
+
+    // Rasterize obstacles into the tile grid, repeating the layout over every screen-sized block of the arena
+    for (int row = 0; row < ARENA_ROWS; row++)
+        for (int col = 0; col < ARENA_COLS; col++) game->tiles[row][col] = 0;
+    for (float y = 0; y < ARENA_HEIGHT; y += SCREEN_HEIGHT) {
+        for (float x = 0; x < ARENA_WIDTH; x += SCREEN_WIDTH) {
+            for (int i = 0; i < MAX_OBSTACLES; i++) {
+                Rectangle rect = obstacles[i];
+                rect.x += x;
+                rect.y += y;
+                StampObstacle(game, rect);
+            }
+        }
+    }
+
+    // Every chunk changed
+    game->dirtyChunkCount = 0;
+    for (int r = 0; r < CHUNK_ROWS; r++) {
+        for (int c = 0; c < CHUNK_COLS; c++) {
+            game->chunkDirty[r][c] = true;
+            game->dirtyChunks[game->dirtyChunkCount++] = r*CHUNK_COLS + c;
+        }
+    }
+
+    // Players
+    InitTank(game, 0, (Vector2){100, 100}, 0);
+    InitTank(game, 1, (Vector2){ARENA_WIDTH - 100, ARENA_HEIGHT - 100}, 180);
+
+    // Bots, scattered over free ground. Spots (x, y and rotation) are drawn in bulk, most of the arena is free
+    RngLanes spawnRng;
+    SeedRngLanes(&spawnRng, BOT_SEED, 0);
+    float spots[3*BOT_SPAWN_BATCH];
+    int spot = BOT_SPAWN_BATCH;
+
+    for (int i = PLAYER_TANKS; i < game->tankCount; i++) {
+        Vector2 position;
+        float rotation;
+        do {
+            if (spot == BOT_SPAWN_BATCH) {
+                FillRandomFloats(&spawnRng, spots, 3*BOT_SPAWN_BATCH);
+                spot = 0;
+            }
+            const float *s = &spots[3*spot++];
+            position.x = TANK_SIZE + s[0]*(ARENA_WIDTH - 2*TANK_SIZE);
+            position.y = TANK_SIZE + s[1]*(ARENA_HEIGHT - 2*TANK_SIZE);
+            rotation = s[2]*360.0f;
+        } while (CheckTankObstacleCollision(game, position));
+
+        InitTank(game, i, position, rotation);
+        game->tanks[i].isBot = true;
+        SeedRng(&game->brains[i].rng, BOT_SEED, (unsigned int)i);
+    }
+
+    BuildSpatialGrid(game);
+}
+
+// One simulation tick, only depends on the current state and the players' buttons
+void StepTankGame(TankGame *game, TankInput input)
+{
+    Tank *tanks = game->tanks;
+    game->eventCount = 0;
+
+    PROFILE_ZONE("grid") BuildSpatialGrid(game);
+
+    // Bots think in parallel: each bot only writes its own brain and command
+    for (int i = 0; i < PLAYER_TANKS; i++) {
+        TankCommand command = GetPlayerCommand(input.buttons[i], game->previousButtons[i]);
+        game->commands[i] = tanks[i].alive? command : (TankCommand){ 0 };
+        game->previousButtons[i] = input.buttons[i];
+    }
+    PROFILE_ZONE("ai") RunParallelFor(ThinkTanks, game, game->tankCount, THINK_BATCH_SIZE);
+
+    // Commands are applied in tank order, so fire events land in the same bullet slots whatever the thread timing
+    for (int i = 0; i < game->tankCount; i++) {
+        if (tanks[i].alive) ApplyTankCommand(game, i, game->commands[i]);
+    }
+
+    // Bullets move and detect hits in parallel, hits are merged back in bullet order
+    PROFILE_ZONE("grid") BuildSpatialGrid(game);
+    PROFILE_ZONE("collision") {
+        RunParallelFor(UpdateBullets, game, game->tankCount*MAX_BULLETS, BULLET_BATCH_SIZE);
+
+        for (int i = 0; i < game->tankCount*MAX_BULLETS; i++) {
+            if (game->bulletHits[i].kind == HIT_TILE) DamageTiles(game, game->bullets[i].position, BULLET_RADIUS);
+            else if (game->bulletHits[i].kind == HIT_TANK && tanks[game->bulletHits[i].tank].alive) {
+                tanks[game->bulletHits[i].tank].alive = false;
+                PushEvent(game, TANK_EVENT_TANK_DESTROYED, tanks[game->bulletHits[i].tank].position);
+            }
+        }
+    }
+
+    int aliveCount = 0;
+    for (int i = 0; i < game->tankCount; i++) if (tanks[i].alive) aliveCount++;
+
+    game->tick++;
+
+    // Round over when one tank (or none) is left
+    if (aliveCount <= 1) {
+        PushEvent(game, TANK_EVENT_ROUND_OVER, (Vector2){ 0, 0 });
+        StartRound(game);
+    }
+}
+
+void InitTank(TankGame *game, int index, Vector2 position, float rotation)
+{
+    game->tanks[index] = (Tank){ 0 };
+    game->tanks[index].position = position;
+    game->tanks[index].rotation = rotation;
+    game->tanks[index].alive = true;
+
+    game->brains[index] = (TankBrain){ .target = -1, .wallDistance = LOOKAHEAD_DISTANCE, .turnDir = 1 };
+    for (int i = 0; i < MAX_BULLETS; i++) game->bullets[index*MAX_BULLETS + i].active = false;
+}
+
+// Fire only on the tick the button goes down
+TankCommand GetPlayerCommand(unsigned char buttons, unsigned char previousButtons)
+{
+    TankCommand command = { 0 };
+    command.turn = ((buttons & TANK_INPUT_RIGHT) != 0) - ((buttons & TANK_INPUT_LEFT) != 0);
+    command.move = ((buttons & TANK_INPUT_UP) != 0) - ((buttons & TANK_INPUT_DOWN) != 0);
+    command.fire = (buttons & ~previousButtons & TANK_INPUT_FIRE) != 0;
+    return command;
+}
+
+// Bot think step: refresh the cached senses on this bot's tick, then steer towards the target or wander
+void ThinkTanks(void *data, int first, int last)
+{
+    TankGame *game = (TankGame *)data;
+    const Tank *tanks = game->tanks;
+
+    ProfileBegin("think");
+    for (int i = first; i < last; i++) {
+        const Tank *tank = &tanks[i];
+        TankBrain *brain = &game->brains[i];
+        if (!tank->isBot || !tank->alive) continue;
+
+        if ((game->tick + i)%SENSE_INTERVAL == 0 || (brain->target >= 0 && !tanks[brain->target].alive)) SenseTank(game, i);
+        if (brain->fireCooldown > 0) brain->fireCooldown--;
+
+        TankCommand command = { 0 };
+
+        if (brain->target >= 0) {
+            Vector2 diff = { tanks[brain->target].position.x - tank->position.x, tanks[brain->target].position.y - tank->position.y };
+            float distance = sqrtf(diff.x*diff.x + diff.y*diff.y);
+
+            // Forward is (sin, -cos) of the rotation
+            float angle = atan2f(diff.x, -diff.y)*RAD2DEG - tank->rotation;
+            angle = fmodf(angle + 540.0f, 360.0f) - 180.0f;
+            if (angle > TANK_ROT_SPEED) command.turn = 1;
+            else if (angle < -TANK_ROT_SPEED) command.turn = -1;
+
+            if (fabsf(angle) < 5.0f && brain->fireCooldown == 0) {
+                command.fire = true;
+                brain->fireCooldown = BOT_FIRE_COOLDOWN;
+            }
+            if (distance > BOT_PREFERRED_RANGE && brain->wallDistance >= LOOKAHEAD_DISTANCE) command.move = 1;
+        }
+        else if (brain->wallDistance < LOOKAHEAD_DISTANCE) {
+            command.turn = brain->turnDir;
+        }
+        else {
+            command.move = 1;
+            unsigned int roll = NextRandom(&brain->rng);
+            if (roll%64 == 0) brain->turnDir = -brain->turnDir;
+            if ((roll >> 8)%4 == 0) command.turn = brain->turnDir;
+        }
+
+        game->commands[i] = command;
+    }
+    ProfileEnd();
+}
+
+// Line-of-sight queries for one bot: nearest enemy in sight and free distance ahead, cached in its brain
+void SenseTank(TankGame *game, int index)
+{
+    const Tank *tanks = game->tanks;
+    const SpatialGrid *grid = &game->grid;
+    const Tank *tank = &tanks[index];
+    TankBrain *brain = &game->brains[index];
+
+    Vector2 ahead = {
+        tank->position.x + sinf(DEG2RAD*tank->rotation)*LOOKAHEAD_DISTANCE,
+        tank->position.y - cosf(DEG2RAD*tank->rotation)*LOOKAHEAD_DISTANCE
+    };
+    float wallDistance = LOOKAHEAD_DISTANCE;
+    RaycastTiles(game, tank->position, ahead, &wallDistance);
+    brain->wallDistance = wallDistance;
+
+    int minCol, minRow, maxCol, maxRow;
+    GetGridRange((Rectangle){ tank->position.x - SIGHT_RANGE, tank->position.y - SIGHT_RANGE, 2*SIGHT_RANGE, 2*SIGHT_RANGE },
+        &minCol, &minRow, &maxCol, &maxRow);
+
+    int best = -1;
+    float bestDistance = SIGHT_RANGE*SIGHT_RANGE;
+    for (int row = minRow; row <= maxRow; row++) {
+        for (int col = minCol; col <= maxCol; col++) {
+            int cell = row*GRID_COLS + col;
+            for (int e = grid->cellStart[cell]; e < grid->cellStart[cell + 1]; e++) {
+                int other = grid->entries[e].index;
+                if (grid->entries[e].kind != ENTITY_TANK || other == index || !tanks[other].alive) continue;
+
+                float dx = tanks[other].position.x - tank->position.x;
+                float dy = tanks[other].position.y - tank->position.y;
+                float distance = dx*dx + dy*dy;
+                // Ties go to the lower index so the result does not depend on grid order
+                if (distance > bestDistance || (distance == bestDistance && other > best)) continue;
+                if (RaycastTiles(game, tank->position, tanks[other].position, NULL)) continue;
+
+                best = other;
+                bestDistance = distance;
+            }
+        }
+    }
+    brain->target = best;
+}
+
+void ApplyTankCommand(TankGame *game, int index, TankCommand command)
+{
+    Tank *tank = &game->tanks[index];
+
+    // Movement
+    float nextRot = tank->rotation + command.turn*TANK_ROT_SPEED;
+
+    Vector2 forward = {
+        sinf(DEG2RAD * nextRot),
+        -cosf(DEG2RAD * nextRot)
+    };
+
+    Vector2 nextPos = tank->position;
+
+    if (command.move != 0) {
+        Vector2 tryPos = {
+            tank->position.x + forward.x * TANK_SPEED * command.move,
+            tank->position.y + forward.y * TANK_SPEED * command.move
+        };
+        if (!CheckTankObstacleCollision(game, tryPos)) {
+            nextPos = tryPos;
+        }
+    }
+
+    // Clamp to arena
+    if (nextPos.x < TANK_SIZE/2) nextPos.x = TANK_SIZE/2;
+    if (nextPos.x > ARENA_WIDTH - TANK_SIZE/2) nextPos.x = ARENA_WIDTH - TANK_SIZE/2;
+    if (nextPos.y < TANK_SIZE/2) nextPos.y = TANK_SIZE/2;
+    if (nextPos.y > ARENA_HEIGHT - TANK_SIZE/2) nextPos.y = ARENA_HEIGHT - TANK_SIZE/2;
+
+    // Only update rotation if not colliding
+    tank->rotation = nextRot;
+    tank->position = nextPos;
+
+    // Fire
+    if (command.fire) {
+        Bullet *owned = &game->bullets[index*MAX_BULLETS];
+        for (int i = 0; i < MAX_BULLETS; i++) {
+            if (!owned[i].active) {
+                owned[i].active = true;
+                owned[i].position = (Vector2){
+                    tank->position.x + forward.x * (TANK_SIZE/2 + BULLET_RADIUS),
+                    tank->position.y + forward.y * (TANK_SIZE/2 + BULLET_RADIUS)
+                };
+                owned[i].rotation = tank->rotation;
+                PushEvent(game, TANK_EVENT_FIRE, owned[i].position);
+                break;
+            }
+        }
+    }
+}
+
+// Moves bullets [first, last) and records what they hit, world state is only changed when hits are merged
+void UpdateBullets(void *data, int first, int last)
+{
+    TankGame *game = (TankGame *)data;
+    const Tank *tanks = game->tanks;
+    const SpatialGrid *grid = &game->grid;
+
+    ProfileBegin("bullets");
+    for (int i = first; i < last; i++) {
+        Bullet *bullet = &game->bullets[i];
+        BulletHit *hit = &game->bulletHits[i];
+        *hit = (BulletHit){ HIT_NONE, -1 };
+        if (!bullet->active) continue;
+
+        bullet->position.x += sinf(DEG2RAD * bullet->rotation) * BULLET_SPEED;
+        bullet->position.y -= cosf(DEG2RAD * bullet->rotation) * BULLET_SPEED;
+
+        // Out of bounds
+        if (bullet->position.x < 0 || bullet->position.x > ARENA_WIDTH ||
+            bullet->position.y < 0 || bullet->position.y > ARENA_HEIGHT) {
+            bullet->active = false;
+            continue;
+        }
+
+        // Hit terrain: the tiles under the bullet get chipped away on merge
+        if (IsTileSolid(game, bullet->position)) {
+            *hit = (BulletHit){ HIT_TILE, -1 };
+            bullet->active = false;
+            continue;
+        }
+
+        // Hit a tank other than the owner, lowest index first
+        int owner = i/MAX_BULLETS;
+        int minCol, minRow, maxCol, maxRow;
+        GetGridRange((Rectangle){ bullet->position.x - TANK_SIZE, bullet->position.y - TANK_SIZE, 2*TANK_SIZE, 2*TANK_SIZE },
+            &minCol, &minRow, &maxCol, &maxRow);
+        for (int row = minRow; row <= maxRow; row++) {
+            for (int col = minCol; col <= maxCol; col++) {
+                int cell = row*GRID_COLS + col;
+                for (int e = grid->cellStart[cell]; e < grid->cellStart[cell + 1]; e++) {
+                    int other = grid->entries[e].index;
+                    if (grid->entries[e].kind != ENTITY_TANK || other == owner || !tanks[other].alive) continue;
+                    if (hit->kind == HIT_TANK && other > hit->tank) continue;
+                    if (OverlapCircles(bullet->position, BULLET_RADIUS, tanks[other].position, TANK_HIT_RADIUS)) {
+                        *hit = (BulletHit){ HIT_TANK, other };
+                    }
+                }
+            }
+        }
+        if (hit->kind == HIT_TANK) bullet->active = false;
+    }
+    ProfileEnd();
+}
+
+unsigned long long HashTankGame(const TankGame *game)
+{
+    unsigned long long hash = REPLAY_HASH_SEED;
+    hash = HashInt(hash, game->tankCount);
+    hash = HashInt(hash, (int)game->tick);
+    hash = HashBytes(hash, game->previousButtons, sizeof(game->previousButtons));
+
+    for (int i = 0; i < game->tankCount; i++) {
+        const Tank *tank = &game->tanks[i];
+        const TankBrain *brain = &game->brains[i];
+        hash = HashInt(hash, tank->alive);
+        if (!tank->alive) continue;
+        hash = HashFloat(hash, tank->position.x);
+        hash = HashFloat(hash, tank->position.y);
+        hash = HashFloat(hash, tank->rotation);
+        hash = HashBytes(hash, brain, sizeof(TankBrain));       // Ints and floats only, no padding
+    }
+    for (int i = 0; i < game->tankCount*MAX_BULLETS; i++) {
+        const Bullet *bullet = &game->bullets[i];
+        hash = HashInt(hash, bullet->active);
+        if (!bullet->active) continue;
+        hash = HashFloat(hash, bullet->position.x);
+        hash = HashFloat(hash, bullet->position.y);
+        hash = HashFloat(hash, bullet->rotation);
+    }
+
+    return HashBytes(hash, game->tiles, sizeof(game->tiles));
+}
+
+void PushEvent(TankGame *game, TankEventType type, Vector2 position)
+{
+    if (game->eventCount < TANK_MAX_EVENTS) game->events[game->eventCount++] = (TankEvent){ type, position };
+}
+
+void SaveTankSnapshot(const TankGame *game, GameSnapshot *snapshot)
+{
+    memset(snapshot, 0, sizeof(GameSnapshot));     // Padding too, snapshots are compared and delta compressed bytewise
+
+    snapshot->tick = game->tick;
+    for (int i = 0; i < PLAYER_TANKS; i++) {
+        const Tank *tank = &game->tanks[i];
+        snapshot->previousButtons[i] = game->previousButtons[i];
+        snapshot->tanks[i] = (TankSnapshot){ tank->position.x, tank->position.y, tank->rotation, tank->alive };
+    }
+    for (int i = 0; i < PLAYER_TANKS*MAX_BULLETS; i++) {
+        const Bullet *bullet = &game->bullets[i];
+        snapshot->bullets[i] = (BulletSnapshot){ bullet->position.x, bullet->position.y, bullet->rotation, bullet->active };
+    }
+
+    const unsigned char *tile = &game->tiles[0][0];
+    for (int i = 0; i < ARENA_ROWS*ARENA_COLS/4; i++, tile += 4) {
+        snapshot->tiles[i] = (unsigned char)(tile[0] | (tile[1] << 2) | (tile[2] << 4) | (tile[3] << 6));
+    }
+}
+
+void LoadTankSnapshot(TankGame *game, const GameSnapshot *snapshot)
+{
+    game->tick = snapshot->tick;
+    for (int i = 0; i < PLAYER_TANKS; i++) {
+        Tank *tank = &game->tanks[i];
+        game->previousButtons[i] = snapshot->previousButtons[i];
+        tank->position = (Vector2){ snapshot->tanks[i].x, snapshot->tanks[i].y };
+        tank->rotation = snapshot->tanks[i].rotation;
+        tank->alive = snapshot->tanks[i].alive;
+    }
+    for (int i = 0; i < PLAYER_TANKS*MAX_BULLETS; i++) {
+        Bullet *bullet = &game->bullets[i];
+        bullet->position = (Vector2){ snapshot->bullets[i].x, snapshot->bullets[i].y };
+        bullet->rotation = snapshot->bullets[i].rotation;
+        bullet->active = snapshot->bullets[i].active;
+    }
+
+    // Only tiles that actually change get their chunk marked
+    for (int i = 0; i < ARENA_ROWS*ARENA_COLS; i++) {
+        unsigned char hp = (snapshot->tiles[i/4] >> ((i%4)*2)) & 3;
+        int row = i/ARENA_COLS, col = i%ARENA_COLS;
+        if (game->tiles[row][col] != hp) {
+            game->tiles[row][col] = hp;
+            MarkTileDirty(game, col, row);
+        }
+    }
+}
+
+void StampObstacle(TankGame *game, Rectangle rect)
+{
+    int minCol = (int)(rect.x/TILE_SIZE), maxCol = (int)((rect.x + rect.width - 1)/TILE_SIZE);
+    int minRow = (int)(rect.y/TILE_SIZE), maxRow = (int)((rect.y + rect.height - 1)/TILE_SIZE);
+    for (int row = minRow; row <= maxRow; row++) {
+        for (int col = minCol; col <= maxCol; col++) {
+            if (row >= 0 && row < ARENA_ROWS && col >= 0 && col < ARENA_COLS) game->tiles[row][col] = TILE_MAX_HP;
+        }
+    }
+}
+
+void DamageTiles(TankGame *game, Vector2 center, float radius)
+{
+    int minCol = (int)((center.x - radius)/TILE_SIZE), maxCol = (int)((center.x + radius)/TILE_SIZE);
+    int minRow = (int)((center.y - radius)/TILE_SIZE), maxRow = (int)((center.y + radius)/TILE_SIZE);
+    for (int row = minRow; row <= maxRow; row++) {
+        for (int col = minCol; col <= maxCol; col++) {
+            if (row < 0 || row >= ARENA_ROWS || col < 0 || col >= ARENA_COLS) continue;
+            if (game->tiles[row][col] > 0) {
+                game->tiles[row][col]--;
+                MarkTileDirty(game, col, row);
+            }
+        }
+    }
+}
+
+void MarkTileDirty(TankGame *game, int col, int row)
+{
+    int r = row/CHUNK_TILES, c = col/CHUNK_TILES;
+    if (game->chunkDirty[r][c]) return;
+    game->chunkDirty[r][c] = true;
+    game->dirtyChunks[game->dirtyChunkCount++] = r*CHUNK_COLS + c;
+}
+
+bool IsTileSolid(const TankGame *game, Vector2 pos)
+{
+    int col = (int)(pos.x/TILE_SIZE);
+    int row = (int)(pos.y/TILE_SIZE);
+    if (pos.x < 0 || pos.y < 0 || row >= ARENA_ROWS || col >= ARENA_COLS) return false;
+    return game->tiles[row][col] > 0;
+}
+
+// Walks the tiles crossed by the segment (DDA), returns true if a solid tile or the arena edge blocks it.
+// hitDistance, if given, receives the distance from the start to the blocking tile
+bool RaycastTiles(const TankGame *game, Vector2 from, Vector2 to, float *hitDistance)
+{
+    float dx = to.x - from.x, dy = to.y - from.y;
+    float length = sqrtf(dx*dx + dy*dy);
+
+    int col = (int)floorf(from.x/TILE_SIZE), row = (int)floorf(from.y/TILE_SIZE);
+    int endCol = (int)floorf(to.x/TILE_SIZE), endRow = (int)floorf(to.y/TILE_SIZE);
+    int stepCol = (dx > 0)? 1 : -1, stepRow = (dy > 0)? 1 : -1;
+
+    // Segment parameter t in [0, 1] at the next vertical/horizontal tile boundary, and between boundaries
+    float tDeltaX = (dx != 0)? TILE_SIZE/fabsf(dx) : INFINITY;
+    float tDeltaY = (dy != 0)? TILE_SIZE/fabsf(dy) : INFINITY;
+    float tMaxX = (dx != 0)? (((dx > 0)? (col + 1)*TILE_SIZE : col*TILE_SIZE) - from.x)/dx : INFINITY;
+    float tMaxY = (dy != 0)? (((dy > 0)? (row + 1)*TILE_SIZE : row*TILE_SIZE) - from.y)/dy : INFINITY;
+    float t = 0.0f;
+
+    for (;;) {
+        if (col < 0 || row < 0 || col >= ARENA_COLS || row >= ARENA_ROWS || game->tiles[row][col] > 0) {
+            if (hitDistance != NULL) *hitDistance = t*length;
+            return true;
+        }
+        if (col == endCol && row == endRow) break;
+
+        if (tMaxX < tMaxY) { t = tMaxX; tMaxX += tDeltaX; col += stepCol; }
+        else { t = tMaxY; tMaxY += tDeltaY; row += stepRow; }
+        if (t > 1.0f) break;
+    }
+
+    return false;
+}
+
+bool CheckTankObstacleCollision(const TankGame *game, Vector2 nextPos)
+{
+    Rectangle tankRect = {
+        nextPos.x - TANK_SIZE/2,
+        nextPos.y - TANK_SIZE*0.3f,
+        TANK_SIZE,
+        TANK_SIZE * 0.6f
+    };
+    int minCol = (int)(tankRect.x/TILE_SIZE), maxCol = (int)((tankRect.x + tankRect.width)/TILE_SIZE);
+    int minRow = (int)(tankRect.y/TILE_SIZE), maxRow = (int)((tankRect.y + tankRect.height)/TILE_SIZE);
+    if (minCol < 0) minCol = 0;
+    if (minRow < 0) minRow = 0;
+    if (maxCol >= ARENA_COLS) maxCol = ARENA_COLS - 1;
+    if (maxRow >= ARENA_ROWS) maxRow = ARENA_ROWS - 1;
+    for (int row = minRow; row <= maxRow; row++) {
+        for (int col = minCol; col <= maxCol; col++) {
+            if (game->tiles[row][col] > 0) return true;
+        }
+    }
+    return false;
+}
+
+int GetGridCell(Vector2 pos)
+{
+    int col = (int)(pos.x/GRID_CELL_SIZE);
+    int row = (int)(pos.y/GRID_CELL_SIZE);
+    if (col < 0) col = 0;
+    if (row < 0) row = 0;
+    if (col >= GRID_COLS) col = GRID_COLS - 1;
+    if (row >= GRID_ROWS) row = GRID_ROWS - 1;
+    return row*GRID_COLS + col;
+}
+
+// Range of grid cells overlapping a world-space area, clamped to the grid
+void GetGridRange(Rectangle area, int *minCol, int *minRow, int *maxCol, int *maxRow)
+{
+    *minCol = (int)floorf(area.x/GRID_CELL_SIZE);
+    *minRow = (int)floorf(area.y/GRID_CELL_SIZE);
+    *maxCol = (int)floorf((area.x + area.width)/GRID_CELL_SIZE);
+    *maxRow = (int)floorf((area.y + area.height)/GRID_CELL_SIZE);
+    if (*minCol < 0) *minCol = 0;
+    if (*minRow < 0) *minRow = 0;
+    if (*maxCol >= GRID_COLS) *maxCol = GRID_COLS - 1;
+    if (*maxRow >= GRID_ROWS) *maxRow = GRID_ROWS - 1;
+}
+
+// Counting sort of the live tanks and bullets into grid cells
+void BuildSpatialGrid(TankGame *game)
+{
+    static EntityRef refs[MAX_GRID_ENTRIES];
+    static int cells[MAX_GRID_ENTRIES];
+    static int fill[GRID_ROWS*GRID_COLS];
+    SpatialGrid *grid = &game->grid;
+    int count = 0;
+
+    for (int t = 0; t < game->tankCount; t++) {
+        if (game->tanks[t].alive) {
+            refs[count] = (EntityRef){ ENTITY_TANK, t };
+            cells[count++] = GetGridCell(game->tanks[t].position);
+        }
+        for (int i = t*MAX_BULLETS; i < (t + 1)*MAX_BULLETS; i++) {
+            if (!game->bullets[i].active) continue;
+            refs[count] = (EntityRef){ ENTITY_BULLET, i };
+            cells[count++] = GetGridCell(game->bullets[i].position);
+        }
+    }
+
+    for (int i = 0; i <= GRID_ROWS*GRID_COLS; i++) grid->cellStart[i] = 0;
+    for (int i = 0; i < count; i++) grid->cellStart[cells[i] + 1]++;
+    for (int i = 0; i < GRID_ROWS*GRID_COLS; i++) grid->cellStart[i + 1] += grid->cellStart[i];
+
+    for (int i = 0; i < GRID_ROWS*GRID_COLS; i++) fill[i] = grid->cellStart[i];
+    for (int i = 0; i < count; i++) grid->entries[fill[cells[i]]++] = refs[i];
+}
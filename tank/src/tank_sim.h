@@ -0,0 +1,189 @@
+#ifndef TANK_SIM_H
+#define TANK_SIM_H
+
+// Tank simulation: arena, tanks, bots and bullets, and the per-tick step, with no window, input or audio calls.
+// Only the raylib.h types are used, so it also builds into the headless target.
+// Bots and bullets are updated with RunParallelFor(), the job system must be initialized first
+
+#include "raylib.h"
+#include "rng.h"
+
+#define SCREEN_WIDTH 720
+#define SCREEN_HEIGHT 900
+
+#define TANK_SIZE 32
+#define TANK_SPEED 2.0f
+#define TANK_ROT_SPEED 2.5f
+#define TANK_HIT_RADIUS (TANK_SIZE*0.4f)
+
+#define BULLET_SPEED 5.0f
+#define BULLET_RADIUS 4
+#define MAX_BULLETS 3               // Bullet slots per tank
+
+#define MAX_OBSTACLES 6
+#define OBSTACLE_SIZE 64
+
+// Tank and bullet pools: tank i owns bullet slots [i*MAX_BULLETS, (i + 1)*MAX_BULLETS)
+#define MAX_TANKS 1024
+#define PLAYER_TANKS 2
+#define ROYALE_TANKS 256            // Default tank count for battle royale mode
+
+// Bots
+#define SIGHT_RANGE 480.0f
+#define LOOKAHEAD_DISTANCE 48.0f
+#define SENSE_INTERVAL 4            // Ticks between line-of-sight refreshes, staggered across bots
+#define BOT_FIRE_COOLDOWN 40
+#define BOT_PREFERRED_RANGE 200.0f
+#define THINK_BATCH_SIZE 32
+#define BOT_SEED 12345              // Every round starts with the same bots, see rng.h
+#define BOT_SPAWN_BATCH 64          // Spawn spots drawn at a time
+#define BULLET_BATCH_SIZE 128
+
+// Arena is a grid of destructible tiles
+#define TILE_SIZE 8
+#define ARENA_COLS 256
+#define ARENA_ROWS 256
+#define ARENA_WIDTH (ARENA_COLS*TILE_SIZE)
+#define ARENA_HEIGHT (ARENA_ROWS*TILE_SIZE)
+#define TILE_MAX_HP 3
+#define CHUNK_TILES 16     // Tile changes are tracked in chunks of CHUNK_TILES x CHUNK_TILES tiles, for the terrain layer
+#define CHUNK_COLS ((ARENA_COLS + CHUNK_TILES - 1)/CHUNK_TILES)
+#define CHUNK_ROWS ((ARENA_ROWS + CHUNK_TILES - 1)/CHUNK_TILES)
+
+// Uniform grid used to find the tanks and bullets near a point or inside a viewport
+#define GRID_CELL_SIZE 128
+#define GRID_COLS ((ARENA_WIDTH + GRID_CELL_SIZE - 1)/GRID_CELL_SIZE)
+#define GRID_ROWS ((ARENA_HEIGHT + GRID_CELL_SIZE - 1)/GRID_CELL_SIZE)
+#define MAX_GRID_ENTRIES (MAX_TANKS*(1 + MAX_BULLETS))
+
+#define TANK_MAX_EVENTS 256
+
+// Buttons held this tick, one byte per player (also the netplay input)
+enum {
+    TANK_INPUT_LEFT = 1,
+    TANK_INPUT_RIGHT = 2,
+    TANK_INPUT_UP = 4,
+    TANK_INPUT_DOWN = 8,
+    TANK_INPUT_FIRE = 16,
+    TANK_INPUT_ALL = 31
+};
+
+typedef struct {
+    unsigned char buttons[PLAYER_TANKS];
+} TankInput;
+
+// What happened during the last step, for sounds and effects
+typedef enum {
+    TANK_EVENT_FIRE = 0,
+    TANK_EVENT_TANK_DESTROYED,
+    TANK_EVENT_ROUND_OVER
+} TankEventType;
+
+typedef struct {
+    TankEventType type;
+    Vector2 position;
+} TankEvent;
+
+typedef struct {
+    Vector2 position;
+    float rotation;
+    bool alive;
+    bool isBot;
+} Tank;
+
+typedef struct Bullet {
+    Vector2 position;
+    float rotation;
+    bool active;
+} Bullet;
+
+// What a tank wants to do this tick, from the players' buttons or from a bot
+typedef struct {
+    int turn;           // -1 left, 1 right
+    int move;           // -1 backwards, 1 forwards
+    bool fire;
+} TankCommand;
+
+typedef struct {
+    int target;             // Tank in sight, -1 if none
+    float wallDistance;     // Free distance ahead, up to LOOKAHEAD_DISTANCE
+    int turnDir;
+    int fireCooldown;
+    Rng rng;                // Wandering turns, a stream per bot
+} TankBrain;
+
+typedef enum { HIT_NONE = 0, HIT_TILE, HIT_TANK } HitKind;
+
+typedef struct {
+    HitKind kind;
+    int tank;
+} BulletHit;
+
+typedef enum { ENTITY_TANK = 0, ENTITY_BULLET } EntityKind;
+
+typedef struct {
+    EntityKind kind;
+    int index;
+} EntityRef;
+
+// Entities bucketed by grid cell: cell i owns entries[cellStart[i]..cellStart[i + 1])
+typedef struct {
+    int cellStart[GRID_ROWS*GRID_COLS + 1];
+    EntityRef entries[MAX_GRID_ENTRIES];
+} SpatialGrid;
+
+typedef struct {
+    int tankCount;
+    Tank tanks[MAX_TANKS];
+    Bullet bullets[MAX_TANKS*MAX_BULLETS];
+    TankBrain brains[MAX_TANKS];
+    TankCommand commands[MAX_TANKS];
+    BulletHit bulletHits[MAX_TANKS*MAX_BULLETS];
+    unsigned int tick;
+    unsigned char previousButtons[PLAYER_TANKS];
+
+    unsigned char tiles[ARENA_ROWS][ARENA_COLS];        // 0 = empty, otherwise remaining hit points
+    bool chunkDirty[CHUNK_ROWS][CHUNK_COLS];
+    int dirtyChunks[CHUNK_ROWS*CHUNK_COLS];             // Chunks with changed tiles, cleared by whoever redraws them
+    int dirtyChunkCount;
+
+    SpatialGrid grid;
+
+    TankEvent events[TANK_MAX_EVENTS];
+    int eventCount;
+} TankGame;
+
+// Compact netplay snapshot of a duel: everything the simulation needs to resume from a frame
+typedef struct {
+    float x, y, rotation;
+    unsigned char alive;
+} TankSnapshot;
+
+typedef struct {
+    float x, y, rotation;
+    unsigned char active;
+} BulletSnapshot;
+
+typedef struct {
+    unsigned int tick;
+    unsigned char previousButtons[PLAYER_TANKS];
+    TankSnapshot tanks[PLAYER_TANKS];
+    BulletSnapshot bullets[PLAYER_TANKS*MAX_BULLETS];
+    unsigned char tiles[ARENA_ROWS*ARENA_COLS/4];       // 2 bits of hit points per tile
+} GameSnapshot;
+
+void InitTankGame(TankGame *game, int tankCount);       // New round, players 0 and 1 plus bots up to tankCount
+void StepTankGame(TankGame *game, TankInput input);     // One tick, events are replaced
+unsigned long long HashTankGame(const TankGame *game);  // For replays, see replay.h
+void BuildSpatialGrid(TankGame *game);                  // Refresh the grid after moving things outside of a step
+void GetGridRange(Rectangle area, int *minCol, int *minRow, int *maxCol, int *maxRow);     // Cells overlapping an area
+
+// Obstacle queries against the tiles
+bool RaycastTiles(const TankGame *game, Vector2 from, Vector2 to, float *hitDistance);  // True if the segment is blocked
+bool CheckTankObstacleCollision(const TankGame *game, Vector2 nextPos);                 // True if a tank can't stand there
+
+// Duel only: tanks and bullets of the two players, and the tiles
+void SaveTankSnapshot(const TankGame *game, GameSnapshot *snapshot);
+void LoadTankSnapshot(TankGame *game, const GameSnapshot *snapshot);
+
+#endif // TANK_SIM_H
@@ -0,0 +1,359 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+// Asset cache: the textures, fonts, atlases, sounds, mixer sounds and music streams a game loads, by name in the pak,
+// shared and reference-counted. Loading a name that is already in returns the same handle without touching the pak
+// or the GPU, so a game restart that asks for its assets again loads nothing and holds no second copy
+//
+//   InitAssetCache(&assets, &pak);
+//   Texture2D ship = AcquireTexture(&assets, "player-ship.png");   // Loaded, 1 reference
+//   Texture2D same = AcquireTexture(&assets, "player-ship.png");   // Same texture, 2 references
+//   ReleaseAsset(&assets, "player-ship.png");                      // 1 reference, still resident
+//   LogAssetCache(&assets);                                        // Resident memory per asset type
+//   UnloadAssetCache(&assets);                                     // Before UnloadPak() and CloseWindow()
+//
+// The handles belong to the cache: release them, never unload them. Unreferenced assets stay resident for the next
+// load until TrimAssetCache(). The startup loader (see startup.h) adds what it uploads, with one reference held by
+// the game's variable. Resident memory is the GPU memory of textures, fonts and atlases, the samples of sounds and
+// mixer sounds, and for music the pak data it streams from
+//
+// Mixer sounds come from <name>.pcm when the pak has one (see pcmbuild.c), already in the mixer's format: the sound
+// borrows its samples from the pak's mapping, nothing is decoded, converted or copied
+//
+// Declarations only, unless ASSETS_IMPLEMENTATION is defined, in a file that includes raylib.h first. Needs pak.h's
+// loaders, atlas.h's and mixer.h's
+
+#include "raylib.h"
+#include "pak.h"
+#include "atlas.h"
+#include "mixer.h"
+
+#define ASSETS_MAX 64                   // Looked up by hash, one pass: games have a few dozen assets at most
+
+typedef enum {
+    ASSET_TEXTURE = 0,
+    ASSET_FONT,
+    ASSET_ATLAS,
+    ASSET_SOUND,
+    ASSET_MIXER_SOUND,
+    ASSET_MUSIC,
+    ASSET_TYPE_COUNT
+} AssetType;
+
+typedef struct {
+    unsigned long long hash;            // PakHash() of the name
+    char name[PAK_MAX_NAME];
+    AssetType type;
+    int refs;
+    size_t bytes;                       // Resident, for the report
+    union {
+        Texture2D texture;
+        Font font;
+        Atlas atlas;
+        Sound sound;
+        MixerSound mixerSound;
+        Music music;
+    };
+} CachedAsset;
+
+typedef struct {
+    const Pak *pak;
+    CachedAsset assets[ASSETS_MAX];
+    int count;
+    int loads;                          // From the pak, the rest were shared
+    int hits;
+} AssetCache;
+
+void InitAssetCache(AssetCache *cache, const Pak *pak);
+Texture2D AcquireTexture(AssetCache *cache, const char *name);
+Font AcquireFont(AssetCache *cache, const char *name);
+Atlas AcquireAtlas(AssetCache *cache, const char *name);
+Sound AcquireSound(AssetCache *cache, const char *name);
+MixerSound AcquireMixerSound(AssetCache *cache, const char *name);
+MixerSound LoadMixerSoundFromPak(const Pak *pak, const char *name);    // Uncached, on any thread
+Music AcquireMusic(AssetCache *cache, const char *name);
+void ReleaseAsset(AssetCache *cache, const char *name);
+void AddCachedAsset(AssetCache *cache, AssetType type, const char *name, const void *handle);  // Loaded elsewhere, 1 reference
+void TrimAssetCache(AssetCache *cache);                 // Unloads the unreferenced assets
+void UnloadAssetCache(AssetCache *cache);               // Unloads them all, referenced or not
+size_t GetAssetCacheMemory(const AssetCache *cache, AssetType type);
+void LogAssetCache(const AssetCache *cache);
+
+#endif // ASSETS_H
+
+#if defined(ASSETS_IMPLEMENTATION) && !defined(ASSETS_IMPLEMENTATION_DONE)
+#define ASSETS_IMPLEMENTATION_DONE
+
+#include <stdio.h>
+#include <string.h>
+
+static const char *assetTypeNames[ASSET_TYPE_COUNT] = { "textures", "fonts", "atlases", "sounds", "mixer", "music" };
+
+static CachedAsset *FindCachedAsset(AssetCache *cache, const char *name);
+static CachedAsset *AcquireCachedAsset(AssetCache *cache, AssetType type, const char *name, bool *cached);
+static void MeasureCachedAsset(const AssetCache *cache, CachedAsset *asset);
+static void UnloadCachedAsset(CachedAsset *asset);
+
+void InitAssetCache(AssetCache *cache, const Pak *pak)
+{
+    *cache = (AssetCache){ 0 };
+    cache->pak = pak;
+}
+
+Texture2D AcquireTexture(AssetCache *cache, const char *name)
+{
+    bool cached = false;
+    CachedAsset *asset = AcquireCachedAsset(cache, ASSET_TEXTURE, name, &cached);
+    if (asset == NULL) return (Texture2D){ 0 };
+    if (!cached) {
+        asset->texture = LoadTextureFromPak(cache->pak, name);
+        MeasureCachedAsset(cache, asset);
+    }
+    return asset->texture;
+}
+
+Font AcquireFont(AssetCache *cache, const char *name)
+{
+    bool cached = false;
+    CachedAsset *asset = AcquireCachedAsset(cache, ASSET_FONT, name, &cached);
+    if (asset == NULL) return GetFontDefault();
+    if (!cached) {
+        asset->font = LoadFontFromPak(cache->pak, name);
+        MeasureCachedAsset(cache, asset);
+    }
+    return asset->font;
+}
+
+Atlas AcquireAtlas(AssetCache *cache, const char *name)
+{
+    bool cached = false;
+    CachedAsset *asset = AcquireCachedAsset(cache, ASSET_ATLAS, name, &cached);
+    if (asset == NULL) return (Atlas){ 0 };
+    if (!cached) {
+        asset->atlas = LoadAtlas(cache->pak, name);
+        MeasureCachedAsset(cache, asset);
+    }
+    return asset->atlas;
+}
+
+Sound AcquireSound(AssetCache *cache, const char *name)
+{
+    bool cached = false;
+    CachedAsset *asset = AcquireCachedAsset(cache, ASSET_SOUND, name, &cached);
+    if (asset == NULL) return (Sound){ 0 };
+    if (!cached) {
+        asset->sound = LoadSoundFromPak(cache->pak, name);
+        MeasureCachedAsset(cache, asset);
+    }
+    return asset->sound;
+}
+
+MixerSound AcquireMixerSound(AssetCache *cache, const char *name)
+{
+    bool cached = false;
+    CachedAsset *asset = AcquireCachedAsset(cache, ASSET_MIXER_SOUND, name, &cached);
+    if (asset == NULL) return (MixerSound){ 0 };
+    if (!cached) {
+        asset->mixerSound = LoadMixerSoundFromPak(cache->pak, name);
+        MeasureCachedAsset(cache, asset);
+    }
+    return asset->mixerSound;
+}
+
+// The prebuilt .pcm if any, else the sound decoded, from the pak or loose. No TextFormat(), its buffers are shared
+MixerSound LoadMixerSoundFromPak(const Pak *pak, const char *name)
+{
+    char path[256];
+    const char *extension = strrchr(name, '.');
+    int length = (extension != NULL)? (int)(extension - name) : (int)strlen(name);
+    snprintf(path, sizeof(path), "%.*s.pcm", length, name);
+
+    int size = 0;
+    const unsigned char *data = GetPakData(pak, path, &size);
+    if (data != NULL) {
+        MixerSound sound = LoadMixerSoundFromPcm(data, size);
+        if (sound.samples != NULL) return sound;
+        TraceLog(LOG_WARNING, "ASSETS: [%s] Not in this mixer's format, decoding %s instead", path, name);
+    }
+
+    data = GetPakData(pak, name, &size);
+    snprintf(path, sizeof(path), "%s%s", (pak->looseDir != NULL)? pak->looseDir : "", name);
+    Wave wave = (data != NULL)? LoadWaveFromMemory(GetFileExtension(name), data, size) : LoadWave(path);
+    MixerSound sound = LoadMixerSoundFromWave(wave);
+    UnloadWave(wave);
+    return sound;
+}
+
+// One stream, shared: its users play, pause and seek the same music
+Music AcquireMusic(AssetCache *cache, const char *name)
+{
+    bool cached = false;
+    CachedAsset *asset = AcquireCachedAsset(cache, ASSET_MUSIC, name, &cached);
+    if (asset == NULL) return (Music){ 0 };
+    if (!cached) {
+        asset->music = LoadMusicFromPak(cache->pak, name);
+        MeasureCachedAsset(cache, asset);
+    }
+    return asset->music;
+}
+
+void ReleaseAsset(AssetCache *cache, const char *name)
+{
+    CachedAsset *asset = FindCachedAsset(cache, name);
+    if (asset == NULL || asset->refs == 0) {
+        TraceLog(LOG_WARNING, "ASSETS: [%s] Released more times than acquired", name);
+        return;
+    }
+    asset->refs--;
+}
+
+void AddCachedAsset(AssetCache *cache, AssetType type, const char *name, const void *handle)
+{
+    if (FindCachedAsset(cache, name) != NULL) {
+        TraceLog(LOG_WARNING, "ASSETS: [%s] Loaded twice, the second copy is not shared", name);
+        return;
+    }
+    bool cached = false;
+    CachedAsset *asset = AcquireCachedAsset(cache, type, name, &cached);
+    if (asset == NULL) return;
+
+    if (type == ASSET_TEXTURE) asset->texture = *(const Texture2D *)handle;
+    else if (type == ASSET_FONT) asset->font = *(const Font *)handle;
+    else if (type == ASSET_ATLAS) asset->atlas = *(const Atlas *)handle;
+    else if (type == ASSET_SOUND) asset->sound = *(const Sound *)handle;
+    else if (type == ASSET_MIXER_SOUND) asset->mixerSound = *(const MixerSound *)handle;
+    else asset->music = *(const Music *)handle;
+    MeasureCachedAsset(cache, asset);
+    cache->loads--;             // Not loaded by the cache
+}
+
+void TrimAssetCache(AssetCache *cache)
+{
+    int count = 0;
+    for (int i = 0; i < cache->count; i++) {
+        if (cache->assets[i].refs == 0) UnloadCachedAsset(&cache->assets[i]);
+        else cache->assets[count++] = cache->assets[i];
+    }
+    cache->count = count;
+}
+
+void UnloadAssetCache(AssetCache *cache)
+{
+    for (int i = 0; i < cache->count; i++) UnloadCachedAsset(&cache->assets[i]);
+    cache->count = 0;
+}
+
+size_t GetAssetCacheMemory(const AssetCache *cache, AssetType type)
+{
+    size_t bytes = 0;
+    for (int i = 0; i < cache->count; i++) if (cache->assets[i].type == type) bytes += cache->assets[i].bytes;
+    return bytes;
+}
+
+void LogAssetCache(const AssetCache *cache)
+{
+    size_t total = 0;
+    TraceLog(LOG_INFO, "ASSETS: %d resident, %d loads, %d shared", cache->count, cache->loads, cache->hits);
+    for (int type = 0; type < ASSET_TYPE_COUNT; type++) {
+        int count = 0, refs = 0;
+        for (int i = 0; i < cache->count; i++) {
+            if (cache->assets[i].type != (AssetType)type) continue;
+            count++;
+            refs += cache->assets[i].refs;
+        }
+        if (count == 0) continue;
+
+        size_t bytes = GetAssetCacheMemory(cache, (AssetType)type);
+        total += bytes;
+        TraceLog(LOG_INFO, "ASSETS:     %-8s %3d  %9.1f KB  %3d references", assetTypeNames[type], count, bytes/1024.0, refs);
+    }
+    TraceLog(LOG_INFO, "ASSETS:     total         %9.1f KB", total/1024.0);
+}
+
+CachedAsset *FindCachedAsset(AssetCache *cache, const char *name)
+{
+    unsigned long long hash = PakHash(name);
+    for (int i = 0; i < cache->count; i++) {
+        if (cache->assets[i].hash == hash && strcmp(cache->assets[i].name, name) == 0) return &cache->assets[i];
+    }
+    return NULL;
+}
+
+// The asset of that name with one more reference, a new entry to load into when it was not cached.
+// NULL when it can't be: a name too long, the cache full, or the name cached as another type
+CachedAsset *AcquireCachedAsset(AssetCache *cache, AssetType type, const char *name, bool *cached)
+{
+    CachedAsset *asset = FindCachedAsset(cache, name);
+    if (asset != NULL) {
+        if (asset->type != type) {
+            TraceLog(LOG_WARNING, "ASSETS: [%s] Cached as %s, not %s", name, assetTypeNames[asset->type], assetTypeNames[type]);
+            return NULL;
+        }
+        asset->refs++;
+        cache->hits++;
+        *cached = true;
+        return asset;
+    }
+
+    if (strlen(name) >= PAK_MAX_NAME || cache->count >= ASSETS_MAX) {
+        TraceLog(LOG_WARNING, "ASSETS: [%s] Name too long or more than %d assets, not loaded", name, ASSETS_MAX);
+        return NULL;
+    }
+    asset = &cache->assets[cache->count++];
+    *asset = (CachedAsset){ 0 };
+    asset->hash = PakHash(name);
+    strcpy(asset->name, name);
+    asset->type = type;
+    asset->refs = 1;
+    cache->loads++;
+    *cached = false;
+    return asset;
+}
+
+void MeasureCachedAsset(const AssetCache *cache, CachedAsset *asset)
+{
+    size_t bytes = 0;
+    if (asset->type == ASSET_TEXTURE) {
+        bytes = GetPixelDataSize(asset->texture.width, asset->texture.height, asset->texture.format);
+    }
+    else if (asset->type == ASSET_FONT) {
+        // The atlas texture, and the glyph images raylib keeps on the CPU
+        bytes = GetPixelDataSize(asset->font.texture.width, asset->font.texture.height, asset->font.texture.format);
+        bytes += asset->font.glyphCount*(sizeof(GlyphInfo) + sizeof(Rectangle));
+        for (int i = 0; asset->font.glyphs != NULL && i < asset->font.glyphCount; i++) {
+            Image image = asset->font.glyphs[i].image;
+            bytes += GetPixelDataSize(image.width, image.height, image.format);
+        }
+    }
+    else if (asset->type == ASSET_ATLAS) {
+        bytes = GetPixelDataSize(asset->atlas.texture.width, asset->atlas.texture.height, asset->atlas.texture.format);
+        if (asset->atlas.packed != NULL) bytes += asset->atlas.count*sizeof(AtlasRegion);
+    }
+    else if (asset->type == ASSET_SOUND) {
+        bytes = (size_t)asset->sound.frameCount*asset->sound.stream.channels*(asset->sound.stream.sampleSize/8);
+    }
+    else if (asset->type == ASSET_MIXER_SOUND) {
+        bytes = (size_t)asset->mixerSound.frameCount*MIXER_CHANNELS*sizeof(float);
+    }
+    else {
+        int size = 0;
+        GetPakData(cache->pak, asset->name, &size);
+        bytes = (size_t)size;
+    }
+    asset->bytes = bytes;
+}
+
+void UnloadCachedAsset(CachedAsset *asset)
+{
+    if (asset->type == ASSET_TEXTURE) UnloadTexture(asset->texture);
+    else if (asset->type == ASSET_FONT) {
+        if (asset->font.texture.id != GetFontDefault().texture.id) UnloadFont(asset->font);    // A failed load got raylib's
+    }
+    else if (asset->type == ASSET_ATLAS) UnloadAtlas(&asset->atlas);
+    else if (asset->type == ASSET_SOUND) UnloadSound(asset->sound);
+    else if (asset->type == ASSET_MIXER_SOUND) UnloadMixerSound(asset->mixerSound);
+    else UnloadMusicStream(asset->music);
+    *asset = (CachedAsset){ 0 };
+}
+
+#endif // ASSETS_IMPLEMENTATION
@@ -0,0 +1,253 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+
+// Sprite atlas: a game's sprites packed into one texture, so that everything drawn from it is one batch whatever the
+// sprite count (see SpriteBatch in drawlist.h). The images in resources/sprites/ are packed at build time by
+// atlasbuild.c into <name>.png and the region table <name>.atlas, both shipped in the pak
+//
+//   Atlas atlas = LoadAtlas(&pak, "sprites");          // Or AddStartupAtlas() (see startup.h)
+//   Rectangle ship = GetAtlasRegion(&atlas, "player-ship");
+//   AddSprite(&batch, 0, atlas.texture, ship, dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
+//
+// Regions are named after their image without the extension. Every atlas also has a small opaque white region,
+// GetAtlasWhite(), to draw rectangles as sprites of the same texture. When the pak has no table (web builds ship
+// the loose resources), the images in the pak's looseDir/<name>/ are packed when the atlas is loaded instead.
+//
+// Declarations only, unless ATLAS_IMPLEMENTATION is defined, in a file that includes raylib.h first. The packer
+// alone, what atlasbuild.c needs, is ATLAS_PACK_IMPLEMENTATION. The loader is built on pak.h
+
+#include "raylib.h"
+#include "pak.h"
+
+#define ATLAS_MAGIC "RATL"
+#define ATLAS_VERSION 1
+#define ATLAS_MAX_NAME 32               // Including the terminator
+#define ATLAS_PADDING 1                 // Transparent pixels around each region, no bleeding between neighbours
+#define ATLAS_WHITE "white"
+#define ATLAS_WHITE_SIZE 4              // Sampled in its middle only, away from the padding
+
+typedef struct {
+    char magic[4];
+    unsigned int version;
+    unsigned int count;                 // Regions after the header
+    unsigned int width, height;         // Of the atlas image
+} AtlasHeader;
+
+typedef struct {
+    char name[ATLAS_MAX_NAME];
+    int x, y, width, height;
+} AtlasRegion;
+
+typedef struct {
+    Texture2D texture;
+    const AtlasRegion *regions;         // Sorted by name, into the pak or the packed table
+    int count;
+    AtlasRegion *packed;                // Table packed at load, when the pak has none
+} Atlas;
+
+// Packs the images into one, the regions (count + 1 with the white one) come out sorted by name. Image names
+// are without extension and shorter than ATLAS_MAX_NAME
+Image PackAtlas(const Image *images, const char **names, int count, AtlasRegion *regions);
+
+Image LoadAtlasImage(Atlas *atlas, const Pak *pak, const char *name);  // Table and pixels, on any thread
+Atlas LoadAtlas(const Pak *pak, const char *name);                     // Both, then the texture
+void UnloadAtlas(Atlas *atlas);
+Rectangle GetAtlasRegion(const Atlas *atlas, const char *name);        // Empty when missing
+Rectangle GetAtlasWhite(const Atlas *atlas);
+
+#endif // ATLAS_H
+
+#if (defined(ATLAS_IMPLEMENTATION) || defined(ATLAS_PACK_IMPLEMENTATION)) && !defined(ATLAS_PACK_IMPLEMENTATION_DONE)
+#define ATLAS_PACK_IMPLEMENTATION_DONE
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    Image image;
+    const char *name;
+} AtlasInput;
+
+static int CompareAtlasInputs(const void *a, const void *b)
+{
+    const AtlasInput *left = (const AtlasInput *)a, *right = (const AtlasInput *)b;
+    if (left->image.height != right->image.height) return right->image.height - left->image.height;
+    if (left->image.width != right->image.width) return right->image.width - left->image.width;
+    return strcmp(left->name, right->name);
+}
+
+static int CompareAtlasRegions(const void *a, const void *b)
+{
+    return strcmp(((const AtlasRegion *)a)->name, ((const AtlasRegion *)b)->name);
+}
+
+// Shelves, tallest images first, in the narrowest power of two width that keeps the atlas about square
+Image PackAtlas(const Image *images, const char **names, int count, AtlasRegion *regions)
+{
+    AtlasInput *inputs = (AtlasInput *)calloc(count + 1, sizeof(AtlasInput));
+    long long area = 0;
+    int widest = 0;
+    for (int i = 0; i < count; i++) {
+        inputs[i] = (AtlasInput){ images[i], names[i] };
+        area += (long long)(images[i].width + 2*ATLAS_PADDING)*(images[i].height + 2*ATLAS_PADDING);
+        if (images[i].width > widest) widest = images[i].width;
+    }
+    inputs[count] = (AtlasInput){ GenImageColor(ATLAS_WHITE_SIZE, ATLAS_WHITE_SIZE, WHITE), ATLAS_WHITE };
+    area += (ATLAS_WHITE_SIZE + 2*ATLAS_PADDING)*(ATLAS_WHITE_SIZE + 2*ATLAS_PADDING);
+    qsort(inputs, count + 1, sizeof(AtlasInput), CompareAtlasInputs);
+
+    int width = 64;
+    while (width < widest + 2*ATLAS_PADDING || (long long)width*width < area) width *= 2;
+
+    int x = 0, y = 0, shelf = 0;
+    for (int i = 0; i <= count; i++) {
+        int w = inputs[i].image.width + 2*ATLAS_PADDING, h = inputs[i].image.height + 2*ATLAS_PADDING;
+        if (x + w > width) {
+            x = 0;
+            y += shelf;
+            shelf = 0;
+        }
+        AtlasRegion *region = &regions[i];
+        *region = (AtlasRegion){ 0 };
+        strncpy(region->name, inputs[i].name, ATLAS_MAX_NAME - 1);
+        region->x = x + ATLAS_PADDING;
+        region->y = y + ATLAS_PADDING;
+        region->width = inputs[i].image.width;
+        region->height = inputs[i].image.height;
+        x += w;
+        if (h > shelf) shelf = h;
+    }
+    int height = 1;
+    while (height < y + shelf) height *= 2;
+
+    Image atlas = GenImageColor(width, height, BLANK);
+    for (int i = 0; i <= count; i++) {
+        Rectangle source = { 0, 0, (float)inputs[i].image.width, (float)inputs[i].image.height };
+        Rectangle dest = { (float)regions[i].x, (float)regions[i].y, source.width, source.height };
+        ImageDraw(&atlas, inputs[i].image, source, dest, WHITE);
+    }
+    UnloadImage(inputs[count].image);
+    free(inputs);
+
+    qsort(regions, count + 1, sizeof(AtlasRegion), CompareAtlasRegions);
+    return atlas;
+}
+
+#endif // ATLAS_PACK_IMPLEMENTATION
+
+#if defined(ATLAS_IMPLEMENTATION) && !defined(ATLAS_IMPLEMENTATION_DONE)
+#define ATLAS_IMPLEMENTATION_DONE
+
+#include <stdio.h>
+
+static Image PackLooseAtlas(Atlas *atlas, const char *directory);
+
+Image LoadAtlasImage(Atlas *atlas, const Pak *pak, const char *name)
+{
+    char fileName[PAK_MAX_NAME];
+    int tableSize = 0, imageSize = 0;
+    snprintf(fileName, sizeof(fileName), "%s.atlas", name);
+    const unsigned char *table = GetPakData(pak, fileName, &tableSize);
+    snprintf(fileName, sizeof(fileName), "%s.png", name);
+    const unsigned char *data = GetPakData(pak, fileName, &imageSize);
+
+    if (table == NULL || data == NULL) {
+        char directory[512];
+        snprintf(directory, sizeof(directory), "%s%s", (pak->looseDir != NULL)? pak->looseDir : "", name);
+        return PackLooseAtlas(atlas, directory);
+    }
+
+    // The table is used in place, in the mapping
+    const AtlasHeader *header = (const AtlasHeader *)table;
+    bool valid = (tableSize >= (int)sizeof(AtlasHeader)) && (memcmp(header->magic, ATLAS_MAGIC, 4) == 0) &&
+        (header->version == ATLAS_VERSION) && (header->count <= (tableSize - sizeof(AtlasHeader))/sizeof(AtlasRegion));
+    if (!valid) {
+        fprintf(stderr, "ATLAS: [%s.atlas] Not a valid region table\n", name);
+        return (Image){ 0 };
+    }
+    atlas->regions = (const AtlasRegion *)(table + sizeof(AtlasHeader));
+    atlas->count = (int)header->count;
+
+    return LoadImageFromMemory(".png", data, imageSize);
+}
+
+// Same packing as atlasbuild, of the images in the directory
+Image PackLooseAtlas(Atlas *atlas, const char *directory)
+{
+    FilePathList files = LoadDirectoryFiles(directory);
+    Image *images = (Image *)calloc(files.count + 1, sizeof(Image));
+    const char **names = (const char **)calloc(files.count + 1, sizeof(const char *));
+    char (*nameBuffers)[ATLAS_MAX_NAME] = (char (*)[ATLAS_MAX_NAME])calloc(files.count + 1, ATLAS_MAX_NAME);
+    int count = 0;
+
+    // No IsFileExtension() or GetFileNameWithoutExt(), their static buffers are not safe off the main thread
+    for (unsigned int i = 0; i < files.count; i++) {
+        const char *path = files.paths[i];
+        const char *base = path;
+        for (const char *c = path; *c != '\0'; c++) if (*c == '/' || *c == '\\') base = c + 1;
+        const char *extension = strrchr(base, '.');
+        if (extension == NULL || strcmp(extension, ".png") != 0 || extension - base >= ATLAS_MAX_NAME) continue;
+
+        images[count] = LoadImage(path);
+        if (images[count].data == NULL) continue;
+        memcpy(nameBuffers[count], base, extension - base);
+        names[count] = nameBuffers[count];
+        count++;
+    }
+    UnloadDirectoryFiles(files);
+    if (count == 0) fprintf(stderr, "ATLAS: [%s] No region table in the pak and no sprites to pack\n", directory);
+
+    atlas->packed = (AtlasRegion *)calloc(count + 1, sizeof(AtlasRegion));
+    Image image = PackAtlas(images, names, count, atlas->packed);
+    atlas->regions = atlas->packed;
+    atlas->count = count + 1;
+
+    for (int i = 0; i < count; i++) UnloadImage(images[i]);
+    free(images);
+    free(names);
+    free(nameBuffers);
+    return image;
+}
+
+Atlas LoadAtlas(const Pak *pak, const char *name)
+{
+    Atlas atlas = { 0 };
+    Image image = LoadAtlasImage(&atlas, pak, name);
+    atlas.texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+    return atlas;
+}
+
+void UnloadAtlas(Atlas *atlas)
+{
+    UnloadTexture(atlas->texture);
+    free(atlas->packed);
+    *atlas = (Atlas){ 0 };
+}
+
+Rectangle GetAtlasRegion(const Atlas *atlas, const char *name)
+{
+    int low = 0, high = atlas->count;
+    while (low < high) {
+        int middle = (low + high)/2;
+        int order = strcmp(atlas->regions[middle].name, name);
+        if (order == 0) {
+            const AtlasRegion *region = &atlas->regions[middle];
+            return (Rectangle){ (float)region->x, (float)region->y, (float)region->width, (float)region->height };
+        }
+        if (order < 0) low = middle + 1;
+        else high = middle;
+    }
+
+    TraceLog(LOG_WARNING, "ATLAS: [%s] No such region", name);
+    return (Rectangle){ 0 };
+}
+
+Rectangle GetAtlasWhite(const Atlas *atlas)
+{
+    Rectangle white = GetAtlasRegion(atlas, ATLAS_WHITE);
+    if (white.width < 2.0f) return white;
+    return (Rectangle){ white.x + 1.0f, white.y + 1.0f, white.width - 2.0f, white.height - 2.0f };
+}
+
+#endif // ATLAS_IMPLEMENTATION
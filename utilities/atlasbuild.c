@@ -0,0 +1,87 @@
+// Sprite atlas packer, run by the games' builds: atlasbuild OUTPUT SPRITE.png...
+// Packs the sprites with PackAtlas() (see atlas.h) into OUTPUT.png and the region table OUTPUT.atlas, which go in
+// the pak. Regions are named after the files without directory or extension. Uses raylib for the images only,
+// no window is opened
+#include "raylib.h"
+#define ATLAS_PACK_IMPLEMENTATION
+#include "atlas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        printf("usage: %s OUTPUT SPRITE.png...\n", argv[0]);
+        return 1;
+    }
+    SetTraceLogLevel(LOG_WARNING);
+
+    int count = argc - 2;
+    Image *images = (Image *)calloc(count + 1, sizeof(Image));
+    const char **names = (const char **)calloc(count + 1, sizeof(const char *));
+    char (*nameBuffers)[ATLAS_MAX_NAME] = (char (*)[ATLAS_MAX_NAME])calloc(count + 1, ATLAS_MAX_NAME);
+
+    for (int i = 0; i < count; i++) {
+        const char *path = argv[i + 2];
+        const char *base = path;
+        for (const char *c = path; *c != '\0'; c++) if (*c == '/' || *c == '\\') base = c + 1;
+        const char *extension = strrchr(base, '.');
+        int length = (extension != NULL)? (int)(extension - base) : (int)strlen(base);
+        if (length >= ATLAS_MAX_NAME || strcmp(base, ATLAS_WHITE ".png") == 0) {
+            fprintf(stderr, "ATLASBUILD: [%s] Name longer than %d characters, or reserved\n", path, ATLAS_MAX_NAME - 1);
+            return 1;
+        }
+        memcpy(nameBuffers[i], base, length);
+        names[i] = nameBuffers[i];
+
+        images[i] = LoadImage(path);
+        if (images[i].data == NULL) {
+            fprintf(stderr, "ATLASBUILD: [%s] Failed to load\n", path);
+            return 1;
+        }
+    }
+
+    AtlasRegion *regions = (AtlasRegion *)calloc(count + 1, sizeof(AtlasRegion));
+    Image atlas = PackAtlas(images, names, count, regions);
+    for (int i = 1; i <= count; i++) {
+        if (strcmp(regions[i].name, regions[i - 1].name) == 0) {
+            fprintf(stderr, "ATLASBUILD: [%s] Two sprites of that name\n", regions[i].name);
+            return 1;
+        }
+    }
+
+    char fileName[1024];
+    snprintf(fileName, sizeof(fileName), "%s.png", argv[1]);
+    if (!ExportImage(atlas, fileName)) {
+        fprintf(stderr, "ATLASBUILD: [%s] Failed to write\n", fileName);
+        return 1;
+    }
+
+    AtlasHeader header = { 0 };
+    memcpy(header.magic, ATLAS_MAGIC, 4);
+    header.version = ATLAS_VERSION;
+    header.count = (unsigned int)(count + 1);
+    header.width = (unsigned int)atlas.width;
+    header.height = (unsigned int)atlas.height;
+
+    snprintf(fileName, sizeof(fileName), "%s.atlas", argv[1]);
+    FILE *out = fopen(fileName, "wb");
+    bool written = (out != NULL) && (fwrite(&header, sizeof(header), 1, out) == 1) &&
+        (fwrite(regions, sizeof(AtlasRegion), count + 1, out) == (size_t)(count + 1));
+    if (out != NULL && fclose(out) != 0) written = false;
+    if (!written) {
+        fprintf(stderr, "ATLASBUILD: [%s] Failed to write\n", fileName);
+        remove(fileName);
+        return 1;
+    }
+
+    printf("ATLASBUILD: [%s] %d sprites, %dx%d\n", argv[1], count, atlas.width, atlas.height);
+    for (int i = 0; i < count; i++) UnloadImage(images[i]);
+    UnloadImage(atlas);
+    free(images);
+    free(names);
+    free(nameBuffers);
+    free(regions);
+    return 0;
+}
@@ -0,0 +1,57 @@
+#ifndef BOT_H
+#define BOT_H
+
+// Autoplayer for unattended runs: each game has a policy that reads its state and returns the buttons a player
+// would hold (see <game>_bot.h), and a Bot turns those into the tick's input the way a human of some skill would.
+// The buttons go through the same input as the keyboard's, so replays record bot sessions like any other
+//
+//   Bot bot;
+//   InitBot(&bot, skill, seed);
+//   input.buttons = NextBotButtons(&bot, GetBreakoutBotButtons(&game), BREAKOUT_INPUT_ALL);
+//
+// Skill goes from 0 to 100. Lower skill reacts later (a decision is held for a few ticks before the policy is
+// asked again) and makes more mistakes (random buttons instead of the policy's). At 100 the policy runs every
+// tick. Policies handle buttons that act on the press themselves, releasing them when the previous tick held them
+//
+// Header-only, like rng.h
+
+#include "rng.h"
+
+#define BOT_DEFAULT_SKILL 75
+#define BOT_RNG_STREAM 0x626f74         // Random stream of the bots, apart from the games' own (see rng.h)
+
+typedef struct {
+    int skill;
+    int reactionTicks;                  // Ticks a decision is held
+    unsigned int mistakeChance;         // Out of 65536, per decision
+    Rng rng;
+    unsigned int buttons;               // Decision being held
+    int holdTicks;
+} Bot;
+
+static inline void InitBot(Bot *bot, int skill, unsigned int seed)
+{
+    if (skill < 0) skill = 0;
+    if (skill > 100) skill = 100;
+
+    *bot = (Bot){ 0 };
+    bot->skill = skill;
+    bot->reactionTicks = (100 - skill)/8;                       // Up to 12 ticks, a fifth of a second at 60 Hz
+    bot->mistakeChance = (unsigned int)(100 - skill)*65536u/400u;  // Up to one decision in four
+    SeedRng(&bot->rng, seed, BOT_RNG_STREAM);
+}
+
+// Buttons of this tick, from what the policy wants
+static inline unsigned int NextBotButtons(Bot *bot, unsigned int wanted, unsigned int buttonMask)
+{
+    if (bot->holdTicks-- > 0) return bot->buttons;
+
+    unsigned int roll = NextRandom(&bot->rng);
+    if ((roll >> 16) < bot->mistakeChance) bot->buttons = NextRandom(&bot->rng) & buttonMask;
+    else bot->buttons = wanted & buttonMask;
+
+    bot->holdTicks = bot->reactionTicks;
+    return bot->buttons;
+}
+
+#endif // BOT_H
@@ -0,0 +1,37 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+// Overlap tests with the same results as raylib's CheckCollision* functions, but header-only,
+// so simulation code can use them in builds that don't link raylib (the headless targets).
+// Only the raylib.h types are used
+
+#include "raylib.h"
+#include <math.h>
+
+static inline bool OverlapRecs(Rectangle a, Rectangle b)
+{
+    return (a.x < b.x + b.width) && (a.x + a.width > b.x) && (a.y < b.y + b.height) && (a.y + a.height > b.y);
+}
+
+static inline bool OverlapCircles(Vector2 center1, float radius1, Vector2 center2, float radius2)
+{
+    float dx = center2.x - center1.x;
+    float dy = center2.y - center1.y;
+    return dx*dx + dy*dy <= (radius1 + radius2)*(radius1 + radius2);
+}
+
+static inline bool OverlapCircleRec(Vector2 center, float radius, Rectangle rec)
+{
+    float dx = fabsf(center.x - (rec.x + rec.width/2.0f));
+    float dy = fabsf(center.y - (rec.y + rec.height/2.0f));
+
+    if (dx > rec.width/2.0f + radius) return false;
+    if (dy > rec.height/2.0f + radius) return false;
+    if (dx <= rec.width/2.0f) return true;
+    if (dy <= rec.height/2.0f) return true;
+
+    float cornerDistanceSq = (dx - rec.width/2.0f)*(dx - rec.width/2.0f) + (dy - rec.height/2.0f)*(dy - rec.height/2.0f);
+    return cornerDistanceSq <= radius*radius;
+}
+
+#endif // COLLISION_H
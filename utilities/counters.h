@@ -0,0 +1,203 @@
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+// Workload counters: named per-frame counts (live entities, pairs tested, nodes expanded, draw calls), to see
+// why a frame was slow where the profiler only shows that it was
+//
+//   COUNT("bfs nodes", expanded);           adds to this frame's value, the name is looked up once per call site
+//
+// CounterFrame() ends a frame: each value moves to last (shown by the overlay), is written to the stream, and
+// starts again from 0. Counters are registered by their first COUNT(). COUNT() runs on one thread at a time, and
+// CounterFrame() while none can: the games count on the pipeline worker (see drawlist.h) and end the frame after
+// FinishPipelineFrame(). GetCounters() and the overlay read a copy made by CounterFrame(), so the main thread can
+// draw them while the worker counts the next frame. Names must be string literals, only their pointers are kept.
+// Defining COUNTERS_DISABLED compiles the COUNT()s out
+//
+// The stream is CSV (one row per frame, a column per counter) when the file name ends in .csv, otherwise binary:
+//   "CNTR", version, then records of varints: 0 id length name (new counter), 1 frame count values... (a frame)
+// A CSV has the counters registered by the end of its first frame, later ones only make it to a binary stream:
+// register a counter that may first be hit late with GetCounterId() up front.
+//
+// Declarations only, unless COUNTERS_IMPLEMENTATION is defined. The overlay is drawn with raylib: define
+// COUNTERS_OVERLAY_IMPLEMENTATION in a file that includes raylib.h first
+
+#include <stdbool.h>
+
+#define COUNTERS_MAX 64
+
+typedef struct {
+    const char *name;
+    long long last;                     // Value of the last frame
+    long long peak;                     // Highest frame value so far
+} Counter;
+
+// This frame's values by id, the extra last slot takes the counts of the ones past COUNTERS_MAX
+extern long long counterValues[COUNTERS_MAX + 1];
+
+int GetCounterId(const char *name);             // Registers the name on first use
+void CounterFrame(void);                        // Frame boundary, once per frame
+int GetCounters(const Counter **counters);      // As of the last CounterFrame(), returns the count
+
+bool OpenCounterStream(const char *fileName);   // Every frame from the next CounterFrame() on, CSV or binary (see above)
+void CloseCounterStream(void);
+
+void UpdateCounterOverlay(void);                // F4 shows or hides the overlay
+void DrawCounterOverlay(int x, int y);          // Only while shown
+
+#if defined(COUNTERS_DISABLED)
+    #define COUNT(name, amount)
+#else
+    #define COUNT(name, amount) do { static int counterId = -1; if (counterId < 0) counterId = GetCounterId(name); counterValues[counterId] += (amount); } while (0)
+#endif
+
+#endif // COUNTERS_H
+
+#if defined(COUNTERS_IMPLEMENTATION) && !defined(COUNTERS_IMPLEMENTATION_DONE)
+#define COUNTERS_IMPLEMENTATION_DONE
+
+#include <stdio.h>
+#include <string.h>
+
+#define COUNTERS_MAGIC "CNTR"
+#define COUNTERS_VERSION 1
+
+long long counterValues[COUNTERS_MAX + 1] = { 0 };
+
+static struct {
+    Counter counters[COUNTERS_MAX];
+    int count;
+    Counter shown[COUNTERS_MAX];        // Copy for GetCounters(), taken at the frame boundary
+    int shownCount;
+    long long frame;
+
+    FILE *stream;
+    bool csv;
+    int streamed;                       // Counters in the CSV header, or already named in the binary stream
+} counters = { 0 };
+
+static void PutCounterVarint(FILE *file, unsigned long long value)
+{
+    while (value >= 0x80) {
+        fputc((int)(value & 0x7f) | 0x80, file);
+        value >>= 7;
+    }
+    fputc((int)value, file);
+}
+
+int GetCounterId(const char *name)
+{
+    for (int i = 0; i < counters.count; i++) if (strcmp(counters.counters[i].name, name) == 0) return i;
+    if (counters.count == COUNTERS_MAX) return COUNTERS_MAX;
+
+    counters.counters[counters.count] = (Counter){ name, 0, 0 };
+    return counters.count++;
+}
+
+void CounterFrame(void)
+{
+    for (int i = 0; i < counters.count; i++) {
+        Counter *counter = &counters.counters[i];
+        counter->last = counterValues[i];
+        if (counter->last > counter->peak) counter->peak = counter->last;
+        counterValues[i] = 0;
+    }
+    counterValues[COUNTERS_MAX] = 0;
+    memcpy(counters.shown, counters.counters, counters.count*sizeof(Counter));
+    counters.shownCount = counters.count;
+
+    if (counters.stream != NULL) {
+        if (counters.csv) {
+            if (counters.frame == 0) {
+                fprintf(counters.stream, "frame");
+                for (int i = 0; i < counters.count; i++) fprintf(counters.stream, ",%s", counters.counters[i].name);
+                fprintf(counters.stream, "\n");
+                counters.streamed = counters.count;
+            }
+            fprintf(counters.stream, "%lld", counters.frame);
+            for (int i = 0; i < counters.streamed; i++) fprintf(counters.stream, ",%lld", counters.counters[i].last);
+            fprintf(counters.stream, "\n");
+        }
+        else {
+            for (; counters.streamed < counters.count; counters.streamed++) {
+                const char *name = counters.counters[counters.streamed].name;
+                size_t length = strlen(name);
+                PutCounterVarint(counters.stream, 0);
+                PutCounterVarint(counters.stream, (unsigned long long)counters.streamed);
+                PutCounterVarint(counters.stream, length);
+                fwrite(name, 1, length, counters.stream);
+            }
+            PutCounterVarint(counters.stream, 1);
+            PutCounterVarint(counters.stream, (unsigned long long)counters.frame);
+            PutCounterVarint(counters.stream, (unsigned long long)counters.count);
+            for (int i = 0; i < counters.count; i++) PutCounterVarint(counters.stream, (unsigned long long)counters.counters[i].last);
+        }
+    }
+
+    counters.frame++;
+}
+
+int GetCounters(const Counter **list)
+{
+    *list = counters.shown;
+    return counters.shownCount;
+}
+
+bool OpenCounterStream(const char *fileName)
+{
+    CloseCounterStream();
+
+    size_t length = strlen(fileName);
+    counters.csv = (length >= 4 && strcmp(fileName + length - 4, ".csv") == 0);
+    counters.stream = fopen(fileName, counters.csv? "w" : "wb");
+    if (counters.stream == NULL) {
+        fprintf(stderr, "COUNTERS: [%s] Failed to create stream file\n", fileName);
+        return false;
+    }
+
+    counters.frame = 0;
+    counters.streamed = 0;
+    if (!counters.csv) {
+        fwrite(COUNTERS_MAGIC, 1, 4, counters.stream);
+        PutCounterVarint(counters.stream, COUNTERS_VERSION);
+    }
+    return true;
+}
+
+void CloseCounterStream(void)
+{
+    if (counters.stream == NULL) return;
+
+    if (counters.csv && counters.streamed < counters.count) {
+        fprintf(stderr, "COUNTERS: %d counters registered after the first frame are missing from the CSV\n", counters.count - counters.streamed);
+    }
+    fclose(counters.stream);
+    counters.stream = NULL;
+}
+
+#endif // COUNTERS_IMPLEMENTATION
+
+#if defined(COUNTERS_OVERLAY_IMPLEMENTATION) && !defined(COUNTERS_OVERLAY_IMPLEMENTATION_DONE)
+#define COUNTERS_OVERLAY_IMPLEMENTATION_DONE
+
+static bool counterOverlayVisible = false;
+
+void UpdateCounterOverlay(void)
+{
+    if (IsKeyPressed(KEY_F4)) counterOverlayVisible = !counterOverlayVisible;
+}
+
+void DrawCounterOverlay(int x, int y)
+{
+    if (!counterOverlayVisible) return;
+
+    const Counter *list = NULL;
+    int count = GetCounters(&list);
+
+    DrawRectangle(x, y, 248, 20 + count*12, Fade(BLACK, 0.75f));
+    DrawText(TextFormat("%-16s %10s %10s", "counter", "last", "peak"), x + 4, y + 4, 10, WHITE);
+    for (int i = 0; i < count; i++) {
+        DrawText(TextFormat("%-16s %10lld %10lld", list[i].name, list[i].last, list[i].peak), x + 4, y + 16 + i*12, 10, LIGHTGRAY);
+    }
+}
+
+#endif // COUNTERS_OVERLAY_IMPLEMENTATION
@@ -0,0 +1,559 @@
+#ifndef DRAWLIST_H
+#define DRAWLIST_H
+
+// Recorded draw commands, and a two-stage frame pipeline built on them: a worker thread updates the game and
+// records frame N+1 while the main thread replays frame N to raylib, so a frame costs about
+// max(update, render) instead of their sum. Drawing shows the game one frame late
+//
+//   InitFramePipeline(&pipeline, RunFrame, NULL);     // RunFrame(user, list): UpdateGame() ticks, then records
+//   while (!WindowShouldClose()) {
+//       input = ReadInput();                           // raylib input, window and GL calls stay on the main thread
+//       StartPipelineFrame(&pipeline);
+//       BeginDrawing();
+//       ReplayDrawList(GetPipelineFrame(&pipeline));
+//       EndDrawing();
+//       FinishPipelineFrame(&pipeline);
+//   }
+//
+// Commands are packed in a byte buffer, a type byte then its arguments, and replayed in order. Text is copied in,
+// so the worker never needs raylib's TextFormat() buffers; sounds ride along to play on the main thread too, raylib's
+// or the mixer's (see mixer.h). Mixer sounds are kept by address and read at replay: one still loading (see
+// startup.h) is written by the main thread, the worker must not read it.
+// Textures are kept by value, they must stay loaded until the frame is replayed
+//
+// Sprites go through a SpriteBatch: added in any order with a layer, recorded sorted by layer then texture, and
+// each run of one texture is one DRAW_SPRITES command. raylib batches the quads of one texture into a single draw
+// call, so with every sprite in one atlas (see atlas.h) the batch costs one draw whatever the sprite count
+//
+//   AddSprite(&batch, 1, atlas.texture, region, dest, origin, rotation, tint);
+//   RecordSpriteBatch(list, &batch);                   // Where the sprites go in the frame, empties the batch
+//
+// Declarations only, unless DRAWLIST_IMPLEMENTATION is defined, which is enough to record and read back commands
+// without raylib (softraster.h draws them headless). The replay and the pipeline need
+// DRAWLIST_REPLAY_IMPLEMENTATION as well: the replay calls raylib and the mixer, define it in a file that includes
+// raylib.h, with mixer.h implemented somewhere.
+// The pipeline needs thread.h implemented somewhere (see the games' platform.c), and runs the worker's frame
+// inline on the main thread when there are no threads (web builds)
+
+#include "raylib.h"
+#include "thread.h"
+#include "mixer.h"
+
+typedef enum {
+    DRAW_CLEAR = 0,
+    DRAW_RECTANGLE,
+    DRAW_CIRCLE,
+    DRAW_LINE,
+    DRAW_TRIANGLE,
+    DRAW_TEXTURE,
+    DRAW_TEXT,
+    DRAW_SOUND,
+    DRAW_SPRITES,
+    DRAW_MIXER_SOUND
+} DrawCommandType;
+
+// One sprite of a DRAW_SPRITES command, drawn like DrawTexturePro()
+typedef struct {
+    Rectangle source, dest;
+    Vector2 origin;
+    float rotation;
+    Color tint;
+} DrawSprite;
+
+// A command read back from a list, only the fields of its type are set
+typedef struct {
+    DrawCommandType type;
+    Color color;                        // Tint for textures
+    Rectangle rec;
+    struct { Vector2 center; float radius; } circle;
+    struct { Vector2 start, end; } line;
+    struct { Vector2 v1, v2, v3; } triangle;
+    struct { Texture2D texture; Rectangle source, dest; Vector2 origin; float rotation; } texture;
+    struct { const char *text; int x, y, fontSize; } text;      // Points into the list
+    Sound sound;
+    struct { Texture2D texture; const unsigned char *sprites; int count; } sprites;    // Points into the list, see GetDrawSprite()
+    struct { const MixerSound *sound; float volume; int priority; } mixerSound;
+} DrawCommand;
+
+typedef struct {
+    unsigned char *bytes;
+    int size;
+    int capacity;                       // Grows as needed and is kept from frame to frame
+    int count;                          // Commands
+    int draws;                          // Commands that draw something, clears and sounds aside
+    int sprites;                        // In DRAW_SPRITES commands
+} DrawList;
+
+typedef struct {
+    int layer;
+    int order;                          // Added, sprites of one layer and texture keep it
+    Texture2D texture;
+    DrawSprite sprite;
+} SpriteBatchItem;
+
+typedef struct {
+    SpriteBatchItem *items;
+    int count;
+    int capacity;                       // Grows as needed and is kept from frame to frame
+} SpriteBatch;
+
+typedef void (*PipelineFunc)(void *user, DrawList *list);
+
+typedef struct {
+    DrawList lists[2];
+    int front;                          // List replayed by the main thread, the worker records into the other
+    PipelineFunc func;
+    void *user;
+
+    Thread *worker;                     // NULL when frames run inline
+    Mutex *mutex;
+    CondVar *cv;
+    int started;                        // Frames handed to the worker, under the mutex
+    int finished;                       // Frames it has recorded
+    bool quit;
+} FramePipeline;
+
+void ResetDrawList(DrawList *list);
+void UnloadDrawList(DrawList *list);
+bool NextDrawCommand(const DrawList *list, int *offset, DrawCommand *command);     // From offset 0, false past the end
+int ReplayDrawList(const DrawList *list);       // Returns the commands replayed
+
+void RecordClear(DrawList *list, Color color);
+void RecordRectangle(DrawList *list, Rectangle rec, Color color);
+void RecordCircle(DrawList *list, Vector2 center, float radius, Color color);
+void RecordLine(DrawList *list, Vector2 start, Vector2 end, Color color);
+void RecordTriangle(DrawList *list, Vector2 v1, Vector2 v2, Vector2 v3, Color color);
+void RecordTexture(DrawList *list, Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint);
+void RecordText(DrawList *list, const char *text, int x, int y, int fontSize, Color color);
+void RecordTextFormat(DrawList *list, int x, int y, int fontSize, Color color, const char *format, ...);
+void RecordSound(DrawList *list, Sound sound);
+void RecordMixerSound(DrawList *list, const MixerSound *sound, float volume, int priority);   // See PlayMixerSound()
+void RecordSprites(DrawList *list, Texture2D texture, const DrawSprite *sprites, int count);
+DrawSprite GetDrawSprite(const DrawCommand *command, int index);       // Of a DRAW_SPRITES command
+
+void AddSprite(SpriteBatch *batch, int layer, Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint);
+void RecordSpriteBatch(DrawList *list, SpriteBatch *batch);
+void UnloadSpriteBatch(SpriteBatch *batch);
+
+void InitFramePipeline(FramePipeline *pipeline, PipelineFunc func, void *user);
+void CloseFramePipeline(FramePipeline *pipeline);
+void StartPipelineFrame(FramePipeline *pipeline);                       // Records the next frame, on the worker if there is one
+const DrawList *GetPipelineFrame(const FramePipeline *pipeline);        // Frame to replay, the one recorded before
+void FinishPipelineFrame(FramePipeline *pipeline);                      // Waits for the recording, which becomes the next frame
+
+#endif // DRAWLIST_H
+
+#if defined(DRAWLIST_IMPLEMENTATION) && !defined(DRAWLIST_IMPLEMENTATION_DONE)
+#define DRAWLIST_IMPLEMENTATION_DONE
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DRAWLIST_MIN_CAPACITY 4096
+#define DRAWLIST_MAX_TEXT 256
+
+typedef struct { Color color; Rectangle rec; } DrawRectangleArgs;
+typedef struct { Color color; Vector2 center; float radius; } DrawCircleArgs;
+typedef struct { Color color; Vector2 start, end; } DrawLineArgs;
+typedef struct { Color color; Vector2 v1, v2, v3; } DrawTriangleArgs;
+typedef struct { Color tint; Texture2D texture; Rectangle source, dest; Vector2 origin; float rotation; } DrawTextureArgs;
+typedef struct { Color color; short x, y, fontSize, length; } DrawTextArgs;      // The text and its terminator follow
+typedef struct { Texture2D texture; int count; } DrawSpritesArgs;               // The sprites follow
+typedef struct { const MixerSound *sound; float volume; int priority; } DrawMixerSoundArgs;
+
+// Room for a command, the caller copies the arguments in
+static unsigned char *PushDrawCommand(DrawList *list, DrawCommandType type, int size, bool draws)
+{
+    if (list->size + 1 + size > list->capacity) {
+        int capacity = (list->capacity > 0)? list->capacity : DRAWLIST_MIN_CAPACITY;
+        while (list->size + 1 + size > capacity) capacity *= 2;
+        list->bytes = (unsigned char *)realloc(list->bytes, capacity);
+        list->capacity = capacity;
+    }
+
+    unsigned char *command = list->bytes + list->size;
+    command[0] = (unsigned char)type;
+    list->size += 1 + size;
+    list->count++;
+    if (draws) list->draws++;
+    return command + 1;
+}
+
+void ResetDrawList(DrawList *list)
+{
+    list->size = 0;
+    list->count = 0;
+    list->draws = 0;
+    list->sprites = 0;
+}
+
+void UnloadDrawList(DrawList *list)
+{
+    free(list->bytes);
+    *list = (DrawList){ 0 };
+}
+
+void RecordClear(DrawList *list, Color color)
+{
+    memcpy(PushDrawCommand(list, DRAW_CLEAR, sizeof(Color), false), &color, sizeof(Color));
+}
+
+void RecordRectangle(DrawList *list, Rectangle rec, Color color)
+{
+    DrawRectangleArgs args = { color, rec };
+    memcpy(PushDrawCommand(list, DRAW_RECTANGLE, sizeof(args), true), &args, sizeof(args));
+}
+
+void RecordCircle(DrawList *list, Vector2 center, float radius, Color color)
+{
+    DrawCircleArgs args = { color, center, radius };
+    memcpy(PushDrawCommand(list, DRAW_CIRCLE, sizeof(args), true), &args, sizeof(args));
+}
+
+void RecordLine(DrawList *list, Vector2 start, Vector2 end, Color color)
+{
+    DrawLineArgs args = { color, start, end };
+    memcpy(PushDrawCommand(list, DRAW_LINE, sizeof(args), true), &args, sizeof(args));
+}
+
+void RecordTriangle(DrawList *list, Vector2 v1, Vector2 v2, Vector2 v3, Color color)
+{
+    DrawTriangleArgs args = { color, v1, v2, v3 };
+    memcpy(PushDrawCommand(list, DRAW_TRIANGLE, sizeof(args), true), &args, sizeof(args));
+}
+
+void RecordTexture(DrawList *list, Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint)
+{
+    DrawTextureArgs args = { tint, texture, source, dest, origin, rotation };
+    memcpy(PushDrawCommand(list, DRAW_TEXTURE, sizeof(args), true), &args, sizeof(args));
+}
+
+void RecordText(DrawList *list, const char *text, int x, int y, int fontSize, Color color)
+{
+    int length = (int)strlen(text);
+    if (length > DRAWLIST_MAX_TEXT) length = DRAWLIST_MAX_TEXT;
+
+    DrawTextArgs args = { color, (short)x, (short)y, (short)fontSize, (short)length };
+    unsigned char *command = PushDrawCommand(list, DRAW_TEXT, sizeof(args) + length + 1, true);
+    memcpy(command, &args, sizeof(args));
+    memcpy(command + sizeof(args), text, length);
+    command[sizeof(args) + length] = '\0';
+}
+
+void RecordTextFormat(DrawList *list, int x, int y, int fontSize, Color color, const char *format, ...)
+{
+    char text[DRAWLIST_MAX_TEXT + 1];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+
+    RecordText(list, text, x, y, fontSize, color);
+}
+
+void RecordSound(DrawList *list, Sound sound)
+{
+    memcpy(PushDrawCommand(list, DRAW_SOUND, sizeof(Sound), false), &sound, sizeof(Sound));
+}
+
+void RecordMixerSound(DrawList *list, const MixerSound *sound, float volume, int priority)
+{
+    DrawMixerSoundArgs args = { sound, volume, priority };
+    memcpy(PushDrawCommand(list, DRAW_MIXER_SOUND, sizeof(args), false), &args, sizeof(args));
+}
+
+void RecordSprites(DrawList *list, Texture2D texture, const DrawSprite *sprites, int count)
+{
+    if (count <= 0) return;
+
+    DrawSpritesArgs args = { texture, count };
+    unsigned char *command = PushDrawCommand(list, DRAW_SPRITES, sizeof(args) + count*sizeof(DrawSprite), true);
+    memcpy(command, &args, sizeof(args));
+    memcpy(command + sizeof(args), sprites, count*sizeof(DrawSprite));
+    list->sprites += count;
+}
+
+DrawSprite GetDrawSprite(const DrawCommand *command, int index)
+{
+    DrawSprite sprite;
+    memcpy(&sprite, command->sprites.sprites + index*sizeof(DrawSprite), sizeof(DrawSprite));
+    return sprite;
+}
+
+void AddSprite(SpriteBatch *batch, int layer, Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint)
+{
+    if (batch->count == batch->capacity) {
+        batch->capacity = (batch->capacity > 0)? 2*batch->capacity : 256;
+        batch->items = (SpriteBatchItem *)realloc(batch->items, batch->capacity*sizeof(SpriteBatchItem));
+    }
+
+    SpriteBatchItem *item = &batch->items[batch->count];
+    item->layer = layer;
+    item->order = batch->count++;
+    item->texture = texture;
+    item->sprite = (DrawSprite){ source, dest, origin, rotation, tint };
+}
+
+static int CompareSpriteBatchItems(const void *a, const void *b)
+{
+    const SpriteBatchItem *left = (const SpriteBatchItem *)a, *right = (const SpriteBatchItem *)b;
+    if (left->layer != right->layer) return (left->layer < right->layer)? -1 : 1;
+    if (left->texture.id != right->texture.id) return (left->texture.id < right->texture.id)? -1 : 1;
+    return left->order - right->order;
+}
+
+// Layers in order, and a command for each run of one texture: layers of the same texture share a run
+void RecordSpriteBatch(DrawList *list, SpriteBatch *batch)
+{
+    qsort(batch->items, batch->count, sizeof(SpriteBatchItem), CompareSpriteBatchItems);
+
+    for (int first = 0, last = 0; first < batch->count; first = last) {
+        Texture2D texture = batch->items[first].texture;
+        while (last < batch->count && batch->items[last].texture.id == texture.id) last++;
+
+        DrawSpritesArgs args = { texture, last - first };
+        unsigned char *command = PushDrawCommand(list, DRAW_SPRITES, sizeof(args) + args.count*sizeof(DrawSprite), true);
+        memcpy(command, &args, sizeof(args));
+        for (int i = first; i < last; i++) memcpy(command + sizeof(args) + (i - first)*sizeof(DrawSprite), &batch->items[i].sprite, sizeof(DrawSprite));
+        list->sprites += args.count;
+    }
+
+    batch->count = 0;
+}
+
+void UnloadSpriteBatch(SpriteBatch *batch)
+{
+    free(batch->items);
+    *batch = (SpriteBatch){ 0 };
+}
+
+bool NextDrawCommand(const DrawList *list, int *offset, DrawCommand *command)
+{
+    if (*offset >= list->size) return false;
+
+    const unsigned char *bytes = list->bytes + *offset;
+    command->type = (DrawCommandType)*bytes++;
+    switch (command->type) {
+        case DRAW_CLEAR: {
+            memcpy(&command->color, bytes, sizeof(Color));
+            bytes += sizeof(Color);
+        } break;
+        case DRAW_RECTANGLE: {
+            DrawRectangleArgs args;
+            memcpy(&args, bytes, sizeof(args));
+            command->color = args.color;
+            command->rec = args.rec;
+            bytes += sizeof(args);
+        } break;
+        case DRAW_CIRCLE: {
+            DrawCircleArgs args;
+            memcpy(&args, bytes, sizeof(args));
+            command->color = args.color;
+            command->circle.center = args.center;
+            command->circle.radius = args.radius;
+            bytes += sizeof(args);
+        } break;
+        case DRAW_LINE: {
+            DrawLineArgs args;
+            memcpy(&args, bytes, sizeof(args));
+            command->color = args.color;
+            command->line.start = args.start;
+            command->line.end = args.end;
+            bytes += sizeof(args);
+        } break;
+        case DRAW_TRIANGLE: {
+            DrawTriangleArgs args;
+            memcpy(&args, bytes, sizeof(args));
+            command->color = args.color;
+            command->triangle.v1 = args.v1;
+            command->triangle.v2 = args.v2;
+            command->triangle.v3 = args.v3;
+            bytes += sizeof(args);
+        } break;
+        case DRAW_TEXTURE: {
+            DrawTextureArgs args;
+            memcpy(&args, bytes, sizeof(args));
+            command->color = args.tint;
+            command->texture.texture = args.texture;
+            command->texture.source = args.source;
+            command->texture.dest = args.dest;
+            command->texture.origin = args.origin;
+            command->texture.rotation = args.rotation;
+            bytes += sizeof(args);
+        } break;
+        case DRAW_TEXT: {
+            DrawTextArgs args;
+            memcpy(&args, bytes, sizeof(args));
+            command->color = args.color;
+            command->text.text = (const char *)bytes + sizeof(args);
+            command->text.x = args.x;
+            command->text.y = args.y;
+            command->text.fontSize = args.fontSize;
+            bytes += sizeof(args) + args.length + 1;
+        } break;
+        case DRAW_SOUND: {
+            memcpy(&command->sound, bytes, sizeof(Sound));
+            bytes += sizeof(Sound);
+        } break;
+        case DRAW_SPRITES: {
+            DrawSpritesArgs args;
+            memcpy(&args, bytes, sizeof(args));
+            command->sprites.texture = args.texture;
+            command->sprites.sprites = bytes + sizeof(args);
+            command->sprites.count = args.count;
+            bytes += sizeof(args) + args.count*sizeof(DrawSprite);
+        } break;
+        case DRAW_MIXER_SOUND: {
+            DrawMixerSoundArgs args;
+            memcpy(&args, bytes, sizeof(args));
+            command->mixerSound.sound = args.sound;
+            command->mixerSound.volume = args.volume;
+            command->mixerSound.priority = args.priority;
+            bytes += sizeof(args);
+        } break;
+    }
+
+    *offset = (int)(bytes - list->bytes);
+    return true;
+}
+
+#endif // DRAWLIST_IMPLEMENTATION
+
+#if defined(DRAWLIST_REPLAY_IMPLEMENTATION) && !defined(DRAWLIST_REPLAY_IMPLEMENTATION_DONE)
+#define DRAWLIST_REPLAY_IMPLEMENTATION_DONE
+
+#include "profiler.h"
+
+int ReplayDrawList(const DrawList *list)
+{
+    DrawCommand command;
+    int offset = 0;
+
+    while (NextDrawCommand(list, &offset, &command)) {
+        switch (command.type) {
+            case DRAW_CLEAR: ClearBackground(command.color); break;
+            case DRAW_RECTANGLE: DrawRectangleRec(command.rec, command.color); break;
+            case DRAW_CIRCLE: DrawCircleV(command.circle.center, command.circle.radius, command.color); break;
+            case DRAW_LINE: DrawLineV(command.line.start, command.line.end, command.color); break;
+            case DRAW_TRIANGLE: DrawTriangle(command.triangle.v1, command.triangle.v2, command.triangle.v3, command.color); break;
+            case DRAW_TEXTURE: {
+                DrawTexturePro(command.texture.texture, command.texture.source, command.texture.dest,
+                    command.texture.origin, command.texture.rotation, command.color);
+            } break;
+            case DRAW_TEXT: DrawText(command.text.text, command.text.x, command.text.y, command.text.fontSize, command.color); break;
+            case DRAW_SOUND: PlaySound(command.sound); break;
+            case DRAW_MIXER_SOUND: PlayMixerSound(*command.mixerSound.sound, command.mixerSound.volume, command.mixerSound.priority); break;
+            case DRAW_SPRITES: {
+                // Same texture all along, raylib keeps adding to one draw call
+                for (int i = 0; i < command.sprites.count; i++) {
+                    DrawSprite sprite = GetDrawSprite(&command, i);
+                    DrawTexturePro(command.sprites.texture, sprite.source, sprite.dest, sprite.origin, sprite.rotation, sprite.tint);
+                }
+            } break;
+        }
+    }
+
+    return list->count;
+}
+
+// Records one frame into the back list
+static void RecordPipelineFrame(FramePipeline *pipeline)
+{
+    DrawList *list = &pipeline->lists[1 - pipeline->front];
+    ResetDrawList(list);
+    pipeline->func(pipeline->user, list);
+}
+
+static int RunPipelineWorker(void *arg)
+{
+    FramePipeline *pipeline = (FramePipeline *)arg;
+    ProfileFrameThread();                   // Its "update" and "record" zones show in the graph
+
+    MutexLock(pipeline->mutex);
+    for (;;) {
+        while (pipeline->finished == pipeline->started && !pipeline->quit) CondVarWait(pipeline->cv, pipeline->mutex);
+        if (pipeline->quit) break;
+        MutexUnlock(pipeline->mutex);
+
+        RecordPipelineFrame(pipeline);
+
+        MutexLock(pipeline->mutex);
+        pipeline->finished++;
+        CondVarBroadcast(pipeline->cv);
+    }
+    MutexUnlock(pipeline->mutex);
+    return 0;
+}
+
+void InitFramePipeline(FramePipeline *pipeline, PipelineFunc func, void *user)
+{
+    *pipeline = (FramePipeline){ 0 };
+    pipeline->func = func;
+    pipeline->user = user;
+
+#if !defined(PLATFORM_WEB)
+    pipeline->mutex = MutexCreate();
+    pipeline->cv = CondVarCreate();
+    pipeline->worker = ThreadCreate(RunPipelineWorker, pipeline);
+    if (pipeline->worker == NULL) {
+        TraceLog(LOG_WARNING, "DRAWLIST: Could not start the pipeline worker, frames run inline");
+        CondVarDestroy(pipeline->cv);
+        MutexDestroy(pipeline->mutex);
+        pipeline->cv = NULL;
+        pipeline->mutex = NULL;
+    }
+#endif
+}
+
+void CloseFramePipeline(FramePipeline *pipeline)
+{
+    if (pipeline->worker != NULL) {
+        MutexLock(pipeline->mutex);
+        pipeline->quit = true;
+        CondVarBroadcast(pipeline->cv);
+        MutexUnlock(pipeline->mutex);
+
+        ThreadJoin(pipeline->worker);
+        CondVarDestroy(pipeline->cv);
+        MutexDestroy(pipeline->mutex);
+    }
+
+    UnloadDrawList(&pipeline->lists[0]);
+    UnloadDrawList(&pipeline->lists[1]);
+    *pipeline = (FramePipeline){ 0 };
+}
+
+void StartPipelineFrame(FramePipeline *pipeline)
+{
+    if (pipeline->worker == NULL) {
+        RecordPipelineFrame(pipeline);
+        return;
+    }
+
+    MutexLock(pipeline->mutex);
+    pipeline->started++;
+    CondVarBroadcast(pipeline->cv);
+    MutexUnlock(pipeline->mutex);
+}
+
+const DrawList *GetPipelineFrame(const FramePipeline *pipeline)
+{
+    return &pipeline->lists[pipeline->front];
+}
+
+void FinishPipelineFrame(FramePipeline *pipeline)
+{
+    if (pipeline->worker != NULL) {
+        PROFILE_ZONE("wait") {
+            MutexLock(pipeline->mutex);
+            while (pipeline->finished != pipeline->started) CondVarWait(pipeline->cv, pipeline->mutex);
+            MutexUnlock(pipeline->mutex);
+        }
+    }
+
+    pipeline->front = 1 - pipeline->front;
+}
+
+#endif // DRAWLIST_REPLAY_IMPLEMENTATION
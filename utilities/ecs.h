@@ -0,0 +1,581 @@
+#ifndef ECS_H
+#define ECS_H
+
+// Entity component system: an entity is an id, its components live in the archetype of its set of components, in
+// fixed-size chunks holding each component as a column of its own. A system is a loop over the chunks of a query,
+// straight down dense arrays of only the components it reads, whatever else the entities carry
+//
+//   enum { POSITION = 0, VELOCITY, LIFETIME };                 // The game's components, ids below ECS_MAX_COMPONENTS
+//   InitEcsWorld(&world);
+//   RegisterComponent(&world, POSITION, sizeof(Vector2));
+//   ...
+//   int moving = AddQuery(&world, ECS_BIT(POSITION) | ECS_BIT(VELOCITY), 0);     // Has all of, has none of
+//   EcsEntity bullet = CreateEntity(&world, ECS_BIT(POSITION) | ECS_BIT(VELOCITY) | ECS_BIT(LIFETIME));
+//   *(Vector2 *)GetComponent(&world, bullet, POSITION) = ship.pos;
+//
+//   EcsIter it = IterateQuery(&world, moving);
+//   while (NextQueryChunk(&it)) {
+//       Vector2 *pos = GetQueryColumn(&it, POSITION);
+//       const Vector2 *vel = GetQueryColumn(&it, VELOCITY);
+//       for (int i = 0; i < it.count; i++) { pos[i].x += vel[i].x; pos[i].y += vel[i].y; }
+//   }
+//   UnloadEcsWorld(&world);
+//
+// Rows stay packed: destroying an entity moves the last one of its archetype into its row, adding or removing a
+// component moves the entity's row to the archetype of the new set, looked up once and then remembered on both
+// archetypes. Queries live in the world and are matched against each archetype when it is created, so iterating
+// one looks nothing up. Emptied chunks are kept for the next entities, a steady game allocates nothing.
+//
+// While iterating, creating entities and DestroyEntityLater() are fine: the entity is dead at once (IsEntityAlive(),
+// GetComponent()) but its row stays, still iterated, until FlushEcsWorld(). DestroyEntity(), AddComponent() and
+// RemoveComponent() move rows, they must not touch an archetype being iterated. Ids and rows only depend on the
+// calls made, so a simulation on an ECS iterates in the same order on every run, as replays need.
+// CopyEcsWorld() copies entities, ids and queries: the copy of a tick before is iterated with the same query ids.
+//
+// Declarations only, unless ECS_IMPLEMENTATION is defined
+
+#include <stdbool.h>
+
+#define ECS_MAX_COMPONENTS 32
+#define ECS_MAX_ARCHETYPES 64           // Distinct component sets, games use a handful
+#define ECS_MAX_QUERIES 16
+#define ECS_CHUNK_SIZE 16384            // Bytes of a chunk, rows fit in it
+#define ECS_BIT(component) (1u << (component))
+
+typedef unsigned int EcsMask;           // A set of components, ECS_BIT() of each
+
+// Index in the low 24 bits, generation in the high 8: ids of destroyed entities go stale. 0 is never an entity
+typedef unsigned int EcsEntity;
+
+typedef struct {
+    unsigned char *data;                // The entity column, then a column per component, capacity rows each
+    int count;
+} EcsChunk;
+
+typedef struct {
+    EcsMask mask;
+    int capacity;                       // Rows per chunk
+    int chunkBytes;
+    int offsets[ECS_MAX_COMPONENTS];    // Of each component's column in a chunk, -1 for those not in the set
+    EcsChunk *chunks;                   // All full but the last in use, the ones after it are spares
+    int chunkCount;                     // In use
+    int chunkAllocated;                 // With their data allocated
+    int chunkCapacity;                  // Of the chunks array
+    int count;                          // Rows
+    int dead;                           // Rows of entities destroyed later, until the flush
+    signed char edges[ECS_MAX_COMPONENTS];  // Archetype with the component added or removed, -1 until needed
+} EcsArchetype;
+
+typedef struct {
+    EcsMask all;
+    EcsMask none;
+    int count;
+    unsigned char archetypes[ECS_MAX_ARCHETYPES];   // The matching ones, in creation order
+} EcsQuery;
+
+typedef struct {
+    int archetype;                      // -1 when free
+    int chunk;
+    int row;                            // Next free index when free, -1 for the last
+    unsigned int generation;
+} EcsRecord;
+
+typedef struct {
+    int componentSizes[ECS_MAX_COMPONENTS];
+    EcsArchetype archetypes[ECS_MAX_ARCHETYPES];
+    int archetypeCount;
+    EcsQuery queries[ECS_MAX_QUERIES];
+    int queryCount;
+
+    EcsRecord *records;                 // By entity index
+    int recordCount;
+    int recordCapacity;
+    int freeRecord;                     // Last freed index, reused first, -1 when none
+    int *pending;                       // Indices destroyed later
+    int pendingCount;
+    int pendingCapacity;
+    int entityCount;                    // Alive
+} EcsWorld;
+
+// A query's chunks, one at a time: entities and columns hold count rows
+typedef struct {
+    const EcsWorld *world;
+    const EcsQuery *query;
+    int next;                           // In the query's archetypes
+    int chunk;
+    const EcsArchetype *archetype;
+    unsigned char *data;
+    const EcsEntity *entities;
+    int count;
+} EcsIter;
+
+void InitEcsWorld(EcsWorld *world);
+void UnloadEcsWorld(EcsWorld *world);
+void ClearEcsWorld(EcsWorld *world);                            // Destroys every entity, keeps archetypes, queries and memory
+void CopyEcsWorld(EcsWorld *dst, const EcsWorld *src);          // dst from InitEcsWorld() or zeroed, its memory is reused
+void RegisterComponent(EcsWorld *world, int component, int size);  // Before the first entity that has it
+int AddQuery(EcsWorld *world, EcsMask all, EcsMask none);       // Query id, -1 if there are too many
+
+EcsEntity CreateEntity(EcsWorld *world, EcsMask components);    // Components zeroed, 0 if there are too many sets
+void DestroyEntity(EcsWorld *world, EcsEntity entity);
+void DestroyEntityLater(EcsWorld *world, EcsEntity entity);     // Dead now, its row goes at the next flush
+void FlushEcsWorld(EcsWorld *world);                            // Removes the rows of the entities destroyed later
+bool IsEntityAlive(const EcsWorld *world, EcsEntity entity);
+EcsMask GetEntityComponents(const EcsWorld *world, EcsEntity entity);
+void *GetComponent(const EcsWorld *world, EcsEntity entity, int component);    // NULL if dead or without it
+void *AddComponent(EcsWorld *world, EcsEntity entity, int component);          // The component, zeroed if new
+void RemoveComponent(EcsWorld *world, EcsEntity entity, int component);
+
+EcsIter IterateQuery(const EcsWorld *world, int query);
+bool NextQueryChunk(EcsIter *it);                               // False past the last chunk
+void *GetQueryColumn(const EcsIter *it, int component);         // NULL if not in this chunk's archetype
+int CountQueryEntities(const EcsWorld *world, int query);       // Alive
+
+#endif // ECS_H
+
+#if defined(ECS_IMPLEMENTATION) && !defined(ECS_IMPLEMENTATION_DONE)
+#define ECS_IMPLEMENTATION_DONE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ECS_INDEX_BITS 24
+#define ECS_INDEX_MASK ((1u << ECS_INDEX_BITS) - 1)
+#define ECS_COLUMN_ALIGNMENT 16         // Columns start aligned for SIMD loads
+
+static int FindArchetype(EcsWorld *world, EcsMask mask);
+static int GetArchetypeEdge(EcsWorld *world, int archetype, int component);
+static void AppendRow(EcsWorld *world, int archetype, EcsEntity entity, int *chunk, int *row);
+static void RemoveRow(EcsWorld *world, int archetype, int chunk, int row);
+static void MoveEntity(EcsWorld *world, unsigned int index, int archetype);
+static int GetChunkBytes(const EcsWorld *world, EcsMask mask, int capacity, int *offsets);
+static void FreeArchetypeChunks(EcsArchetype *archetype);
+
+void InitEcsWorld(EcsWorld *world)
+{
+    memset(world, 0, sizeof(EcsWorld));
+    world->freeRecord = -1;
+}
+
+void UnloadEcsWorld(EcsWorld *world)
+{
+    for (int a = 0; a < ECS_MAX_ARCHETYPES; a++) FreeArchetypeChunks(&world->archetypes[a]);
+    free(world->records);
+    free(world->pending);
+    InitEcsWorld(world);
+}
+
+void ClearEcsWorld(EcsWorld *world)
+{
+    for (int a = 0; a < world->archetypeCount; a++) {
+        EcsArchetype *archetype = &world->archetypes[a];
+        for (int c = 0; c < archetype->chunkCount; c++) archetype->chunks[c].count = 0;
+        archetype->chunkCount = 0;
+        archetype->count = 0;
+        archetype->dead = 0;
+    }
+    // Every index free again, the lowest first, under a new generation so the ids held before go stale
+    world->freeRecord = -1;
+    for (int i = world->recordCount - 1; i >= 0; i--) {
+        EcsRecord *record = &world->records[i];
+        if (record->archetype >= 0) record->generation++;
+        record->archetype = -1;
+        record->row = world->freeRecord;
+        world->freeRecord = i;
+    }
+    world->pendingCount = 0;
+    world->entityCount = 0;
+}
+
+void CopyEcsWorld(EcsWorld *dst, const EcsWorld *src)
+{
+    if (dst == src) return;
+
+    for (int a = 0; a < ECS_MAX_ARCHETYPES; a++) {
+        EcsArchetype *to = &dst->archetypes[a];
+        const EcsArchetype *from = &src->archetypes[a];
+        if (to->chunkBytes != from->chunkBytes || memcmp(to->offsets, from->offsets, sizeof(to->offsets)) != 0) FreeArchetypeChunks(to);  // Another layout
+
+        EcsChunk *chunks = to->chunks;
+        int allocated = to->chunkAllocated;
+        int capacity = to->chunkCapacity;
+        if (allocated < from->chunkCount) {
+            if (capacity < from->chunkCount) {
+                capacity = from->chunkCount;
+                chunks = (EcsChunk *)realloc(chunks, capacity*sizeof(EcsChunk));
+            }
+            for (; allocated < from->chunkCount; allocated++) chunks[allocated] = (EcsChunk){ (unsigned char *)malloc(from->chunkBytes), 0 };
+        }
+
+        // The rows in use only, column by column
+        for (int c = 0; c < from->chunkCount; c++) {
+            const EcsChunk *chunk = &from->chunks[c];
+            memcpy(chunks[c].data, chunk->data, chunk->count*sizeof(EcsEntity));
+            for (int i = 0; i < ECS_MAX_COMPONENTS; i++) {
+                if (from->offsets[i] < 0) continue;
+                memcpy(chunks[c].data + from->offsets[i], chunk->data + from->offsets[i], (size_t)chunk->count*src->componentSizes[i]);
+            }
+            chunks[c].count = chunk->count;
+        }
+        for (int c = from->chunkCount; c < allocated; c++) chunks[c].count = 0;
+
+        *to = *from;
+        to->chunks = chunks;
+        to->chunkAllocated = allocated;
+        to->chunkCapacity = capacity;
+    }
+
+    if (dst->recordCapacity < src->recordCount) {
+        dst->records = (EcsRecord *)realloc(dst->records, src->recordCount*sizeof(EcsRecord));
+        dst->recordCapacity = src->recordCount;
+    }
+    if (src->recordCount > 0) memcpy(dst->records, src->records, src->recordCount*sizeof(EcsRecord));
+    if (dst->pendingCapacity < src->pendingCount) {
+        dst->pending = (int *)realloc(dst->pending, src->pendingCount*sizeof(int));
+        dst->pendingCapacity = src->pendingCount;
+    }
+    if (src->pendingCount > 0) memcpy(dst->pending, src->pending, src->pendingCount*sizeof(int));
+
+    memcpy(dst->componentSizes, src->componentSizes, sizeof(src->componentSizes));
+    memcpy(dst->queries, src->queries, sizeof(src->queries));
+    dst->archetypeCount = src->archetypeCount;
+    dst->queryCount = src->queryCount;
+    dst->recordCount = src->recordCount;
+    dst->freeRecord = src->freeRecord;
+    dst->pendingCount = src->pendingCount;
+    dst->entityCount = src->entityCount;
+}
+
+void RegisterComponent(EcsWorld *world, int component, int size)
+{
+    if (component < 0 || component >= ECS_MAX_COMPONENTS) return;
+    world->componentSizes[component] = size;
+}
+
+int AddQuery(EcsWorld *world, EcsMask all, EcsMask none)
+{
+    if (world->queryCount >= ECS_MAX_QUERIES) {
+        fprintf(stderr, "ECS: More than %d queries\n", ECS_MAX_QUERIES);
+        return -1;
+    }
+
+    EcsQuery *query = &world->queries[world->queryCount];
+    *query = (EcsQuery){ all, none, 0, { 0 } };
+    for (int a = 0; a < world->archetypeCount; a++) {
+        EcsMask mask = world->archetypes[a].mask;
+        if ((mask & all) == all && (mask & none) == 0) query->archetypes[query->count++] = (unsigned char)a;
+    }
+    return world->queryCount++;
+}
+
+EcsEntity CreateEntity(EcsWorld *world, EcsMask components)
+{
+    int archetype = FindArchetype(world, components);
+    if (archetype < 0) return 0;
+
+    int index = world->freeRecord;
+    if (index >= 0) world->freeRecord = world->records[index].row;
+    else {
+        if (world->recordCount >= (int)ECS_INDEX_MASK) return 0;
+        if (world->recordCount == world->recordCapacity) {
+            world->recordCapacity = (world->recordCapacity > 0)? world->recordCapacity*2 : 256;
+            world->records = (EcsRecord *)realloc(world->records, world->recordCapacity*sizeof(EcsRecord));
+        }
+        index = world->recordCount++;
+        world->records[index].generation = 0;
+    }
+
+    EcsRecord *record = &world->records[index];
+    record->generation = (record->generation + 1) & 0xff;
+    if (record->generation == 0) record->generation = 1;        // Keeps 0 from being an id
+    EcsEntity entity = (record->generation << ECS_INDEX_BITS) | (unsigned int)index;
+
+    record->archetype = archetype;
+    AppendRow(world, archetype, entity, &record->chunk, &record->row);
+    world->entityCount++;
+    return entity;
+}
+
+void DestroyEntity(EcsWorld *world, EcsEntity entity)
+{
+    if (!IsEntityAlive(world, entity)) return;
+
+    unsigned int index = entity & ECS_INDEX_MASK;
+    EcsRecord *record = &world->records[index];
+    RemoveRow(world, record->archetype, record->chunk, record->row);
+    record->archetype = -1;
+    record->generation++;               // Stale ids of it no longer match
+    record->row = world->freeRecord;
+    world->freeRecord = (int)index;
+    world->entityCount--;
+}
+
+void DestroyEntityLater(EcsWorld *world, EcsEntity entity)
+{
+    if (!IsEntityAlive(world, entity)) return;
+
+    if (world->pendingCount == world->pendingCapacity) {
+        world->pendingCapacity = (world->pendingCapacity > 0)? world->pendingCapacity*2 : 64;
+        world->pending = (int *)realloc(world->pending, world->pendingCapacity*sizeof(int));
+    }
+    unsigned int index = entity & ECS_INDEX_MASK;
+    world->pending[world->pendingCount++] = (int)index;
+    world->records[index].generation++;
+    world->archetypes[world->records[index].archetype].dead++;
+    world->entityCount--;
+}
+
+void FlushEcsWorld(EcsWorld *world)
+{
+    for (int i = 0; i < world->pendingCount; i++) {
+        int index = world->pending[i];
+        EcsRecord *record = &world->records[index];
+        world->archetypes[record->archetype].dead--;
+        RemoveRow(world, record->archetype, record->chunk, record->row);
+        record->archetype = -1;
+        record->row = world->freeRecord;
+        world->freeRecord = index;
+    }
+    world->pendingCount = 0;
+}
+
+bool IsEntityAlive(const EcsWorld *world, EcsEntity entity)
+{
+    unsigned int index = entity & ECS_INDEX_MASK;
+    return (entity != 0) && ((int)index < world->recordCount) && (world->records[index].archetype >= 0) &&
+        (world->records[index].generation == (entity >> ECS_INDEX_BITS));
+}
+
+EcsMask GetEntityComponents(const EcsWorld *world, EcsEntity entity)
+{
+    if (!IsEntityAlive(world, entity)) return 0;
+    return world->archetypes[world->records[entity & ECS_INDEX_MASK].archetype].mask;
+}
+
+void *GetComponent(const EcsWorld *world, EcsEntity entity, int component)
+{
+    if (!IsEntityAlive(world, entity) || component < 0 || component >= ECS_MAX_COMPONENTS) return NULL;
+
+    const EcsRecord *record = &world->records[entity & ECS_INDEX_MASK];
+    const EcsArchetype *archetype = &world->archetypes[record->archetype];
+    if (archetype->offsets[component] < 0) return NULL;
+    return archetype->chunks[record->chunk].data + archetype->offsets[component] + (size_t)record->row*world->componentSizes[component];
+}
+
+void *AddComponent(EcsWorld *world, EcsEntity entity, int component)
+{
+    if (!IsEntityAlive(world, entity) || component < 0 || component >= ECS_MAX_COMPONENTS) return NULL;
+
+    unsigned int index = entity & ECS_INDEX_MASK;
+    int archetype = world->records[index].archetype;
+    if (!(world->archetypes[archetype].mask & ECS_BIT(component))) {
+        int next = GetArchetypeEdge(world, archetype, component);
+        if (next < 0) return NULL;
+        MoveEntity(world, index, next);
+    }
+    return GetComponent(world, entity, component);
+}
+
+void RemoveComponent(EcsWorld *world, EcsEntity entity, int component)
+{
+    if (!IsEntityAlive(world, entity) || component < 0 || component >= ECS_MAX_COMPONENTS) return;
+
+    unsigned int index = entity & ECS_INDEX_MASK;
+    int archetype = world->records[index].archetype;
+    if (world->archetypes[archetype].mask & ECS_BIT(component)) {
+        int next = GetArchetypeEdge(world, archetype, component);
+        if (next >= 0) MoveEntity(world, index, next);
+    }
+}
+
+EcsIter IterateQuery(const EcsWorld *world, int query)
+{
+    EcsIter it = { 0 };
+    it.world = world;
+    it.query = (query >= 0 && query < world->queryCount)? &world->queries[query] : NULL;
+    it.next = 0;
+    it.chunk = -1;
+    return it;
+}
+
+bool NextQueryChunk(EcsIter *it)
+{
+    if (it->query == NULL) return false;
+
+    it->chunk++;
+    while (it->archetype == NULL || it->chunk >= it->archetype->chunkCount) {
+        // A copy of an earlier tick may not have the query's newest archetypes yet
+        if (it->next >= it->query->count || it->query->archetypes[it->next] >= it->world->archetypeCount) return false;
+        it->archetype = &it->world->archetypes[it->query->archetypes[it->next++]];
+        it->chunk = 0;
+    }
+
+    const EcsChunk *chunk = &it->archetype->chunks[it->chunk];
+    it->data = chunk->data;
+    it->entities = (const EcsEntity *)chunk->data;
+    it->count = chunk->count;
+    return true;
+}
+
+void *GetQueryColumn(const EcsIter *it, int component)
+{
+    if (it->archetype == NULL || component < 0 || component >= ECS_MAX_COMPONENTS || it->archetype->offsets[component] < 0) return NULL;
+    return it->data + it->archetype->offsets[component];
+}
+
+int CountQueryEntities(const EcsWorld *world, int query)
+{
+    if (query < 0 || query >= world->queryCount) return 0;
+
+    int count = 0;
+    const EcsQuery *q = &world->queries[query];
+    for (int i = 0; i < q->count; i++) count += world->archetypes[q->archetypes[i]].count - world->archetypes[q->archetypes[i]].dead;
+    return count;
+}
+
+// The archetype of a component set, created on first use with its chunk layout, and added to the matching queries
+int FindArchetype(EcsWorld *world, EcsMask mask)
+{
+    for (int a = 0; a < world->archetypeCount; a++) {
+        if (world->archetypes[a].mask == mask) return a;
+    }
+    if (world->archetypeCount >= ECS_MAX_ARCHETYPES) {
+        fprintf(stderr, "ECS: More than %d component sets\n", ECS_MAX_ARCHETYPES);
+        return -1;
+    }
+
+    int a = world->archetypeCount++;
+    EcsArchetype *archetype = &world->archetypes[a];
+    FreeArchetypeChunks(archetype);     // Spares of a world this one was copied from
+    memset(archetype, 0, sizeof(EcsArchetype));
+    archetype->mask = mask;
+    memset(archetype->edges, -1, sizeof(archetype->edges));
+
+    int rowBytes = (int)sizeof(EcsEntity);
+    for (int i = 0; i < ECS_MAX_COMPONENTS; i++) if (mask & ECS_BIT(i)) rowBytes += world->componentSizes[i];
+    int capacity = ECS_CHUNK_SIZE/rowBytes;
+    while (capacity > 1 && GetChunkBytes(world, mask, capacity, NULL) > ECS_CHUNK_SIZE) capacity--;
+    if (capacity < 1) capacity = 1;     // Bigger than a chunk, then a chunk per entity
+    archetype->capacity = capacity;
+    archetype->chunkBytes = GetChunkBytes(world, mask, capacity, archetype->offsets);
+
+    for (int q = 0; q < world->queryCount; q++) {
+        EcsQuery *query = &world->queries[q];
+        if ((mask & query->all) == query->all && (mask & query->none) == 0) query->archetypes[query->count++] = (unsigned char)a;
+    }
+    return a;
+}
+
+int GetArchetypeEdge(EcsWorld *world, int archetype, int component)
+{
+    if (world->archetypes[archetype].edges[component] < 0) {
+        int next = FindArchetype(world, world->archetypes[archetype].mask ^ ECS_BIT(component));
+        if (next < 0) return -1;
+        world->archetypes[archetype].edges[component] = (signed char)next;
+        world->archetypes[next].edges[component] = (signed char)archetype;
+    }
+    return world->archetypes[archetype].edges[component];
+}
+
+// A zeroed row at the end of the archetype, in a spare or new chunk if the last is full
+void AppendRow(EcsWorld *world, int archetype, EcsEntity entity, int *chunk, int *row)
+{
+    EcsArchetype *a = &world->archetypes[archetype];
+    if (a->chunkCount == 0 || a->chunks[a->chunkCount - 1].count == a->capacity) {
+        if (a->chunkCount == a->chunkAllocated) {
+            if (a->chunkAllocated == a->chunkCapacity) {
+                a->chunkCapacity = (a->chunkCapacity > 0)? a->chunkCapacity*2 : 4;
+                a->chunks = (EcsChunk *)realloc(a->chunks, a->chunkCapacity*sizeof(EcsChunk));
+            }
+            a->chunks[a->chunkAllocated++] = (EcsChunk){ (unsigned char *)malloc(a->chunkBytes), 0 };
+        }
+        a->chunks[a->chunkCount++].count = 0;
+    }
+
+    EcsChunk *last = &a->chunks[a->chunkCount - 1];
+    *chunk = a->chunkCount - 1;
+    *row = last->count++;
+    ((EcsEntity *)last->data)[*row] = entity;
+    for (int i = 0; i < ECS_MAX_COMPONENTS; i++) {
+        if (a->offsets[i] >= 0) memset(last->data + a->offsets[i] + (size_t)*row*world->componentSizes[i], 0, world->componentSizes[i]);
+    }
+    a->count++;
+}
+
+// Fills the row with the archetype's last one, whose record follows it
+void RemoveRow(EcsWorld *world, int archetype, int chunk, int row)
+{
+    EcsArchetype *a = &world->archetypes[archetype];
+    EcsChunk *last = &a->chunks[a->chunkCount - 1];
+    int lastRow = last->count - 1;
+
+    if (chunk != a->chunkCount - 1 || row != lastRow) {
+        EcsChunk *hole = &a->chunks[chunk];
+        EcsEntity moved = ((EcsEntity *)last->data)[lastRow];
+        ((EcsEntity *)hole->data)[row] = moved;
+        for (int i = 0; i < ECS_MAX_COMPONENTS; i++) {
+            if (a->offsets[i] < 0) continue;
+            int size = world->componentSizes[i];
+            memcpy(hole->data + a->offsets[i] + (size_t)row*size, last->data + a->offsets[i] + (size_t)lastRow*size, size);
+        }
+        EcsRecord *record = &world->records[moved & ECS_INDEX_MASK];
+        record->chunk = chunk;
+        record->row = row;
+    }
+
+    last->count--;
+    if (last->count == 0) a->chunkCount--;      // Kept as a spare
+    a->count--;
+}
+
+void MoveEntity(EcsWorld *world, unsigned int index, int archetype)
+{
+    EcsRecord *record = &world->records[index];
+    EcsEntity entity = (record->generation << ECS_INDEX_BITS) | index;
+    int chunk = 0, row = 0;
+    AppendRow(world, archetype, entity, &chunk, &row);
+
+    const EcsArchetype *from = &world->archetypes[record->archetype];
+    const EcsArchetype *to = &world->archetypes[archetype];
+    const unsigned char *src = from->chunks[record->chunk].data;
+    unsigned char *dst = to->chunks[chunk].data;
+    for (int i = 0; i < ECS_MAX_COMPONENTS; i++) {
+        if (from->offsets[i] < 0 || to->offsets[i] < 0) continue;
+        int size = world->componentSizes[i];
+        memcpy(dst + to->offsets[i] + (size_t)row*size, src + from->offsets[i] + (size_t)record->row*size, size);
+    }
+
+    RemoveRow(world, record->archetype, record->chunk, record->row);
+    record->archetype = archetype;
+    record->chunk = chunk;
+    record->row = row;
+}
+
+// Bytes of a chunk of capacity rows: the entity column, then each component's, aligned
+int GetChunkBytes(const EcsWorld *world, EcsMask mask, int capacity, int *offsets)
+{
+    int bytes = capacity*(int)sizeof(EcsEntity);
+    for (int i = 0; i < ECS_MAX_COMPONENTS; i++) {
+        if (!(mask & ECS_BIT(i))) {
+            if (offsets != NULL) offsets[i] = -1;
+            continue;
+        }
+        bytes = (bytes + ECS_COLUMN_ALIGNMENT - 1) & ~(ECS_COLUMN_ALIGNMENT - 1);
+        if (offsets != NULL) offsets[i] = bytes;
+        bytes += capacity*world->componentSizes[i];
+    }
+    return bytes;
+}
+
+void FreeArchetypeChunks(EcsArchetype *archetype)
+{
+    for (int c = 0; c < archetype->chunkAllocated; c++) free(archetype->chunks[c].data);
+    free(archetype->chunks);
+    archetype->chunks = NULL;
+    archetype->chunkCount = 0;
+    archetype->chunkAllocated = 0;
+    archetype->chunkCapacity = 0;
+}
+
+#endif // ECS_IMPLEMENTATION
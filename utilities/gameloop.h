@@ -0,0 +1,105 @@
+#ifndef GAMELOOP_H
+#define GAMELOOP_H
+
+// Fixed-timestep main loop: the simulation always steps at the tick rate whatever the display rate, and
+// drawing interpolates between the last two ticks
+//
+//   InitGameLoop(&loop, GAMELOOP_TICK_RATE, GAMELOOP_MAX_CATCH_UP);
+//   while (!WindowShouldClose()) {
+//       for (int ticks = AdvanceGameLoop(&loop, GetTime()); ticks > 0; ticks--) UpdateGame();  // Keeps the previous state
+//       DrawGame(GetGameLoopAlpha(&loop));      // Previous state + alpha*(current - previous)
+//   }
+//
+// After a hitch at most maxCatchUp ticks run in one frame, the rest of the lost time is dropped so the game
+// slows down for a moment instead of spiralling. Time is passed in, so the loop itself needs no clock.
+// Only the raylib.h types are used
+//
+// Declarations only, unless GAMELOOP_IMPLEMENTATION is defined
+
+#include "raylib.h"
+#include <math.h>
+
+#define GAMELOOP_TICK_RATE 60           // Ticks per second the games' speeds and timers are tuned for
+#define GAMELOOP_MAX_CATCH_UP 5         // Ticks per frame at most
+
+typedef struct {
+    double tickSeconds;
+    int maxCatchUp;
+    double accumulator;                 // Time not simulated yet, less than a tick after AdvanceGameLoop()
+    double lastTime;                    // Of the previous frame, negative before the first one
+    long long ticks;                    // Run so far
+    double droppedSeconds;              // Lost to catch-up capping so far
+} GameLoop;
+
+void InitGameLoop(GameLoop *loop, int tickRate, int maxCatchUp);
+int AdvanceGameLoop(GameLoop *loop, double time);       // Ticks to run this frame, time in seconds (GetTime())
+float GetGameLoopAlpha(const GameLoop *loop);           // Fraction of a tick since the last one, in [0, 1)
+
+// Draw position between the last two ticks. A longer move than maxDistance (screen wrap, respawn) is a jump
+// and shows at the current position
+static inline Vector2 InterpolatePosition(Vector2 previous, Vector2 current, float alpha, float maxDistance)
+{
+    float dx = current.x - previous.x, dy = current.y - previous.y;
+    if (dx*dx + dy*dy > maxDistance*maxDistance) return current;
+    return (Vector2){ previous.x + dx*alpha, previous.y + dy*alpha };
+}
+
+// Same for a rectangle's position, the size is the current one
+static inline Rectangle InterpolateRectangle(Rectangle previous, Rectangle current, float alpha, float maxDistance)
+{
+    Vector2 position = InterpolatePosition((Vector2){ previous.x, previous.y }, (Vector2){ current.x, current.y }, alpha, maxDistance);
+    return (Rectangle){ position.x, position.y, current.width, current.height };
+}
+
+// Angle in degrees between the last two ticks, the short way round
+static inline float InterpolateAngle(float previous, float current, float alpha)
+{
+    float delta = fmodf(current - previous + 540.0f, 360.0f) - 180.0f;
+    return previous + delta*alpha;
+}
+
+#endif // GAMELOOP_H
+
+#if defined(GAMELOOP_IMPLEMENTATION) && !defined(GAMELOOP_IMPLEMENTATION_DONE)
+#define GAMELOOP_IMPLEMENTATION_DONE
+
+void InitGameLoop(GameLoop *loop, int tickRate, int maxCatchUp)
+{
+    *loop = (GameLoop){ 0 };
+    loop->tickSeconds = 1.0/tickRate;
+    loop->maxCatchUp = maxCatchUp;
+    loop->lastTime = -1.0;
+}
+
+int AdvanceGameLoop(GameLoop *loop, double time)
+{
+    // The first frame runs one tick, so there is a current state to draw
+    if (loop->lastTime < 0.0) {
+        loop->lastTime = time;
+        loop->ticks++;
+        return 1;
+    }
+
+    double elapsed = time - loop->lastTime;
+    loop->lastTime = time;
+    if (elapsed > 0.0) loop->accumulator += elapsed;
+
+    int ticks = (int)(loop->accumulator/loop->tickSeconds);
+    if (ticks > loop->maxCatchUp) {
+        loop->droppedSeconds += (ticks - loop->maxCatchUp)*loop->tickSeconds;
+        ticks = loop->maxCatchUp;
+        loop->accumulator = fmod(loop->accumulator, loop->tickSeconds);
+    }
+    else loop->accumulator -= ticks*loop->tickSeconds;
+
+    loop->ticks += ticks;
+    return ticks;
+}
+
+float GetGameLoopAlpha(const GameLoop *loop)
+{
+    float alpha = (float)(loop->accumulator/loop->tickSeconds);
+    return (alpha < 1.0f)? alpha : 0.999f;
+}
+
+#endif // GAMELOOP_IMPLEMENTATION
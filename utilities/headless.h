@@ -0,0 +1,304 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+// Shared bits of the <game>_headless drivers: command line, clock, random or replayed input, state hashes and report.
+// The headless targets run a game's simulation without a window or audio device, and don't link raylib
+//
+//   <game>_headless [--ticks N] [--seed N] [--quiet]      random input
+//   <game>_headless --replay FILE                         re-simulate a session recorded by the game
+//   [--record FILE]       save the session as a replay
+//   [--hashes FILE]       write the rolling state hash of every tick, one "tick hash" line each
+//   [--compare FILE]      hashes of an earlier run, stop at the first tick that differs
+//   [--profile FILE]      Chrome trace of the simulation's zones, one frame per tick (see profiler.h)
+//   [--counters FILE]     workload counters of every tick, CSV or binary (see counters.h)
+//   [--frames DIR]        save a picture of the game as DIR/<game>_<tick>.png, for games that can draw headless
+//   [--frame-every N]     ticks between pictures, 60 by default
+//   [--bot SKILL]         the game plays itself with skill 0 to 100 instead of random input (see bot.h)
+//   [--soak SECONDS]      run for this long rather than --ticks, reporting tick time drift and memory (see soak.h)
+//   [--soak-log FILE]     CSV of the soak, a row every SOAK_INTERVAL_SECONDS
+//
+// A driver loops while run.tick < run.options.ticks: NextHeadlessButtons(), or NextHeadlessBotButtons() with the
+// game's bot policy when run.botting is set, step the game, then EndHeadlessTick() with the state hash when
+// run.hashing is set. When IsHeadlessFrameDue(), it records the game
+// in a draw list and saves it to GetHeadlessFramePath() with softraster.h.
+//
+// Declarations only, unless HEADLESS_IMPLEMENTATION is defined. Built on replay.h, profiler.h, counters.h, bot.h
+// and soak.h
+
+#include "replay.h"
+#include "profiler.h"
+#include "counters.h"
+#include "bot.h"
+#include "soak.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+typedef struct {
+    long long ticks;            // --ticks N, simulation ticks to run
+    unsigned int seed;          // --seed N, for the game and the random input
+    bool quiet;                 // --quiet, no report
+    const char *replayFile;     // --replay FILE
+    const char *recordFile;     // --record FILE
+    const char *hashFile;       // --hashes FILE
+    const char *compareFile;    // --compare FILE
+    const char *profileFile;    // --profile FILE
+    const char *countersFile;   // --counters FILE
+    const char *framesDir;      // --frames DIR
+    int frameEvery;             // --frame-every N
+    int botSkill;               // --bot SKILL, negative for random input
+    double soakSeconds;         // --soak SECONDS
+    const char *soakLogFile;    // --soak-log FILE
+} HeadlessOptions;
+
+// Random button combinations, each held for a random number of ticks, like a player mashing keys
+typedef struct {
+    unsigned int seed;
+    unsigned int buttons;
+    int holdTicks;
+} RandomButtons;
+
+typedef struct {
+    HeadlessOptions options;    // Seed and ticks come from the replay when there is one
+    const char *game;
+    RandomButtons random;
+    Replay replay;              // Loaded with --replay, otherwise the session being recorded
+    ReplayPlayer player;
+    unsigned int buttons;       // Random or bot buttons of the tick in progress
+    Bot bot;
+    SoakRun soak;
+    bool replaying;
+    bool botting;               // The driver must ask its bot policy for the buttons, see NextHeadlessBotButtons()
+    bool hashing;               // The driver must pass each tick's state hash to EndHeadlessTick()
+    FILE *hashes;
+    FILE *compare;
+    long long divergedTick;     // First tick that missed a checkpoint or the --compare hashes, -1 if none
+    long long tick;
+    long long events;
+    double startTime;
+} HeadlessRun;
+
+HeadlessOptions ParseHeadlessOptions(int argc, char *argv[]);
+double GetHeadlessTime(void);                                   // Monotonic seconds
+unsigned int NextRandomButtons(RandomButtons *input, unsigned int buttonMask);
+void PrintHeadlessReport(const char *game, HeadlessOptions options, double seconds, long long events);
+
+// mode is the game's start option when not replaying (see Replay), run.replay.mode has the one to use
+bool StartHeadlessRun(HeadlessRun *run, int argc, char *argv[], const char *game, int mode);
+unsigned int NextHeadlessButtons(HeadlessRun *run, unsigned int buttonMask);
+unsigned int NextHeadlessBotButtons(HeadlessRun *run, unsigned int botButtons, unsigned int buttonMask);   // botButtons from the game's policy
+bool EndHeadlessTick(HeadlessRun *run, int events, unsigned long long stateHash);   // False when the run must stop
+int FinishHeadlessRun(HeadlessRun *run);                        // Report and cleanup, returns the exit code
+bool IsHeadlessFrameDue(const HeadlessRun *run);                // After EndHeadlessTick(), true when a picture is due
+const char *GetHeadlessFramePath(const HeadlessRun *run);       // Of the picture due, valid until the next call
+
+#endif // HEADLESS_H
+
+#if defined(HEADLESS_IMPLEMENTATION) && !defined(HEADLESS_IMPLEMENTATION_DONE)
+#define HEADLESS_IMPLEMENTATION_DONE
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+#define HEADLESS_DEFAULT_TICKS 100000
+#define HEADLESS_DEFAULT_FRAME_EVERY 60
+
+HeadlessOptions ParseHeadlessOptions(int argc, char *argv[])
+{
+    HeadlessOptions options = { -1, 1, false, NULL, NULL, NULL, NULL, NULL, NULL, NULL, HEADLESS_DEFAULT_FRAME_EVERY, -1, 0.0, NULL };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) options.ticks = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) options.seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--quiet") == 0) options.quiet = true;
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) options.replayFile = argv[++i];
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) options.recordFile = argv[++i];
+        else if (strcmp(argv[i], "--hashes") == 0 && i + 1 < argc) options.hashFile = argv[++i];
+        else if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc) options.compareFile = argv[++i];
+        else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) options.profileFile = argv[++i];
+        else if (strcmp(argv[i], "--counters") == 0 && i + 1 < argc) options.countersFile = argv[++i];
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) options.framesDir = argv[++i];
+        else if (strcmp(argv[i], "--frame-every") == 0 && i + 1 < argc) options.frameEvery = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--bot") == 0 && i + 1 < argc) options.botSkill = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--soak") == 0 && i + 1 < argc) options.soakSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--soak-log") == 0 && i + 1 < argc) options.soakLogFile = argv[++i];
+        else {
+            printf("usage: %s [--ticks N] [--seed N] [--quiet] [--replay FILE] [--record FILE] [--hashes FILE] [--compare FILE] [--profile FILE] [--counters FILE] [--frames DIR] [--frame-every N] [--bot SKILL] [--soak SECONDS] [--soak-log FILE]\n", argv[0]);
+            exit(1);
+        }
+    }
+
+    // A soak runs for its time unless --ticks cuts it shorter
+    if (options.ticks < 0) options.ticks = (options.soakSeconds > 0.0)? LLONG_MAX : HEADLESS_DEFAULT_TICKS;
+    if (options.frameEvery < 1) options.frameEvery = 1;
+    return options;
+}
+
+double GetHeadlessTime(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart/(double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec*1e-9;
+#endif
+}
+
+unsigned int NextRandomButtons(RandomButtons *input, unsigned int buttonMask)
+{
+    if (input->holdTicks-- > 0) return input->buttons;
+
+    input->seed = input->seed*1664525u + 1013904223u;
+    input->buttons = (input->seed >> 8) & buttonMask;
+    input->seed = input->seed*1664525u + 1013904223u;
+    input->holdTicks = (int)((input->seed >> 8)%30);      // Up to half a second at 60 Hz
+    return input->buttons;
+}
+
+void PrintHeadlessReport(const char *game, HeadlessOptions options, double seconds, long long events)
+{
+    if (options.quiet) return;
+
+    printf("%s: %lld ticks in %.3f s (%.0f ticks/s, %.1f us/tick), %lld events, seed %u\n",
+        game, options.ticks, seconds, (seconds > 0.0)? options.ticks/seconds : 0.0,
+        (options.ticks > 0)? seconds*1e6/options.ticks : 0.0, events, options.seed);
+}
+
+bool StartHeadlessRun(HeadlessRun *run, int argc, char *argv[], const char *game, int mode)
+{
+    memset(run, 0, sizeof(HeadlessRun));
+    run->options = ParseHeadlessOptions(argc, argv);
+    run->game = game;
+    run->divergedTick = -1;
+
+    if (run->options.replayFile != NULL) {
+        if (!LoadReplay(&run->replay, run->options.replayFile)) return false;
+        if (strcmp(run->replay.game, game) != 0) {
+            fprintf(stderr, "HEADLESS: [%s] Replay is for %s, not %s\n", run->options.replayFile, run->replay.game, game);
+            UnloadReplay(&run->replay);
+            return false;
+        }
+        run->replaying = true;
+        run->options.seed = run->replay.seed;
+        run->options.ticks = run->replay.tickCount;
+    }
+    else InitReplay(&run->replay, game, run->options.seed, mode);
+
+    if (run->options.hashFile != NULL && (run->hashes = fopen(run->options.hashFile, "w")) == NULL) {
+        fprintf(stderr, "HEADLESS: [%s] Failed to create hash file\n", run->options.hashFile);
+    }
+    if (run->options.compareFile != NULL && (run->compare = fopen(run->options.compareFile, "r")) == NULL) {
+        fprintf(stderr, "HEADLESS: [%s] Failed to open hash file\n", run->options.compareFile);
+    }
+
+    if (run->options.profileFile != NULL) InitProfiler(run->options.profileFile);
+    if (run->options.countersFile != NULL) OpenCounterStream(run->options.countersFile);
+
+    run->hashing = run->replaying || (run->options.recordFile != NULL) || (run->hashes != NULL) || (run->compare != NULL);
+    run->random.seed = run->options.seed;
+    run->botting = !run->replaying && (run->options.botSkill >= 0);
+    if (run->botting) InitBot(&run->bot, run->options.botSkill, run->options.seed);
+    StartSoakRun(&run->soak, run->options.soakSeconds, run->options.soakLogFile);
+    run->startTime = GetHeadlessTime();
+    return true;
+}
+
+unsigned int NextHeadlessButtons(HeadlessRun *run, unsigned int buttonMask)
+{
+    if (run->replaying) return NextReplayButtons(&run->replay, &run->player);
+
+    run->buttons = NextRandomButtons(&run->random, buttonMask);     // Recorded in EndHeadlessTick(), with the state hash
+    return run->buttons;
+}
+
+unsigned int NextHeadlessBotButtons(HeadlessRun *run, unsigned int botButtons, unsigned int buttonMask)
+{
+    if (run->replaying) return NextReplayButtons(&run->replay, &run->player);
+
+    run->buttons = NextBotButtons(&run->bot, botButtons, buttonMask);
+    return run->buttons;
+}
+
+bool EndHeadlessTick(HeadlessRun *run, int events, unsigned long long stateHash)
+{
+    long long tick = run->tick++;
+    run->events += events;
+    if (run->options.profileFile != NULL) ProfileFrame();
+    if (run->options.countersFile != NULL) CounterFrame();
+
+    bool soaking = !run->soak.active || UpdateSoakRun(&run->soak, GetHeadlessTime());
+    if (!run->hashing) return soaking;
+
+    bool matches = true;
+    if (run->replaying) matches = CheckReplayTick(&run->replay, &run->player, stateHash);
+    else {
+        RecordReplayTick(&run->replay, run->buttons, stateHash);
+        run->player.hash = run->replay.hash;
+    }
+
+    if (run->hashes != NULL) fprintf(run->hashes, "%lld %016llx\n", tick, run->player.hash);
+
+    if (run->compare != NULL) {
+        long long expectedTick;
+        unsigned long long expectedHash;
+        if (fscanf(run->compare, "%lld %llx", &expectedTick, &expectedHash) == 2 && (expectedTick != tick || expectedHash != run->player.hash)) {
+            printf("%s: diverged from %s at tick %lld\n", run->game, run->options.compareFile, tick);
+            run->divergedTick = tick;
+            return false;
+        }
+    }
+
+    if (!matches) {
+        printf("%s: diverged from the replay between ticks %lld and %lld, rerun with --hashes to compare tick by tick\n",
+            run->game, tick + 1 - REPLAY_CHECKPOINT_TICKS, tick);
+        run->divergedTick = tick + 1 - REPLAY_CHECKPOINT_TICKS;
+        return false;
+    }
+
+    return soaking;
+}
+
+int FinishHeadlessRun(HeadlessRun *run)
+{
+    double seconds = GetHeadlessTime() - run->startTime;
+
+    if (run->options.recordFile != NULL && !run->replaying) SaveReplay(&run->replay, run->options.recordFile);
+    if (run->hashes != NULL) fclose(run->hashes);
+    if (run->compare != NULL) fclose(run->compare);
+    if (run->options.profileFile != NULL) CloseProfiler();
+    if (run->options.countersFile != NULL) CloseCounterStream();
+    UnloadReplay(&run->replay);
+
+    run->options.ticks = run->tick;
+    PrintHeadlessReport(run->game, run->options, seconds, run->events);
+    if (run->replaying && run->divergedTick < 0 && !run->options.quiet) printf("%s: replay matches\n", run->game);
+    FinishSoakRun(&run->soak, run->game);
+
+    return (run->divergedTick < 0)? 0 : 2;
+}
+
+bool IsHeadlessFrameDue(const HeadlessRun *run)
+{
+    return (run->options.framesDir != NULL) && (run->tick%run->options.frameEvery == 0);
+}
+
+const char *GetHeadlessFramePath(const HeadlessRun *run)
+{
+    static char path[1024];
+    snprintf(path, sizeof(path), "%s/%s_%06lld.png", run->options.framesDir, run->game, run->tick);
+    return path;
+}
+
+#endif // HEADLESS_IMPLEMENTATION
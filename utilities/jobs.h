@@ -0,0 +1,155 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+// Fork-join job system: a fixed pool of worker threads splitting index ranges in batches
+//
+// Declarations only, unless JOBS_IMPLEMENTATION is defined. Built on thread.h
+
+// Processes items [first, last) of a parallel loop
+typedef void (*JobFunc)(void *data, int first, int last);
+
+void InitJobSystem(int threadCount);            // Worker threads to spawn, 0 = one per core besides the caller
+void CloseJobSystem(void);
+int GetJobThreadCount(void);                    // Threads taking part in a parallel loop, caller included
+
+// Runs func over [0, count) split in batches of batchSize, the caller works too and returns when all are done.
+// Batches run in any order on any thread: jobs must only write to data owned by their own items
+void RunParallelFor(JobFunc func, void *data, int count, int batchSize);
+
+#endif // JOBS_H
+
+#if defined(JOBS_IMPLEMENTATION) && !defined(JOBS_IMPLEMENTATION_DONE)
+#define JOBS_IMPLEMENTATION_DONE
+
+#include "thread.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+static struct {
+    Thread **threads;
+    int threadCount;
+    Mutex *mutex;
+    CondVar *wake;
+    CondVar *done;
+    int generation;             // Bumped for every parallel loop, workers wake up on change
+    bool quit;
+    int busyWorkers;
+
+    JobFunc func;
+    void *data;
+    int count;
+    int batchSize;
+    int batchCount;
+    AtomicInt nextBatch;
+} jobs = { 0 };
+
+static void RunJobBatches(void)
+{
+    for (;;) {
+        int batch = AtomicFetchAdd(&jobs.nextBatch, 1);
+        if (batch >= jobs.batchCount) break;
+
+        int first = batch*jobs.batchSize;
+        int last = first + jobs.batchSize;
+        if (last > jobs.count) last = jobs.count;
+        jobs.func(jobs.data, first, last);
+    }
+}
+
+// arg is the generation when the pool started: a loop run before the thread first takes the mutex is still its own
+static int JobWorker(void *arg)
+{
+    int seen = (int)(intptr_t)arg;
+
+    MutexLock(jobs.mutex);
+    for (;;) {
+        while (jobs.generation == seen && !jobs.quit) CondVarWait(jobs.wake, jobs.mutex);
+        if (jobs.quit) break;
+        seen = jobs.generation;
+        MutexUnlock(jobs.mutex);
+
+        RunJobBatches();
+
+        MutexLock(jobs.mutex);
+        if (--jobs.busyWorkers == 0) CondVarSignal(jobs.done);
+    }
+    MutexUnlock(jobs.mutex);
+
+    return 0;
+}
+
+void InitJobSystem(int threadCount)
+{
+    if (jobs.mutex != NULL) return;
+    if (threadCount <= 0) threadCount = GetCpuCount() - 1;
+
+    jobs.mutex = MutexCreate();
+    jobs.wake = CondVarCreate();
+    jobs.done = CondVarCreate();
+    jobs.threads = (Thread **)calloc((threadCount > 0)? threadCount : 1, sizeof(Thread *));
+
+    MutexLock(jobs.mutex);
+    int generation = jobs.generation;
+    MutexUnlock(jobs.mutex);
+    for (int i = 0; i < threadCount; i++) {
+        jobs.threads[jobs.threadCount] = ThreadCreate(JobWorker, (void *)(intptr_t)generation);
+        if (jobs.threads[jobs.threadCount] != NULL) jobs.threadCount++;
+    }
+}
+
+void CloseJobSystem(void)
+{
+    if (jobs.mutex == NULL) return;
+
+    MutexLock(jobs.mutex);
+    jobs.quit = true;
+    CondVarBroadcast(jobs.wake);
+    MutexUnlock(jobs.mutex);
+
+    for (int i = 0; i < jobs.threadCount; i++) ThreadJoin(jobs.threads[i]);
+    free(jobs.threads);
+    CondVarDestroy(jobs.wake);
+    CondVarDestroy(jobs.done);
+    MutexDestroy(jobs.mutex);
+    jobs.threads = NULL;
+    jobs.threadCount = 0;
+    jobs.mutex = NULL;
+    jobs.quit = false;
+}
+
+int GetJobThreadCount(void)
+{
+    return jobs.threadCount + 1;
+}
+
+void RunParallelFor(JobFunc func, void *data, int count, int batchSize)
+{
+    if (count <= 0) return;
+    if (batchSize <= 0) batchSize = 1;
+
+    // Not worth waking anybody up
+    if (jobs.threadCount == 0 || count <= batchSize) {
+        func(data, 0, count);
+        return;
+    }
+
+    MutexLock(jobs.mutex);
+    jobs.func = func;
+    jobs.data = data;
+    jobs.count = count;
+    jobs.batchSize = batchSize;
+    jobs.batchCount = (count + batchSize - 1)/batchSize;
+    AtomicStore(&jobs.nextBatch, 0);
+    jobs.busyWorkers = jobs.threadCount;
+    jobs.generation++;
+    CondVarBroadcast(jobs.wake);
+    MutexUnlock(jobs.mutex);
+
+    RunJobBatches();
+
+    MutexLock(jobs.mutex);
+    while (jobs.busyWorkers > 0) CondVarWait(jobs.done, jobs.mutex);
+    MutexUnlock(jobs.mutex);
+}
+
+#endif // JOBS_IMPLEMENTATION
@@ -0,0 +1,387 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+// Asynchronous logger: log calls copy the format pointer and the raw arguments into a lock-free
+// ring buffer, a background thread does the formatting and the writing
+//
+// The format must be a string literal, only its pointer is queued. Strings passed to %s are
+// copied (truncated to fit a record). Records that don't fit in a full ring are dropped rather
+// than stalling the caller. Calls below LOGGER_MIN_LEVEL compile to nothing.
+//
+// Declarations only, unless LOGGER_IMPLEMENTATION is defined. Built on thread.h, so define it
+// in a translation unit that does not include raylib.h (see the games' src/platform.c)
+
+// Same values as raylib's TraceLogLevel, usable in #if
+#define LOGGER_LEVEL_TRACE 1
+#define LOGGER_LEVEL_DEBUG 2
+#define LOGGER_LEVEL_INFO 3
+#define LOGGER_LEVEL_WARNING 4
+#define LOGGER_LEVEL_ERROR 5
+
+#ifndef LOGGER_MIN_LEVEL
+    #if defined(NDEBUG)
+        #define LOGGER_MIN_LEVEL LOGGER_LEVEL_INFO
+    #else
+        #define LOGGER_MIN_LEVEL LOGGER_LEVEL_TRACE
+    #endif
+#endif
+
+#define LOGGER_RING_SIZE 4096       // Records, power of two
+#define LOGGER_RECORD_SIZE 128      // Bytes per record, arguments included
+
+void InitLogger(const char *fileName);      // Starts the writer thread, NULL writes to stdout
+void CloseLogger(void);                     // Writes out what is still queued
+int GetLoggerDropped(void);                 // Records lost to a full ring so far
+
+// Prefer the macros below. Before InitLogger() the record is written synchronously
+void LogWrite(int level, const char *format, ...);
+
+#if LOGGER_MIN_LEVEL <= LOGGER_LEVEL_TRACE
+    #define LogTrace(...) LogWrite(LOGGER_LEVEL_TRACE, __VA_ARGS__)
+#else
+    #define LogTrace(...) ((void)0)
+#endif
+#if LOGGER_MIN_LEVEL <= LOGGER_LEVEL_DEBUG
+    #define LogDebug(...) LogWrite(LOGGER_LEVEL_DEBUG, __VA_ARGS__)
+#else
+    #define LogDebug(...) ((void)0)
+#endif
+#if LOGGER_MIN_LEVEL <= LOGGER_LEVEL_INFO
+    #define LogInfo(...) LogWrite(LOGGER_LEVEL_INFO, __VA_ARGS__)
+#else
+    #define LogInfo(...) ((void)0)
+#endif
+#if LOGGER_MIN_LEVEL <= LOGGER_LEVEL_WARNING
+    #define LogWarning(...) LogWrite(LOGGER_LEVEL_WARNING, __VA_ARGS__)
+#else
+    #define LogWarning(...) ((void)0)
+#endif
+#define LogError(...) LogWrite(LOGGER_LEVEL_ERROR, __VA_ARGS__)
+
+#endif // LOGGER_H
+
+#if defined(LOGGER_IMPLEMENTATION) && !defined(LOGGER_IMPLEMENTATION_DONE)
+#define LOGGER_IMPLEMENTATION_DONE
+
+#include "thread.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+typedef struct {
+    const char *format;
+    double time;
+    unsigned char level;
+    unsigned char size;         // Argument bytes used
+    unsigned char truncated;
+} LogRecordHeader;
+
+#define LOGGER_ARGS_SIZE (LOGGER_RECORD_SIZE - sizeof(AtomicInt) - sizeof(LogRecordHeader))
+
+typedef struct {
+    AtomicInt sequence;
+    LogRecordHeader header;
+    unsigned char args[LOGGER_ARGS_SIZE];
+} LogRecord;
+
+// Argument types, as the conversion specifiers say
+typedef enum { LOG_ARG_NONE, LOG_ARG_INT, LOG_ARG_UINT, LOG_ARG_DOUBLE, LOG_ARG_STRING, LOG_ARG_POINTER } LogArgType;
+
+static struct {
+    LogRecord *ring;
+    AtomicInt enqueuePos;
+    int dequeuePos;
+    AtomicInt dropped;
+    AtomicInt quit;
+    Thread *thread;
+    FILE *file;
+    double startTime;
+} logger = { 0 };
+
+static double LoggerTime(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart/(double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec*1e-9;
+#endif
+}
+
+// Finds the next conversion in format, returns the text following it (NULL when there is none).
+// The specifier itself is copied to spec, with its length modifier (0, 'h', 'l', 'L' for ll, 'z', 'j', 't')
+static const char *LogNextSpec(const char *format, const char **start, char *spec, int specSize, LogArgType *type, char *length)
+{
+    for (const char *p = format; *p != '\0'; p++) {
+        if (*p != '%') continue;
+        if (p[1] == '%') { p++; continue; }
+
+        const char *q = p + 1;
+        while (*q != '\0' && strchr("-+ #0123456789.", *q) != NULL) q++;
+
+        *length = 0;
+        if (*q == 'h') { *length = 'h'; q++; if (*q == 'h') q++; }
+        else if (*q == 'l') { *length = 'l'; q++; if (*q == 'l') { *length = 'L'; q++; } }
+        else if (*q == 'z' || *q == 'j' || *q == 't') *length = *q++;
+
+        switch (*q) {
+            case 'd': case 'i': case 'c': *type = LOG_ARG_INT; break;
+            case 'u': case 'x': case 'X': case 'o': *type = LOG_ARG_UINT; break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': *type = LOG_ARG_DOUBLE; break;
+            case 's': *type = LOG_ARG_STRING; break;
+            case 'p': *type = LOG_ARG_POINTER; break;
+            default: *type = LOG_ARG_NONE; break;   // '*' widths and %n are not supported
+        }
+        if (*q == '\0') return NULL;
+
+        int size = (int)(q - p) + 1;
+        if (size >= specSize) size = specSize - 1;
+        memcpy(spec, p, size);
+        spec[size] = '\0';
+        *start = p;
+        return q + 1;
+    }
+
+    return NULL;
+}
+
+// Pulls the arguments off the list in their promoted types, stored as 8 bytes each
+static int LogPackArgs(unsigned char *args, int capacity, const char *format, va_list list, unsigned char *truncated)
+{
+    int size = 0;
+    const char *start;
+    char spec[32];
+    LogArgType type;
+    char length;
+
+    while ((format = LogNextSpec(format, &start, spec, sizeof(spec), &type, &length)) != NULL) {
+        union { long long i; unsigned long long u; double d; const void *p; } value;
+
+        switch (type) {
+            case LOG_ARG_INT:
+                if (length == 'l') value.i = va_arg(list, long);
+                else if (length == 'L') value.i = va_arg(list, long long);
+                else if (length == 'z' || length == 't') value.i = va_arg(list, ptrdiff_t);
+                else if (length == 'j') value.i = va_arg(list, intmax_t);
+                else value.i = va_arg(list, int);
+                break;
+            case LOG_ARG_UINT:
+                if (length == 'l') value.u = va_arg(list, unsigned long);
+                else if (length == 'L') value.u = va_arg(list, unsigned long long);
+                else if (length == 'z' || length == 't') value.u = va_arg(list, size_t);
+                else if (length == 'j') value.u = va_arg(list, uintmax_t);
+                else value.u = va_arg(list, unsigned int);
+                break;
+            case LOG_ARG_DOUBLE: value.d = va_arg(list, double); break;
+            case LOG_ARG_POINTER: value.p = va_arg(list, void *); break;
+            case LOG_ARG_STRING: {
+                // Length byte, then the characters
+                const char *text = va_arg(list, const char *);
+                if (text == NULL) text = "(null)";
+                int textLength = (int)strlen(text);
+                int room = capacity - size - 1;
+                if (textLength > 255) textLength = 255;
+                if (textLength > room) { textLength = (room > 0)? room : 0; *truncated = 1; }
+                if (room < 0) return size;
+                args[size++] = (unsigned char)textLength;
+                memcpy(args + size, text, textLength);
+                size += textLength;
+                continue;
+            }
+            default: return size;
+        }
+
+        if (size + 8 > capacity) { *truncated = 1; return size; }
+        memcpy(args + size, &value, 8);
+        size += 8;
+    }
+
+    return size;
+}
+
+static void LogFormatRecord(const LogRecordHeader *header, const unsigned char *args, char *text, int textSize)
+{
+    static const char *levels[] = { "", "TRACE", "DEBUG", "INFO", "WARNING", "ERROR" };
+    int length = snprintf(text, textSize, "[%9.3f] %s: ", header->time, levels[(header->level <= LOGGER_LEVEL_ERROR)? header->level : 0]);
+
+    const char *format = header->format;
+    const char *start;
+    const char *next;
+    char spec[32];
+    LogArgType type;
+    char lengthMod;
+    int offset = 0;
+
+    while ((next = LogNextSpec(format, &start, spec, sizeof(spec), &type, &lengthMod)) != NULL && length < textSize) {
+        // Literal text up to the conversion, with "%%" folded
+        for (const char *p = format; p < start && length < textSize - 1; p++) {
+            text[length++] = *p;
+            if (p[0] == '%' && p[1] == '%') p++;
+        }
+
+        if (type == LOG_ARG_NONE) break;
+        if (type == LOG_ARG_STRING) {
+            if (offset >= header->size) break;
+            int textLength = args[offset++];
+            char string[256];
+            memcpy(string, args + offset, textLength);
+            string[textLength] = '\0';
+            offset += textLength;
+            length += snprintf(text + length, textSize - length, spec, string);
+        }
+        else {
+            if (offset + 8 > header->size) break;
+            union { long long i; unsigned long long u; double d; const void *p; } value;
+            memcpy(&value, args + offset, 8);
+            offset += 8;
+
+            // Handed back in the type the specifier expects
+            if (type == LOG_ARG_DOUBLE) length += snprintf(text + length, textSize - length, spec, value.d);
+            else if (type == LOG_ARG_POINTER) length += snprintf(text + length, textSize - length, spec, value.p);
+            else if (lengthMod == 'l') length += snprintf(text + length, textSize - length, spec, (long)value.i);
+            else if (lengthMod == 'L') length += snprintf(text + length, textSize - length, spec, value.i);
+            else if (lengthMod == 'z' || lengthMod == 't') length += snprintf(text + length, textSize - length, spec, (ptrdiff_t)value.i);
+            else if (lengthMod == 'j') length += snprintf(text + length, textSize - length, spec, (intmax_t)value.i);
+            else length += snprintf(text + length, textSize - length, spec, (int)value.i);
+        }
+        format = next;
+    }
+
+    // Trailing literal text
+    if (next == NULL) {
+        for (const char *p = format; *p != '\0' && length < textSize - 1; p++) {
+            text[length++] = *p;
+            if (p[0] == '%' && p[1] == '%') p++;
+        }
+    }
+    if (length > textSize - 2) length = textSize - 2;
+    if (header->truncated && length < textSize - 5) length += snprintf(text + length, textSize - length, "...");
+    text[length++] = '\n';
+    text[length] = '\0';
+}
+
+static bool LogDequeue(void)
+{
+    LogRecord *record = &logger.ring[logger.dequeuePos & (LOGGER_RING_SIZE - 1)];
+    if (AtomicLoad(&record->sequence) != logger.dequeuePos + 1) return false;
+
+    char text[1024];
+    LogFormatRecord(&record->header, record->args, text, sizeof(text));
+    fputs(text, logger.file);
+
+    // Hand the slot back to the producers for the next lap
+    AtomicStore(&record->sequence, logger.dequeuePos + LOGGER_RING_SIZE);
+    logger.dequeuePos++;
+    return true;
+}
+
+static int LoggerThread(void *arg)
+{
+    (void)arg;
+
+    for (;;) {
+        bool wrote = false;
+        while (LogDequeue()) wrote = true;
+
+        if (wrote) fflush(logger.file);
+        else if (AtomicLoad(&logger.quit)) break;
+        else ThreadSleep(0.001);
+    }
+
+    return 0;
+}
+
+void InitLogger(const char *fileName)
+{
+    if (logger.ring != NULL) return;
+
+    logger.file = (fileName != NULL)? fopen(fileName, "w") : stdout;
+    if (logger.file == NULL) logger.file = stdout;
+
+    logger.ring = (LogRecord *)calloc(LOGGER_RING_SIZE, sizeof(LogRecord));
+    for (int i = 0; i < LOGGER_RING_SIZE; i++) logger.ring[i].sequence = i;
+    logger.enqueuePos = 0;
+    logger.dequeuePos = 0;
+    logger.dropped = 0;
+    logger.quit = 0;
+    logger.startTime = LoggerTime();
+    logger.thread = ThreadCreate(LoggerThread, NULL);
+}
+
+void CloseLogger(void)
+{
+    if (logger.ring == NULL) return;
+
+    AtomicStore(&logger.quit, 1);
+    if (logger.thread != NULL) ThreadJoin(logger.thread);
+    else while (LogDequeue()) { }
+
+    if (logger.file != stdout) fclose(logger.file);
+    free(logger.ring);
+    logger.ring = NULL;
+    logger.thread = NULL;
+}
+
+int GetLoggerDropped(void)
+{
+    return AtomicLoad(&logger.dropped);
+}
+
+void LogWrite(int level, const char *format, ...)
+{
+    LogRecordHeader header = { format, 0.0, (unsigned char)level, 0, 0 };
+    va_list list;
+
+    if (logger.ring == NULL) {
+        unsigned char args[LOGGER_ARGS_SIZE];
+        char text[1024];
+        va_start(list, format);
+        header.size = (unsigned char)LogPackArgs(args, sizeof(args), format, list, &header.truncated);
+        va_end(list);
+        LogFormatRecord(&header, args, text, sizeof(text));
+        fputs(text, stdout);
+        return;
+    }
+
+    // Claim a slot (bounded MPMC queue: a slot is free for position pos when its sequence equals pos)
+    LogRecord *record;
+    int pos = AtomicLoad(&logger.enqueuePos);
+    for (;;) {
+        record = &logger.ring[pos & (LOGGER_RING_SIZE - 1)];
+        int diff = AtomicLoad(&record->sequence) - pos;
+        if (diff == 0) {
+            if (AtomicCompareExchange(&logger.enqueuePos, pos, pos + 1)) break;
+            pos = AtomicLoad(&logger.enqueuePos);
+        }
+        else if (diff < 0) {
+            AtomicFetchAdd(&logger.dropped, 1);
+            return;
+        }
+        else pos = AtomicLoad(&logger.enqueuePos);
+    }
+
+    header.time = LoggerTime() - logger.startTime;
+    va_start(list, format);
+    header.size = (unsigned char)LogPackArgs(record->args, LOGGER_ARGS_SIZE, format, list, &header.truncated);
+    va_end(list);
+    record->header = header;
+
+    AtomicStore(&record->sequence, pos + 1);
+}
+
+#endif // LOGGER_IMPLEMENTATION
@@ -0,0 +1,271 @@
+#ifndef MIXER_H
+#define MIXER_H
+
+// Sound effects mixer: one raylib AudioStream whose callback mixes a fixed pool of voices, so the same sound
+// retriggered by rapid fire overlaps instead of restarting, and the mixing cost is bounded by the pool whatever
+// the game asks for. When every voice is busy a new sound takes over the one with the lowest priority, the one
+// closest to its end among equals, or is dropped if they all have a higher priority than it
+//
+//   InitMixer();                                       // After InitAudioDevice()
+//   MixerSound laser = LoadMixerSoundFromWave(wave);   // Or LoadMixerSoundFromPcm(), straight from the pak
+//   PlayMixerSound(laser, 1.0f, 1);                    // Volume, priority
+//   CloseMixer();                                      // Before CloseAudioDevice(), and before unloading its sounds
+//
+// PlayMixerSound() only queues the sound, the audio thread starts it: the queue is lock-free, one thread plays
+// (the main one, the drawlist replays sounds there). Sounds are in the mixer's format, interleaved stereo floats at
+// the rate the device most likely runs at, so the mix is a multiply-add per sample and a clip, four samples at a
+// time with SSE2 when available. They are converted once at load, or at build time: pcmbuild.c writes sound effects
+// as a MixerPcmHeader and the samples, which then play from the pak's mapping without a decode or a copy. Before
+// InitMixer() and after CloseMixer() playing does nothing, as with raylib's sounds. raylib's stream callback takes
+// no user pointer: there is one mixer, like the logger
+//
+// Declarations only, unless MIXER_IMPLEMENTATION is defined, in a file that includes raylib.h first
+
+#include "raylib.h"
+#include "thread.h"
+
+#define MIXER_SAMPLE_RATE 48000             // Most devices' own, miniaudio has nothing to resample
+#define MIXER_CHANNELS 2
+#define MIXER_BUFFER_FRAMES 1024            // Of the stream, about 21 ms
+#define MIXER_MAX_VOICES 16
+#define MIXER_QUEUE_SIZE 64                 // Sounds played between two callbacks, more are dropped
+#define MIXER_PCM_MAGIC "RPCM"
+#define MIXER_PCM_VERSION 1
+
+typedef struct {
+    const float *samples;                   // Interleaved stereo at MIXER_SAMPLE_RATE, NULL when not loaded
+    unsigned int frameCount;
+    float *allocated;                       // The samples when converted at load, NULL when they are borrowed
+} MixerSound;
+
+// Header of the .pcm files pcmbuild.c writes, the samples follow
+typedef struct {
+    char magic[4];
+    unsigned int version;
+    unsigned int sampleRate;                // MIXER_SAMPLE_RATE and MIXER_CHANNELS when written,
+    unsigned int channels;                  // files from another mixer format are turned down at load
+    unsigned int frameCount;
+    unsigned int reserved[3];               // 32 bytes: the samples stay 16-byte aligned in the pak
+} MixerPcmHeader;
+
+typedef struct {
+    int voices;                             // Playing at the last callback
+    int peakVoices;
+    int stolen;                             // Voices taken over by a new sound, so far
+    int dropped;                            // Sounds that found no voice, or a full queue
+} MixerStats;
+
+void InitMixer(void);
+void CloseMixer(void);
+MixerSound LoadMixerSoundFromWave(Wave wave);                           // On any thread
+MixerSound LoadMixerSoundFromPcm(const unsigned char *data, int size);  // Borrows data, empty if not a .pcm of this format
+void UnloadMixerSound(MixerSound sound);
+void PlayMixerSound(MixerSound sound, float volume, int priority);      // Higher priorities steal lower ones
+MixerStats GetMixerStats(void);
+
+#endif // MIXER_H
+
+#if defined(MIXER_IMPLEMENTATION) && !defined(MIXER_IMPLEMENTATION_DONE)
+#define MIXER_IMPLEMENTATION_DONE
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define MIXER_SSE2
+#endif
+
+typedef struct {
+    const float *samples;                   // NULL when free
+    unsigned int frameCount;
+    unsigned int position;                  // Frames played
+    float volume;
+    int priority;
+} MixerVoice;
+
+typedef struct {
+    MixerSound sound;
+    float volume;
+    int priority;
+} MixerCommand;
+
+static struct {
+    AudioStream stream;
+    AtomicInt ready;
+    MixerCommand queue[MIXER_QUEUE_SIZE];   // Ring, empty when head == tail
+    AtomicInt queueHead;                    // Written by the playing thread only
+    AtomicInt queueTail;                    // Written by the audio thread only
+    MixerVoice voices[MIXER_MAX_VOICES];    // Audio thread only
+    AtomicInt voiceCount;
+    AtomicInt peakVoices;
+    AtomicInt stolen;
+    AtomicInt dropped;
+} mixer = { 0 };
+
+static void MixAudio(void *buffer, unsigned int frames);
+static void StartMixerVoices(void);
+static void MixVoice(float *out, const float *samples, unsigned int count, float volume);
+static void ClipSamples(float *out, unsigned int count);
+
+void InitMixer(void)
+{
+    SetAudioStreamBufferSizeDefault(MIXER_BUFFER_FRAMES);
+    mixer.stream = LoadAudioStream(MIXER_SAMPLE_RATE, 32, MIXER_CHANNELS);
+    SetAudioStreamBufferSizeDefault(0);     // Back to raylib's, for the music streams
+    SetAudioStreamCallback(mixer.stream, MixAudio);
+    PlayAudioStream(mixer.stream);
+    AtomicStore(&mixer.ready, 1);
+}
+
+void CloseMixer(void)
+{
+    if (!AtomicLoad(&mixer.ready)) return;
+    AtomicStore(&mixer.ready, 0);
+    StopAudioStream(mixer.stream);
+    UnloadAudioStream(mixer.stream);        // Waits for a callback in progress, under raylib's audio lock
+    memset(mixer.voices, 0, sizeof(mixer.voices));
+    AtomicStore(&mixer.queueTail, AtomicLoad(&mixer.queueHead));
+}
+
+MixerSound LoadMixerSoundFromWave(Wave wave)
+{
+    MixerSound sound = { 0 };
+    if (wave.data == NULL || wave.frameCount == 0) return sound;
+
+    Wave copy = WaveCopy(wave);
+    WaveFormat(&copy, MIXER_SAMPLE_RATE, 32, MIXER_CHANNELS);    // 32-bit samples are floats
+    sound.allocated = (float *)malloc((size_t)copy.frameCount*MIXER_CHANNELS*sizeof(float));
+    if (sound.allocated != NULL) {
+        memcpy(sound.allocated, copy.data, (size_t)copy.frameCount*MIXER_CHANNELS*sizeof(float));
+        sound.samples = sound.allocated;
+        sound.frameCount = copy.frameCount;
+    }
+    UnloadWave(copy);
+    return sound;
+}
+
+MixerSound LoadMixerSoundFromPcm(const unsigned char *data, int size)
+{
+    MixerSound sound = { 0 };
+    const MixerPcmHeader *header = (const MixerPcmHeader *)data;
+    bool valid = (data != NULL) && (size >= (int)sizeof(MixerPcmHeader)) && (memcmp(header->magic, MIXER_PCM_MAGIC, 4) == 0) &&
+        (header->version == MIXER_PCM_VERSION) && (header->sampleRate == MIXER_SAMPLE_RATE) && (header->channels == MIXER_CHANNELS) &&
+        (header->frameCount <= (size - sizeof(MixerPcmHeader))/(MIXER_CHANNELS*sizeof(float)));
+    if (!valid) return sound;
+
+    sound.samples = (const float *)(data + sizeof(MixerPcmHeader));
+    sound.frameCount = header->frameCount;
+    return sound;
+}
+
+void UnloadMixerSound(MixerSound sound)
+{
+    free(sound.allocated);
+}
+
+void PlayMixerSound(MixerSound sound, float volume, int priority)
+{
+    if (!AtomicLoad(&mixer.ready) || sound.samples == NULL) return;
+
+    int head = AtomicLoad(&mixer.queueHead);
+    int next = (head + 1)%MIXER_QUEUE_SIZE;
+    if (next == AtomicLoad(&mixer.queueTail)) {
+        AtomicFetchAdd(&mixer.dropped, 1);
+        return;
+    }
+    mixer.queue[head] = (MixerCommand){ sound, volume, priority };
+    AtomicStore(&mixer.queueHead, next);    // Publishes the command to the audio thread
+}
+
+MixerStats GetMixerStats(void)
+{
+    return (MixerStats){
+        AtomicLoad(&mixer.voiceCount), AtomicLoad(&mixer.peakVoices), AtomicLoad(&mixer.stolen), AtomicLoad(&mixer.dropped)
+    };
+}
+
+// The stream callback, on raylib's audio thread: 32-bit float stereo frames to fill
+void MixAudio(void *buffer, unsigned int frames)
+{
+    StartMixerVoices();
+
+    float *out = (float *)buffer;
+    memset(out, 0, (size_t)frames*MIXER_CHANNELS*sizeof(float));
+    int playing = 0;
+    for (int i = 0; i < MIXER_MAX_VOICES; i++) {
+        MixerVoice *voice = &mixer.voices[i];
+        if (voice->samples == NULL) continue;
+
+        unsigned int count = voice->frameCount - voice->position;
+        if (count > frames) count = frames;
+        MixVoice(out, voice->samples + (size_t)voice->position*MIXER_CHANNELS, count*MIXER_CHANNELS, voice->volume);
+        voice->position += count;
+        if (voice->position >= voice->frameCount) voice->samples = NULL;
+        else playing++;
+    }
+    ClipSamples(out, frames*MIXER_CHANNELS);
+
+    AtomicStore(&mixer.voiceCount, playing);
+    if (playing > AtomicLoad(&mixer.peakVoices)) AtomicStore(&mixer.peakVoices, playing);
+}
+
+// Gives the queued sounds a voice each, free or stolen
+void StartMixerVoices(void)
+{
+    int tail = AtomicLoad(&mixer.queueTail);
+    int head = AtomicLoad(&mixer.queueHead);
+
+    for (; tail != head; tail = (tail + 1)%MIXER_QUEUE_SIZE) {
+        const MixerCommand *command = &mixer.queue[tail];
+        MixerVoice *voice = NULL;
+        for (int i = 0; i < MIXER_MAX_VOICES && voice == NULL; i++) {
+            if (mixer.voices[i].samples == NULL) voice = &mixer.voices[i];
+        }
+
+        if (voice == NULL) {
+            MixerVoice *victim = &mixer.voices[0];
+            for (int i = 1; i < MIXER_MAX_VOICES; i++) {
+                const MixerVoice *candidate = &mixer.voices[i];
+                unsigned int left = candidate->frameCount - candidate->position;
+                if (candidate->priority < victim->priority ||
+                    (candidate->priority == victim->priority && left < victim->frameCount - victim->position)) victim = &mixer.voices[i];
+            }
+            if (victim->priority > command->priority) {
+                AtomicFetchAdd(&mixer.dropped, 1);
+                continue;
+            }
+            AtomicFetchAdd(&mixer.stolen, 1);
+            voice = victim;
+        }
+
+        *voice = (MixerVoice){ command->sound.samples, command->sound.frameCount, 0, command->volume, command->priority };
+    }
+
+    AtomicStore(&mixer.queueTail, tail);
+}
+
+void MixVoice(float *out, const float *samples, unsigned int count, float volume)
+{
+    unsigned int i = 0;
+#if defined(MIXER_SSE2)
+    const __m128 gain = _mm_set1_ps(volume);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(samples + i), gain)));
+    }
+#endif
+    for (; i < count; i++) out[i] += samples[i]*volume;
+}
+
+// Hard clip of the sum to [-1, 1], what the device would do anyway, but without wrapping on integer outputs
+void ClipSamples(float *out, unsigned int count)
+{
+    unsigned int i = 0;
+#if defined(MIXER_SSE2)
+    const __m128 low = _mm_set1_ps(-1.0f), high = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4) _mm_storeu_ps(out + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(out + i), low), high));
+#endif
+    for (; i < count; i++) out[i] = (out[i] < -1.0f)? -1.0f : (out[i] > 1.0f)? 1.0f : out[i];
+}
+
+#endif // MIXER_IMPLEMENTATION
@@ -0,0 +1,247 @@
+#ifndef MUSIC_H
+#define MUSIC_H
+
+// Music player thread: the music stream is decoded on a thread of its own instead of by UpdateMusicStream() in the
+// game loop, so decoding never shows in the frame time and a slow frame can't starve the stream. The main thread
+// only posts commands, through a lock-free queue; the thread owns the Music from PlayMusicPlayer() on
+//
+//   InitMusicPlayer();                                 // Starts the thread
+//   PlayMusicPlayer(music, 1.0f);                      // The startup loader does it for AddStartupMusic()
+//   while (!WindowShouldClose()) { UpdateMusicPlayer(); ... }
+//   CloseMusicPlayer();                                // Before unloading the music, and before CloseAudioDevice()
+//
+// There is no PCM ring of our own: raylib only decodes music through UpdateMusicStream(), into the stream's two
+// sub-buffers, so those are the PCM queued ahead of playback, and the audio thread reads them under raylib's lock.
+// Music loaded while the default buffer size is MUSIC_BUFFER_FRAMES (SetAudioStreamBufferSizeDefault(), the startup
+// loader does it) gets deeper ones, and the thread refills them every MUSIC_UPDATE_PERIOD, a fraction of what one
+// lasts. A refill later than a sub-buffer lasts is counted as late: the device may have starved, it is not measured.
+// There is one player, like the mixer (see mixer.h).
+//
+// Without threads (web builds) UpdateMusicPlayer() runs the commands and decodes on the main thread, once per frame.
+//
+// Declarations only, unless MUSIC_IMPLEMENTATION is defined, in a file that includes raylib.h first. Needs thread.h
+// implemented somewhere (see the games' platform.c)
+
+#include "raylib.h"
+#include "thread.h"
+
+#define MUSIC_BUFFER_FRAMES 8192            // Per sub-buffer, about 190 ms at 44100 Hz
+#define MUSIC_UPDATE_PERIOD 0.02            // Seconds between refills
+#define MUSIC_QUEUE_SIZE 16                 // Commands not taken by the thread yet, more are dropped
+
+typedef struct {
+    int updates;                            // Refills of the stream
+    int lateRefills;                        // Later than a sub-buffer lasts, the device may have starved
+    int dropped;                            // Commands lost to a full queue
+    float lastDecodeMs;                     // Of the last refill
+    float peakDecodeMs;
+} MusicPlayerStats;
+
+void InitMusicPlayer(void);
+void CloseMusicPlayer(void);                // Stops the music and the thread, logs the stats
+void UpdateMusicPlayer(void);               // Once per frame, only does something without threads
+
+void PlayMusicPlayer(Music music, float volume);    // The thread owns the music until stopped or closed
+void PauseMusicPlayer(void);
+void ResumeMusicPlayer(void);
+void StopMusicPlayer(void);
+void SetMusicPlayerVolume(float volume);
+MusicPlayerStats GetMusicPlayerStats(void);
+
+#endif // MUSIC_H
+
+#if defined(MUSIC_IMPLEMENTATION) && !defined(MUSIC_IMPLEMENTATION_DONE)
+#define MUSIC_IMPLEMENTATION_DONE
+
+#include "profiler.h"
+#include <time.h>
+
+typedef enum {
+    MUSIC_PLAY = 0,
+    MUSIC_PAUSE,
+    MUSIC_RESUME,
+    MUSIC_STOP,
+    MUSIC_VOLUME
+} MusicCommandType;
+
+typedef struct {
+    MusicCommandType type;
+    Music music;
+    float volume;
+} MusicCommand;
+
+static struct {
+    Thread *thread;                         // NULL when the main thread updates
+    AtomicInt quit;
+    MusicCommand queue[MUSIC_QUEUE_SIZE];   // Ring, empty when head == tail
+    AtomicInt queueHead;                    // Written by the main thread only
+    AtomicInt queueTail;                    // Written by the player only
+
+    // The player's, on its thread
+    Music music;
+    bool playing;
+    bool paused;
+    double lastUpdate;                      // Clock of the last refill, 0 after a pause
+    double bufferSeconds;                   // What a sub-buffer lasts
+
+    AtomicInt updates;
+    AtomicInt lateRefills;
+    AtomicInt dropped;
+    AtomicInt lastDecodeUs;
+    AtomicInt peakDecodeUs;
+} player = { 0 };
+
+static double GetMusicClock(void);
+static void PostMusicCommand(MusicCommand command);
+static void StepMusicPlayer(void);
+static int RunMusicPlayer(void *arg);
+
+void InitMusicPlayer(void)
+{
+#if !defined(PLATFORM_WEB)
+    AtomicStore(&player.quit, 0);
+    player.thread = ThreadCreate(RunMusicPlayer, NULL);
+    if (player.thread == NULL) TraceLog(LOG_WARNING, "MUSIC: Could not start the player thread, decoding on the main thread");
+#endif
+}
+
+void CloseMusicPlayer(void)
+{
+    if (player.thread != NULL) {
+        AtomicStore(&player.quit, 1);
+        ThreadJoin(player.thread);
+        player.thread = NULL;
+    }
+
+    // The player is the main thread's now, the commands still queued don't matter
+    if (player.playing) StopMusicStream(player.music);
+    player.playing = false;
+    AtomicStore(&player.queueTail, AtomicLoad(&player.queueHead));
+
+    MusicPlayerStats stats = GetMusicPlayerStats();
+    TraceLog(LOG_INFO, "MUSIC: %d refills, %d late, %d commands dropped, decode %.2f ms at most",
+        stats.updates, stats.lateRefills, stats.dropped, stats.peakDecodeMs);
+}
+
+void UpdateMusicPlayer(void)
+{
+    if (player.thread == NULL) StepMusicPlayer();
+}
+
+void PlayMusicPlayer(Music music, float volume)
+{
+    PostMusicCommand((MusicCommand){ .type = MUSIC_PLAY, .music = music, .volume = volume });
+}
+
+void PauseMusicPlayer(void)
+{
+    PostMusicCommand((MusicCommand){ .type = MUSIC_PAUSE });
+}
+
+void ResumeMusicPlayer(void)
+{
+    PostMusicCommand((MusicCommand){ .type = MUSIC_RESUME });
+}
+
+void StopMusicPlayer(void)
+{
+    PostMusicCommand((MusicCommand){ .type = MUSIC_STOP });
+}
+
+void SetMusicPlayerVolume(float volume)
+{
+    PostMusicCommand((MusicCommand){ .type = MUSIC_VOLUME, .volume = volume });
+}
+
+MusicPlayerStats GetMusicPlayerStats(void)
+{
+    return (MusicPlayerStats){
+        AtomicLoad(&player.updates), AtomicLoad(&player.lateRefills), AtomicLoad(&player.dropped),
+        AtomicLoad(&player.lastDecodeUs)/1000.0f, AtomicLoad(&player.peakDecodeUs)/1000.0f
+    };
+}
+
+double GetMusicClock(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+void PostMusicCommand(MusicCommand command)
+{
+    int head = AtomicLoad(&player.queueHead);
+    int next = (head + 1)%MUSIC_QUEUE_SIZE;
+    if (next == AtomicLoad(&player.queueTail)) {
+        AtomicFetchAdd(&player.dropped, 1);
+        return;
+    }
+    player.queue[head] = command;
+    AtomicStore(&player.queueHead, next);   // Publishes the command to the player
+}
+
+// Runs the queued commands, then refills the stream
+void StepMusicPlayer(void)
+{
+    int tail = AtomicLoad(&player.queueTail);
+    int head = AtomicLoad(&player.queueHead);
+    for (; tail != head; tail = (tail + 1)%MUSIC_QUEUE_SIZE) {
+        const MusicCommand *command = &player.queue[tail];
+        switch (command->type) {
+            case MUSIC_PLAY: {
+                if (player.playing) StopMusicStream(player.music);
+                player.music = command->music;
+                player.bufferSeconds = (player.music.stream.sampleRate > 0)? (double)MUSIC_BUFFER_FRAMES/player.music.stream.sampleRate : 0.0;
+                SetMusicVolume(player.music, command->volume);
+                PlayMusicStream(player.music);
+                player.playing = true;
+                player.paused = false;
+                player.lastUpdate = 0.0;
+            } break;
+            case MUSIC_PAUSE: {
+                if (player.playing) PauseMusicStream(player.music);
+                player.paused = true;
+            } break;
+            case MUSIC_RESUME: {
+                if (player.playing) ResumeMusicStream(player.music);
+                player.paused = false;
+                player.lastUpdate = 0.0;
+            } break;
+            case MUSIC_STOP: {
+                if (player.playing) StopMusicStream(player.music);
+                player.playing = false;
+            } break;
+            case MUSIC_VOLUME: {
+                if (player.playing) SetMusicVolume(player.music, command->volume);
+            } break;
+        }
+    }
+    AtomicStore(&player.queueTail, tail);
+
+    if (!player.playing || player.paused) return;
+
+    double start = GetMusicClock();
+    if (player.lastUpdate > 0.0 && start - player.lastUpdate > player.bufferSeconds) AtomicFetchAdd(&player.lateRefills, 1);
+    player.lastUpdate = start;
+
+    ProfileBegin("music decode");
+    UpdateMusicStream(player.music);
+    ProfileEnd();
+
+    int decodeUs = (int)((GetMusicClock() - start)*1e6);
+    AtomicStore(&player.lastDecodeUs, decodeUs);
+    if (decodeUs > AtomicLoad(&player.peakDecodeUs)) AtomicStore(&player.peakDecodeUs, decodeUs);
+    AtomicFetchAdd(&player.updates, 1);
+}
+
+int RunMusicPlayer(void *arg)
+{
+    (void)arg;
+    while (!AtomicLoad(&player.quit)) {
+        StepMusicPlayer();
+        ThreadSleep(MUSIC_UPDATE_PERIOD);
+    }
+    return 0;
+}
+
+#endif // MUSIC_IMPLEMENTATION
@@ -0,0 +1,194 @@
+#ifndef NET_H
+#define NET_H
+
+// Non-blocking UDP sockets on the loopback interface, with a lag/loss injector for testing
+//
+// Declarations only, unless NET_IMPLEMENTATION is defined. The implementation pulls in the
+// platform socket headers, which clash with raylib.h on Windows
+
+#include <stdbool.h>
+
+#define NET_MAX_PACKET 65507
+
+typedef struct UdpSocket UdpSocket;
+
+UdpSocket *UdpOpen(int port);                                   // Bound to 127.0.0.1:port, NULL on failure
+void UdpClose(UdpSocket *sock);
+bool UdpSend(UdpSocket *sock, int port, const void *data, int size);   // To 127.0.0.1:port
+int UdpReceive(UdpSocket *sock, void *buffer, int size);        // Bytes read, 0 if nothing is pending
+
+// Outgoing packets are dropped with lossPercent chance and held back lagMs (+ up to jitterMs)
+void UdpSetConditions(UdpSocket *sock, int lagMs, int jitterMs, int lossPercent);
+
+double NetGetTime(void);                                        // Monotonic seconds
+
+#endif // NET_H
+
+#if defined(NET_IMPLEMENTATION) && !defined(NET_IMPLEMENTATION_DONE)
+#define NET_IMPLEMENTATION_DONE
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #include <windows.h>
+    typedef SOCKET NetSocketHandle;
+    #define NET_INVALID_SOCKET INVALID_SOCKET
+    #define NetCloseSocket closesocket
+#else
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <fcntl.h>
+    #include <time.h>
+    #include <unistd.h>
+    typedef int NetSocketHandle;
+    #define NET_INVALID_SOCKET (-1)
+    #define NetCloseSocket close
+#endif
+
+#define NET_MAX_DELAYED 256
+
+typedef struct {
+    double sendTime;
+    int port;
+    int size;
+    unsigned char *data;
+} DelayedPacket;
+
+struct UdpSocket {
+    NetSocketHandle handle;
+    int lagMs, jitterMs, lossPercent;
+    unsigned int seed;
+    DelayedPacket delayed[NET_MAX_DELAYED];
+    int delayedCount;
+};
+
+double NetGetTime(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart/(double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec*1e-9;
+#endif
+}
+
+UdpSocket *UdpOpen(int port)
+{
+#if defined(_WIN32)
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return NULL;
+#endif
+
+    NetSocketHandle handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle == NET_INVALID_SOCKET) return NULL;
+
+    struct sockaddr_in address = { 0 };
+    address.sin_family = AF_INET;
+    address.sin_port = htons((unsigned short)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(handle, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        NetCloseSocket(handle);
+        return NULL;
+    }
+
+#if defined(_WIN32)
+    u_long nonBlocking = 1;
+    ioctlsocket(handle, FIONBIO, &nonBlocking);
+#else
+    fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    UdpSocket *sock = (UdpSocket *)calloc(1, sizeof(UdpSocket));
+    sock->handle = handle;
+    sock->seed = 0x9e3779b9u ^ (unsigned int)port;
+    return sock;
+}
+
+void UdpClose(UdpSocket *sock)
+{
+    if (sock == NULL) return;
+    for (int i = 0; i < sock->delayedCount; i++) free(sock->delayed[i].data);
+    NetCloseSocket(sock->handle);
+    free(sock);
+#if defined(_WIN32)
+    WSACleanup();
+#endif
+}
+
+void UdpSetConditions(UdpSocket *sock, int lagMs, int jitterMs, int lossPercent)
+{
+    sock->lagMs = lagMs;
+    sock->jitterMs = jitterMs;
+    sock->lossPercent = lossPercent;
+}
+
+static bool UdpSendNow(UdpSocket *sock, int port, const void *data, int size)
+{
+    struct sockaddr_in address = { 0 };
+    address.sin_family = AF_INET;
+    address.sin_port = htons((unsigned short)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return sendto(sock->handle, (const char *)data, size, 0, (struct sockaddr *)&address, sizeof(address)) == size;
+}
+
+static unsigned int UdpRandom(UdpSocket *sock)
+{
+    sock->seed ^= sock->seed << 13;
+    sock->seed ^= sock->seed >> 17;
+    sock->seed ^= sock->seed << 5;
+    return sock->seed;
+}
+
+// Hand over the held back packets that are due
+static void UdpFlushDelayed(UdpSocket *sock)
+{
+    double now = NetGetTime();
+    int kept = 0;
+    for (int i = 0; i < sock->delayedCount; i++) {
+        DelayedPacket *packet = &sock->delayed[i];
+        if (packet->sendTime <= now) {
+            UdpSendNow(sock, packet->port, packet->data, packet->size);
+            free(packet->data);
+        }
+        else sock->delayed[kept++] = *packet;
+    }
+    sock->delayedCount = kept;
+}
+
+bool UdpSend(UdpSocket *sock, int port, const void *data, int size)
+{
+    UdpFlushDelayed(sock);
+
+    if (sock->lossPercent > 0 && (int)(UdpRandom(sock)%100) < sock->lossPercent) return true;
+    if (sock->lagMs <= 0 && sock->jitterMs <= 0) return UdpSendNow(sock, port, data, size);
+    if (sock->delayedCount == NET_MAX_DELAYED) return false;
+
+    DelayedPacket *packet = &sock->delayed[sock->delayedCount++];
+    int jitter = (sock->jitterMs > 0)? (int)(UdpRandom(sock)%(sock->jitterMs + 1)) : 0;
+    packet->sendTime = NetGetTime() + (sock->lagMs + jitter)/1000.0;
+    packet->port = port;
+    packet->size = size;
+    packet->data = (unsigned char *)malloc(size);
+    memcpy(packet->data, data, size);
+    return true;
+}
+
+int UdpReceive(UdpSocket *sock, void *buffer, int size)
+{
+    UdpFlushDelayed(sock);
+
+    int received = (int)recvfrom(sock->handle, (char *)buffer, size, 0, NULL, NULL);
+    return (received > 0)? received : 0;
+}
+
+#endif // NET_IMPLEMENTATION
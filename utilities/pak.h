@@ -0,0 +1,272 @@
+#ifndef PAK_H
+#define PAK_H
+
+// Resource pak: a game's resources packed into one file at build time (see pakbuild.c), memory-mapped at startup.
+// Opening it is one mapping, finding an asset is one binary search in the index, and raylib decodes straight from
+// the mapped bytes with its Load*FromMemory() functions, with no file reads or copies
+//
+//   Pak pak = LoadPak(TextFormat("%sresources.pak", GetApplicationDirectory()), "resources/");
+//   Sound laser = LoadSoundFromPak(&pak, "laser.wav");
+//   ...
+//   UnloadPak(&pak);            // After the music streams, they decode from the mapping while they play
+//
+// Assets missing from the pak, or every asset when the pak can't be opened, are loaded from the loose files in
+// looseDir instead: the web builds ship the resources directory, and a new file works before the pak is rebuilt.
+//
+// File layout, little-endian: a PakHeader, count PakEntry sorted by name hash, then the data of each entry at an
+// offset that is a multiple of PAK_ALIGNMENT
+//
+// Declarations only, unless PAK_IMPLEMENTATION is defined. The implementation pulls in <windows.h> on Windows,
+// define it in the games' src/platform.c. The raylib loaders need raylib.h: define PAK_LOADERS_IMPLEMENTATION in
+// a file that includes raylib.h first
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define PAK_MAGIC "RPAK"
+#define PAK_VERSION 1
+#define PAK_ALIGNMENT 64                // Of each asset's data, a cache line
+#define PAK_MAX_NAME 40                 // Including the terminator
+#define PAK_FONT_SIZE 32                // Of TTF/OTF fonts, raylib's defaults for LoadFont()
+#define PAK_FONT_GLYPHS 95
+#define PAK_FONT_FIRST_CHAR 32          // Of image fonts
+
+typedef struct {
+    char magic[4];
+    unsigned int version;
+    unsigned int count;                 // Entries in the index
+    unsigned int alignment;
+    unsigned long long size;            // Of the whole file, a truncated pak is rejected
+    unsigned long long reserved;
+} PakHeader;
+
+typedef struct {
+    unsigned long long hash;            // PakHash() of the name
+    unsigned long long offset;          // From the start of the file
+    unsigned long long size;
+    char name[PAK_MAX_NAME];            // File name without directory
+} PakEntry;
+
+typedef struct {
+    const unsigned char *data;          // Whole file, mapped read-only, NULL if not open
+    size_t size;
+    const PakEntry *entries;
+    int count;
+    const char *looseDir;               // Fallback for assets not in the pak, with the trailing slash
+    void *mapping;                      // Platform handle
+} Pak;
+
+// FNV-1a, also used by the packer to sort the index
+static inline unsigned long long PakHash(const char *name)
+{
+    unsigned long long hash = 0xcbf29ce484222325ull;
+    for (const unsigned char *c = (const unsigned char *)name; *c != '\0'; c++) hash = (hash ^ *c)*0x100000001b3ull;
+    return hash;
+}
+
+Pak LoadPak(const char *fileName, const char *looseDir);        // A pak that failed to open still loads loose files
+void UnloadPak(Pak *pak);
+const unsigned char *GetPakData(const Pak *pak, const char *name, int *dataSize);   // Into the mapping, NULL if missing
+
+#if defined(RAYLIB_H)
+Texture2D LoadTextureFromPak(const Pak *pak, const char *name);
+Sound LoadSoundFromPak(const Pak *pak, const char *name);
+Music LoadMusicFromPak(const Pak *pak, const char *name);      // Streams from the mapping, unload it before the pak
+Font LoadFontFromPak(const Pak *pak, const char *name);        // Image fonts like LoadFont(), or TTF/OTF
+#endif
+
+#endif // PAK_H
+
+#if defined(PAK_IMPLEMENTATION) && !defined(PAK_IMPLEMENTATION_DONE)
+#define PAK_IMPLEMENTATION_DONE
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+static const void *MapPakFile(const char *fileName, size_t *size, void **mapping);
+static void UnmapPakFile(const void *data, size_t size, void *mapping);
+
+Pak LoadPak(const char *fileName, const char *looseDir)
+{
+    Pak pak = { 0 };
+    pak.looseDir = looseDir;
+
+    size_t size = 0;
+    void *mapping = NULL;
+    const unsigned char *data = (const unsigned char *)MapPakFile(fileName, &size, &mapping);
+    if (data == NULL) {
+        fprintf(stderr, "PAK: [%s] Failed to open, loading loose files from %s\n", fileName, looseDir);
+        return pak;
+    }
+
+    // Everything the index points to must be inside the file, so lookups need no further checks
+    const PakHeader *header = (const PakHeader *)data;
+    const PakEntry *entries = (const PakEntry *)(data + sizeof(PakHeader));
+    bool valid = (size >= sizeof(PakHeader)) && (memcmp(header->magic, PAK_MAGIC, 4) == 0) && (header->version == PAK_VERSION) &&
+        (header->size == size) && (header->count <= (size - sizeof(PakHeader))/sizeof(PakEntry));
+    for (unsigned int i = 0; valid && i < header->count; i++) {
+        valid = (entries[i].offset <= size) && (entries[i].size <= size - entries[i].offset) && (entries[i].size <= 0x7fffffff) &&
+            (memchr(entries[i].name, '\0', PAK_MAX_NAME) != NULL);
+    }
+    if (!valid) {
+        fprintf(stderr, "PAK: [%s] Not a valid pak, loading loose files from %s\n", fileName, looseDir);
+        UnmapPakFile(data, size, mapping);
+        return pak;
+    }
+
+    pak.data = data;
+    pak.size = size;
+    pak.entries = entries;
+    pak.count = (int)header->count;
+    pak.mapping = mapping;
+    return pak;
+}
+
+void UnloadPak(Pak *pak)
+{
+    if (pak->data != NULL) UnmapPakFile(pak->data, pak->size, pak->mapping);
+    *pak = (Pak){ 0 };
+}
+
+const unsigned char *GetPakData(const Pak *pak, const char *name, int *dataSize)
+{
+    unsigned long long hash = PakHash(name);
+    int low = 0, high = pak->count;
+    while (low < high) {
+        int middle = (low + high)/2;
+        if (pak->entries[middle].hash < hash) low = middle + 1;
+        else high = middle;
+    }
+
+    for (int i = low; i < pak->count && pak->entries[i].hash == hash; i++) {
+        if (strcmp(pak->entries[i].name, name) != 0) continue;
+        *dataSize = (int)pak->entries[i].size;
+        return pak->data + pak->entries[i].offset;
+    }
+
+    *dataSize = 0;
+    return NULL;
+}
+
+const void *MapPakFile(const char *fileName, size_t *size, void **mapping)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return NULL;
+
+    LARGE_INTEGER fileSize;
+    HANDLE map = NULL;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) map = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);      // The mapping keeps the file open
+    if (map == NULL) return NULL;
+
+    const void *data = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+    if (data == NULL) {
+        CloseHandle(map);
+        return NULL;
+    }
+    *size = (size_t)fileSize.QuadPart;
+    *mapping = map;
+    return data;
+#else
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat info;
+    void *data = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);              // Same, the mapping keeps the file
+    if (data == MAP_FAILED) return NULL;
+
+    *size = (size_t)info.st_size;
+    *mapping = NULL;
+    return data;
+#endif
+}
+
+void UnmapPakFile(const void *data, size_t size, void *mapping)
+{
+#if defined(_WIN32)
+    (void)size;
+    UnmapViewOfFile(data);
+    CloseHandle((HANDLE)mapping);
+#else
+    (void)mapping;
+    munmap((void *)data, size);
+#endif
+}
+
+#endif // PAK_IMPLEMENTATION
+
+#if defined(PAK_LOADERS_IMPLEMENTATION) && !defined(PAK_LOADERS_IMPLEMENTATION_DONE)
+#define PAK_LOADERS_IMPLEMENTATION_DONE
+
+static const char *GetPakLoosePath(const Pak *pak, const char *name)
+{
+    return TextFormat("%s%s", (pak->looseDir != NULL)? pak->looseDir : "", name);
+}
+
+Texture2D LoadTextureFromPak(const Pak *pak, const char *name)
+{
+    int size = 0;
+    const unsigned char *data = GetPakData(pak, name, &size);
+    if (data == NULL) return LoadTexture(GetPakLoosePath(pak, name));
+
+    Image image = LoadImageFromMemory(GetFileExtension(name), data, size);     // The type comes from the extension
+    Texture2D texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+    return texture;
+}
+
+Sound LoadSoundFromPak(const Pak *pak, const char *name)
+{
+    int size = 0;
+    const unsigned char *data = GetPakData(pak, name, &size);
+    if (data == NULL) return LoadSound(GetPakLoosePath(pak, name));
+
+    Wave wave = LoadWaveFromMemory(GetFileExtension(name), data, size);
+    Sound sound = LoadSoundFromWave(wave);
+    UnloadWave(wave);
+    return sound;
+}
+
+Music LoadMusicFromPak(const Pak *pak, const char *name)
+{
+    int size = 0;
+    const unsigned char *data = GetPakData(pak, name, &size);
+    if (data == NULL) return LoadMusicStream(GetPakLoosePath(pak, name));
+
+    return LoadMusicStreamFromMemory(GetFileExtension(name), data, size);
+}
+
+Font LoadFontFromPak(const Pak *pak, const char *name)
+{
+    int size = 0;
+    const unsigned char *data = GetPakData(pak, name, &size);
+    if (data == NULL) return LoadFont(GetPakLoosePath(pak, name));
+
+    const char *extension = GetFileExtension(name);
+    if (TextIsEqual(extension, ".ttf") || TextIsEqual(extension, ".otf")) {
+        return LoadFontFromMemory(extension, data, size, PAK_FONT_SIZE, NULL, PAK_FONT_GLYPHS);
+    }
+
+    // Same as LoadFont() for an image: glyphs separated by a key color, from the space on
+    Font font = { 0 };
+    Image image = LoadImageFromMemory(extension, data, size);
+    if (image.data != NULL) font = LoadFontFromImage(image, MAGENTA, PAK_FONT_FIRST_CHAR);
+    UnloadImage(image);
+    if (font.texture.id == 0) font = GetFontDefault();
+    return font;
+}
+
+#endif // PAK_LOADERS_IMPLEMENTATION
@@ -0,0 +1,127 @@
+// Resource packer, run by the games' builds: pakbuild OUTPUT.pak FILE...
+// Packs the files into one pak (see pak.h) under their names without directory, the index sorted by name hash
+// and each file's data aligned to PAK_ALIGNMENT. Files without an extension (LICENSE) are left out
+#include "pak.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    PakEntry entry;
+    const char *path;
+} PakInput;
+
+static const char *GetBaseName(const char *path);
+static int CompareInputs(const void *a, const void *b);
+static bool CopyFileData(FILE *out, const char *path, unsigned long long size);
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        printf("usage: %s OUTPUT.pak FILE...\n", argv[0]);
+        return 1;
+    }
+
+    PakInput *inputs = (PakInput *)calloc((argc > 2)? argc - 2 : 1, sizeof(PakInput));
+    int count = 0;
+
+    for (int i = 2; i < argc; i++) {
+        const char *name = GetBaseName(argv[i]);
+        if (strchr(name, '.') == NULL) continue;
+        if (strlen(name) >= PAK_MAX_NAME) {
+            fprintf(stderr, "PAKBUILD: [%s] Name longer than %d characters\n", argv[i], PAK_MAX_NAME - 1);
+            return 1;
+        }
+
+        FILE *file = fopen(argv[i], "rb");
+        if (file == NULL) {
+            fprintf(stderr, "PAKBUILD: [%s] Failed to open\n", argv[i]);
+            return 1;
+        }
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fclose(file);
+
+        PakInput *input = &inputs[count++];
+        strcpy(input->entry.name, name);
+        input->entry.hash = PakHash(name);
+        input->entry.size = (unsigned long long)size;
+        input->path = argv[i];
+    }
+
+    qsort(inputs, count, sizeof(PakInput), CompareInputs);
+    for (int i = 1; i < count; i++) {
+        if (strcmp(inputs[i].entry.name, inputs[i - 1].entry.name) == 0) {
+            fprintf(stderr, "PAKBUILD: [%s] Same name as %s\n", inputs[i].path, inputs[i - 1].path);
+            return 1;
+        }
+    }
+
+    // Data after the index, each file at the next aligned offset
+    unsigned long long offset = sizeof(PakHeader) + count*sizeof(PakEntry);
+    for (int i = 0; i < count; i++) {
+        offset = (offset + PAK_ALIGNMENT - 1)/PAK_ALIGNMENT*PAK_ALIGNMENT;
+        inputs[i].entry.offset = offset;
+        offset += inputs[i].entry.size;
+    }
+
+    PakHeader header = { 0 };
+    memcpy(header.magic, PAK_MAGIC, 4);
+    header.version = PAK_VERSION;
+    header.count = (unsigned int)count;
+    header.alignment = PAK_ALIGNMENT;
+    header.size = offset;
+
+    FILE *out = fopen(argv[1], "wb");
+    if (out == NULL) {
+        fprintf(stderr, "PAKBUILD: [%s] Failed to create\n", argv[1]);
+        return 1;
+    }
+
+    bool written = (fwrite(&header, sizeof(header), 1, out) == 1);
+    for (int i = 0; written && i < count; i++) written = (fwrite(&inputs[i].entry, sizeof(PakEntry), 1, out) == 1);
+
+    static const unsigned char padding[PAK_ALIGNMENT] = { 0 };
+    for (int i = 0; written && i < count; i++) {
+        long position = ftell(out);
+        written = (fwrite(padding, 1, (size_t)(inputs[i].entry.offset - position), out) == (size_t)(inputs[i].entry.offset - position)) &&
+            CopyFileData(out, inputs[i].path, inputs[i].entry.size);
+    }
+
+    if (fclose(out) != 0 || !written) {
+        fprintf(stderr, "PAKBUILD: [%s] Failed to write\n", argv[1]);
+        remove(argv[1]);
+        return 1;
+    }
+
+    printf("PAKBUILD: [%s] %d files, %llu bytes\n", argv[1], count, offset);
+    free(inputs);
+    return 0;
+}
+
+const char *GetBaseName(const char *path)
+{
+    const char *name = path;
+    for (const char *c = path; *c != '\0'; c++) if (*c == '/' || *c == '\\') name = c + 1;
+    return name;
+}
+
+int CompareInputs(const void *a, const void *b)
+{
+    const PakEntry *left = &((const PakInput *)a)->entry, *right = &((const PakInput *)b)->entry;
+    if (left->hash != right->hash) return (left->hash < right->hash)? -1 : 1;
+    return strcmp(left->name, right->name);
+}
+
+bool CopyFileData(FILE *out, const char *path, unsigned long long size)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return false;
+
+    unsigned char buffer[65536];
+    unsigned long long copied = 0;
+    size_t read = 0;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0 && fwrite(buffer, 1, read, out) == read) copied += read;
+    fclose(file);
+    return copied == size;
+}
@@ -0,0 +1,66 @@
+// Sound effects converter, run by the games' builds: pcmbuild OUTDIR SOUND...
+// Decodes each sound and converts it to the mixer's format (see mixer.h), written as OUTDIR/<name>.pcm, a
+// MixerPcmHeader and the interleaved float samples, which go in the pak in place of the sound. The mixer then plays
+// them from the pak's mapping: Vorbis decoding and resampling happen here once instead of at every launch. Music
+// is not for this, it stays compressed and streams. Uses raylib for the decoders only, no audio device is opened
+#include "raylib.h"
+#include "mixer.h"
+#include <stdio.h>
+#include <string.h>
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        printf("usage: %s OUTDIR SOUND...\n", argv[0]);
+        return 1;
+    }
+    SetTraceLogLevel(LOG_WARNING);
+
+    size_t total = 0;
+    for (int i = 2; i < argc; i++) {
+        const char *path = argv[i];
+        const char *base = path;
+        for (const char *c = path; *c != '\0'; c++) if (*c == '/' || *c == '\\') base = c + 1;
+        const char *extension = strrchr(base, '.');
+        int length = (extension != NULL)? (int)(extension - base) : (int)strlen(base);
+        for (int j = 2; j < i; j++) {
+            const char *other = argv[j];
+            for (const char *c = argv[j]; *c != '\0'; c++) if (*c == '/' || *c == '\\') other = c + 1;
+            if (strncmp(other, base, length) == 0 && (other[length] == '.' || other[length] == '\0')) {
+                fprintf(stderr, "PCMBUILD: [%s] Same name as %s\n", path, argv[j]);
+                return 1;
+            }
+        }
+
+        Wave wave = LoadWave(path);
+        if (wave.data == NULL || wave.frameCount == 0) {
+            fprintf(stderr, "PCMBUILD: [%s] Failed to load\n", path);
+            return 1;
+        }
+        WaveFormat(&wave, MIXER_SAMPLE_RATE, 32, MIXER_CHANNELS);      // 32-bit samples are floats
+
+        MixerPcmHeader header = { 0 };
+        memcpy(header.magic, MIXER_PCM_MAGIC, 4);
+        header.version = MIXER_PCM_VERSION;
+        header.sampleRate = MIXER_SAMPLE_RATE;
+        header.channels = MIXER_CHANNELS;
+        header.frameCount = wave.frameCount;
+        size_t bytes = (size_t)wave.frameCount*MIXER_CHANNELS*sizeof(float);
+
+        char fileName[1024];
+        snprintf(fileName, sizeof(fileName), "%s/%.*s.pcm", argv[1], length, base);
+        FILE *out = fopen(fileName, "wb");
+        bool written = (out != NULL) && (fwrite(&header, sizeof(header), 1, out) == 1) && (fwrite(wave.data, 1, bytes, out) == bytes);
+        if (out != NULL && fclose(out) != 0) written = false;
+        UnloadWave(wave);
+        if (!written) {
+            fprintf(stderr, "PCMBUILD: [%s] Failed to write\n", fileName);
+            remove(fileName);
+            return 1;
+        }
+        total += sizeof(header) + bytes;
+    }
+
+    printf("PCMBUILD: [%s] %d sounds, %zu bytes at %d Hz\n", argv[1], argc - 2, total, MIXER_SAMPLE_RATE);
+    return 0;
+}
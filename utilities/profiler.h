@@ -0,0 +1,373 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Scoped-zone frame profiler: zones are timed into a ring buffer per thread, and can be shown as an
+// on-screen frame-time graph or written out as a Chrome trace (chrome://tracing, ui.perfetto.dev)
+//
+//   PROFILE_ZONE("update") StepGame(&game);             a statement or a { } block, no break or return inside
+//   ProfileBegin("draw"); ... ProfileEnd();             the same, for code that can't be wrapped
+//
+// Zones are only recorded while recording is on, otherwise ProfileBegin() and ProfileEnd() only keep the
+// nesting depth. Recording changes at the next ProfileFrame(), and a zone is recorded when it begins and ends
+// with recording on: one open across the change (on a thread that doesn't follow frames) is left out. Names
+// must be string literals, only their pointers are kept.
+// Each thread keeps its last PROFILER_MAX_EVENTS zones. Defining PROFILER_DISABLED compiles the zones out
+//
+// The graph lists the zones of the last frame from the main thread and from the threads that called
+// ProfileFrameThread(): threads whose work is done by ProfileFrame(), like the frame pipeline's worker (see
+// drawlist.h). Free-running threads (music, jobs) only show in the trace
+//
+// Declarations only, unless PROFILER_IMPLEMENTATION is defined. The implementation pulls in <windows.h>
+// on Windows, which clashes with raylib.h, so define it in a translation unit that does not include
+// raylib.h (see the games' src/platform.c). The graph is drawn with raylib: define
+// PROFILER_GRAPH_IMPLEMENTATION in a file that includes raylib.h first
+
+#include <stdbool.h>
+
+#define PROFILER_MAX_THREADS 64
+#define PROFILER_MAX_EVENTS 65536       // Zones kept per thread, power of two
+#define PROFILER_MAX_DEPTH 32
+#define PROFILER_FRAME_HISTORY 240      // Frames in the graph
+
+typedef struct {
+    const char *name;
+    float ms;                           // Total time in zones of this name
+    int count;
+} ProfilerZone;
+
+void InitProfiler(const char *traceFile);       // Trace file written by CloseProfiler(), recording from the start. NULL for none
+void CloseProfiler(void);
+void SetProfilerRecording(bool recording);      // From the next frame on, always on while tracing
+
+void ProfileFrame(void);                        // Frame boundary, once per frame on the main thread
+void ProfileFrameThread(void);                  // The calling thread's zones count in the frame's, see above
+void ProfileBegin(const char *name);
+void ProfileEnd(void);
+
+int GetProfilerFrameTimes(float *ms, int maxCount);             // Last frames, oldest first
+int GetProfilerFrameZones(ProfilerZone *zones, int maxCount);   // Frame thread zones of the last frame, two levels deep
+bool SaveProfilerTrace(const char *fileName);                   // Chrome trace_event JSON of the zones recorded so far
+
+void UpdateProfilerGraph(void);                 // F3 shows or hides the graph, zones are recorded while it's shown
+void DrawProfilerGraph(int x, int y);           // Only while shown
+
+#if defined(PROFILER_DISABLED)
+    #define PROFILE_ZONE(name)
+#else
+    #define PROFILE_ZONE(name) for (int profileZone = (ProfileBegin(name), 1); profileZone; profileZone = (ProfileEnd(), 0))
+#endif
+
+#endif // PROFILER_H
+
+#if defined(PROFILER_IMPLEMENTATION) && !defined(PROFILER_IMPLEMENTATION_DONE)
+#define PROFILER_IMPLEMENTATION_DONE
+
+#include "thread.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+#if defined(_MSC_VER)
+    #define PROFILER_THREAD_LOCAL __declspec(thread)
+#else
+    #define PROFILER_THREAD_LOCAL __thread
+#endif
+
+typedef struct {
+    const char *name;
+    double start;
+    double end;
+    int depth;
+} ProfilerEvent;
+
+typedef struct {
+    ProfilerEvent *events;              // Ring of PROFILER_MAX_EVENTS, written by the owning thread only
+    unsigned int eventCount;            // Events ever recorded, the ring holds the last ones
+    const char *names[PROFILER_MAX_DEPTH];      // NULL for the open zones begun while not recording
+    double starts[PROFILER_MAX_DEPTH];
+    bool frameThread;                   // Only ever set, by the owning thread or ProfileFrameThread()
+    unsigned int frameEvents[2];        // eventCount at the start of the last frame and of this one, frame threads only
+} ProfilerThread;
+
+static struct {
+    ProfilerThread threads[PROFILER_MAX_THREADS];
+    AtomicInt threadCount;
+    volatile bool recording;
+    bool recordingRequested;
+    const char *traceFile;
+
+    double frameStart;
+    float frameTimes[PROFILER_FRAME_HISTORY];
+    int frameCount;
+} profiler = { 0 };
+
+static PROFILER_THREAD_LOCAL ProfilerThread *profilerThread = NULL;
+static PROFILER_THREAD_LOCAL bool profilerThreadFull = false;
+static PROFILER_THREAD_LOCAL bool profilerFrameThread = false;
+static PROFILER_THREAD_LOCAL int profilerDepth = 0;            // Open zones, recorded or not
+
+static double ProfilerTime(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart/(double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec*1e-9;
+#endif
+}
+
+// The calling thread's buffer, claimed on its first zone. NULL once all PROFILER_MAX_THREADS are taken
+static ProfilerThread *GetProfilerThread(void)
+{
+    if (profilerThread != NULL || profilerThreadFull) return profilerThread;
+
+    int index = AtomicFetchAdd(&profiler.threadCount, 1);
+    if (index >= PROFILER_MAX_THREADS) {
+        profilerThreadFull = true;
+        return NULL;
+    }
+
+    ProfilerThread *thread = &profiler.threads[index];
+    thread->events = (ProfilerEvent *)calloc(PROFILER_MAX_EVENTS, sizeof(ProfilerEvent));
+    if (profilerFrameThread) thread->frameThread = true;
+    profilerThread = thread;
+    return thread;
+}
+
+void InitProfiler(const char *traceFile)
+{
+    profiler.traceFile = traceFile;
+    profiler.recording = (traceFile != NULL);
+    profiler.frameStart = ProfilerTime();
+}
+
+void CloseProfiler(void)
+{
+    if (profiler.traceFile != NULL) SaveProfilerTrace(profiler.traceFile);
+
+    int threadCount = AtomicLoad(&profiler.threadCount);
+    if (threadCount > PROFILER_MAX_THREADS) threadCount = PROFILER_MAX_THREADS;
+    for (int i = 0; i < threadCount; i++) {
+        free(profiler.threads[i].events);
+        profiler.threads[i].events = NULL;
+    }
+    profiler.recording = false;
+    profiler.traceFile = NULL;
+}
+
+void SetProfilerRecording(bool recording)
+{
+    profiler.recordingRequested = recording;
+}
+
+void ProfileFrame(void)
+{
+    double now = ProfilerTime();
+    if (profiler.frameStart > 0.0) profiler.frameTimes[profiler.frameCount++%PROFILER_FRAME_HISTORY] = (float)((now - profiler.frameStart)*1000.0);
+    profiler.frameStart = now;
+
+    profiler.recording = profiler.recordingRequested || (profiler.traceFile != NULL);
+
+    profilerFrameThread = true;
+    if (profiler.recording) GetProfilerThread();
+    if (profilerThread != NULL) profilerThread->frameThread = true;
+
+    // The other frame threads are idle now, their counts can be read
+    int threadCount = AtomicLoad(&profiler.threadCount);
+    if (threadCount > PROFILER_MAX_THREADS) threadCount = PROFILER_MAX_THREADS;
+    for (int i = 0; i < threadCount; i++) {
+        ProfilerThread *thread = &profiler.threads[i];
+        if (!thread->frameThread) continue;
+        thread->frameEvents[0] = thread->frameEvents[1];
+        thread->frameEvents[1] = thread->eventCount;
+    }
+}
+
+void ProfileFrameThread(void)
+{
+    profilerFrameThread = true;
+    if (profilerThread != NULL) profilerThread->frameThread = true;
+}
+
+void ProfileBegin(const char *name)
+{
+    int depth = profilerDepth++;
+    if (depth >= PROFILER_MAX_DEPTH) return;
+
+    ProfilerThread *thread = profiler.recording? GetProfilerThread() : profilerThread;
+    if (thread == NULL) return;
+
+    thread->names[depth] = profiler.recording? name : NULL;
+    thread->starts[depth] = profiler.recording? ProfilerTime() : 0.0;
+}
+
+// The depth always goes back, only the event depends on recording
+void ProfileEnd(void)
+{
+    if (profilerDepth == 0) return;
+
+    int depth = --profilerDepth;
+    ProfilerThread *thread = profilerThread;
+    if (thread == NULL || depth >= PROFILER_MAX_DEPTH || thread->names[depth] == NULL) return;
+
+    if (profiler.recording) {
+        ProfilerEvent *event = &thread->events[thread->eventCount++&(PROFILER_MAX_EVENTS - 1)];
+        event->name = thread->names[depth];
+        event->start = thread->starts[depth];
+        event->end = ProfilerTime();
+        event->depth = depth;
+    }
+    thread->names[depth] = NULL;
+}
+
+int GetProfilerFrameTimes(float *ms, int maxCount)
+{
+    int count = (profiler.frameCount < PROFILER_FRAME_HISTORY)? profiler.frameCount : PROFILER_FRAME_HISTORY;
+    if (count > maxCount) count = maxCount;
+
+    for (int i = 0; i < count; i++) ms[i] = profiler.frameTimes[(profiler.frameCount - count + i)%PROFILER_FRAME_HISTORY];
+    return count;
+}
+
+// The events of the last frame were written before ProfileFrame(), their threads only write after them since.
+// On the main thread, like ProfileFrame()
+int GetProfilerFrameZones(ProfilerZone *zones, int maxCount)
+{
+    int threadCount = AtomicLoad(&profiler.threadCount);
+    if (threadCount > PROFILER_MAX_THREADS) threadCount = PROFILER_MAX_THREADS;
+
+    int count = 0;
+    for (int t = 0; t < threadCount; t++) {
+        const ProfilerThread *thread = &profiler.threads[t];
+        if (!thread->frameThread || thread->events == NULL) continue;
+
+        unsigned int first = thread->frameEvents[0], last = thread->frameEvents[1];
+        if (last - first > PROFILER_MAX_EVENTS) continue;       // More than the ring holds
+
+        for (unsigned int i = first; i != last; i++) {
+            const ProfilerEvent *event = &thread->events[i&(PROFILER_MAX_EVENTS - 1)];
+            if (event->depth > 1) continue;
+
+            int z = 0;
+            while (z < count && zones[z].name != event->name) z++;
+            if (z == count) {
+                if (count == maxCount) continue;
+                zones[count++] = (ProfilerZone){ event->name, 0.0f, 0 };
+            }
+            zones[z].ms += (float)((event->end - event->start)*1000.0);
+            zones[z].count++;
+        }
+    }
+
+    return count;
+}
+
+// Complete ("X") events in microseconds from the earliest zone, one track per thread
+bool SaveProfilerTrace(const char *fileName)
+{
+    FILE *file = fopen(fileName, "w");
+    if (file == NULL) {
+        fprintf(stderr, "PROFILER: [%s] Failed to create trace file\n", fileName);
+        return false;
+    }
+
+    int threadCount = AtomicLoad(&profiler.threadCount);
+    if (threadCount > PROFILER_MAX_THREADS) threadCount = PROFILER_MAX_THREADS;
+
+    double origin = 0.0;
+    for (int t = 0; t < threadCount; t++) {
+        const ProfilerThread *thread = &profiler.threads[t];
+        unsigned int count = (thread->eventCount < PROFILER_MAX_EVENTS)? thread->eventCount : PROFILER_MAX_EVENTS;
+        if (count == 0) continue;
+        double start = thread->events[(thread->eventCount - count)&(PROFILER_MAX_EVENTS - 1)].start;
+        if (origin == 0.0 || start < origin) origin = start;
+    }
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+    for (int t = 0; t < threadCount; t++) {
+        const ProfilerThread *thread = &profiler.threads[t];
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}}",
+            first? "" : ",\n", t, (t == 0)? "main" : "thread", t);
+        first = false;
+
+        unsigned int count = (thread->eventCount < PROFILER_MAX_EVENTS)? thread->eventCount : PROFILER_MAX_EVENTS;
+        for (unsigned int i = thread->eventCount - count; i != thread->eventCount; i++) {
+            const ProfilerEvent *event = &thread->events[i&(PROFILER_MAX_EVENTS - 1)];
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                event->name, t, (event->start - origin)*1e6, (event->end - event->start)*1e6);
+        }
+    }
+    fprintf(file, "\n]}\n");
+
+    fclose(file);
+    return true;
+}
+
+#endif // PROFILER_IMPLEMENTATION
+
+#if defined(PROFILER_GRAPH_IMPLEMENTATION) && !defined(PROFILER_GRAPH_IMPLEMENTATION_DONE)
+#define PROFILER_GRAPH_IMPLEMENTATION_DONE
+
+#define PROFILER_GRAPH_WIDTH PROFILER_FRAME_HISTORY
+#define PROFILER_GRAPH_HEIGHT 80
+#define PROFILER_GRAPH_MS 33.3f         // Full graph height, two frames at 60 Hz
+#define PROFILER_GRAPH_MAX_ZONES 8
+
+static bool profilerGraphVisible = false;
+
+void UpdateProfilerGraph(void)
+{
+    if (IsKeyPressed(KEY_F3)) {
+        profilerGraphVisible = !profilerGraphVisible;
+        SetProfilerRecording(profilerGraphVisible);
+    }
+}
+
+void DrawProfilerGraph(int x, int y)
+{
+    if (!profilerGraphVisible) return;
+
+    float times[PROFILER_FRAME_HISTORY];
+    ProfilerZone zones[PROFILER_GRAPH_MAX_ZONES];
+    int count = GetProfilerFrameTimes(times, PROFILER_FRAME_HISTORY);
+    int zoneCount = GetProfilerFrameZones(zones, PROFILER_GRAPH_MAX_ZONES);
+
+    float average = 0.0f, worst = 0.0f;
+    for (int i = 0; i < count; i++) {
+        average += times[i];
+        if (times[i] > worst) worst = times[i];
+    }
+    if (count > 0) average /= count;
+
+    int height = PROFILER_GRAPH_HEIGHT + 24 + zoneCount*12;
+    DrawRectangle(x, y, PROFILER_GRAPH_WIDTH + 8, height, Fade(BLACK, 0.75f));
+
+    // One bar per frame, red above the 60 Hz budget
+    int base = y + 4 + PROFILER_GRAPH_HEIGHT;
+    for (int i = 0; i < count; i++) {
+        float ms = (times[i] < PROFILER_GRAPH_MS)? times[i] : PROFILER_GRAPH_MS;
+        int barHeight = (int)(ms/PROFILER_GRAPH_MS*PROFILER_GRAPH_HEIGHT);
+        DrawLine(x + 4 + i, base, x + 4 + i, base - barHeight, (times[i] > 1000.0f/60.0f + 0.5f)? RED : GREEN);
+    }
+    int budget = base - (int)(1000.0f/60.0f/PROFILER_GRAPH_MS*PROFILER_GRAPH_HEIGHT);
+    DrawLine(x + 4, budget, x + 4 + PROFILER_GRAPH_WIDTH, budget, YELLOW);
+
+    DrawText(TextFormat("frame %.2f ms avg, %.2f ms max", average, worst), x + 4, base + 6, 10, WHITE);
+    for (int i = 0; i < zoneCount; i++) {
+        DrawText(TextFormat("%-10s %6.3f ms x%d", zones[i].name, zones[i].ms, zones[i].count), x + 4, base + 20 + i*12, 10, LIGHTGRAY);
+    }
+}
+
+#endif // PROFILER_GRAPH_IMPLEMENTATION
@@ -0,0 +1,305 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+// Input replays: the seed and the per-tick button bitmask of a session, enough to re-simulate it exactly
+//
+// Buttons are stored as runs (RLE) of varints, a player holding keys for seconds costs a few bytes.
+// The rolling state hash is stored every REPLAY_CHECKPOINT_TICKS ticks, so a replay that no longer
+// matches the simulation is caught within that many ticks. The state hash of a tick comes from the
+// game (Hash<Game>() in each sim), built with the Hash* helpers below.
+//
+// Declarations only, unless REPLAY_IMPLEMENTATION is defined
+
+#include <stdbool.h>
+#include <string.h>
+
+#define REPLAY_CHECKPOINT_TICKS 60
+#define REPLAY_HASH_SEED 0xcbf29ce484222325ull
+
+typedef struct {
+    unsigned int buttons;
+    unsigned int length;            // Ticks the buttons were held
+} ReplayRun;
+
+typedef struct {
+    char game[32];
+    unsigned int seed;
+    int mode;                       // Game specific start option, e.g. the tank count
+    long long tickCount;
+
+    ReplayRun *runs;
+    int runCount;
+    int runCapacity;
+
+    unsigned long long *checkpoints;    // Rolling hash after every REPLAY_CHECKPOINT_TICKS ticks
+    int checkpointCount;
+    int checkpointCapacity;
+
+    unsigned long long hash;        // Rolling hash while recording
+} Replay;
+
+// Playback position in a replay
+typedef struct {
+    int run;
+    unsigned int used;              // Ticks already taken from the current run
+    long long tick;
+    unsigned long long hash;
+} ReplayPlayer;
+
+void InitReplay(Replay *replay, const char *game, unsigned int seed, int mode);     // Empty, ready to record
+void UnloadReplay(Replay *replay);
+void RecordReplayTick(Replay *replay, unsigned int buttons, unsigned long long stateHash);  // Buttons of a tick, and the state after it
+bool SaveReplay(const Replay *replay, const char *fileName);
+bool LoadReplay(Replay *replay, const char *fileName);
+
+unsigned int NextReplayButtons(const Replay *replay, ReplayPlayer *player);
+// Rolls the state after the tick into the player's hash, false if it misses a recorded checkpoint
+bool CheckReplayTick(const Replay *replay, ReplayPlayer *player, unsigned long long stateHash);
+
+// State hashing, a word at a time. Hash fields rather than whole structs: padding bytes are not deterministic
+static inline unsigned long long HashBytes(unsigned long long hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    unsigned long long word;
+
+    for (; size >= 8; size -= 8, bytes += 8) {
+        memcpy(&word, bytes, 8);
+        hash ^= word*0x9e3779b97f4a7c15ull;
+        hash = ((hash << 27) | (hash >> 37))*0xc2b2ae3d27d4eb4full;
+    }
+    for (; size > 0; size--, bytes++) {
+        hash ^= *bytes*0x9e3779b97f4a7c15ull;
+        hash = ((hash << 27) | (hash >> 37))*0xc2b2ae3d27d4eb4full;
+    }
+
+    return hash;
+}
+
+static inline unsigned long long HashInt(unsigned long long hash, int value)
+{
+    return HashBytes(hash, &value, sizeof(value));
+}
+
+static inline unsigned long long HashFloat(unsigned long long hash, float value)
+{
+    return HashBytes(hash, &value, sizeof(value));
+}
+
+#endif // REPLAY_H
+
+#if defined(REPLAY_IMPLEMENTATION) && !defined(REPLAY_IMPLEMENTATION_DONE)
+#define REPLAY_IMPLEMENTATION_DONE
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define REPLAY_MAGIC "RPLY"
+#define REPLAY_VERSION 1
+
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+} ReplayBuffer;
+
+static void ReplayPutByte(ReplayBuffer *buffer, unsigned char byte)
+{
+    if (buffer->size == buffer->capacity) {
+        buffer->capacity = (buffer->capacity == 0)? 1024 : buffer->capacity*2;
+        buffer->data = (unsigned char *)realloc(buffer->data, buffer->capacity);
+    }
+    buffer->data[buffer->size++] = byte;
+}
+
+// Unsigned LEB128: 7 bits per byte, high bit set on all but the last
+static void ReplayPutVarint(ReplayBuffer *buffer, unsigned long long value)
+{
+    while (value >= 0x80) {
+        ReplayPutByte(buffer, (unsigned char)(value | 0x80));
+        value >>= 7;
+    }
+    ReplayPutByte(buffer, (unsigned char)value);
+}
+
+static bool ReplayGetVarint(const unsigned char **cursor, const unsigned char *end, unsigned long long *value)
+{
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (*cursor >= end) return false;
+        unsigned char byte = *(*cursor)++;
+        *value |= (unsigned long long)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+void InitReplay(Replay *replay, const char *game, unsigned int seed, int mode)
+{
+    memset(replay, 0, sizeof(Replay));
+    strncpy(replay->game, game, sizeof(replay->game) - 1);
+    replay->seed = seed;
+    replay->mode = mode;
+    replay->hash = REPLAY_HASH_SEED;
+}
+
+void UnloadReplay(Replay *replay)
+{
+    free(replay->runs);
+    free(replay->checkpoints);
+    memset(replay, 0, sizeof(Replay));
+}
+
+void RecordReplayTick(Replay *replay, unsigned int buttons, unsigned long long stateHash)
+{
+    ReplayRun *last = (replay->runCount > 0)? &replay->runs[replay->runCount - 1] : NULL;
+    if (last != NULL && last->buttons == buttons && last->length < 0xffffffffu) last->length++;
+    else {
+        if (replay->runCount == replay->runCapacity) {
+            replay->runCapacity = (replay->runCapacity == 0)? 256 : replay->runCapacity*2;
+            replay->runs = (ReplayRun *)realloc(replay->runs, replay->runCapacity*sizeof(ReplayRun));
+        }
+        replay->runs[replay->runCount++] = (ReplayRun){ buttons, 1 };
+    }
+
+    replay->hash = HashBytes(replay->hash, &stateHash, sizeof(stateHash));
+    replay->tickCount++;
+
+    if (replay->tickCount%REPLAY_CHECKPOINT_TICKS == 0) {
+        if (replay->checkpointCount == replay->checkpointCapacity) {
+            replay->checkpointCapacity = (replay->checkpointCapacity == 0)? 256 : replay->checkpointCapacity*2;
+            replay->checkpoints = (unsigned long long *)realloc(replay->checkpoints, replay->checkpointCapacity*sizeof(unsigned long long));
+        }
+        replay->checkpoints[replay->checkpointCount++] = replay->hash;
+    }
+}
+
+// Layout: magic, version, game name, seed, mode, tick count, runs (buttons, length), checkpoints.
+// Everything is a varint except the magic, the name bytes and the 8 byte little endian checkpoints
+bool SaveReplay(const Replay *replay, const char *fileName)
+{
+    ReplayBuffer buffer = { 0 };
+    size_t nameLength = strlen(replay->game);
+
+    for (int i = 0; i < 4; i++) ReplayPutByte(&buffer, (unsigned char)REPLAY_MAGIC[i]);
+    ReplayPutVarint(&buffer, REPLAY_VERSION);
+    ReplayPutVarint(&buffer, nameLength);
+    for (size_t i = 0; i < nameLength; i++) ReplayPutByte(&buffer, (unsigned char)replay->game[i]);
+    ReplayPutVarint(&buffer, replay->seed);
+    ReplayPutVarint(&buffer, (unsigned int)replay->mode);
+    ReplayPutVarint(&buffer, (unsigned long long)replay->tickCount);
+
+    ReplayPutVarint(&buffer, (unsigned int)replay->runCount);
+    for (int i = 0; i < replay->runCount; i++) {
+        ReplayPutVarint(&buffer, replay->runs[i].buttons);
+        ReplayPutVarint(&buffer, replay->runs[i].length);
+    }
+
+    ReplayPutVarint(&buffer, (unsigned int)replay->checkpointCount);
+    for (int i = 0; i < replay->checkpointCount; i++) {
+        for (int b = 0; b < 8; b++) ReplayPutByte(&buffer, (unsigned char)(replay->checkpoints[i] >> (b*8)));
+    }
+
+    FILE *file = fopen(fileName, "wb");
+    bool success = (file != NULL) && (fwrite(buffer.data, 1, buffer.size, file) == buffer.size);
+    if (file != NULL && fclose(file) != 0) success = false;
+    free(buffer.data);
+
+    if (!success) fprintf(stderr, "REPLAY: [%s] Failed to write replay\n", fileName);
+    return success;
+}
+
+bool LoadReplay(Replay *replay, const char *fileName)
+{
+    memset(replay, 0, sizeof(Replay));
+
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "REPLAY: [%s] Failed to open replay\n", fileName);
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    unsigned char *data = (size > 0)? (unsigned char *)malloc((size_t)size) : NULL;
+    bool success = (data != NULL) && (fread(data, 1, (size_t)size, file) == (size_t)size);
+    fclose(file);
+
+    const unsigned char *cursor = data, *end = data + ((size > 0)? size : 0);
+    unsigned long long version = 0, nameLength = 0, seed = 0, mode = 0, tickCount = 0, runCount = 0, checkpointCount = 0;
+
+    success = success && (size >= 4) && (memcmp(cursor, REPLAY_MAGIC, 4) == 0);
+    if (success) cursor += 4;
+    success = success && ReplayGetVarint(&cursor, end, &version) && (version == REPLAY_VERSION);
+    success = success && ReplayGetVarint(&cursor, end, &nameLength) && (nameLength < sizeof(replay->game)) && (nameLength <= (unsigned long long)(end - cursor));
+    if (success) {
+        memcpy(replay->game, cursor, (size_t)nameLength);
+        cursor += nameLength;
+    }
+    success = success && ReplayGetVarint(&cursor, end, &seed) && ReplayGetVarint(&cursor, end, &mode) && ReplayGetVarint(&cursor, end, &tickCount);
+
+    // Each run takes at least two bytes, each checkpoint eight: reject counts the file can't hold before allocating
+    success = success && ReplayGetVarint(&cursor, end, &runCount) && (runCount <= (unsigned long long)(end - cursor)/2);
+    if (success && runCount > 0) {
+        replay->runs = (ReplayRun *)malloc((size_t)runCount*sizeof(ReplayRun));
+        replay->runCapacity = (int)runCount;
+    }
+    long long runTicks = 0;
+    for (unsigned long long i = 0; success && i < runCount; i++) {
+        unsigned long long buttons = 0, length = 0;
+        success = ReplayGetVarint(&cursor, end, &buttons) && ReplayGetVarint(&cursor, end, &length) && (length > 0);
+        replay->runs[replay->runCount++] = (ReplayRun){ (unsigned int)buttons, (unsigned int)length };
+        runTicks += (long long)length;
+    }
+    success = success && (runTicks == (long long)tickCount);
+
+    success = success && ReplayGetVarint(&cursor, end, &checkpointCount) && (checkpointCount <= (unsigned long long)(end - cursor)/8);
+    if (success && checkpointCount > 0) {
+        replay->checkpoints = (unsigned long long *)malloc((size_t)checkpointCount*sizeof(unsigned long long));
+        replay->checkpointCapacity = (int)checkpointCount;
+    }
+    for (unsigned long long i = 0; success && i < checkpointCount; i++) {
+        unsigned long long hash = 0;
+        for (int b = 0; b < 8; b++) hash |= (unsigned long long)cursor[b] << (b*8);
+        cursor += 8;
+        replay->checkpoints[replay->checkpointCount++] = hash;
+    }
+
+    free(data);
+
+    if (!success) {
+        fprintf(stderr, "REPLAY: [%s] Not a valid replay file\n", fileName);
+        UnloadReplay(replay);
+        return false;
+    }
+
+    replay->seed = (unsigned int)seed;
+    replay->mode = (int)mode;
+    replay->tickCount = (long long)tickCount;
+    replay->hash = REPLAY_HASH_SEED;
+    return true;
+}
+
+unsigned int NextReplayButtons(const Replay *replay, ReplayPlayer *player)
+{
+    while (player->run < replay->runCount && player->used >= replay->runs[player->run].length) {
+        player->run++;
+        player->used = 0;
+    }
+    if (player->run >= replay->runCount) return 0;
+
+    player->used++;
+    return replay->runs[player->run].buttons;
+}
+
+bool CheckReplayTick(const Replay *replay, ReplayPlayer *player, unsigned long long stateHash)
+{
+    if (player->tick == 0) player->hash = REPLAY_HASH_SEED;
+    player->hash = HashBytes(player->hash, &stateHash, sizeof(stateHash));
+    player->tick++;
+
+    if (player->tick%REPLAY_CHECKPOINT_TICKS != 0) return true;
+    long long checkpoint = player->tick/REPLAY_CHECKPOINT_TICKS - 1;
+    return (checkpoint >= replay->checkpointCount) || (replay->checkpoints[checkpoint] == player->hash);
+}
+
+#endif // REPLAY_IMPLEMENTATION
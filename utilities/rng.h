@@ -0,0 +1,192 @@
+#ifndef RNG_H
+#define RNG_H
+
+// Deterministic random numbers for the simulations: xoshiro128** streams seeded with SplitMix64.
+// Each subsystem draws from its own stream (same seed, different stream number), so one that draws more
+// or less often doesn't shift the numbers of the others, and nothing outside the simulation (rendering,
+// raylib's GetRandomValue()) can touch them. The same seed gives the same numbers on every platform.
+//
+//   Rng rng;
+//   SeedRng(&rng, seed, ASTEROIDS_RNG_SPAWN);
+//   int sides = RandomRange(&rng, 8, 11);
+//
+// RngLanes run four streams side by side for bulk fills, with SSE2 when available. The scalar fallback
+// produces the same values in the same order.
+//
+// Header-only, like collision.h
+
+#include <stdbool.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define RNG_SSE2
+#endif
+
+typedef struct {
+    unsigned int s[4];
+} Rng;
+
+// Four streams, state word by word: s[word][lane]
+typedef struct {
+    unsigned int s[4][4];
+} RngLanes;
+
+static inline unsigned long long RngSplitMix(unsigned long long *state)
+{
+    unsigned long long z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27))*0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+static inline void SeedRng(Rng *rng, unsigned long long seed, unsigned int stream)
+{
+    unsigned long long state = seed ^ ((unsigned long long)stream*0xd1342543de82ef95ull);
+    unsigned long long a = RngSplitMix(&state), b = RngSplitMix(&state);
+
+    rng->s[0] = (unsigned int)a;
+    rng->s[1] = (unsigned int)(a >> 32);
+    rng->s[2] = (unsigned int)b;
+    rng->s[3] = (unsigned int)(b >> 32);
+    if ((rng->s[0] | rng->s[1] | rng->s[2] | rng->s[3]) == 0) rng->s[0] = 1;     // All zero never leaves zero
+}
+
+static inline unsigned int RngRotl(unsigned int x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+static inline unsigned int NextRandom(Rng *rng)
+{
+    unsigned int *s = rng->s;
+    unsigned int result = RngRotl(s[1]*5, 7)*9;
+    unsigned int t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = RngRotl(s[3], 11);
+
+    return result;
+}
+
+// Uniform in [min, max] like GetRandomValue(), by multiply and shift rather than modulo
+static inline int RandomRange(Rng *rng, int min, int max)
+{
+    unsigned int range = (unsigned int)(max - min) + 1u;
+    return min + (int)(((unsigned long long)NextRandom(rng)*range) >> 32);
+}
+
+// Uniform in [0, 1), 24 bits
+static inline float RandomFloat(Rng *rng)
+{
+    return (float)(NextRandom(rng) >> 8)*(1.0f/16777216.0f);
+}
+
+// True with the given chance in [0, 1]
+static inline bool RandomChance(Rng *rng, float chance)
+{
+    return RandomFloat(rng) < chance;
+}
+
+// Lane streams don't overlap the Rng streams of the same seed and stream number
+static inline void SeedRngLanes(RngLanes *lanes, unsigned long long seed, unsigned int stream)
+{
+    unsigned long long state = seed ^ ((unsigned long long)stream*0xd1342543de82ef95ull) ^ 0x6a09e667f3bcc909ull;
+
+    for (int lane = 0; lane < 4; lane++) {
+        unsigned long long a = RngSplitMix(&state), b = RngSplitMix(&state);
+        lanes->s[0][lane] = (unsigned int)a;
+        lanes->s[1][lane] = (unsigned int)(a >> 32);
+        lanes->s[2][lane] = (unsigned int)b;
+        lanes->s[3][lane] = (unsigned int)(b >> 32) | 1u;      // Never all zero
+    }
+}
+
+#if defined(RNG_SSE2)
+static inline __m128i RngRotl4(__m128i x, int k)
+{
+    return _mm_or_si128(_mm_slli_epi32(x, k), _mm_srli_epi32(x, 32 - k));
+}
+
+// Four xoshiro128** steps at once. The multiplies by 5 and 9 are shift and add, SSE2 has no 32-bit mullo
+static inline __m128i NextRandom4(__m128i *s)
+{
+    __m128i x = _mm_add_epi32(_mm_slli_epi32(s[1], 2), s[1]);
+    x = RngRotl4(x, 7);
+    __m128i result = _mm_add_epi32(_mm_slli_epi32(x, 3), x);
+    __m128i t = _mm_slli_epi32(s[1], 9);
+
+    s[2] = _mm_xor_si128(s[2], s[0]);
+    s[3] = _mm_xor_si128(s[3], s[1]);
+    s[1] = _mm_xor_si128(s[1], s[2]);
+    s[0] = _mm_xor_si128(s[0], s[3]);
+    s[2] = _mm_xor_si128(s[2], t);
+    s[3] = RngRotl4(s[3], 11);
+
+    return result;
+}
+#endif
+
+// Values are interleaved across the lanes: values[i] comes from lane i%4. A count that isn't a multiple
+// of 4 still advances every lane, the extra values are dropped
+static inline void FillRandom(RngLanes *lanes, unsigned int *values, int count)
+{
+#if defined(RNG_SSE2)
+    __m128i s[4];
+    for (int word = 0; word < 4; word++) s[word] = _mm_loadu_si128((const __m128i *)lanes->s[word]);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) _mm_storeu_si128((__m128i *)(values + i), NextRandom4(s));
+    if (i < count) {
+        unsigned int tail[4];
+        _mm_storeu_si128((__m128i *)tail, NextRandom4(s));
+        for (int j = 0; i + j < count; j++) values[i + j] = tail[j];
+    }
+
+    for (int word = 0; word < 4; word++) _mm_storeu_si128((__m128i *)lanes->s[word], s[word]);
+#else
+    for (int i = 0; i < count; i += 4) {
+        for (int lane = 0; lane < 4; lane++) {
+            Rng rng = { { lanes->s[0][lane], lanes->s[1][lane], lanes->s[2][lane], lanes->s[3][lane] } };
+            unsigned int value = NextRandom(&rng);
+            if (i + lane < count) values[i + lane] = value;
+            for (int word = 0; word < 4; word++) lanes->s[word][lane] = rng.s[word];
+        }
+    }
+#endif
+}
+
+// Uniform in [0, 1), same order as FillRandom()
+static inline void FillRandomFloats(RngLanes *lanes, float *values, int count)
+{
+#if defined(RNG_SSE2)
+    __m128i s[4];
+    for (int word = 0; word < 4; word++) s[word] = _mm_loadu_si128((const __m128i *)lanes->s[word]);
+
+    const __m128 scale = _mm_set1_ps(1.0f/16777216.0f);
+    int i = 0;
+    for (; i < count; i += 4) {
+        __m128 x = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(NextRandom4(s), 8)), scale);
+        if (i + 4 <= count) _mm_storeu_ps(values + i, x);
+        else {
+            float tail[4];
+            _mm_storeu_ps(tail, x);
+            for (int j = 0; i + j < count; j++) values[i + j] = tail[j];
+        }
+    }
+
+    for (int word = 0; word < 4; word++) _mm_storeu_si128((__m128i *)lanes->s[word], s[word]);
+#else
+    unsigned int bits[64];
+    for (int i = 0; i < count; i += 64) {
+        int n = (count - i < 64)? count - i : 64;
+        FillRandom(lanes, bits, n);
+        for (int j = 0; j < n; j++) values[i + j] = (float)(bits[j] >> 8)*(1.0f/16777216.0f);
+    }
+#endif
+}
+
+#endif // RNG_H
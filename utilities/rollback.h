@@ -0,0 +1,468 @@
+#ifndef ROLLBACK_H
+#define ROLLBACK_H
+
+// Two-player input-delay + rollback session over loopback UDP (net.h)
+//
+// Every frame each side sends its not yet acknowledged inputs. Missing remote inputs are predicted
+// by repeating the last confirmed one; when the real input arrives and differs, the simulation is
+// restored to the snapshot taken before that frame and re-simulated. The host also sends periodic
+// snapshots of the last fully confirmed frame, XOR-delta compressed against the last snapshot the
+// other side acknowledged, which the other side uses to detect and repair desyncs. A snapshot is compared once the
+// joining side has the host's inputs up to that frame and has rolled back for them: a state still built on a
+// prediction is not a desync.
+//
+// Declarations only, unless ROLLBACK_IMPLEMENTATION is defined
+
+#include <stdbool.h>
+
+#define ROLLBACK_MAX_FRAMES 8           // Frames we may run ahead of the last confirmed remote input
+#define ROLLBACK_RING 16                // Snapshots kept, must cover ROLLBACK_MAX_FRAMES + input delay
+#define ROLLBACK_INPUT_RING 128
+#define ROLLBACK_SYNC_INTERVAL 30       // Frames between host snapshots
+#define ROLLBACK_MAX_SEND_INPUTS 64
+
+typedef struct {
+    int stateSize;                                              // Bytes of a snapshot blob
+    void (*saveState)(void *user, void *blob);                  // Write the simulation state into blob
+    void (*loadState)(void *user, const void *blob);            // Restore the simulation state from blob
+    void (*advance)(void *user, const unsigned char inputs[2]); // Simulate one frame with both players' inputs
+    void *user;
+} RollbackCallbacks;
+
+typedef struct {
+    int localPlayer;        // 0 hosts and sends snapshots, 1 joins
+    int localPort;
+    int remotePort;
+    int inputDelay;         // Frames local input is held back before being simulated
+    int lagMs, jitterMs, lossPercent;   // Injected on outgoing packets, for testing
+} RollbackConfig;
+
+typedef struct {
+    int frame;              // Next frame to simulate
+    int confirmedFrame;     // Remote inputs are known up to this frame
+    int rollbacks;
+    int lastRollback;       // Frames re-simulated by the last rollback
+    int maxRollback;
+    double lastRollbackMs;
+    double maxRollbackMs;
+    int stalls;             // Updates spent waiting for the remote side
+    int desyncs;            // Snapshots from the host that did not match our confirmed state
+    int bytesSent;
+    int lastSnapshotBytes;  // Size of the last delta compressed snapshot
+} RollbackStats;
+
+typedef struct RollbackSession RollbackSession;
+
+RollbackSession *RollbackStart(RollbackConfig config, RollbackCallbacks callbacks);   // NULL if the port is taken
+void RollbackStop(RollbackSession *session);
+
+// Polls the network, rolls back if a prediction was wrong and simulates the next frame.
+// Returns false, without simulating, while waiting for the remote side
+bool RollbackUpdate(RollbackSession *session, unsigned char localInput);
+
+RollbackStats RollbackGetStats(const RollbackSession *session);
+
+#endif // ROLLBACK_H
+
+#if defined(ROLLBACK_IMPLEMENTATION) && !defined(ROLLBACK_IMPLEMENTATION_DONE)
+#define ROLLBACK_IMPLEMENTATION_DONE
+
+#include "net.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ROLLBACK_RECEIVED 4         // Host snapshots kept by the joining side as delta baselines
+
+enum { PACKET_INPUTS = 1, PACKET_SNAPSHOT = 2 };
+
+struct RollbackSession {
+    RollbackConfig config;
+    RollbackCallbacks callbacks;
+    UdpSocket *sock;
+
+    int frame;
+    unsigned char inputs[2][ROLLBACK_INPUT_RING];
+    int inputFrame[2][ROLLBACK_INPUT_RING];         // Frame held by each input slot, -1 if none
+    unsigned char predicted[ROLLBACK_INPUT_RING];   // Remote input each simulated frame used
+    int remoteConfirmed;
+    int localAcked;                                 // Remote side has our inputs up to this frame
+    int firstMispredict;
+
+    unsigned char *ring;                            // State at the start of ringFrame[i]
+    int ringFrame[ROLLBACK_RING];
+
+    unsigned char *baseline;                        // Host: last snapshot acknowledged by the remote side
+    int baselineFrame;
+    unsigned char *pending;                         // Host: last snapshot sent
+    int pendingFrame;
+    unsigned char *received[ROLLBACK_RECEIVED];     // Join: last snapshots received
+    int receivedFrame[ROLLBACK_RECEIVED];
+    int receivedNext;
+    int syncAck;
+    int syncCheck;                                  // Join: received slot of the snapshot to compare, -1 if none
+
+    unsigned char *scratch;
+    unsigned char *packet;
+    RollbackStats stats;
+};
+
+static int PutVarint(unsigned char *out, unsigned int value)
+{
+    int n = 0;
+    while (value >= 0x80) {
+        out[n++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (unsigned char)value;
+    return n;
+}
+
+static int GetVarint(const unsigned char *in, int size, int *offset, unsigned int *value)
+{
+    unsigned int result = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (*offset >= size) return 0;
+        unsigned char byte = in[(*offset)++];
+        result |= (unsigned int)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// XOR against the baseline (zeros if NULL), then alternating runs: varint zero count, varint literal count, literals
+static int DeltaEncode(const unsigned char *blob, const unsigned char *base, int size, unsigned char *out, int capacity)
+{
+    int n = 0, i = 0;
+    while (i < size) {
+        int zeros = 0;
+        while (i + zeros < size && (blob[i + zeros] ^ (base? base[i + zeros] : 0)) == 0) zeros++;
+        int literals = 0;
+        while (i + zeros + literals < size && (blob[i + zeros + literals] ^ (base? base[i + zeros + literals] : 0)) != 0) literals++;
+
+        if (n + 10 + literals > capacity) return -1;
+        n += PutVarint(out + n, zeros);
+        n += PutVarint(out + n, literals);
+        for (int k = 0; k < literals; k++) {
+            int j = i + zeros + k;
+            out[n++] = blob[j] ^ (base? base[j] : 0);
+        }
+        i += zeros + literals;
+    }
+    return n;
+}
+
+static bool DeltaDecode(const unsigned char *in, int inSize, const unsigned char *base, unsigned char *blob, int size)
+{
+    int offset = 0, i = 0;
+    while (offset < inSize) {
+        unsigned int zeros, literals;
+        if (!GetVarint(in, inSize, &offset, &zeros) || !GetVarint(in, inSize, &offset, &literals)) return false;
+        if (i + (int)zeros + (int)literals > size || offset + (int)literals > inSize) return false;
+        for (unsigned int k = 0; k < zeros; k++, i++) blob[i] = base? base[i] : 0;
+        for (unsigned int k = 0; k < literals; k++, i++) blob[i] = in[offset++] ^ (base? base[i] : 0);
+    }
+    for (; i < size; i++) blob[i] = base? base[i] : 0;
+    return true;
+}
+
+static bool GetRollbackInput(const RollbackSession *session, int player, int frame, unsigned char *value)
+{
+    int slot = frame%ROLLBACK_INPUT_RING;
+    if (session->inputFrame[player][slot] != frame) return false;
+    *value = session->inputs[player][slot];
+    return true;
+}
+
+static void SetRollbackInput(RollbackSession *session, int player, int frame, unsigned char value)
+{
+    int slot = frame%ROLLBACK_INPUT_RING;
+    session->inputs[player][slot] = value;
+    session->inputFrame[player][slot] = frame;
+}
+
+static unsigned char *GetRingSnapshot(RollbackSession *session, int frame)
+{
+    if (frame < 0 || session->ringFrame[frame%ROLLBACK_RING] != frame) return NULL;
+    return session->ring + (size_t)(frame%ROLLBACK_RING)*session->callbacks.stateSize;
+}
+
+// Snapshot the current state as the start of session->frame, then simulate it
+static void AdvanceRollbackFrame(RollbackSession *session)
+{
+    int frame = session->frame;
+    int local = session->config.localPlayer, remote = 1 - local;
+
+    session->callbacks.saveState(session->callbacks.user, session->ring + (size_t)(frame%ROLLBACK_RING)*session->callbacks.stateSize);
+    session->ringFrame[frame%ROLLBACK_RING] = frame;
+
+    unsigned char inputs[2] = { 0 };
+    GetRollbackInput(session, local, frame, &inputs[local]);
+    if (!GetRollbackInput(session, remote, frame, &inputs[remote])) {
+        GetRollbackInput(session, remote, session->remoteConfirmed, &inputs[remote]);
+    }
+    session->predicted[frame%ROLLBACK_INPUT_RING] = inputs[remote];
+
+    session->callbacks.advance(session->callbacks.user, inputs);
+    session->frame++;
+}
+
+static void SendRollbackInputs(RollbackSession *session)
+{
+    int local = session->config.localPlayer;
+    int first = session->localAcked + 1;
+    int last = session->frame + session->config.inputDelay - 1;
+    if (last - first + 1 > ROLLBACK_MAX_SEND_INPUTS) last = first + ROLLBACK_MAX_SEND_INPUTS - 1;
+
+    unsigned char *p = session->packet;
+    int n = 0;
+    p[n++] = PACKET_INPUTS;
+    n += PutVarint(p + n, first);
+    p[n++] = (unsigned char)((last >= first)? last - first + 1 : 0);
+    for (int f = first; f <= last; f++) GetRollbackInput(session, local, f, &p[n++]);
+    n += PutVarint(p + n, session->remoteConfirmed + 1);
+    n += PutVarint(p + n, session->syncAck + 1);
+
+    UdpSend(session->sock, session->config.remotePort, p, n);
+    session->stats.bytesSent += n;
+}
+
+static void SendRollbackSnapshot(RollbackSession *session)
+{
+    // State at the start of the frame after the last confirmed one no longer depends on predictions
+    int frame = session->remoteConfirmed + 1;
+    int size = session->callbacks.stateSize;
+
+    if (frame == session->frame) session->callbacks.saveState(session->callbacks.user, session->pending);
+    else if (GetRingSnapshot(session, frame) != NULL) memcpy(session->pending, GetRingSnapshot(session, frame), size);
+    else return;
+
+    unsigned char *p = session->packet;
+    int n = 0;
+    p[n++] = PACKET_SNAPSHOT;
+    n += PutVarint(p + n, frame);
+    n += PutVarint(p + n, session->baselineFrame + 1);
+    int deltaSize = DeltaEncode(session->pending, (session->baselineFrame >= 0)? session->baseline : NULL, size, p + n, NET_MAX_PACKET - n);
+    if (deltaSize < 0) return;
+    n += deltaSize;
+
+    session->pendingFrame = frame;
+    UdpSend(session->sock, session->config.remotePort, p, n);
+    session->stats.bytesSent += n;
+    session->stats.lastSnapshotBytes = n;
+}
+
+static void ReceiveRollbackSnapshot(RollbackSession *session, const unsigned char *p, int size, int offset)
+{
+    unsigned int frame, baseFrame;
+    if (!GetVarint(p, size, &offset, &frame) || !GetVarint(p, size, &offset, &baseFrame)) return;
+
+    const unsigned char *base = NULL;
+    if (baseFrame > 0) {
+        for (int i = 0; i < ROLLBACK_RECEIVED; i++) {
+            if (session->receivedFrame[i] == (int)baseFrame - 1) base = session->received[i];
+        }
+        if (base == NULL) return;       // Baseline already dropped, wait for the next one
+    }
+
+    int stateSize = session->callbacks.stateSize;
+    if (!DeltaDecode(p + offset, size - offset, base, session->scratch, stateSize)) return;
+
+    memcpy(session->received[session->receivedNext], session->scratch, stateSize);
+    session->receivedFrame[session->receivedNext] = (int)frame;
+    if ((int)frame > session->syncAck) {
+        session->syncAck = (int)frame;
+        session->syncCheck = session->receivedNext;     // Compared by CheckRollbackSnapshot(), the newest wins
+    }
+    session->receivedNext = (session->receivedNext + 1)%ROLLBACK_RECEIVED;
+}
+
+// The host's snapshot is authoritative: once our state of that frame no longer depends on predictions, replace it
+// and re-simulate from there if they differ
+static void CheckRollbackSnapshot(RollbackSession *session)
+{
+    if (session->syncCheck < 0) return;
+
+    int frame = session->receivedFrame[session->syncCheck];
+    const unsigned char *host = session->received[session->syncCheck];
+    int stateSize = session->callbacks.stateSize;
+    if (frame > session->frame || frame - 1 > session->remoteConfirmed) return;     // Not confirmed here yet
+    session->syncCheck = -1;
+
+    unsigned char *ours = GetRingSnapshot(session, frame);
+    if (frame == session->frame) {
+        unsigned char *current = session->pending;
+        session->callbacks.saveState(session->callbacks.user, current);
+        if (memcmp(current, host, stateSize) != 0) {
+            session->callbacks.loadState(session->callbacks.user, host);
+            session->stats.desyncs++;
+        }
+    }
+    else if (ours != NULL && memcmp(ours, host, stateSize) != 0) {
+        memcpy(ours, host, stateSize);
+        if (frame < session->firstMispredict) session->firstMispredict = frame;
+        session->stats.desyncs++;
+    }
+}
+
+static void ReceiveRollbackPackets(RollbackSession *session)
+{
+    int remote = 1 - session->config.localPlayer;
+    unsigned char *p = session->packet;
+    int size;
+
+    while ((size = UdpReceive(session->sock, p, NET_MAX_PACKET)) > 0) {
+        int offset = 1;
+
+        if (p[0] == PACKET_SNAPSHOT) {
+            if (session->config.localPlayer != 0) ReceiveRollbackSnapshot(session, p, size, offset);
+            continue;
+        }
+        if (p[0] != PACKET_INPUTS) continue;
+
+        unsigned int first, ack, syncAck;
+        if (!GetVarint(p, size, &offset, &first) || offset >= size) continue;
+        int count = p[offset++];
+        if (offset + count > size) continue;
+
+        for (int i = 0; i < count; i++) {
+            int frame = (int)first + i;
+            unsigned char value = p[offset + i];
+            if (frame <= session->remoteConfirmed || frame >= session->frame + ROLLBACK_INPUT_RING/2) continue;
+
+            unsigned char known;
+            if (GetRollbackInput(session, remote, frame, &known)) continue;
+            SetRollbackInput(session, remote, frame, value);
+
+            // Already simulated with a prediction that turned out wrong
+            if (frame < session->frame && session->predicted[frame%ROLLBACK_INPUT_RING] != value &&
+                frame < session->firstMispredict) session->firstMispredict = frame;
+        }
+        offset += count;
+
+        unsigned char value;
+        while (GetRollbackInput(session, remote, session->remoteConfirmed + 1, &value)) session->remoteConfirmed++;
+
+        if (GetVarint(p, size, &offset, &ack) && (int)ack - 1 > session->localAcked) session->localAcked = (int)ack - 1;
+        if (GetVarint(p, size, &offset, &syncAck) && (int)syncAck - 1 == session->pendingFrame && session->pendingFrame > session->baselineFrame) {
+            memcpy(session->baseline, session->pending, session->callbacks.stateSize);
+            session->baselineFrame = session->pendingFrame;
+        }
+    }
+}
+
+RollbackSession *RollbackStart(RollbackConfig config, RollbackCallbacks callbacks)
+{
+    if (config.inputDelay < 0) config.inputDelay = 0;
+    if (config.inputDelay > ROLLBACK_RING - ROLLBACK_MAX_FRAMES - 2) config.inputDelay = ROLLBACK_RING - ROLLBACK_MAX_FRAMES - 2;
+
+    UdpSocket *sock = UdpOpen(config.localPort);
+    if (sock == NULL) return NULL;
+    UdpSetConditions(sock, config.lagMs, config.jitterMs, config.lossPercent);
+
+    RollbackSession *session = (RollbackSession *)calloc(1, sizeof(RollbackSession));
+    session->config = config;
+    session->callbacks = callbacks;
+    session->sock = sock;
+
+    int size = callbacks.stateSize;
+    session->ring = (unsigned char *)calloc(ROLLBACK_RING, size);
+    session->baseline = (unsigned char *)calloc(1, size);
+    session->pending = (unsigned char *)calloc(1, size);
+    session->scratch = (unsigned char *)calloc(1, size);
+    session->packet = (unsigned char *)malloc(NET_MAX_PACKET);
+    for (int i = 0; i < ROLLBACK_RECEIVED; i++) {
+        session->received[i] = (unsigned char *)calloc(1, size);
+        session->receivedFrame[i] = -1;
+    }
+    for (int i = 0; i < ROLLBACK_RING; i++) session->ringFrame[i] = -1;
+    for (int p = 0; p < 2; p++)
+        for (int i = 0; i < ROLLBACK_INPUT_RING; i++) session->inputFrame[p][i] = -1;
+
+    // Both sides idle through the input delay
+    for (int f = 0; f < config.inputDelay; f++) {
+        SetRollbackInput(session, 0, f, 0);
+        SetRollbackInput(session, 1, f, 0);
+    }
+    session->remoteConfirmed = config.inputDelay - 1;
+    session->localAcked = config.inputDelay - 1;
+    session->firstMispredict = INT_MAX;
+    session->baselineFrame = -1;
+    session->pendingFrame = -1;
+    session->syncAck = -1;
+    session->syncCheck = -1;
+
+    return session;
+}
+
+void RollbackStop(RollbackSession *session)
+{
+    if (session == NULL) return;
+    UdpClose(session->sock);
+    free(session->ring);
+    free(session->baseline);
+    free(session->pending);
+    free(session->scratch);
+    free(session->packet);
+    for (int i = 0; i < ROLLBACK_RECEIVED; i++) free(session->received[i]);
+    free(session);
+}
+
+// Restores the snapshot before the first wrong prediction and catches up again
+static void RollbackToMispredict(RollbackSession *session)
+{
+    if (session->firstMispredict < session->frame) {
+        int target = session->frame;
+        unsigned char *snapshot = GetRingSnapshot(session, session->firstMispredict);
+        if (snapshot != NULL) {
+            double start = NetGetTime();
+            session->callbacks.loadState(session->callbacks.user, snapshot);
+            session->frame = session->firstMispredict;
+            while (session->frame < target) AdvanceRollbackFrame(session);
+
+            double elapsed = (NetGetTime() - start)*1000.0;
+            session->stats.rollbacks++;
+            session->stats.lastRollback = target - session->firstMispredict;
+            session->stats.lastRollbackMs = elapsed;
+            if (session->stats.lastRollback > session->stats.maxRollback) session->stats.maxRollback = session->stats.lastRollback;
+            if (elapsed > session->stats.maxRollbackMs) session->stats.maxRollbackMs = elapsed;
+        }
+        session->firstMispredict = INT_MAX;
+    }
+}
+
+bool RollbackUpdate(RollbackSession *session, unsigned char localInput)
+{
+    ReceiveRollbackPackets(session);
+    RollbackToMispredict(session);
+    CheckRollbackSnapshot(session);
+    RollbackToMispredict(session);      // From a desync repaired in the past
+
+    // Too far ahead of the remote side to keep predicting
+    if (session->frame - session->remoteConfirmed > ROLLBACK_MAX_FRAMES) {
+        session->stats.stalls++;
+        SendRollbackInputs(session);
+        return false;
+    }
+
+    SetRollbackInput(session, session->config.localPlayer, session->frame + session->config.inputDelay, localInput);
+    AdvanceRollbackFrame(session);
+
+    if (session->config.localPlayer == 0 && session->frame%ROLLBACK_SYNC_INTERVAL == 0) SendRollbackSnapshot(session);
+    SendRollbackInputs(session);
+
+    return true;
+}
+
+RollbackStats RollbackGetStats(const RollbackSession *session)
+{
+    RollbackStats stats = session->stats;
+    stats.frame = session->frame;
+    stats.confirmedFrame = session->remoteConfirmed;
+    return stats;
+}
+
+#endif // ROLLBACK_IMPLEMENTATION
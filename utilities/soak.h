@@ -0,0 +1,168 @@
+#ifndef SOAK_H
+#define SOAK_H
+
+// Soak runs: leave a game playing itself (see bot.h) for a long time and watch for frame times that drift up and
+// memory that grows. Every SOAK_INTERVAL_SECONDS a CSV row goes to the log, and the summary on exit compares the
+// first interval with the last
+//
+//   <game> --bot 75 --soak 3600 --soak-log soak.csv
+//
+//   StartSoakRun(&soak, seconds, logFile);
+//   while (!WindowShouldClose() && UpdateSoakRun(&soak, GetTime())) { ... }
+//   FinishSoakRun(&soak, "breakout");
+//
+// Frame times are the time between two calls, so they include the wait for the target frame rate: a frame that
+// takes longer than the display interval shows as a higher mean. The headless drivers call it once per tick,
+// with nothing to wait for. Time is passed in, like gameloop.h. Without seconds or a log file it does nothing
+//
+// Declarations only, unless SOAK_IMPLEMENTATION is defined
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define SOAK_INTERVAL_SECONDS 10.0
+
+typedef struct {
+    bool active;
+    double seconds;                     // Length of the run, 0 to run until the game is closed
+    FILE *log;
+    double startTime;                   // Of the first call, negative before it
+    double lastTime;
+    double intervalStart;
+    long long frames;
+    int intervalFrames;
+    double intervalTotal, intervalMax;  // Frame seconds of the interval in progress
+    double worstFrame;
+    double firstMean, lastMean;         // Milliseconds per frame of the first and the last full interval
+    size_t startMemory, lastMemory, peakMemory;
+} SoakRun;
+
+void StartSoakRun(SoakRun *soak, double seconds, const char *logFile);
+bool UpdateSoakRun(SoakRun *soak, double time);         // Once per frame, false once the run is over
+void FinishSoakRun(SoakRun *soak, const char *game);    // Summary on stdout, closes the log
+size_t GetResidentMemory(void);                         // Bytes of the process in RAM, 0 if unknown
+
+#endif // SOAK_H
+
+#if defined(SOAK_IMPLEMENTATION) && !defined(SOAK_IMPLEMENTATION_DONE)
+#define SOAK_IMPLEMENTATION_DONE
+
+#if defined(_WIN32)
+    // No GDI or USER, their names clash with raylib.h's
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI
+    #define NOUSER
+    #include <windows.h>
+    #include <psapi.h>
+#elif defined(__APPLE__)
+    #include <mach/mach.h>
+#else
+    #include <unistd.h>
+#endif
+
+static void EndSoakInterval(SoakRun *soak, double time);
+
+void StartSoakRun(SoakRun *soak, double seconds, const char *logFile)
+{
+    *soak = (SoakRun){ 0 };
+    soak->seconds = seconds;
+    soak->startTime = -1.0;
+    soak->firstMean = -1.0;
+    soak->lastMean = -1.0;
+    soak->active = (seconds > 0.0) || (logFile != NULL);
+
+    if (logFile != NULL) {
+        soak->log = fopen(logFile, "w");
+        if (soak->log == NULL) fprintf(stderr, "SOAK: [%s] Failed to create log file\n", logFile);
+        else fprintf(soak->log, "seconds,frames,mean_ms,max_ms,resident_mb\n");
+    }
+}
+
+bool UpdateSoakRun(SoakRun *soak, double time)
+{
+    if (!soak->active) return true;
+
+    if (soak->startTime < 0.0) {
+        soak->startTime = soak->lastTime = soak->intervalStart = time;
+        soak->startMemory = soak->peakMemory = soak->lastMemory = GetResidentMemory();
+        return true;
+    }
+
+    double frame = time - soak->lastTime;
+    soak->lastTime = time;
+    soak->frames++;
+    soak->intervalFrames++;
+    soak->intervalTotal += frame;
+    if (frame > soak->intervalMax) soak->intervalMax = frame;
+
+    if (time - soak->intervalStart >= SOAK_INTERVAL_SECONDS) EndSoakInterval(soak, time);
+
+    return (soak->seconds <= 0.0) || (time - soak->startTime < soak->seconds);
+}
+
+void EndSoakInterval(SoakRun *soak, double time)
+{
+    double mean = soak->intervalTotal*1000.0/soak->intervalFrames;
+    if (soak->firstMean < 0.0) soak->firstMean = mean;
+    soak->lastMean = mean;
+    if (soak->intervalMax > soak->worstFrame) soak->worstFrame = soak->intervalMax;
+
+    soak->lastMemory = GetResidentMemory();
+    if (soak->lastMemory > soak->peakMemory) soak->peakMemory = soak->lastMemory;
+
+    if (soak->log != NULL) {
+        fprintf(soak->log, "%.1f,%lld,%.4f,%.4f,%.2f\n", time - soak->startTime, soak->frames, mean,
+            soak->intervalMax*1000.0, soak->lastMemory/(1024.0*1024.0));
+        fflush(soak->log);      // A run that crashes after an hour still leaves its log
+    }
+
+    soak->intervalStart = time;
+    soak->intervalFrames = 0;
+    soak->intervalTotal = 0.0;
+    soak->intervalMax = 0.0;
+}
+
+void FinishSoakRun(SoakRun *soak, const char *game)
+{
+    if (!soak->active) return;
+    if (soak->log != NULL) fclose(soak->log);
+
+    soak->lastMemory = GetResidentMemory();
+    if (soak->lastMemory > soak->peakMemory) soak->peakMemory = soak->lastMemory;
+
+    double megabyte = 1024.0*1024.0;
+    printf("%s: soak of %.0f s, %lld frames\n", game, (soak->startTime < 0.0)? 0.0 : soak->lastTime - soak->startTime, soak->frames);
+    if (soak->firstMean > 0.0) {
+        printf("%s: frame time %.4f ms in the first %.0f s, %.4f ms in the last (%+.1f%%), worst frame %.2f ms\n", game,
+            soak->firstMean, SOAK_INTERVAL_SECONDS, soak->lastMean, (soak->lastMean/soak->firstMean - 1.0)*100.0, soak->worstFrame*1000.0);
+    }
+    printf("%s: resident memory %.1f MB at the start, %.1f MB at the end (%+.1f MB), %.1f MB at most\n", game,
+        soak->startMemory/megabyte, soak->lastMemory/megabyte, ((double)soak->lastMemory - (double)soak->startMemory)/megabyte,
+        soak->peakMemory/megabyte);
+    soak->active = false;
+}
+
+size_t GetResidentMemory(void)
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return (size_t)counters.WorkingSetSize;
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) return 0;
+    return (size_t)info.resident_size;
+#else
+    // Second field of statm: resident pages
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (file == NULL) return 0;
+    unsigned long long size = 0, resident = 0;
+    int fields = fscanf(file, "%llu %llu", &size, &resident);
+    fclose(file);
+    return (fields == 2)? (size_t)(resident*(unsigned long long)sysconf(_SC_PAGESIZE)) : 0;
+#endif
+}
+
+#endif // SOAK_IMPLEMENTATION
@@ -0,0 +1,713 @@
+#ifndef SOFTRASTER_H
+#define SOFTRASTER_H
+
+// CPU rasterizer for recorded draw lists (see drawlist.h): pixels without a GPU or a window, for replay
+// thumbnails, visual regression frames and bot observations
+//
+//   RasterFrame frame = LoadRasterFrame(SCREEN_WIDTH, SCREEN_HEIGHT);
+//   RasterizeDrawList(&frame, &list);
+//   SaveRasterFrame(&frame, "frame.png");
+//
+// The frame is cut in RASTER_TILE_SIZE tiles and every command is binned into the tiles its bounds touch. Tiles
+// are drawn in parallel on the job system (jobs.h, inline when it isn't started), each one in command order,
+// and spans are filled four pixels at a time with SSE2 when available.
+//
+// It covers what the games draw and comes close to raylib, without being pixel-exact: a pixel is drawn when its
+// center is inside the shape, no antialiasing, one pixel lines, text in a built-in 5x7 font laid out like raylib's
+// default font. Textures draw the pixels registered for them with SetRasterTexture(), or their tint when none are
+//
+// Declarations only, unless SOFTRASTER_IMPLEMENTATION is defined. Built on drawlist.h and jobs.h
+
+#include "drawlist.h"
+#include <stdbool.h>
+
+#define RASTER_TILE_SIZE 64
+#define RASTER_MAX_TEXTURES 16
+
+typedef struct {
+    int width;
+    int height;
+    unsigned int *pixels;               // 0xAABBGGRR, row by row
+
+    // Binning scratch, kept from frame to frame
+    DrawCommand *commands;
+    void *commandTiles;                 // Tile range of each command
+    int commandCapacity;
+    int *tileStart;                     // Per tile, into entries, plus one past the end
+    int *tileFill;
+    int *entries;                       // Command indices, tile by tile
+    int entryCapacity;
+} RasterFrame;
+
+RasterFrame LoadRasterFrame(int width, int height);
+void UnloadRasterFrame(RasterFrame *frame);
+void RasterizeDrawList(RasterFrame *frame, const DrawList *list);     // Draws over what the frame has
+Color GetRasterPixel(const RasterFrame *frame, int x, int y);
+
+// Pixels to draw a texture with, by its id. Only the pointer is kept, width*height RGBA pixels
+void SetRasterTexture(unsigned int id, const Color *pixels, int width, int height);
+
+bool SaveRasterFrame(const RasterFrame *frame, const char *fileName);  // PNG, stored without compression
+
+#endif // SOFTRASTER_H
+
+#if defined(SOFTRASTER_IMPLEMENTATION) && !defined(SOFTRASTER_IMPLEMENTATION_DONE)
+#define SOFTRASTER_IMPLEMENTATION_DONE
+
+#include "jobs.h"
+#include "profiler.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define RASTER_SSE2
+#endif
+
+#define RASTER_TILE_BATCH 4             // Tiles per job batch
+#define RASTER_FONT_SIZE 10             // Size the font is drawn at unscaled, like raylib's default font
+#define RASTER_LINE_SPACING 2           // Between text lines, like raylib
+
+typedef struct {
+    int x0, y0, x1, y1;                 // Pixels, end exclusive
+} RasterClip;
+
+static struct {
+    unsigned int id;
+    const Color *pixels;
+    int width;
+    int height;
+} rasterTextures[RASTER_MAX_TEXTURES] = { 0 };
+static int rasterTextureCount = 0;
+
+// Printable ASCII, 5 columns of 7 rows each, bit 0 at the top
+static const unsigned char rasterFont[95][5] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x5f, 0x00, 0x00 }, { 0x00, 0x07, 0x00, 0x07, 0x00 }, { 0x14, 0x7f, 0x14, 0x7f, 0x14 },
+    { 0x24, 0x2a, 0x7f, 0x2a, 0x12 }, { 0x23, 0x13, 0x08, 0x64, 0x62 }, { 0x36, 0x49, 0x55, 0x22, 0x50 }, { 0x00, 0x05, 0x03, 0x00, 0x00 },
+    { 0x00, 0x1c, 0x22, 0x41, 0x00 }, { 0x00, 0x41, 0x22, 0x1c, 0x00 }, { 0x14, 0x08, 0x3e, 0x08, 0x14 }, { 0x08, 0x08, 0x3e, 0x08, 0x08 },
+    { 0x00, 0x50, 0x30, 0x00, 0x00 }, { 0x08, 0x08, 0x08, 0x08, 0x08 }, { 0x00, 0x60, 0x60, 0x00, 0x00 }, { 0x20, 0x10, 0x08, 0x04, 0x02 },
+    { 0x3e, 0x51, 0x49, 0x45, 0x3e }, { 0x00, 0x42, 0x7f, 0x40, 0x00 }, { 0x42, 0x61, 0x51, 0x49, 0x46 }, { 0x21, 0x41, 0x45, 0x4b, 0x31 },
+    { 0x18, 0x14, 0x12, 0x7f, 0x10 }, { 0x27, 0x45, 0x45, 0x45, 0x39 }, { 0x3c, 0x4a, 0x49, 0x49, 0x30 }, { 0x01, 0x71, 0x09, 0x05, 0x03 },
+    { 0x36, 0x49, 0x49, 0x49, 0x36 }, { 0x06, 0x49, 0x49, 0x29, 0x1e }, { 0x00, 0x36, 0x36, 0x00, 0x00 }, { 0x00, 0x56, 0x36, 0x00, 0x00 },
+    { 0x08, 0x14, 0x22, 0x41, 0x00 }, { 0x14, 0x14, 0x14, 0x14, 0x14 }, { 0x00, 0x41, 0x22, 0x14, 0x08 }, { 0x02, 0x01, 0x51, 0x09, 0x06 },
+    { 0x32, 0x49, 0x79, 0x41, 0x3e }, { 0x7e, 0x11, 0x11, 0x11, 0x7e }, { 0x7f, 0x49, 0x49, 0x49, 0x36 }, { 0x3e, 0x41, 0x41, 0x41, 0x22 },
+    { 0x7f, 0x41, 0x41, 0x22, 0x1c }, { 0x7f, 0x49, 0x49, 0x49, 0x41 }, { 0x7f, 0x09, 0x09, 0x09, 0x01 }, { 0x3e, 0x41, 0x49, 0x49, 0x7a },
+    { 0x7f, 0x08, 0x08, 0x08, 0x7f }, { 0x00, 0x41, 0x7f, 0x41, 0x00 }, { 0x20, 0x40, 0x41, 0x3f, 0x01 }, { 0x7f, 0x08, 0x14, 0x22, 0x41 },
+    { 0x7f, 0x40, 0x40, 0x40, 0x40 }, { 0x7f, 0x02, 0x0c, 0x02, 0x7f }, { 0x7f, 0x04, 0x08, 0x10, 0x7f }, { 0x3e, 0x41, 0x41, 0x41, 0x3e },
+    { 0x7f, 0x09, 0x09, 0x09, 0x06 }, { 0x3e, 0x41, 0x51, 0x21, 0x5e }, { 0x7f, 0x09, 0x19, 0x29, 0x46 }, { 0x46, 0x49, 0x49, 0x49, 0x31 },
+    { 0x01, 0x01, 0x7f, 0x01, 0x01 }, { 0x3f, 0x40, 0x40, 0x40, 0x3f }, { 0x1f, 0x20, 0x40, 0x20, 0x1f }, { 0x3f, 0x40, 0x38, 0x40, 0x3f },
+    { 0x63, 0x14, 0x08, 0x14, 0x63 }, { 0x07, 0x08, 0x70, 0x08, 0x07 }, { 0x61, 0x51, 0x49, 0x45, 0x43 }, { 0x00, 0x7f, 0x41, 0x41, 0x00 },
+    { 0x02, 0x04, 0x08, 0x10, 0x20 }, { 0x00, 0x41, 0x41, 0x7f, 0x00 }, { 0x04, 0x02, 0x01, 0x02, 0x04 }, { 0x40, 0x40, 0x40, 0x40, 0x40 },
+    { 0x00, 0x01, 0x02, 0x04, 0x00 }, { 0x20, 0x54, 0x54, 0x54, 0x78 }, { 0x7f, 0x48, 0x44, 0x44, 0x38 }, { 0x38, 0x44, 0x44, 0x44, 0x20 },
+    { 0x38, 0x44, 0x44, 0x48, 0x7f }, { 0x38, 0x54, 0x54, 0x54, 0x18 }, { 0x08, 0x7e, 0x09, 0x01, 0x02 }, { 0x0c, 0x52, 0x52, 0x52, 0x3e },
+    { 0x7f, 0x08, 0x04, 0x04, 0x78 }, { 0x00, 0x44, 0x7d, 0x40, 0x00 }, { 0x20, 0x40, 0x44, 0x3d, 0x00 }, { 0x7f, 0x10, 0x28, 0x44, 0x00 },
+    { 0x00, 0x41, 0x7f, 0x40, 0x00 }, { 0x7c, 0x04, 0x18, 0x04, 0x78 }, { 0x7c, 0x08, 0x04, 0x04, 0x78 }, { 0x38, 0x44, 0x44, 0x44, 0x38 },
+    { 0x7c, 0x14, 0x14, 0x14, 0x08 }, { 0x08, 0x14, 0x14, 0x18, 0x7c }, { 0x7c, 0x08, 0x04, 0x04, 0x08 }, { 0x48, 0x54, 0x54, 0x54, 0x20 },
+    { 0x04, 0x3f, 0x44, 0x40, 0x20 }, { 0x3c, 0x40, 0x40, 0x20, 0x7c }, { 0x1c, 0x20, 0x40, 0x20, 0x1c }, { 0x3c, 0x40, 0x30, 0x40, 0x3c },
+    { 0x44, 0x28, 0x10, 0x28, 0x44 }, { 0x0c, 0x50, 0x50, 0x50, 0x3c }, { 0x44, 0x64, 0x54, 0x4c, 0x44 }, { 0x00, 0x08, 0x36, 0x41, 0x00 },
+    { 0x00, 0x00, 0x7f, 0x00, 0x00 }, { 0x00, 0x41, 0x36, 0x08, 0x00 }, { 0x10, 0x08, 0x08, 0x10, 0x08 }
+};
+
+typedef struct {
+    RasterFrame *frame;
+    int tileCols;
+} RasterJob;
+
+static inline unsigned int PackRasterColor(Color color)
+{
+    return (unsigned int)color.r | ((unsigned int)color.g << 8) | ((unsigned int)color.b << 16) | ((unsigned int)color.a << 24);
+}
+
+// Source over destination, alpha 255 maps to 256 so opaque copies exactly. The source's own alpha byte
+// counts as 255, so coverage adds up in the alpha channel and an opaque frame stays opaque
+static inline unsigned int BlendRasterPixel(unsigned int dst, unsigned int src, int alpha)
+{
+    src |= 0xff000000u;
+    unsigned int a = (unsigned int)(alpha + (alpha >> 7)), ia = 256 - a;
+    unsigned int rb = ((src & 0x00ff00ffu)*a + (dst & 0x00ff00ffu)*ia) >> 8;
+    unsigned int ga = (((src >> 8) & 0x00ff00ffu)*a + ((dst >> 8) & 0x00ff00ffu)*ia) >> 8;
+    return (rb & 0x00ff00ffu) | ((ga & 0x00ff00ffu) << 8);
+}
+
+// Pixels [x0, x1) of a row
+static void FillRasterSpan(unsigned int *row, int x0, int x1, unsigned int color, int alpha)
+{
+    if (alpha == 0 || x1 <= x0) return;
+
+    int x = x0;
+#if defined(RASTER_SSE2)
+    if (alpha == 255) {
+        __m128i fill = _mm_set1_epi32((int)color);
+        for (; x + 4 <= x1; x += 4) _mm_storeu_si128((__m128i *)(row + x), fill);
+    }
+    else {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i a = _mm_set1_epi16((short)(alpha + (alpha >> 7)));
+        const __m128i ia = _mm_sub_epi16(_mm_set1_epi16(256), a);
+        const __m128i src = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32((int)(color | 0xff000000u)), zero), a);
+        for (; x + 4 <= x1; x += 4) {
+            __m128i dst = _mm_loadu_si128((const __m128i *)(row + x));
+            __m128i lo = _mm_srli_epi16(_mm_add_epi16(src, _mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), ia)), 8);
+            __m128i hi = _mm_srli_epi16(_mm_add_epi16(src, _mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), ia)), 8);
+            _mm_storeu_si128((__m128i *)(row + x), _mm_packus_epi16(lo, hi));
+        }
+    }
+#endif
+    if (alpha == 255) for (; x < x1; x++) row[x] = color;
+    else for (; x < x1; x++) row[x] = BlendRasterPixel(row[x], color, alpha);
+}
+
+static inline void PlotRasterPixel(RasterFrame *frame, RasterClip clip, int x, int y, unsigned int color, int alpha)
+{
+    if (x < clip.x0 || x >= clip.x1 || y < clip.y0 || y >= clip.y1 || alpha == 0) return;
+
+    unsigned int *pixel = frame->pixels + y*frame->width + x;
+    *pixel = (alpha == 255)? color : BlendRasterPixel(*pixel, color, alpha);
+}
+
+// First pixel whose center is at or past the coordinate
+static inline int RasterPixel(float coordinate)
+{
+    return (int)ceilf(coordinate - 0.5f);
+}
+
+static void RasterizeRectangle(RasterFrame *frame, RasterClip clip, Rectangle rec, Color color)
+{
+    int x0 = RasterPixel(rec.x), x1 = RasterPixel(rec.x + rec.width);
+    int y0 = RasterPixel(rec.y), y1 = RasterPixel(rec.y + rec.height);
+    if (x0 < clip.x0) x0 = clip.x0;
+    if (x1 > clip.x1) x1 = clip.x1;
+    if (y0 < clip.y0) y0 = clip.y0;
+    if (y1 > clip.y1) y1 = clip.y1;
+
+    unsigned int packed = PackRasterColor(color);
+    for (int y = y0; y < y1; y++) FillRasterSpan(frame->pixels + y*frame->width, x0, x1, packed, color.a);
+}
+
+static void RasterizeCircle(RasterFrame *frame, RasterClip clip, Vector2 center, float radius, Color color)
+{
+    int y0 = RasterPixel(center.y - radius), y1 = RasterPixel(center.y + radius);
+    if (y0 < clip.y0) y0 = clip.y0;
+    if (y1 > clip.y1) y1 = clip.y1;
+
+    unsigned int packed = PackRasterColor(color);
+    for (int y = y0; y < y1; y++) {
+        float dy = y + 0.5f - center.y;
+        float squared = radius*radius - dy*dy;
+        if (squared < 0.0f) continue;
+
+        float half = sqrtf(squared);
+        int x0 = RasterPixel(center.x - half), x1 = RasterPixel(center.x + half);
+        if (x0 < clip.x0) x0 = clip.x0;
+        if (x1 > clip.x1) x1 = clip.x1;
+        FillRasterSpan(frame->pixels + y*frame->width, x0, x1, packed, color.a);
+    }
+}
+
+// Either winding, a span per row between the edges crossing the row's center
+static void RasterizeTriangle(RasterFrame *frame, RasterClip clip, Vector2 v1, Vector2 v2, Vector2 v3, Color color)
+{
+    Vector2 v[3] = { v1, v2, v3 };
+    float minY = fminf(v1.y, fminf(v2.y, v3.y)), maxY = fmaxf(v1.y, fmaxf(v2.y, v3.y));
+    int y0 = RasterPixel(minY), y1 = RasterPixel(maxY);
+    if (y0 < clip.y0) y0 = clip.y0;
+    if (y1 > clip.y1) y1 = clip.y1;
+
+    unsigned int packed = PackRasterColor(color);
+    for (int y = y0; y < y1; y++) {
+        float py = y + 0.5f;
+        float left = 0.0f, right = 0.0f;
+        int crossings = 0;
+
+        for (int e = 0; e < 3; e++) {
+            Vector2 a = v[e], b = v[(e + 1)%3];
+            if ((a.y <= py && py < b.y) || (b.y <= py && py < a.y)) {
+                float x = a.x + (py - a.y)*(b.x - a.x)/(b.y - a.y);
+                if (crossings == 0 || x < left) left = x;
+                if (crossings == 0 || x > right) right = x;
+                crossings++;
+            }
+        }
+        if (crossings < 2) continue;
+
+        int x0 = RasterPixel(left), x1 = RasterPixel(right);
+        if (x0 < clip.x0) x0 = clip.x0;
+        if (x1 > clip.x1) x1 = clip.x1;
+        FillRasterSpan(frame->pixels + y*frame->width, x0, x1, packed, color.a);
+    }
+}
+
+static void RasterizeLine(RasterFrame *frame, RasterClip clip, Vector2 start, Vector2 end, Color color)
+{
+    float dx = end.x - start.x, dy = end.y - start.y;
+    int steps = (int)ceilf(fmaxf(fabsf(dx), fabsf(dy)));
+    if (steps < 1) steps = 1;
+
+    unsigned int packed = PackRasterColor(color);
+    for (int i = 0; i <= steps; i++) {
+        float t = (float)i/steps;
+        PlotRasterPixel(frame, clip, (int)floorf(start.x + dx*t), (int)floorf(start.y + dy*t), packed, color.a);
+    }
+}
+
+// Corners of a DrawTexturePro() quad: the destination rectangle turned about its position, origin first
+static void GetRasterQuad(Rectangle dest, Vector2 origin, float rotation, Vector2 corners[4])
+{
+    float s = sinf(rotation*DEG2RAD), c = cosf(rotation*DEG2RAD);
+    Vector2 local[4] = {
+        { -origin.x, -origin.y }, { dest.width - origin.x, -origin.y },
+        { dest.width - origin.x, dest.height - origin.y }, { -origin.x, dest.height - origin.y }
+    };
+    for (int i = 0; i < 4; i++) {
+        corners[i] = (Vector2){ dest.x + local[i].x*c - local[i].y*s, dest.y + local[i].x*s + local[i].y*c };
+    }
+}
+
+static void RasterizeTexture(RasterFrame *frame, RasterClip clip, const DrawCommand *command)
+{
+    Rectangle source = command->texture.source, dest = command->texture.dest;
+    Vector2 origin = command->texture.origin;
+    Color tint = command->color;
+    if (dest.width <= 0.0f || dest.height <= 0.0f) return;
+
+    const Color *pixels = NULL;
+    int width = 0, height = 0;
+    for (int i = 0; i < rasterTextureCount; i++) {
+        if (rasterTextures[i].id == command->texture.texture.id) {
+            pixels = rasterTextures[i].pixels;
+            width = rasterTextures[i].width;
+            height = rasterTextures[i].height;
+        }
+    }
+
+    Vector2 corners[4];
+    GetRasterQuad(dest, origin, command->texture.rotation, corners);
+    if (pixels == NULL) {
+        RasterizeTriangle(frame, clip, corners[0], corners[1], corners[2], tint);
+        RasterizeTriangle(frame, clip, corners[0], corners[2], corners[3], tint);
+        return;
+    }
+
+    float minX = corners[0].x, maxX = corners[0].x, minY = corners[0].y, maxY = corners[0].y;
+    for (int i = 1; i < 4; i++) {
+        minX = fminf(minX, corners[i].x);
+        maxX = fmaxf(maxX, corners[i].x);
+        minY = fminf(minY, corners[i].y);
+        maxY = fmaxf(maxY, corners[i].y);
+    }
+    int x0 = RasterPixel(minX), x1 = RasterPixel(maxX), y0 = RasterPixel(minY), y1 = RasterPixel(maxY);
+    if (x0 < clip.x0) x0 = clip.x0;
+    if (x1 > clip.x1) x1 = clip.x1;
+    if (y0 < clip.y0) y0 = clip.y0;
+    if (y1 > clip.y1) y1 = clip.y1;
+
+    // Pixel centers back into the quad, then to the nearest texel. A negative source size flips
+    float s = sinf(command->texture.rotation*DEG2RAD), c = cosf(command->texture.rotation*DEG2RAD);
+    float sourceWidth = fabsf(source.width), sourceHeight = fabsf(source.height);
+    for (int y = y0; y < y1; y++) {
+        unsigned int *row = frame->pixels + y*frame->width;
+        for (int x = x0; x < x1; x++) {
+            float px = x + 0.5f - dest.x, py = y + 0.5f - dest.y;
+            float u = (px*c + py*s + origin.x)/dest.width, v = (-px*s + py*c + origin.y)/dest.height;
+            if (u < 0.0f || u >= 1.0f || v < 0.0f || v >= 1.0f) continue;
+            if (source.width < 0.0f) u = 1.0f - u;
+            if (source.height < 0.0f) v = 1.0f - v;
+
+            int tx = (int)(source.x + u*sourceWidth), ty = (int)(source.y + v*sourceHeight);
+            if (tx < 0 || tx >= width || ty < 0 || ty >= height) continue;
+
+            Color texel = pixels[ty*width + tx];
+            Color color = { (unsigned char)(texel.r*tint.r/255), (unsigned char)(texel.g*tint.g/255), (unsigned char)(texel.b*tint.b/255), 255 };
+            int alpha = texel.a*tint.a/255;
+            if (alpha > 0) row[x] = (alpha == 255)? PackRasterColor(color) : BlendRasterPixel(row[x], PackRasterColor(color), alpha);
+        }
+    }
+}
+
+// Columns a glyph spans, blank ones on both sides trimmed. Unknown characters show as '?'
+static const unsigned char *GetRasterGlyph(int character, int *first, int *width)
+{
+    if (character < 32 || character > 126) character = '?';
+    const unsigned char *glyph = rasterFont[character - 32];
+
+    int lo = 0, hi = 4;
+    while (lo <= hi && glyph[lo] == 0) lo++;
+    while (hi >= lo && glyph[hi] == 0) hi--;
+    if (lo > hi) {
+        *first = 0;         // Space
+        *width = 3;
+    }
+    else {
+        *first = lo;
+        *width = hi - lo + 1;
+    }
+    return glyph;
+}
+
+// Size of a text in pixels, laid out like DrawText()
+static Vector2 MeasureRasterText(const char *text, int fontSize)
+{
+    if (fontSize < RASTER_FONT_SIZE) fontSize = RASTER_FONT_SIZE;
+    float scale = (float)fontSize/RASTER_FONT_SIZE;
+    int spacing = fontSize/RASTER_FONT_SIZE;
+
+    float lineWidth = 0.0f, width = 0.0f;
+    int lines = 1;
+    for (const char *c = text; *c != '\0'; c++) {
+        if (*c == '\n') {
+            lines++;
+            lineWidth = 0.0f;
+            continue;
+        }
+        int first, glyphWidth;
+        GetRasterGlyph((unsigned char)*c, &first, &glyphWidth);
+        lineWidth += glyphWidth*scale + spacing;
+        if (lineWidth > width) width = lineWidth;
+    }
+
+    return (Vector2){ width, (float)(lines*fontSize + (lines - 1)*RASTER_LINE_SPACING) };
+}
+
+static void RasterizeText(RasterFrame *frame, RasterClip clip, const char *text, int x, int y, int fontSize, Color color)
+{
+    if (fontSize < RASTER_FONT_SIZE) fontSize = RASTER_FONT_SIZE;
+    float scale = (float)fontSize/RASTER_FONT_SIZE;
+    int spacing = fontSize/RASTER_FONT_SIZE;
+
+    float penX = (float)x, penY = (float)y;
+    for (const char *c = text; *c != '\0'; c++) {
+        if (*c == '\n') {
+            penX = (float)x;
+            penY += fontSize + RASTER_LINE_SPACING;
+            continue;
+        }
+
+        int first, width;
+        const unsigned char *glyph = GetRasterGlyph((unsigned char)*c, &first, &width);
+        for (int col = 0; col < width; col++) {
+            unsigned char bits = glyph[first + col];
+            for (int row = 0; bits != 0; row++, bits >>= 1) {
+                if (bits & 1) RasterizeRectangle(frame, clip, (Rectangle){ penX + col*scale, penY + (row + 1)*scale, scale, scale }, color);
+            }
+        }
+        penX += width*scale + spacing;
+    }
+}
+
+// Pixels a command may touch, end exclusive, before clipping to the frame
+static RasterClip GetRasterBounds(const DrawCommand *command)
+{
+    float x0 = 0.0f, y0 = 0.0f, x1 = 0.0f, y1 = 0.0f;
+
+    switch (command->type) {
+        case DRAW_CLEAR: return (RasterClip){ -(1 << 30), -(1 << 30), 1 << 30, 1 << 30 };
+        case DRAW_RECTANGLE: {
+            x0 = command->rec.x;
+            y0 = command->rec.y;
+            x1 = command->rec.x + command->rec.width;
+            y1 = command->rec.y + command->rec.height;
+        } break;
+        case DRAW_CIRCLE: {
+            x0 = command->circle.center.x - command->circle.radius;
+            y0 = command->circle.center.y - command->circle.radius;
+            x1 = command->circle.center.x + command->circle.radius;
+            y1 = command->circle.center.y + command->circle.radius;
+        } break;
+        case DRAW_LINE: {
+            x0 = fminf(command->line.start.x, command->line.end.x);
+            y0 = fminf(command->line.start.y, command->line.end.y);
+            x1 = fmaxf(command->line.start.x, command->line.end.x) + 1.0f;
+            y1 = fmaxf(command->line.start.y, command->line.end.y) + 1.0f;
+        } break;
+        case DRAW_TRIANGLE: {
+            x0 = fminf(command->triangle.v1.x, fminf(command->triangle.v2.x, command->triangle.v3.x));
+            y0 = fminf(command->triangle.v1.y, fminf(command->triangle.v2.y, command->triangle.v3.y));
+            x1 = fmaxf(command->triangle.v1.x, fmaxf(command->triangle.v2.x, command->triangle.v3.x));
+            y1 = fmaxf(command->triangle.v1.y, fmaxf(command->triangle.v2.y, command->triangle.v3.y));
+        } break;
+        case DRAW_TEXTURE: {
+            Vector2 corners[4];
+            GetRasterQuad(command->texture.dest, command->texture.origin, command->texture.rotation, corners);
+            x0 = x1 = corners[0].x;
+            y0 = y1 = corners[0].y;
+            for (int i = 1; i < 4; i++) {
+                x0 = fminf(x0, corners[i].x);
+                x1 = fmaxf(x1, corners[i].x);
+                y0 = fminf(y0, corners[i].y);
+                y1 = fmaxf(y1, corners[i].y);
+            }
+        } break;
+        case DRAW_TEXT: {
+            Vector2 size = MeasureRasterText(command->text.text, command->text.fontSize);
+            x0 = (float)command->text.x;
+            y0 = (float)command->text.y;
+            x1 = x0 + size.x;
+            y1 = y0 + size.y;
+        } break;
+        case DRAW_SOUND:
+        case DRAW_MIXER_SOUND:
+        case DRAW_SPRITES: return (RasterClip){ 0, 0, 0, 0 };
+    }
+
+    return (RasterClip){ (int)floorf(x0), (int)floorf(y0), (int)ceilf(x1) + 1, (int)ceilf(y1) + 1 };
+}
+
+static void RasterizeCommand(RasterFrame *frame, RasterClip clip, const DrawCommand *command)
+{
+    switch (command->type) {
+        case DRAW_CLEAR: {
+            unsigned int packed = PackRasterColor(command->color);
+            for (int y = clip.y0; y < clip.y1; y++) FillRasterSpan(frame->pixels + y*frame->width, clip.x0, clip.x1, packed, 255);
+        } break;
+        case DRAW_RECTANGLE: RasterizeRectangle(frame, clip, command->rec, command->color); break;
+        case DRAW_CIRCLE: RasterizeCircle(frame, clip, command->circle.center, command->circle.radius, command->color); break;
+        case DRAW_LINE: RasterizeLine(frame, clip, command->line.start, command->line.end, command->color); break;
+        case DRAW_TRIANGLE: RasterizeTriangle(frame, clip, command->triangle.v1, command->triangle.v2, command->triangle.v3, command->color); break;
+        case DRAW_TEXTURE: RasterizeTexture(frame, clip, command); break;
+        case DRAW_TEXT: RasterizeText(frame, clip, command->text.text, command->text.x, command->text.y, command->text.fontSize, command->color); break;
+        case DRAW_SOUND:
+        case DRAW_MIXER_SOUND:
+        case DRAW_SPRITES: break;
+    }
+}
+
+static void RasterizeTiles(void *data, int first, int last)
+{
+    RasterJob *job = (RasterJob *)data;
+    RasterFrame *frame = job->frame;
+
+    for (int tile = first; tile < last; tile++) {
+        int tx = tile%job->tileCols, ty = tile/job->tileCols;
+        RasterClip clip = { tx*RASTER_TILE_SIZE, ty*RASTER_TILE_SIZE, (tx + 1)*RASTER_TILE_SIZE, (ty + 1)*RASTER_TILE_SIZE };
+        if (clip.x1 > frame->width) clip.x1 = frame->width;
+        if (clip.y1 > frame->height) clip.y1 = frame->height;
+
+        for (int e = frame->tileStart[tile]; e < frame->tileStart[tile + 1]; e++) {
+            RasterizeCommand(frame, clip, &frame->commands[frame->entries[e]]);
+        }
+    }
+}
+
+RasterFrame LoadRasterFrame(int width, int height)
+{
+    RasterFrame frame = { 0 };
+    frame.width = width;
+    frame.height = height;
+    frame.pixels = (unsigned int *)calloc((size_t)width*height, sizeof(unsigned int));
+
+    int tileCount = ((width + RASTER_TILE_SIZE - 1)/RASTER_TILE_SIZE)*((height + RASTER_TILE_SIZE - 1)/RASTER_TILE_SIZE);
+    frame.tileStart = (int *)calloc(tileCount + 1, sizeof(int));
+    frame.tileFill = (int *)calloc(tileCount + 1, sizeof(int));
+    return frame;
+}
+
+void UnloadRasterFrame(RasterFrame *frame)
+{
+    free(frame->pixels);
+    free(frame->commands);
+    free(frame->commandTiles);
+    free(frame->tileStart);
+    free(frame->tileFill);
+    free(frame->entries);
+    *frame = (RasterFrame){ 0 };
+}
+
+void RasterizeDrawList(RasterFrame *frame, const DrawList *list)
+{
+    ProfileBegin("rasterize");
+
+    int tileCols = (frame->width + RASTER_TILE_SIZE - 1)/RASTER_TILE_SIZE;
+    int tileRows = (frame->height + RASTER_TILE_SIZE - 1)/RASTER_TILE_SIZE;
+    int tileCount = tileCols*tileRows;
+
+    // Sprite commands are split into one texture command per sprite, binned apart
+    if (list->count + list->sprites > frame->commandCapacity) {
+        frame->commandCapacity = list->count + list->sprites;
+        frame->commands = (DrawCommand *)realloc(frame->commands, frame->commandCapacity*sizeof(DrawCommand));
+        frame->commandTiles = realloc(frame->commandTiles, frame->commandCapacity*sizeof(RasterClip));
+    }
+
+    // Decode, then count the entries of each tile
+    RasterClip *commandTiles = (RasterClip *)frame->commandTiles;
+    memset(frame->tileStart, 0, (tileCount + 1)*sizeof(int));
+    int commandCount = 0, offset = 0, sprite = 0;
+    DrawCommand sprites = { 0 };
+    while (commandCount < frame->commandCapacity) {
+        if (sprite < sprites.sprites.count) {
+            DrawSprite next = GetDrawSprite(&sprites, sprite++);
+            DrawCommand *command = &frame->commands[commandCount];
+            command->type = DRAW_TEXTURE;
+            command->color = next.tint;
+            command->texture.texture = sprites.sprites.texture;
+            command->texture.source = next.source;
+            command->texture.dest = next.dest;
+            command->texture.origin = next.origin;
+            command->texture.rotation = next.rotation;
+        }
+        else if (!NextDrawCommand(list, &offset, &frame->commands[commandCount])) break;
+        else if (frame->commands[commandCount].type == DRAW_SPRITES) {
+            sprites = frame->commands[commandCount];
+            sprite = 0;
+            continue;
+        }
+
+        RasterClip bounds = GetRasterBounds(&frame->commands[commandCount]);
+        RasterClip tiles = {
+            (bounds.x0 < 0)? 0 : bounds.x0/RASTER_TILE_SIZE, (bounds.y0 < 0)? 0 : bounds.y0/RASTER_TILE_SIZE,
+            (bounds.x1 > frame->width)? tileCols : (bounds.x1 + RASTER_TILE_SIZE - 1)/RASTER_TILE_SIZE,
+            (bounds.y1 > frame->height)? tileRows : (bounds.y1 + RASTER_TILE_SIZE - 1)/RASTER_TILE_SIZE
+        };
+        if (bounds.x1 <= 0 || bounds.y1 <= 0) tiles.x1 = tiles.x0;
+        commandTiles[commandCount] = tiles;
+
+        for (int ty = tiles.y0; ty < tiles.y1; ty++) {
+            for (int tx = tiles.x0; tx < tiles.x1; tx++) frame->tileStart[ty*tileCols + tx + 1]++;
+        }
+        commandCount++;
+    }
+
+    for (int tile = 0; tile < tileCount; tile++) frame->tileStart[tile + 1] += frame->tileStart[tile];
+    int entryCount = frame->tileStart[tileCount];
+    if (entryCount > frame->entryCapacity) {
+        frame->entryCapacity = entryCount;
+        frame->entries = (int *)realloc(frame->entries, frame->entryCapacity*sizeof(int));
+    }
+
+    // Fill in command order, so every tile draws its commands in the order they were recorded
+    memcpy(frame->tileFill, frame->tileStart, tileCount*sizeof(int));
+    for (int i = 0; i < commandCount; i++) {
+        RasterClip tiles = commandTiles[i];
+        for (int ty = tiles.y0; ty < tiles.y1; ty++) {
+            for (int tx = tiles.x0; tx < tiles.x1; tx++) frame->entries[frame->tileFill[ty*tileCols + tx]++] = i;
+        }
+    }
+
+    RasterJob job = { frame, tileCols };
+    RunParallelFor(RasterizeTiles, &job, tileCount, RASTER_TILE_BATCH);
+
+    ProfileEnd();
+}
+
+Color GetRasterPixel(const RasterFrame *frame, int x, int y)
+{
+    unsigned int pixel = frame->pixels[y*frame->width + x];
+    return (Color){ (unsigned char)pixel, (unsigned char)(pixel >> 8), (unsigned char)(pixel >> 16), (unsigned char)(pixel >> 24) };
+}
+
+void SetRasterTexture(unsigned int id, const Color *pixels, int width, int height)
+{
+    int i = 0;
+    while (i < rasterTextureCount && rasterTextures[i].id != id) i++;
+    if (i == RASTER_MAX_TEXTURES) return;
+    if (i == rasterTextureCount) rasterTextureCount++;
+
+    rasterTextures[i].id = id;
+    rasterTextures[i].pixels = pixels;
+    rasterTextures[i].width = width;
+    rasterTextures[i].height = height;
+}
+
+static unsigned int UpdateRasterCrc(unsigned int crc, const unsigned char *data, size_t size)
+{
+    static unsigned int table[256] = { 0 };
+    if (table[1] == 0) {
+        for (unsigned int n = 0; n < 256; n++) {
+            unsigned int c = n;
+            for (int k = 0; k < 8; k++) c = (c & 1)? 0xedb88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+    }
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void PutRasterUint(unsigned char *bytes, unsigned int value)
+{
+    bytes[0] = (unsigned char)(value >> 24);
+    bytes[1] = (unsigned char)(value >> 16);
+    bytes[2] = (unsigned char)(value >> 8);
+    bytes[3] = (unsigned char)value;
+}
+
+static void PutRasterChunk(FILE *file, const char *type, const unsigned char *data, unsigned int size)
+{
+    unsigned char header[8], footer[4];
+    PutRasterUint(header, size);
+    memcpy(header + 4, type, 4);
+    PutRasterUint(footer, UpdateRasterCrc(UpdateRasterCrc(0, header + 4, 4), data, size));
+
+    fwrite(header, 1, 8, file);
+    fwrite(data, 1, size, file);
+    fwrite(footer, 1, 4, file);
+}
+
+// Scanlines with filter 0 in stored deflate blocks: big files, no zlib needed
+bool SaveRasterFrame(const RasterFrame *frame, const char *fileName)
+{
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "SOFTRASTER: [%s] Failed to create image file\n", fileName);
+        return false;
+    }
+
+    size_t rawSize = (size_t)frame->height*(1 + frame->width*4);
+    size_t blockCount = (rawSize + 65534)/65535;
+    size_t dataSize = 2 + blockCount*5 + rawSize + 4;
+    unsigned char *raw = (unsigned char *)malloc(rawSize);
+    unsigned char *data = (unsigned char *)malloc(dataSize);
+
+    unsigned char *out = raw;
+    for (int y = 0; y < frame->height; y++) {
+        *out++ = 0;
+        for (int x = 0; x < frame->width; x++) {
+            unsigned int pixel = frame->pixels[y*frame->width + x];
+            *out++ = (unsigned char)pixel;
+            *out++ = (unsigned char)(pixel >> 8);
+            *out++ = (unsigned char)(pixel >> 16);
+            *out++ = (unsigned char)(pixel >> 24);
+        }
+    }
+
+    unsigned int adlerA = 1, adlerB = 0;
+    for (size_t i = 0; i < rawSize; i++) {
+        adlerA = (adlerA + raw[i])%65521;
+        adlerB = (adlerB + adlerA)%65521;
+    }
+
+    out = data;
+    *out++ = 0x78;
+    *out++ = 0x01;
+    for (size_t done = 0; done < rawSize;) {
+        size_t size = (rawSize - done > 65535)? 65535 : rawSize - done;
+        *out++ = (done + size == rawSize)? 1 : 0;
+        *out++ = (unsigned char)size;
+        *out++ = (unsigned char)(size >> 8);
+        *out++ = (unsigned char)~size;
+        *out++ = (unsigned char)(~size >> 8);
+        memcpy(out, raw + done, size);
+        out += size;
+        done += size;
+    }
+    PutRasterUint(out, (adlerB << 16) | adlerA);
+
+    unsigned char header[13] = { 0 };
+    PutRasterUint(header, (unsigned int)frame->width);
+    PutRasterUint(header + 4, (unsigned int)frame->height);
+    header[8] = 8;      // Bits per channel
+    header[9] = 6;      // RGBA
+
+    fwrite("\x89PNG\r\n\x1a\n", 1, 8, file);
+    PutRasterChunk(file, "IHDR", header, sizeof(header));
+    PutRasterChunk(file, "IDAT", data, (unsigned int)dataSize);
+    PutRasterChunk(file, "IEND", NULL, 0);
+
+    free(raw);
+    free(data);
+    return fclose(file) == 0;
+}
+
+#endif // SOFTRASTER_IMPLEMENTATION
@@ -0,0 +1,471 @@
+#ifndef STARTUP_H
+#define STARTUP_H
+
+// Parallel startup: while the main thread opens the window, worker threads decode the game's assets out of the pak
+// and the audio device comes up on a thread of its own. Only the uploads stay on the main thread, textures to the
+// GPU and sounds to the audio device, each as soon as its asset is decoded. The first frame waits for the assets
+// marked required (what it draws), the others arrive during the first frames
+//
+//   InitStartup(&startup, &assets);                    // The asset cache, on the pak (see assets.h)
+//   AddStartupTexture(&startup, "player-ship.png", &playerTexture, true);
+//   AddStartupMixerSound(&startup, "laser.wav", &sfxLaser);    // Or AddStartupSound() for raylib's
+//   AddStartupMixer(&startup);                         // Starts the mixer with the audio device (see mixer.h)
+//   BeginStartup(&startup, true);                      // Before InitWindow(), true starts the audio device too
+//   InitWindow(...);
+//   MarkStartup(&startup, "window");                   // Main thread steps, for the timeline
+//   WaitStartup(&startup);                             // Required assets uploaded, helps decoding meanwhile
+//   while (!WindowShouldClose()) { UpdateStartup(&startup); ... }
+//   CloseStartup(&startup);                            // Before UnloadAssetCache(), and before CloseWindow()
+//
+// Assets that are not required stay zeroed until uploaded, which raylib's audio functions take as a no-op: they
+// must only be used on the main thread. The frame pipeline's worker may only draw required ones, and records mixer
+// sounds by address, read when the main thread replays them (see drawlist.h). Each asset goes in
+// the cache once uploaded, which owns it from then on. Music streams from the pak, it is opened on the main thread
+// and handed to the music player (see music.h) once the audio device is up.
+// Once every asset is in, the timeline of the startup goes to the log, in ms from BeginStartup()
+//
+// Without threads (web builds) the assets are decoded on the main thread, one per UpdateStartup(), and the audio
+// device starts at the first UpdateStartup() or WaitStartup(), after the window
+//
+// Declarations only, unless STARTUP_IMPLEMENTATION is defined, in a file that includes raylib.h first.
+// Needs thread.h implemented somewhere (see the games' platform.c), and the implementations of assets.h, with the
+// loaders it needs, and music.h
+
+#include "raylib.h"
+#include "thread.h"
+#include "pak.h"
+#include "atlas.h"
+#include "assets.h"
+#include "music.h"
+
+#define STARTUP_MAX_ASSETS 32
+#define STARTUP_MAX_WORKERS 4
+#define STARTUP_MAX_MARKS 16
+
+typedef enum {
+    STARTUP_TEXTURE = 0,
+    STARTUP_FONT,
+    STARTUP_ATLAS,
+    STARTUP_SOUND,
+    STARTUP_MIXER_SOUND,
+    STARTUP_MUSIC
+} StartupAssetType;
+
+typedef struct {
+    StartupAssetType type;
+    const char *name;                   // In the pak
+    void *target;                       // Texture2D, Font, Atlas, Sound, MixerSound or Music, written on upload
+    bool required;                      // The first frame waits for it
+    float volume;                       // Music only
+    Image image;                        // Decoded, textures, image fonts and atlases
+    Wave wave;                          // Decoded, sounds
+    MixerSound mixerSound;              // Decoded and converted, mixer sounds
+    AtomicInt decoded;
+    bool uploaded;
+    int thread;                         // That decoded it, 0 for the main thread
+    double decodeStart, decodeEnd;      // Seconds from BeginStartup()
+    double uploadStart, uploadEnd;
+} StartupAsset;
+
+typedef struct {
+    const char *name;
+    double start, end;
+} StartupMark;
+
+typedef struct {
+    AssetCache *cache;                  // Gets each asset once uploaded
+    const Pak *pak;                     // The cache's
+    StartupAsset assets[STARTUP_MAX_ASSETS];
+    int assetCount;
+    int order[STARTUP_MAX_ASSETS];      // Decoding order, required assets first
+    int requiredCount;
+    AtomicInt nextAsset;                // Into order
+    AtomicInt nextThread;
+
+    Thread *workers[STARTUP_MAX_WORKERS];
+    int workerCount;
+    Thread *audioThread;
+    bool audio;                         // Start the audio device
+    bool mixer;                         // And the mixer on it
+    AtomicInt audioReady;
+    double audioStart, audioEnd;
+
+    double startTime;                   // Clock at BeginStartup()
+    StartupMark marks[STARTUP_MAX_MARKS];
+    int markCount;
+    double firstFrame;                  // First UpdateStartup(), negative before
+    int pending;                        // Assets not uploaded yet
+    int pendingRequired;
+    bool logged;                        // The timeline, once every asset is in
+} Startup;
+
+void InitStartup(Startup *startup, AssetCache *cache);
+void AddStartupTexture(Startup *startup, const char *name, Texture2D *texture, bool required);
+void AddStartupFont(Startup *startup, const char *name, Font *font, bool required);
+void AddStartupAtlas(Startup *startup, const char *name, Atlas *atlas, bool required);     // See LoadAtlas()
+void AddStartupSound(Startup *startup, const char *name, Sound *sound);
+void AddStartupMixerSound(Startup *startup, const char *name, MixerSound *sound);     // No audio device needed to load
+void AddStartupMixer(Startup *startup);                 // InitMixer() once the audio device is up
+void AddStartupMusic(Startup *startup, const char *name, Music *music, float volume);   // Plays once loaded, see InitMusicPlayer()
+void BeginStartup(Startup *startup, bool audio);
+void MarkStartup(Startup *startup, const char *name);   // A main thread step ended, it started at the previous mark
+void WaitStartup(Startup *startup);
+bool UpdateStartup(Startup *startup);                   // Once per frame, uploads what is decoded, true when all is in
+void CloseStartup(Startup *startup);
+
+#endif // STARTUP_H
+
+#if defined(STARTUP_IMPLEMENTATION) && !defined(STARTUP_IMPLEMENTATION_DONE)
+#define STARTUP_IMPLEMENTATION_DONE
+
+#include "profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+typedef struct {
+    const char *what;
+    const char *name;
+    int thread;                         // -1 for the audio thread
+    double start, end;
+} StartupSpan;
+
+static double GetStartupClock(void);
+static double GetStartupTime(const Startup *startup);
+static StartupAsset *AddStartupAsset(Startup *startup, StartupAssetType type, const char *name, void *target, bool required);
+static bool DecodeNextStartupAsset(Startup *startup, int thread);
+static int RunStartupWorker(void *arg);
+static int RunStartupAudio(void *arg);
+static bool UploadStartupAssets(Startup *startup);
+static void JoinStartupThreads(Startup *startup);
+static void LogStartupTimeline(const Startup *startup);
+static int CompareStartupSpans(const void *a, const void *b);
+
+void InitStartup(Startup *startup, AssetCache *cache)
+{
+    *startup = (Startup){ 0 };
+    startup->cache = cache;
+    startup->pak = cache->pak;
+    startup->firstFrame = -1.0;
+}
+
+void AddStartupTexture(Startup *startup, const char *name, Texture2D *texture, bool required)
+{
+    AddStartupAsset(startup, STARTUP_TEXTURE, name, texture, required);
+}
+
+void AddStartupFont(Startup *startup, const char *name, Font *font, bool required)
+{
+    AddStartupAsset(startup, STARTUP_FONT, name, font, required);
+}
+
+void AddStartupAtlas(Startup *startup, const char *name, Atlas *atlas, bool required)
+{
+    AddStartupAsset(startup, STARTUP_ATLAS, name, atlas, required);
+}
+
+void AddStartupSound(Startup *startup, const char *name, Sound *sound)
+{
+    AddStartupAsset(startup, STARTUP_SOUND, name, sound, false);
+}
+
+void AddStartupMixerSound(Startup *startup, const char *name, MixerSound *sound)
+{
+    AddStartupAsset(startup, STARTUP_MIXER_SOUND, name, sound, false);
+}
+
+void AddStartupMixer(Startup *startup)
+{
+    startup->mixer = true;
+}
+
+void AddStartupMusic(Startup *startup, const char *name, Music *music, float volume)
+{
+    StartupAsset *asset = AddStartupAsset(startup, STARTUP_MUSIC, name, music, false);
+    if (asset != NULL) asset->volume = volume;
+}
+
+StartupAsset *AddStartupAsset(Startup *startup, StartupAssetType type, const char *name, void *target, bool required)
+{
+    if (startup->assetCount >= STARTUP_MAX_ASSETS) {
+        TraceLog(LOG_WARNING, "STARTUP: [%s] More than %d assets, not loaded", name, STARTUP_MAX_ASSETS);
+        return NULL;
+    }
+
+    StartupAsset *asset = &startup->assets[startup->assetCount++];
+    *asset = (StartupAsset){ 0 };
+    asset->type = type;
+    asset->name = name;
+    asset->target = target;
+    asset->required = required;
+    startup->pending++;
+    if (required) startup->pendingRequired++;
+    return asset;
+}
+
+void BeginStartup(Startup *startup, bool audio)
+{
+    startup->startTime = GetStartupClock();
+    startup->audio = audio;
+
+    int count = 0;
+    for (int i = 0; i < startup->assetCount; i++) if (startup->assets[i].required) startup->order[count++] = i;
+    startup->requiredCount = count;
+    for (int i = 0; i < startup->assetCount; i++) if (!startup->assets[i].required) startup->order[count++] = i;
+
+#if !defined(PLATFORM_WEB)
+    if (audio) {
+        startup->audioThread = ThreadCreate(RunStartupAudio, startup);
+        if (startup->audioThread == NULL) TraceLog(LOG_WARNING, "STARTUP: Could not start the audio thread, the audio device starts after the window");
+    }
+
+    // Music is only opened, on the main thread: no worker for it
+    int decodes = 0;
+    for (int i = 0; i < startup->assetCount; i++) decodes += (startup->assets[i].type != STARTUP_MUSIC);
+    int workers = GetCpuCount() - 1;
+    if (workers > decodes) workers = decodes;
+    if (workers > STARTUP_MAX_WORKERS) workers = STARTUP_MAX_WORKERS;
+    if (workers < 1 && decodes > 0) workers = 1;      // The main thread is busy with the window anyway
+    for (int i = 0; i < workers; i++) {
+        Thread *worker = ThreadCreate(RunStartupWorker, startup);
+        if (worker == NULL) break;
+        startup->workers[startup->workerCount++] = worker;
+    }
+#endif
+
+    startup->marks[0] = (StartupMark){ "start threads", 0.0, GetStartupTime(startup) };
+    startup->markCount = 1;
+}
+
+void MarkStartup(Startup *startup, const char *name)
+{
+    if (startup->markCount >= STARTUP_MAX_MARKS) return;
+
+    StartupMark *mark = &startup->marks[startup->markCount];
+    mark->name = name;
+    mark->start = startup->marks[startup->markCount - 1].end;
+    mark->end = GetStartupTime(startup);
+    startup->markCount++;
+}
+
+void WaitStartup(Startup *startup)
+{
+    UploadStartupAssets(startup);
+    while (startup->pendingRequired > 0) {
+        // Helps with the required assets only, the others would hold up the first frame
+        bool helped = (AtomicLoad(&startup->nextAsset) < startup->requiredCount) && DecodeNextStartupAsset(startup, 0);
+        if (!helped) ThreadSleep(0.0005);
+        UploadStartupAssets(startup);
+    }
+    MarkStartup(startup, "required assets");
+}
+
+bool UpdateStartup(Startup *startup)
+{
+    if (startup->firstFrame < 0.0) startup->firstFrame = GetStartupTime(startup);
+    if (startup->logged) return true;
+
+    if (startup->workerCount == 0) DecodeNextStartupAsset(startup, 0);
+    if (!UploadStartupAssets(startup)) return false;
+
+    JoinStartupThreads(startup);
+    LogStartupTimeline(startup);
+    startup->logged = true;
+    return true;
+}
+
+void CloseStartup(Startup *startup)
+{
+    AtomicStore(&startup->nextAsset, startup->assetCount);     // Workers finish the asset they are on, and stop
+    JoinStartupThreads(startup);
+
+    for (int i = 0; i < startup->assetCount; i++) {
+        StartupAsset *asset = &startup->assets[i];
+        if (asset->uploaded || !AtomicLoad(&asset->decoded)) continue;
+        if (asset->image.data != NULL) UnloadImage(asset->image);
+        if (asset->wave.data != NULL) UnloadWave(asset->wave);
+        UnloadMixerSound(asset->mixerSound);
+    }
+    startup->pending = 0;
+    startup->pendingRequired = 0;
+    startup->logged = true;
+}
+
+double GetStartupClock(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+double GetStartupTime(const Startup *startup)
+{
+    return GetStartupClock() - startup->startTime;
+}
+
+// Decodes the next asset in the queue on the calling thread, false when the queue is empty
+bool DecodeNextStartupAsset(Startup *startup, int thread)
+{
+    int next = AtomicFetchAdd(&startup->nextAsset, 1);
+    if (next >= startup->assetCount) return false;
+
+    StartupAsset *asset = &startup->assets[startup->order[next]];
+    asset->thread = thread;
+    asset->decodeStart = GetStartupTime(startup);
+    ProfileBegin("decode asset");
+
+    int size = 0;
+    const unsigned char *data = GetPakData(startup->pak, asset->name, &size);
+    const char *extension = GetFileExtension(asset->name);
+    char loosePath[256];
+    snprintf(loosePath, sizeof(loosePath), "%s%s", (startup->pak->looseDir != NULL)? startup->pak->looseDir : "", asset->name);
+
+    // raylib's decoders only allocate and log, they are fine on any thread. TTF fonts and music are left to the upload
+    bool ttf = (extension != NULL) && (TextIsEqual(extension, ".ttf") || TextIsEqual(extension, ".otf"));
+    if (asset->type == STARTUP_TEXTURE || (asset->type == STARTUP_FONT && !ttf)) {
+        asset->image = (data != NULL)? LoadImageFromMemory(extension, data, size) : LoadImage(loosePath);
+    }
+    else if (asset->type == STARTUP_ATLAS) {
+        asset->image = LoadAtlasImage((Atlas *)asset->target, startup->pak, asset->name);
+    }
+    else if (asset->type == STARTUP_SOUND) {
+        asset->wave = (data != NULL)? LoadWaveFromMemory(extension, data, size) : LoadWave(loosePath);
+    }
+    else if (asset->type == STARTUP_MIXER_SOUND) {
+        asset->mixerSound = LoadMixerSoundFromPak(startup->pak, asset->name);   // Nothing to decode from a .pcm
+    }
+
+    ProfileEnd();
+    asset->decodeEnd = GetStartupTime(startup);
+    AtomicStore(&asset->decoded, 1);
+    return true;
+}
+
+int RunStartupWorker(void *arg)
+{
+    Startup *startup = (Startup *)arg;
+    int thread = AtomicFetchAdd(&startup->nextThread, 1) + 1;
+    while (DecodeNextStartupAsset(startup, thread)) { }
+    return 0;
+}
+
+int RunStartupAudio(void *arg)
+{
+    Startup *startup = (Startup *)arg;
+    startup->audioStart = GetStartupTime(startup);
+    ProfileBegin("audio device");
+    InitAudioDevice();
+    if (startup->mixer) InitMixer();
+    ProfileEnd();
+    startup->audioEnd = GetStartupTime(startup);
+    AtomicStore(&startup->audioReady, 1);
+    return 0;
+}
+
+// Uploads every decoded asset, true when none is left
+bool UploadStartupAssets(Startup *startup)
+{
+    if (startup->audio && startup->audioThread == NULL && !AtomicLoad(&startup->audioReady)) {
+        RunStartupAudio(startup);       // No thread for it, now that the window is up
+    }
+    bool audioReady = !startup->audio || AtomicLoad(&startup->audioReady);
+
+    for (int i = 0; i < startup->assetCount; i++) {
+        StartupAsset *asset = &startup->assets[i];
+        if (asset->uploaded) continue;
+        bool audible = (asset->type == STARTUP_SOUND) || (asset->type == STARTUP_MUSIC);
+        if (audible && !audioReady) continue;
+        if (asset->type != STARTUP_MUSIC && !AtomicLoad(&asset->decoded)) continue;
+
+        asset->uploadStart = GetStartupTime(startup);
+        AssetType type = ASSET_MUSIC;
+        if (asset->type == STARTUP_TEXTURE) {
+            *(Texture2D *)asset->target = LoadTextureFromImage(asset->image);
+            UnloadImage(asset->image);
+            type = ASSET_TEXTURE;
+        }
+        else if (asset->type == STARTUP_FONT) {
+            Font font = { 0 };
+            if (asset->image.data != NULL) font = LoadFontFromImage(asset->image, MAGENTA, PAK_FONT_FIRST_CHAR);
+            else font = LoadFontFromPak(startup->pak, asset->name);
+            UnloadImage(asset->image);
+            *(Font *)asset->target = (font.texture.id != 0)? font : GetFontDefault();
+            type = ASSET_FONT;
+        }
+        else if (asset->type == STARTUP_ATLAS) {
+            ((Atlas *)asset->target)->texture = LoadTextureFromImage(asset->image);
+            UnloadImage(asset->image);
+            type = ASSET_ATLAS;
+        }
+        else if (asset->type == STARTUP_SOUND) {
+            *(Sound *)asset->target = LoadSoundFromWave(asset->wave);
+            UnloadWave(asset->wave);
+            type = ASSET_SOUND;
+        }
+        else if (asset->type == STARTUP_MIXER_SOUND) {
+            *(MixerSound *)asset->target = asset->mixerSound;
+            type = ASSET_MIXER_SOUND;
+        }
+        else {
+            Music *music = (Music *)asset->target;
+            SetAudioStreamBufferSizeDefault(MUSIC_BUFFER_FRAMES);     // Deeper buffers, refilled by the player's thread
+            *music = LoadMusicFromPak(startup->pak, asset->name);
+            SetAudioStreamBufferSizeDefault(0);
+            PlayMusicPlayer(*music, asset->volume);
+        }
+        AddCachedAsset(startup->cache, type, asset->name, asset->target);
+        asset->image = (Image){ 0 };
+        asset->wave = (Wave){ 0 };
+        asset->mixerSound = (MixerSound){ 0 };
+        asset->uploadEnd = GetStartupTime(startup);
+        asset->uploaded = true;
+        startup->pending--;
+        if (asset->required) startup->pendingRequired--;
+    }
+
+    return startup->pending == 0;
+}
+
+void JoinStartupThreads(Startup *startup)
+{
+    for (int i = 0; i < startup->workerCount; i++) ThreadJoin(startup->workers[i]);
+    startup->workerCount = 0;
+    if (startup->audioThread != NULL) ThreadJoin(startup->audioThread);
+    startup->audioThread = NULL;
+}
+
+void LogStartupTimeline(const Startup *startup)
+{
+    StartupSpan spans[2*STARTUP_MAX_ASSETS + STARTUP_MAX_MARKS + 2];
+    int count = 0;
+
+    for (int i = 0; i < startup->markCount; i++) {
+        spans[count++] = (StartupSpan){ startup->marks[i].name, "", 0, startup->marks[i].start, startup->marks[i].end };
+    }
+    if (startup->audio) spans[count++] = (StartupSpan){ "audio device", "", -1, startup->audioStart, startup->audioEnd };
+    for (int i = 0; i < startup->assetCount; i++) {
+        const StartupAsset *asset = &startup->assets[i];
+        if (asset->type != STARTUP_MUSIC) spans[count++] = (StartupSpan){ "decode", asset->name, asset->thread, asset->decodeStart, asset->decodeEnd };
+        spans[count++] = (StartupSpan){ (asset->type == STARTUP_MUSIC)? "open" : "upload", asset->name, 0, asset->uploadStart, asset->uploadEnd };
+    }
+    if (startup->firstFrame >= 0.0) spans[count++] = (StartupSpan){ "first frame", "", 0, startup->firstFrame, startup->firstFrame };
+    qsort(spans, count, sizeof(StartupSpan), CompareStartupSpans);
+
+    TraceLog(LOG_INFO, "STARTUP: Timeline, ms from the start");
+    for (int i = 0; i < count; i++) {
+        char thread[24];                // "worker " and any int
+        if (spans[i].thread < 0) snprintf(thread, sizeof(thread), "audio");
+        else if (spans[i].thread == 0) snprintf(thread, sizeof(thread), "main");
+        else snprintf(thread, sizeof(thread), "worker %d", spans[i].thread);
+        TraceLog(LOG_INFO, "STARTUP: %8.2f %8.2f  %-8s  %s %s", spans[i].start*1000.0, spans[i].end*1000.0, thread, spans[i].what, spans[i].name);
+    }
+}
+
+int CompareStartupSpans(const void *a, const void *b)
+{
+    const StartupSpan *left = (const StartupSpan *)a, *right = (const StartupSpan *)b;
+    if (left->start != right->start) return (left->start < right->start)? -1 : 1;
+    return (left->end < right->end)? -1 : (left->end > right->end);
+}
+
+#endif // STARTUP_IMPLEMENTATION
@@ -0,0 +1,178 @@
+#ifndef THREAD_H
+#define THREAD_H
+
+// Minimal portable threads, locks and atomics
+//
+// Declarations only, unless THREAD_IMPLEMENTATION is defined. The implementation pulls in
+// <windows.h> on Windows, which clashes with raylib.h, so define it in a translation unit
+// that does not include raylib.h (see the games' src/platform.c)
+
+#include <stdbool.h>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+typedef struct Thread Thread;
+typedef struct Mutex Mutex;
+typedef struct CondVar CondVar;
+
+typedef int (*ThreadFunc)(void *arg);
+
+Thread *ThreadCreate(ThreadFunc func, void *arg);
+int ThreadJoin(Thread *thread);                 // Waits for the thread, frees it and returns its result
+void ThreadSleep(double seconds);
+void ThreadYield(void);
+int GetCpuCount(void);
+
+Mutex *MutexCreate(void);
+void MutexDestroy(Mutex *mutex);
+void MutexLock(Mutex *mutex);
+void MutexUnlock(Mutex *mutex);
+
+CondVar *CondVarCreate(void);
+void CondVarDestroy(CondVar *cv);
+void CondVarWait(CondVar *cv, Mutex *mutex);
+void CondVarSignal(CondVar *cv);
+void CondVarBroadcast(CondVar *cv);
+
+// Atomics on 32-bit integers (sequentially consistent)
+typedef volatile int AtomicInt;
+
+#if defined(_MSC_VER)
+static inline int AtomicLoad(AtomicInt *a) { return _InterlockedOr((volatile long *)a, 0); }
+static inline void AtomicStore(AtomicInt *a, int value) { _InterlockedExchange((volatile long *)a, value); }
+static inline int AtomicFetchAdd(AtomicInt *a, int value) { return _InterlockedExchangeAdd((volatile long *)a, value); }
+static inline bool AtomicCompareExchange(AtomicInt *a, int expected, int desired) { return _InterlockedCompareExchange((volatile long *)a, desired, expected) == expected; }
+#else
+static inline int AtomicLoad(AtomicInt *a) { return __atomic_load_n(a, __ATOMIC_SEQ_CST); }
+static inline void AtomicStore(AtomicInt *a, int value) { __atomic_store_n(a, value, __ATOMIC_SEQ_CST); }
+static inline int AtomicFetchAdd(AtomicInt *a, int value) { return __atomic_fetch_add(a, value, __ATOMIC_SEQ_CST); }
+static inline bool AtomicCompareExchange(AtomicInt *a, int expected, int desired) { return __atomic_compare_exchange_n(a, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); }
+#endif
+
+#endif // THREAD_H
+
+#if defined(THREAD_IMPLEMENTATION) && !defined(THREAD_IMPLEMENTATION_DONE)
+#define THREAD_IMPLEMENTATION_DONE
+
+#include <stdlib.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+    #include <process.h>
+
+struct Thread { HANDLE handle; ThreadFunc func; void *arg; int result; };
+struct Mutex { CRITICAL_SECTION cs; };
+struct CondVar { CONDITION_VARIABLE cv; };
+
+static unsigned __stdcall ThreadEntry(void *arg)
+{
+    Thread *thread = (Thread *)arg;
+    thread->result = thread->func(thread->arg);
+    return 0;
+}
+
+Thread *ThreadCreate(ThreadFunc func, void *arg)
+{
+    Thread *thread = (Thread *)calloc(1, sizeof(Thread));
+    thread->func = func;
+    thread->arg = arg;
+    thread->handle = (HANDLE)_beginthreadex(NULL, 0, ThreadEntry, thread, 0, NULL);
+    if (thread->handle == NULL) { free(thread); return NULL; }
+    return thread;
+}
+
+int ThreadJoin(Thread *thread)
+{
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+    int result = thread->result;
+    free(thread);
+    return result;
+}
+
+void ThreadSleep(double seconds) { Sleep((DWORD)(seconds*1000.0)); }
+void ThreadYield(void) { SwitchToThread(); }
+
+int GetCpuCount(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+}
+
+Mutex *MutexCreate(void) { Mutex *m = (Mutex *)malloc(sizeof(Mutex)); InitializeCriticalSection(&m->cs); return m; }
+void MutexDestroy(Mutex *m) { DeleteCriticalSection(&m->cs); free(m); }
+void MutexLock(Mutex *m) { EnterCriticalSection(&m->cs); }
+void MutexUnlock(Mutex *m) { LeaveCriticalSection(&m->cs); }
+
+CondVar *CondVarCreate(void) { CondVar *c = (CondVar *)malloc(sizeof(CondVar)); InitializeConditionVariable(&c->cv); return c; }
+void CondVarDestroy(CondVar *c) { free(c); }
+void CondVarWait(CondVar *c, Mutex *m) { SleepConditionVariableCS(&c->cv, &m->cs, INFINITE); }
+void CondVarSignal(CondVar *c) { WakeConditionVariable(&c->cv); }
+void CondVarBroadcast(CondVar *c) { WakeAllConditionVariable(&c->cv); }
+
+#else
+    #include <pthread.h>
+    #include <sched.h>
+    #include <time.h>
+    #include <unistd.h>
+
+struct Thread { pthread_t handle; ThreadFunc func; void *arg; int result; };
+struct Mutex { pthread_mutex_t mutex; };
+struct CondVar { pthread_cond_t cond; };
+
+static void *ThreadEntry(void *arg)
+{
+    Thread *thread = (Thread *)arg;
+    thread->result = thread->func(thread->arg);
+    return NULL;
+}
+
+Thread *ThreadCreate(ThreadFunc func, void *arg)
+{
+    Thread *thread = (Thread *)calloc(1, sizeof(Thread));
+    thread->func = func;
+    thread->arg = arg;
+    if (pthread_create(&thread->handle, NULL, ThreadEntry, thread) != 0) { free(thread); return NULL; }
+    return thread;
+}
+
+int ThreadJoin(Thread *thread)
+{
+    pthread_join(thread->handle, NULL);
+    int result = thread->result;
+    free(thread);
+    return result;
+}
+
+void ThreadSleep(double seconds)
+{
+    struct timespec ts = { (time_t)seconds, (long)((seconds - (time_t)seconds)*1e9) };
+    nanosleep(&ts, NULL);
+}
+
+void ThreadYield(void) { sched_yield(); }
+
+int GetCpuCount(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0)? (int)count : 1;
+}
+
+Mutex *MutexCreate(void) { Mutex *m = (Mutex *)malloc(sizeof(Mutex)); pthread_mutex_init(&m->mutex, NULL); return m; }
+void MutexDestroy(Mutex *m) { pthread_mutex_destroy(&m->mutex); free(m); }
+void MutexLock(Mutex *m) { pthread_mutex_lock(&m->mutex); }
+void MutexUnlock(Mutex *m) { pthread_mutex_unlock(&m->mutex); }
+
+CondVar *CondVarCreate(void) { CondVar *c = (CondVar *)malloc(sizeof(CondVar)); pthread_cond_init(&c->cond, NULL); return c; }
+void CondVarDestroy(CondVar *c) { pthread_cond_destroy(&c->cond); free(c); }
+void CondVarWait(CondVar *c, Mutex *m) { pthread_cond_wait(&c->cond, &m->mutex); }
+void CondVarSignal(CondVar *c) { pthread_cond_signal(&c->cond); }
+void CondVarBroadcast(CondVar *c) { pthread_cond_broadcast(&c->cond); }
+
+#endif
+
+#endif // THREAD_IMPLEMENTATION
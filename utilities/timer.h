@@ -1,18 +1,314 @@
-void StartTimer(Timer *timer, double lifetime);
-bool TimerDone(Timer timer);
+#ifndef TIMER_H
+#define TIMER_H
 
-void StartTimer(Timer *timer, double lifetime)
+// Hierarchical timer wheel: thousands of one-shot or repeating timers driven once per frame
+//
+// Time only moves when the wheel is advanced, so it runs just as well on simulated time in
+// headless runs. Scheduling, cancelling and firing are O(1), far timers are cascaded down a
+// level every 64 ticks.
+//
+// Declarations only, unless TIMER_IMPLEMENTATION is defined
+
+#include <stdbool.h>
+
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+
+typedef struct TimerWheel TimerWheel;
+
+// 0 is never a valid handle, handles of fired or cancelled timers go stale
+typedef unsigned int TimerHandle;
+
+// Called when the timer fires, tag is whatever was passed when scheduling it
+typedef void (*TimerCallback)(void *user, int tag);
+
+TimerWheel *CreateTimerWheel(double tickSeconds);   // Tick length, e.g. 1.0/60.0
+void DestroyTimerWheel(TimerWheel *wheel);
+void ClearTimerWheel(TimerWheel *wheel);            // Cancels every timer and rewinds time to 0
+
+// Fires after delay seconds (rounded up to whole ticks, at least one), then every interval
+// seconds if interval > 0. Without a callback the tag is queued, see GetFiredTimers()
+TimerHandle ScheduleTimer(TimerWheel *wheel, double delay, double interval, TimerCallback callback, void *user, int tag);
+TimerHandle ScheduleTimerTicks(TimerWheel *wheel, unsigned int ticks, unsigned int intervalTicks, TimerCallback callback, void *user, int tag);
+bool CancelTimer(TimerWheel *wheel, TimerHandle handle);    // False if it already fired
+bool IsTimerPending(TimerWheel *wheel, TimerHandle handle);
+double GetTimerRemaining(TimerWheel *wheel, TimerHandle handle);
+
+// Runs every tick that fits in the elapsed time. The fired queue is emptied first
+void AdvanceTimerWheel(TimerWheel *wheel, double deltaTime);
+void TickTimerWheel(TimerWheel *wheel);             // Runs exactly one tick
+int GetFiredTimers(TimerWheel *wheel, const int **tags);   // Tags of the callback-less timers fired by the last advance
+double GetTimerWheelTime(TimerWheel *wheel);        // Seconds of ticks run so far
+int GetTimerCount(TimerWheel *wheel);               // Pending timers
+
+#endif // TIMER_H
+
+#if defined(TIMER_IMPLEMENTATION) && !defined(TIMER_IMPLEMENTATION_DONE)
+#define TIMER_IMPLEMENTATION_DONE
+
+#include <stdlib.h>
+#include <math.h>
+
+#define TIMER_INDEX_BITS 20
+#define TIMER_INDEX_MASK ((1u << TIMER_INDEX_BITS) - 1)
+#define TIMER_LIST_COUNT (TIMER_WHEEL_LEVELS*TIMER_WHEEL_SLOTS)
+#define TIMER_LIST_FIRING TIMER_LIST_COUNT          // Timers of the slot being fired
+#define TIMER_LIST_NONE (-1)
+
+typedef struct {
+    unsigned int expires;       // Absolute tick
+    unsigned int interval;      // Ticks, 0 for one-shot
+    unsigned int generation;
+    int list;                   // Slot list the timer sits in, TIMER_LIST_NONE when free
+    int prev, next;             // Links in that list, or next free timer
+    TimerCallback callback;
+    void *user;
+    int tag;
+} WheelTimer;
+
+struct TimerWheel {
+    double tickSeconds;
+    double accumulator;
+    unsigned int now;           // Next tick to run
+    int heads[TIMER_LIST_COUNT + 1];
+
+    WheelTimer *timers;
+    int capacity;
+    int freeList;
+    int count;
+
+    int *fired;
+    int firedCount;
+    int firedCapacity;
+};
+
+static void TimerListPush(TimerWheel *wheel, int list, int index)
+{
+    WheelTimer *timer = &wheel->timers[index];
+    timer->list = list;
+    timer->prev = -1;
+    timer->next = wheel->heads[list];
+    if (timer->next != -1) wheel->timers[timer->next].prev = index;
+    wheel->heads[list] = index;
+}
+
+static void TimerListRemove(TimerWheel *wheel, int index)
+{
+    WheelTimer *timer = &wheel->timers[index];
+    if (timer->prev != -1) wheel->timers[timer->prev].next = timer->next;
+    else wheel->heads[timer->list] = timer->next;
+    if (timer->next != -1) wheel->timers[timer->next].prev = timer->prev;
+    timer->list = TIMER_LIST_NONE;
+}
+
+// Level 0 holds the next 64 ticks one per slot, each level above holds 64 times coarser slots
+static void TimerInsert(TimerWheel *wheel, int index)
+{
+    unsigned int expires = wheel->timers[index].expires;
+    unsigned int delta = expires - wheel->now;
+
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (1u << (TIMER_WHEEL_BITS*(level + 1)))) level++;
+
+    // Too far even for the top level: park it in the farthest slot, it is re-inserted on cascade
+    if (delta >= (1u << (TIMER_WHEEL_BITS*TIMER_WHEEL_LEVELS))) expires = wheel->now + (1u << (TIMER_WHEEL_BITS*TIMER_WHEEL_LEVELS)) - 1;
+
+    int slot = (expires >> (TIMER_WHEEL_BITS*level)) & (TIMER_WHEEL_SLOTS - 1);
+    TimerListPush(wheel, level*TIMER_WHEEL_SLOTS + slot, index);
+}
+
+static void TimerCascade(TimerWheel *wheel, int level, int slot)
+{
+    int list = level*TIMER_WHEEL_SLOTS + slot;
+    int index = wheel->heads[list];
+    wheel->heads[list] = -1;
+
+    while (index != -1) {
+        int next = wheel->timers[index].next;
+        TimerInsert(wheel, index);
+        index = next;
+    }
+}
+
+static void TimerFree(TimerWheel *wheel, int index)
+{
+    WheelTimer *timer = &wheel->timers[index];
+    if (timer->list != TIMER_LIST_NONE) TimerListRemove(wheel, index);
+    timer->generation++;
+    timer->next = wheel->freeList;
+    wheel->freeList = index;
+    wheel->count--;
+}
+
+static WheelTimer *TimerFromHandle(TimerWheel *wheel, TimerHandle handle)
+{
+    int index = (int)(handle & TIMER_INDEX_MASK);
+    if (handle == 0 || index >= wheel->capacity) return NULL;
+
+    WheelTimer *timer = &wheel->timers[index];
+    if (timer->list == TIMER_LIST_NONE || (timer->generation & (0xffffffffu >> TIMER_INDEX_BITS)) != (handle >> TIMER_INDEX_BITS)) return NULL;
+    return timer;
+}
+
+TimerWheel *CreateTimerWheel(double tickSeconds)
+{
+    TimerWheel *wheel = (TimerWheel *)calloc(1, sizeof(TimerWheel));
+    wheel->tickSeconds = (tickSeconds > 0.0)? tickSeconds : 1.0/60.0;
+    wheel->freeList = -1;
+    for (int i = 0; i <= TIMER_LIST_COUNT; i++) wheel->heads[i] = -1;
+    return wheel;
+}
+
+void DestroyTimerWheel(TimerWheel *wheel)
 {
-    timer->startTime = GetTime();
-    timer->lifeTime = lifetime;
+    if (wheel == NULL) return;
+    free(wheel->timers);
+    free(wheel->fired);
+    free(wheel);
 }
 
-bool TimerDone(Timer timer)
+void ClearTimerWheel(TimerWheel *wheel)
 {
-    return GetTime() - timer.startTime >= timer.lifeTime;
+    for (int i = 0; i < wheel->capacity; i++) {
+        if (wheel->timers[i].list != TIMER_LIST_NONE) TimerFree(wheel, i);
+    }
+    wheel->now = 0;
+    wheel->accumulator = 0.0;
+    wheel->firedCount = 0;
 }
 
-double GetElapsed(Timer timer)
+TimerHandle ScheduleTimerTicks(TimerWheel *wheel, unsigned int ticks, unsigned int intervalTicks, TimerCallback callback, void *user, int tag)
 {
-    return GetTime() - timer.startTime;
-}
\ No newline at end of file
+    if (wheel->freeList == -1) {
+        int capacity = (wheel->capacity > 0)? wheel->capacity*2 : 256;
+        if (capacity > (int)TIMER_INDEX_MASK) capacity = (int)TIMER_INDEX_MASK;
+        if (capacity == wheel->capacity) return 0;
+
+        wheel->timers = (WheelTimer *)realloc(wheel->timers, capacity*sizeof(WheelTimer));
+        for (int i = capacity - 1; i >= wheel->capacity; i--) {
+            wheel->timers[i] = (WheelTimer){ .generation = 1, .list = TIMER_LIST_NONE, .next = wheel->freeList };
+            wheel->freeList = i;
+        }
+        wheel->capacity = capacity;
+    }
+
+    int index = wheel->freeList;
+    WheelTimer *timer = &wheel->timers[index];
+    wheel->freeList = timer->next;
+    wheel->count++;
+
+    if (ticks == 0) ticks = 1;
+    timer->expires = wheel->now + ticks - 1;
+    timer->interval = intervalTicks;
+    timer->callback = callback;
+    timer->user = user;
+    timer->tag = tag;
+    TimerInsert(wheel, index);
+
+    if ((timer->generation & (0xffffffffu >> TIMER_INDEX_BITS)) == 0) timer->generation++;
+    return ((timer->generation & (0xffffffffu >> TIMER_INDEX_BITS)) << TIMER_INDEX_BITS) | (unsigned int)index;
+}
+
+TimerHandle ScheduleTimer(TimerWheel *wheel, double delay, double interval, TimerCallback callback, void *user, int tag)
+{
+    // Small epsilon so a delay that is a whole number of ticks is not rounded up one more
+    unsigned int ticks = (delay > 0.0)? (unsigned int)ceil(delay/wheel->tickSeconds - 1e-6) : 1;
+    unsigned int intervalTicks = (interval > 0.0)? (unsigned int)ceil(interval/wheel->tickSeconds - 1e-6) : 0;
+    if (interval > 0.0 && intervalTicks == 0) intervalTicks = 1;
+    return ScheduleTimerTicks(wheel, ticks, intervalTicks, callback, user, tag);
+}
+
+bool CancelTimer(TimerWheel *wheel, TimerHandle handle)
+{
+    WheelTimer *timer = TimerFromHandle(wheel, handle);
+    if (timer == NULL) return false;
+
+    TimerFree(wheel, (int)(timer - wheel->timers));
+    return true;
+}
+
+bool IsTimerPending(TimerWheel *wheel, TimerHandle handle)
+{
+    return TimerFromHandle(wheel, handle) != NULL;
+}
+
+double GetTimerRemaining(TimerWheel *wheel, TimerHandle handle)
+{
+    WheelTimer *timer = TimerFromHandle(wheel, handle);
+    if (timer == NULL) return 0.0;
+
+    return (timer->expires - wheel->now + 1)*wheel->tickSeconds - wheel->accumulator;
+}
+
+void TickTimerWheel(TimerWheel *wheel)
+{
+    // Every 64 ticks the next coarser slot is spread over the level below
+    unsigned int tick = wheel->now;
+    int slot = tick & (TIMER_WHEEL_SLOTS - 1);
+    for (int level = 1; level < TIMER_WHEEL_LEVELS && ((tick >> (TIMER_WHEEL_BITS*(level - 1))) & (TIMER_WHEEL_SLOTS - 1)) == 0; level++) {
+        TimerCascade(wheel, level, (tick >> (TIMER_WHEEL_BITS*level)) & (TIMER_WHEEL_SLOTS - 1));
+    }
+
+    // Move the due timers aside, so the ones scheduled by callbacks don't land in the slot being run
+    wheel->heads[TIMER_LIST_FIRING] = wheel->heads[slot];
+    wheel->heads[slot] = -1;
+    for (int index = wheel->heads[TIMER_LIST_FIRING]; index != -1; index = wheel->timers[index].next) {
+        wheel->timers[index].list = TIMER_LIST_FIRING;
+    }
+    wheel->now++;
+
+    while (wheel->heads[TIMER_LIST_FIRING] != -1) {
+        int index = wheel->heads[TIMER_LIST_FIRING];
+        WheelTimer *timer = &wheel->timers[index];
+        TimerCallback callback = timer->callback;
+        void *user = timer->user;
+        int tag = timer->tag;
+
+        // Re-arm before calling back, so the callback may still cancel it
+        if (timer->interval > 0) {
+            TimerListRemove(wheel, index);
+            timer->expires += timer->interval;
+            if ((int)(timer->expires - wheel->now) < 0) timer->expires = wheel->now;
+            TimerInsert(wheel, index);
+        }
+        else TimerFree(wheel, index);
+
+        if (callback != NULL) callback(user, tag);
+        else {
+            if (wheel->firedCount == wheel->firedCapacity) {
+                wheel->firedCapacity = (wheel->firedCapacity > 0)? wheel->firedCapacity*2 : 64;
+                wheel->fired = (int *)realloc(wheel->fired, wheel->firedCapacity*sizeof(int));
+            }
+            wheel->fired[wheel->firedCount++] = tag;
+        }
+    }
+}
+
+void AdvanceTimerWheel(TimerWheel *wheel, double deltaTime)
+{
+    wheel->firedCount = 0;
+    wheel->accumulator += deltaTime;
+    while (wheel->accumulator >= wheel->tickSeconds) {
+        wheel->accumulator -= wheel->tickSeconds;
+        TickTimerWheel(wheel);
+    }
+}
+
+int GetFiredTimers(TimerWheel *wheel, const int **tags)
+{
+    if (tags != NULL) *tags = wheel->fired;
+    return wheel->firedCount;
+}
+
+double GetTimerWheelTime(TimerWheel *wheel)
+{
+    return wheel->now*wheel->tickSeconds;
+}
+
+int GetTimerCount(TimerWheel *wheel)
+{
+    return wheel->count;
+}
+
+#endif // TIMER_IMPLEMENTATION
@@ -0,0 +1,115 @@
+#ifndef VECENV_H
+#define VECENV_H
+
+// Vectorized environments: N independent instances of a game's simulation stepped in lockstep, for training and
+// evaluating agents. This is the part the games share: per-instance actions, rewards, episode ends and random
+// streams, all arrays of N the caller reads and writes in place. Each game adds its state and observations
+// (see breakout_env.h, pacman_env.h)
+//
+//   BreakoutEnv env = LoadBreakoutEnv(1024, seed);
+//   for (;;) {
+//       for (int i = 0; i < env.base.count; i++) env.base.actions[i] = Policy(&env.observations[i*BREAKOUT_ENV_OBSERVATION_SIZE]);
+//       StepBreakoutEnv(&env);          // Rewards, dones and observations of every instance
+//   }
+//
+// An instance whose episode ends is reset within the same step: its done flag is set and its observation is
+// already the first of the next episode. Instances are stepped in batches on the job system (jobs.h), start it
+// with InitJobSystem() to use every core, otherwise they all run on the calling thread. The simulations'
+// workload counters take one thread at a time, build the env libraries with COUNTERS_DISABLED
+//
+// Declarations only, unless VECENV_IMPLEMENTATION is defined. Built on rng.h and jobs.h
+
+#include "rng.h"
+#include "jobs.h"
+#include <stdbool.h>
+
+#define VECENV_BATCH_SIZE 64            // Instances per job batch
+
+typedef struct {
+    int count;                          // Instances
+    int maxEpisodeTicks;                // Episodes are cut after this many steps, 0 for no limit
+    unsigned long long steps;           // Instance steps so far, over all instances
+    unsigned long long episodes;        // Ended so far
+
+    unsigned int *actions;              // Buttons of each instance for the next step, set by the caller
+    float *rewards;                     // Of the last step
+    unsigned char *dones;               // The last step ended the episode, the instance was reset
+    unsigned char *truncated;           // Of those, cut by maxEpisodeTicks rather than ended by the game
+    float *episodeReturns;              // Rewards of the running episode so far
+    float *finalReturns;                // Of the last episode that ended
+    int *episodeTicks;                  // Steps of the running episode
+    Rng *rngs;                          // One stream per instance, for resets
+} VecEnv;
+
+VecEnv LoadVecEnv(int count, unsigned long long seed, int maxEpisodeTicks);
+void UnloadVecEnv(VecEnv *env);
+
+// Steps instances [first, last) of the game's env, see JobFunc
+void RunVecEnv(VecEnv *env, JobFunc func, void *data);
+
+// Bookkeeping once an instance has stepped, true when the game must reset it
+static inline bool EndVecEnvStep(VecEnv *env, int instance, float reward, bool terminal)
+{
+    env->rewards[instance] = reward;
+    env->episodeReturns[instance] += reward;
+    env->episodeTicks[instance]++;
+
+    bool truncated = !terminal && (env->maxEpisodeTicks > 0) && (env->episodeTicks[instance] >= env->maxEpisodeTicks);
+    env->dones[instance] = terminal || truncated;
+    env->truncated[instance] = truncated;
+    if (!env->dones[instance]) return false;
+
+    env->finalReturns[instance] = env->episodeReturns[instance];
+    env->episodeReturns[instance] = 0.0f;
+    env->episodeTicks[instance] = 0;
+    return true;
+}
+
+#endif // VECENV_H
+
+#if defined(VECENV_IMPLEMENTATION) && !defined(VECENV_IMPLEMENTATION_DONE)
+#define VECENV_IMPLEMENTATION_DONE
+
+#include <stdlib.h>
+
+VecEnv LoadVecEnv(int count, unsigned long long seed, int maxEpisodeTicks)
+{
+    VecEnv env = { 0 };
+    env.count = count;
+    env.maxEpisodeTicks = maxEpisodeTicks;
+
+    env.actions = (unsigned int *)calloc(count, sizeof(unsigned int));
+    env.rewards = (float *)calloc(count, sizeof(float));
+    env.dones = (unsigned char *)calloc(count, sizeof(unsigned char));
+    env.truncated = (unsigned char *)calloc(count, sizeof(unsigned char));
+    env.episodeReturns = (float *)calloc(count, sizeof(float));
+    env.finalReturns = (float *)calloc(count, sizeof(float));
+    env.episodeTicks = (int *)calloc(count, sizeof(int));
+    env.rngs = (Rng *)calloc(count, sizeof(Rng));
+    for (int i = 0; i < count; i++) SeedRng(&env.rngs[i], seed, (unsigned int)i);
+
+    return env;
+}
+
+void UnloadVecEnv(VecEnv *env)
+{
+    free(env->actions);
+    free(env->rewards);
+    free(env->dones);
+    free(env->truncated);
+    free(env->episodeReturns);
+    free(env->finalReturns);
+    free(env->episodeTicks);
+    free(env->rngs);
+    *env = (VecEnv){ 0 };
+}
+
+void RunVecEnv(VecEnv *env, JobFunc func, void *data)
+{
+    RunParallelFor(func, data, env->count, VECENV_BATCH_SIZE);
+
+    env->steps += (unsigned long long)env->count;
+    for (int i = 0; i < env->count; i++) env->episodes += env->dones[i];
+}
+
+#endif // VECENV_IMPLEMENTATION